@@ -60,6 +60,40 @@ extern "C" {
 #include "bsp_pwm.h"
 #include "bsp_pwm_cb.h"
 #include "bsp_io.h"
+#include "bsp_hall.h"
+#include "bsp_hall_cb.h"
+#include "bsp_adc.h"
+#include "bsp_adc_cb.h"
+#include "bsp_com_tim.h"
+#include "bsp_com_tim_cb.h"
+#include "bsp_comp.h"
+#include "bsp_comp_cb.h"
+#include "bsp_flash.h"
+#include "motor_six_step.h"
+#include "motor_bemf.h"
+#include "motor_hall_speed.h"
+#include "motor_hall_sin.h"
+#include "motor_math.h"
+#include "motor_param.h"
+#include "motor_smo.h"
+#include "motor_flux_obs.h"
+#include "motor_hfi.h"
+#include "motor_fw.h"
+#include "motor_dtc.h"
+#include "motor_single_shunt.h"
+#include "motor_mtpa.h"
+#include "motor_traj.h"
+#include "motor_loop.h"
+#include "motor_ipd.h"
+#include "motor_param_id.h"
+#include "motor_tune.h"
+#include "motor_regen.h"
+#include "motor_cogging.h"
+#include "motor_resonant.h"
+#include "motor_svpwm.h"
+#include "motor_foc.h"
+#include "motor_startup.h"
+#include "motor_ctrl.h"
 
 /* ============================ Public Constants ============================ */
 
@@ -70,15 +70,34 @@ int main(void)
 	bsp_io_init();
 	bsp_led_init();
 	bsp_key_init();
-	bsp_pwm_init(bsp_pwm_irq_cb);
+	bsp_hall_init(bsp_hall_irq_cb);
+	bsp_com_tim_init(bsp_com_tim_irq_cb);
+	bsp_pwm_init(bsp_pwm_irq_cb, bsp_pwm_com_irq_cb, bsp_pwm_cc_irq_cb);
+	bsp_adc_init(bsp_adc_irq_cb);
+	bsp_comp_init(bsp_comp_irq_cb);
+	motor_svpwm_init();
+	motor_six_step_init();
+	motor_hall_speed_init();
+	motor_bemf_init();
+	motor_hall_sin_init();
+	motor_foc_init();
+	motor_startup_init();
+	motor_loop_init();
+	motor_param_id_init();
+	motor_tune_init();
+	motor_ctrl_init(MOTOR_MODE_FOC);
 
 	printf("02-n32g435_timerbase\r\n");
 	bsp_led_ctrl(LED1, LED_ON);
 	bsp_led_ctrl(LED2, LED_ON);
 	bsp_led_ctrl(LED3, LED_ON);
+
+	/*sensorless foc: offsets, alignment, I/F ramp, then the flux observer takes over*/
+	motor_ctrl_start(MOTOR_DIR_CW);
 	
 	while(1)
 	{
+		motor_ctrl_task();
 	}
 }
 
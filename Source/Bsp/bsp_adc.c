@@ -0,0 +1,233 @@
+/**
+ * @file bsp_adc.c
+ * @brief ADC injected group driver
+ * 
+ * @details
+ * The injected sequence is started by TIM1 TRGO once per pwm period and the
+ * JEOC interrupt hands the results to the registered callback.
+ * Default sequence: rank1 = floating phase BEMF, rank2 = DC bus voltage.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include "bsp_adc.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+adc_irq_cb_t adc_irq_cb = {NULL};
+uint8_t adc_vbus_rank = 2;              /*rank of ADC_VBUS_CH in the loaded injected sequence, bsp_adc_config() puts it on 2*/
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief adc clock config
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void bsp_adc_rcc_config(void)
+{
+    RCC_EnableAHBPeriphClk(RCC_AHB_PERIPH_ADC, ENABLE);
+    RCC_EnableAPB2PeriphClk(ADC_GPIO_CLK, ENABLE);
+    /* ADC clock 108MHz / 4 = 27MHz, 1M clock for the internal timing */
+    ADC_ConfigClk(ADC_CTRL3_CKMOD_AHB, RCC_ADCHCLK_DIV4);
+    RCC_ConfigAdc1mClk(RCC_ADC1MCLK_SRC_HSE, RCC_ADC1MCLK_DIV8);
+}
+
+
+/**
+ * @brief adc io config
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void bsp_adc_io_config(void)
+{
+    GPIO_InitType GPIO_InitStructure;
+
+    GPIO_InitStruct(&GPIO_InitStructure);
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Analog;
+
+    GPIO_InitStructure.Pin = ADC_VBUS_PIN;
+    GPIO_InitPeripheral(ADC_VBUS_GPIO, &GPIO_InitStructure);
+    GPIO_InitStructure.Pin = ADC_BEMF_PIN;
+    GPIO_InitPeripheral(ADC_BEMF_GPIO, &GPIO_InitStructure);
+    GPIO_InitStructure.Pin = ADC_I_PIN;
+    GPIO_InitPeripheral(ADC_I_GPIO, &GPIO_InitStructure);
+}
+
+
+/**
+ * @brief adc config, injected group triggered by TIM1
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void bsp_adc_config(void)
+{
+    ADC_InitType ADC_InitStructure;
+    NVIC_InitType NVIC_InitStructure;
+
+    ADC_InitStruct(&ADC_InitStructure);
+    ADC_InitStructure.MultiChEn      = ENABLE;
+    ADC_InitStructure.ContinueConvEn = DISABLE;
+    ADC_InitStructure.ExtTrigSelect  = ADC_EXT_TRIGCONV_NONE;
+    ADC_InitStructure.DatAlign       = ADC_DAT_ALIGN_R;
+    ADC_InitStructure.ChsNumber      = 1;
+    ADC_Init(ADC, &ADC_InitStructure);
+
+    ADC_ConfigInjectedSequencerLength(ADC, 2);
+    ADC_ConfigInjectedChannel(ADC, ADC_BEMF_U_CH, 1, ADC_INJ_SAMPLE_TIME);
+    ADC_ConfigInjectedChannel(ADC, ADC_VBUS_CH,   2, ADC_INJ_SAMPLE_TIME);
+    ADC_ConfigExternalTrigInjectedConv(ADC, ADC_INJ_TRIG_SRC);
+    ADC_EnableExternalTrigInjectedConv(ADC, ENABLE);
+
+    ADC_ConfigInt(ADC, ADC_INT_JENDC, ENABLE);
+
+    NVIC_InitStructure.NVIC_IRQChannel                   = ADC_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+
+    ADC_Enable(ADC, ENABLE);
+    while(ADC_GetFlagStatusNew(ADC, ADC_FLAG_RDY) == RESET);
+
+    ADC_StartCalibration(ADC);
+    while(ADC_GetCalibrationStatus(ADC));
+}
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init the adc
+ * 
+ * @param[in] irq_cb: the injected end of conversion callback
+ * @return None
+ */
+void bsp_adc_init(void (*irq_cb)(void))
+{
+    if(irq_cb == NULL)
+    {
+        while(1);
+    }
+
+    adc_irq_cb.adc_cb = irq_cb;
+    bsp_adc_rcc_config();
+    bsp_adc_io_config();
+    bsp_adc_config();
+}
+
+
+/**
+ * @brief change the channel of an injected rank, takes effect from the next trigger
+ * 
+ * @param[in] rank: 1 ~ 4
+ * @param[in] channel: ADC_CH_x
+ * @return None
+ */
+void bsp_adc_inj_channel_set(uint8_t rank, uint8_t channel)
+{
+    ADC_ConfigInjectedChannel(ADC, channel, rank, ADC_INJ_SAMPLE_TIME);
+    if(channel == ADC_VBUS_CH)
+    {
+        adc_vbus_rank = rank;
+    }
+    else if(rank == adc_vbus_rank)
+    {
+        adc_vbus_rank = ADC_VBUS_RANK_NONE;
+    }
+}
+
+
+/**
+ * @brief load a whole injected sequence, the rank position depends on the length so it is set first
+ * 
+ * @param[in] channel: channel of rank 1 ~ len
+ * @param[in] len: 1 ~ 4
+ * @return None
+ */
+void bsp_adc_inj_seq_set(const uint8_t *channel, uint8_t len)
+{
+    uint8_t i;
+
+    adc_vbus_rank = ADC_VBUS_RANK_NONE;
+    ADC_ConfigInjectedSequencerLength(ADC, len);
+    for(i = 0; i < len; i++)
+    {
+        ADC_ConfigInjectedChannel(ADC, channel[i], i + 1, ADC_INJ_SAMPLE_TIME);
+        adc_vbus_rank = (channel[i] == ADC_VBUS_CH) ? (i + 1) : adc_vbus_rank;
+    }
+}
+
+
+/**
+ * @brief register image of an injected sequence for ADC_INJ_SEQ_LOAD(), the loaded sequence is kept
+ * 
+ * @details
+ * Built by the library (the rank position depends on the length), which also
+ * sets the sample time of the channels: at run time only the image is stored.
+ * The images have to convert the bus on the rank of the sequence loaded when
+ * they are stored (adc_vbus_rank is not changed by the load).
+ * 
+ * @param[in] channel: channel of rank 1 ~ len
+ * @param[in] len: 1 ~ 4
+ * @return JSEQ register value
+ */
+uint32_t bsp_adc_inj_seq_image(const uint8_t *channel, uint8_t len)
+{
+    uint32_t jseq = ADC->JSEQ;
+    uint8_t  rank = adc_vbus_rank;
+    uint32_t image;
+
+    bsp_adc_inj_seq_set(channel, len);
+    image         = ADC->JSEQ;
+    ADC->JSEQ     = jseq;
+    adc_vbus_rank = rank;
+
+    return image;
+}
+
+
+/**
+ * @brief injected group trigger: the whole sequence on TIM1 TRGO, or one rank per TIM1 CC4 event
+ * 
+ * @param[in] src: ADC_INJ_TRIG_SRC or ADC_INJ_TRIG_SINGLE_SHUNT
+ * @param[in] disc: ENABLE converts one rank per trigger, the end of conversion after the last rank
+ * @return None
+ */
+void bsp_adc_inj_trig_select(uint32_t src, FunctionalState disc)
+{
+    ADC_EnableInjectedDiscMode(ADC, disc);
+    ADC_ConfigExternalTrigInjectedConv(ADC, src);
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,118 @@
+/**
+ * @file bsp_adc.h
+ * @brief Driver bsp_adc Header
+ * 
+ * @details
+ * ADC injected group triggered by TIM1, one conversion sequence per pwm period.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+#ifndef __BSP_ADC_H__
+#define __BSP_ADC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+
+/* ============================ Public Constants ============================ */
+
+#define ADC_FULL_SCALE                  (4096)    // 12bit
+#define ADC_INJ_SAMPLE_TIME             ADC_SAMP_TIME_7CYCLES5
+
+/* **************************** adc channel macro **************************** */
+#define ADC_VBUS_CH                     ADC_CH_8_PA7
+#define ADC_VBUS_GPIO                   GPIOA
+#define ADC_VBUS_PIN                    GPIO_PIN_7
+
+#define ADC_BEMF_U_CH                   ADC_CH_12_PC1
+#define ADC_BEMF_V_CH                   ADC_CH_13_PC2
+#define ADC_BEMF_W_CH                   ADC_CH_14_PC3
+#define ADC_BEMF_GPIO                   GPIOC
+#define ADC_BEMF_PIN                    (GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3)
+
+/* low side shunt amplifiers, offset at mid scale */
+#define ADC_IU_CH                       ADC_CH_5_PA4
+#define ADC_IV_CH                       ADC_CH_6_PA5
+#define ADC_IW_CH                       ADC_CH_7_PA6
+#define ADC_I_GPIO                      GPIOA
+#define ADC_I_PIN                       (GPIO_PIN_4 | GPIO_PIN_5 | GPIO_PIN_6)
+
+/* single shunt boards: the dc link shunt amplifier on the phase U input, offset at mid scale */
+#define ADC_IBUS_CH                     ADC_IU_CH
+
+#define ADC_GPIO_CLK                    (RCC_APB2_PERIPH_GPIOA | RCC_APB2_PERIPH_GPIOC)
+
+/* TIM1 TRGO is the update event, i.e. the counter underflow = center of the high side on time */
+#define ADC_INJ_TRIG_SRC                ADC_EXT_TRIG_INJ_CONV_T1_TRGO
+
+/* single shunt: every TIM1 CC4 event converts the next rank (discontinuous injected mode) */
+#define ADC_INJ_TRIG_SINGLE_SHUNT       ADC_EXT_TRIG_INJ_CONV_T1_CC4
+
+#define ADC_VBUS_RANK_NONE              (0)       // the loaded injected sequence does not convert the bus
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct 
+{
+    void (*adc_cb)(void);
+}adc_irq_cb_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern adc_irq_cb_t adc_irq_cb;
+extern uint8_t adc_vbus_rank;
+
+/* ============================ Macro Function Declarations ============================ */
+
+#define ADC_INJ_DAT1()          ((uint16_t)ADC->JDAT1)
+#define ADC_INJ_DAT2()          ((uint16_t)ADC->JDAT2)
+#define ADC_INJ_DAT3()          ((uint16_t)ADC->JDAT3)
+#define ADC_INJ_DAT4()          ((uint16_t)ADC->JDAT4)
+
+/* last bus conversion of the loaded sequence, whatever the mode; only when adc_vbus_rank != ADC_VBUS_RANK_NONE */
+#define ADC_INJ_VBUS()          ((uint16_t)(&ADC->JDAT1)[adc_vbus_rank - 1])
+
+/* a whole injected sequence in one store, image from bsp_adc_inj_seq_image(), the bus on the rank of the loaded one */
+#define ADC_INJ_SEQ_LOAD(image) (ADC->JSEQ = (image))
+
+/* the conversions keep running, only the end of conversion interrupt is gated */
+#define ADC_INJ_IRQ_ENABLE()    (ADC->CTRL1 |= ADC_CTRL1_JENDCIEN)
+#define ADC_INJ_IRQ_DISABLE()   (ADC->CTRL1 &= ~ADC_CTRL1_JENDCIEN)
+
+/* ============================ Function Declarations ============================ */
+
+void bsp_adc_init(void (*irq_cb)(void));
+void bsp_adc_inj_channel_set(uint8_t rank, uint8_t channel);
+void bsp_adc_inj_seq_set(const uint8_t *channel, uint8_t len);
+uint32_t bsp_adc_inj_seq_image(const uint8_t *channel, uint8_t len);
+void bsp_adc_inj_trig_select(uint32_t src, FunctionalState disc);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__BSP_ADC_H__*/
+
+
+/**
+  * @}
+  */
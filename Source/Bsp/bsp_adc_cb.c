@@ -0,0 +1,61 @@
+/**
+ * @file bsp_adc_cb.c
+ * @brief ADC interrupt callback
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_adc.h"
+#include "bsp_adc_cb.h"
+#include "motor_ctrl.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief adc injected end of conversion callback, runs once per pwm period
+ * 
+ * @param[in] None
+ * @return None
+ */
+void bsp_adc_irq_cb(void)
+{
+    if (ADC_GetIntStatus(ADC, ADC_INT_JENDC) != RESET)
+    {
+        ADC_ClearIntPendingBit(ADC, ADC_INT_JENDC);
+        motor_ctrl_adc_isr();
+    }
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
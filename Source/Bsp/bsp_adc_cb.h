@@ -0,0 +1,54 @@
+/**
+ * @file bsp_adc_cb.h
+ * @brief Driver bsp_adc_cb Header
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+#ifndef __BSP_ADC_CB_H__
+#define __BSP_ADC_CB_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+
+/* ============================ Public Constants ============================ */
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void bsp_adc_irq_cb(void);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__BSP_ADC_CB_H__*/
+
+
+/**
+  * @}
+  */
@@ -0,0 +1,89 @@
+/**
+ * @file bsp_com_tim.c
+ * @brief Commutation delay timer
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include "bsp_com_tim.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+com_tim_irq_cb_t com_tim_irq_cb = {NULL};
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init TIM2 as one pulse delay timer, TRGO on update
+ * 
+ * @param[in] cc_cb: the compare 1 (blanking end) interrupt callback
+ * @return None
+ */
+void bsp_com_tim_init(void (*cc_cb)(void))
+{
+    TIM_TimeBaseInitType TIM_TimeBaseStructure;
+    NVIC_InitType NVIC_InitStructure;
+
+    if(cc_cb == NULL)
+    {
+        while(1);
+    }
+
+    com_tim_irq_cb.cc_cb = cc_cb;
+
+    RCC_EnableAPB1PeriphClk(COM_TIM_CLK, ENABLE);
+
+    TIM_InitTimBaseStruct(&TIM_TimeBaseStructure);
+    TIM_TimeBaseStructure.Prescaler = COM_TIM_PRESCALER;
+    TIM_TimeBaseStructure.CntMode   = TIM_CNT_MODE_UP;
+    TIM_TimeBaseStructure.Period    = 0xFFFF;
+    TIM_TimeBaseStructure.ClkDiv    = TIM_CLK_DIV1;
+    TIM_TimeBaseStructure.RepetCnt  = 0;
+    TIM_InitTimeBase(COM_TIM, &TIM_TimeBaseStructure);
+
+    /* AR is written right before the start, no preload */
+    TIM_ConfigArPreload(COM_TIM, DISABLE);
+    TIM_SelectOnePulseMode(COM_TIM, TIM_OPMODE_SINGLE);
+    TIM_ConfigUpdateRequestIntSrc(COM_TIM, TIM_UPDATE_SRC_REGULAr);
+    TIM_SelectOutputTrig(COM_TIM, TIM_TRGO_SRC_UPDATE);
+
+    /* CC1 is a plain compare (frozen output), its interrupt is enabled by COM_TIM_ARM() */
+    NVIC_InitStructure.NVIC_IRQChannel                   = TIM2_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
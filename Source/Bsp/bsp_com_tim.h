@@ -0,0 +1,87 @@
+/**
+ * @file bsp_com_tim.h
+ * @brief Driver bsp_com_tim Header
+ * 
+ * @details
+ * One pulse commutation delay timer (TIM2). Its update event is routed through
+ * TRGO to TIM1 and fires the COM event without software latency.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+#ifndef __BSP_COM_TIM_H__
+#define __BSP_COM_TIM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+
+/* ============================ Public Constants ============================ */
+
+#define COM_TIM                         TIM2
+#define COM_TIM_CLK                     RCC_APB1_PERIPH_TIM2
+#define COM_TIM_PRESCALER               (54 - 1)  // 54MHz timer clock -> 1us tick
+#define COM_TIM_FREQ_HZ                 (1000000)
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    void (*cc_cb)(void);
+}com_tim_irq_cb_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern com_tim_irq_cb_t com_tim_irq_cb;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* fire the TIM1 COM event [delay] us from now, delay >= 1 */
+#define COM_TIM_START(delay)    do { COM_TIM->CNT = 0; COM_TIM->AR = (delay); COM_TIM->CTRL1 |= TIM_CTRL1_CNTEN; } while(0)
+#define COM_TIM_STOP()          do { COM_TIM->CTRL1 &= ~TIM_CTRL1_CNTEN; COM_TIM->DINTEN &= ~TIM_DINTEN_CC1IEN; } while(0)
+
+/* count from the commutation: CC1 interrupt after [blank] us, TIM1 COM after [timeout] us unless moved */
+#define COM_TIM_ARM(timeout, blank)                                                         \
+    do {                                                                                    \
+        COM_TIM->CNT    = 0;                                                                \
+        COM_TIM->AR     = (timeout);                                                        \
+        COM_TIM->CCDAT1 = (blank);                                                          \
+        COM_TIM->STS    = ~TIM_STS_CC1ITF;                                                  \
+        COM_TIM->DINTEN |= TIM_DINTEN_CC1IEN;                                               \
+        COM_TIM->CTRL1 |= TIM_CTRL1_CNTEN;                                                  \
+    } while(0)
+#define COM_TIM_CNT()           (COM_TIM->CNT)
+#define COM_TIM_RELOAD_SET(ar)  (COM_TIM->AR = (ar))
+
+/* ============================ Function Declarations ============================ */
+
+void bsp_com_tim_init(void (*cc_cb)(void));
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__BSP_COM_TIM_H__*/
+
+
+/**
+  * @}
+  */
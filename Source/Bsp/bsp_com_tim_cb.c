@@ -0,0 +1,62 @@
+/**
+ * @file bsp_com_tim_cb.c
+ * @brief Commutation delay timer interrupt callback
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_com_tim.h"
+#include "bsp_com_tim_cb.h"
+#include "motor_bemf.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief compare 1 of the commutation timer: end of the demagnetization blanking
+ * 
+ * @param[in] None
+ * @return None
+ */
+void bsp_com_tim_irq_cb(void)
+{
+    if (TIM_GetIntStatus(COM_TIM, TIM_INT_CC1) != RESET)
+    {
+        TIM_ClrIntPendingBit(COM_TIM, TIM_INT_CC1);
+        TIM_ConfigInt(COM_TIM, TIM_INT_CC1, DISABLE);
+        motor_bemf_comp_blank_isr();
+    }
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,205 @@
+/**
+ * @file bsp_comp.c
+ * @brief Comparator BEMF zero cross driver
+ * 
+ * @details
+ * Only the sector where the floating phase crosses in the expected direction
+ * gives a rising output (the polarity is flipped per sector), so a single
+ * edge interrupt per sector is the whole CPU cost of the detection.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include "bsp_comp.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+comp_irq_cb_t comp_irq_cb = {NULL};
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief comparator clock config
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void bsp_comp_rcc_config(void)
+{
+    RCC_EnableAPB1PeriphClk(BEMF_COMP_CLK, ENABLE);
+    RCC_EnableAPB2PeriphClk(BEMF_COMP_GPIO_CLK, ENABLE);
+}
+
+
+/**
+ * @brief comparator io config
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void bsp_comp_io_config(void)
+{
+    GPIO_InitType GPIO_InitStructure;
+
+    GPIO_InitStruct(&GPIO_InitStructure);
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Analog;
+
+    GPIO_InitStructure.Pin = BEMF_COMP_PHASE_PIN;
+    GPIO_InitPeripheral(BEMF_COMP_PHASE_GPIO, &GPIO_InitStructure);
+    GPIO_InitStructure.Pin = BEMF_COMP_NEUTRAL_PIN;
+    GPIO_InitPeripheral(BEMF_COMP_NEUTRAL_GPIO, &GPIO_InitStructure);
+}
+
+
+/**
+ * @brief comparator config: blanking, filter, hysteresis and the EXTI interrupt
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void bsp_comp_config(void)
+{
+    COMP_InitType COMP_InitStructure;
+    EXTI_InitType EXTI_InitStructure;
+    NVIC_InitType NVIC_InitStructure;
+
+    COMP_StructInit(&COMP_InitStructure);
+    COMP_InitStructure.InpSel  = BEMF_COMP_U_INP;
+    COMP_InitStructure.InmSel  = BEMF_COMP_NEUTRAL_INM;
+    COMP_InitStructure.OutTrig = COMP1_CTRL_OUTSEL_NC;
+    COMP_InitStructure.En      = true;
+    COMP_Init(BEMF_COMP, &COMP_InitStructure);
+
+    /* output forced low while TIM1 OC5REF is active (switching edges, low side on-time) */
+    COMP_SetBlanking(BEMF_COMP, COMP_CTRL_BLKING_TIM1_OC5);
+    /* THRESH equal samples out of WINDOW + 1, the ringing after the blanking window is rejected */
+    COMP_SetFilterPrescaler(BEMF_COMP, BEMF_COMP_FILTER_PSC);
+    COMP_SetFilterControl(BEMF_COMP, 1, BEMF_COMP_FILTER_THRESH, BEMF_COMP_FILTER_WINDOW);
+    COMP_SetHyst(BEMF_COMP, BEMF_COMP_HYST);
+
+    COMP_SetIntEn(COMP_INTEN_CMP1IEN);
+
+    EXTI_InitStruct(&EXTI_InitStructure);
+    EXTI_InitStructure.EXTI_Line    = BEMF_COMP_EXTI_LINE;
+    EXTI_InitStructure.EXTI_Mode    = EXTI_Mode_Interrupt;
+    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising;
+    EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+    EXTI_InitPeripheral(&EXTI_InitStructure);
+    BEMF_COMP_IRQ_DISABLE();
+
+    NVIC_InitStructure.NVIC_IRQChannel                   = BEMF_COMP_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init the bemf comparator, the interrupt stays masked until BEMF_COMP_IRQ_ENABLE()
+ * 
+ * @param[in] irq_cb: the zero cross interrupt callback
+ * @return None
+ */
+void bsp_comp_init(void (*irq_cb)(void))
+{
+    if(irq_cb == NULL)
+    {
+        while(1);
+    }
+
+    comp_irq_cb.comp_cb = irq_cb;
+    bsp_comp_rcc_config();
+    bsp_comp_io_config();
+    bsp_comp_config();
+}
+
+
+/**
+ * @brief select the floating phase and the crossing direction, one register write
+ * 
+ * @param[in] inp: BEMF_COMP_U_INP / BEMF_COMP_V_INP / BEMF_COMP_W_INP
+ * @param[in] invert: ENABLE for a falling bemf, the valid crossing is always a rising output
+ * @return None
+ */
+void bsp_comp_input_set(COMP_CTRL_INPSEL inp, FunctionalState invert)
+{
+    uint32_t ctrl = BEMF_COMP_REG.CTRL & ~(COMP_CTRL_INPSEL_MASK | COMP_POL_MASK);
+
+    ctrl |= (uint32_t)inp;
+    if(invert != DISABLE)
+    {
+        ctrl |= COMP_POL_MASK;
+    }
+    BEMF_COMP_REG.CTRL = ctrl;
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+/**
+ * @brief host model of the blanking and the digital filter, one call per filter clock
+ * 
+ * The raw output is forced low while blanked. The filtered output follows the raw
+ * one once BEMF_COMP_FILTER_THRESH of the last BEMF_COMP_FILTER_WINDOW + 1 samples
+ * agree, otherwise it holds. Detection latency = calls from the crossing to a 1.
+ * 
+ * @param[in] hist: filter state, the sample history (bit0 = newest) and the output in bit15
+ * @param[in] in: raw comparator output
+ * @param[in] blank: blanking active
+ * @return the filtered output
+ */
+uint8_t bsp_comp_filter_model(uint16_t *hist, uint8_t in, uint8_t blank)
+{
+    uint16_t window = (uint16_t)((1U << (BEMF_COMP_FILTER_WINDOW + 1)) - 1U);
+    uint16_t samples;
+    uint8_t ones = 0;
+    uint8_t i;
+
+    samples = (uint16_t)(((*hist << 1) | ((blank != 0) ? 0U : (in & 1U))) & window);
+    for(i = 0; i <= BEMF_COMP_FILTER_WINDOW; i++)
+    {
+        ones += (samples >> i) & 1U;
+    }
+
+    *hist = (uint16_t)((*hist & 0x8000U) | samples);
+    if(ones >= BEMF_COMP_FILTER_THRESH)
+    {
+        *hist |= 0x8000U;
+    }
+    else if((BEMF_COMP_FILTER_WINDOW + 1 - ones) >= BEMF_COMP_FILTER_THRESH)
+    {
+        *hist &= 0x7FFFU;
+    }
+
+    return (uint8_t)(*hist >> 15);
+}
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
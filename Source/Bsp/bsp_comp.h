@@ -0,0 +1,99 @@
+/**
+ * @file bsp_comp.h
+ * @brief Driver bsp_comp Header
+ * 
+ * @details
+ * COMP1 compares the floating phase with the virtual neutral (resistor star of
+ * the three phase dividers). The output is blanked by TIM1 OC5 outside the
+ * high side on-time and digitally filtered, a rising output raises EXTI line 21.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+#ifndef __BSP_COMP_H__
+#define __BSP_COMP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+
+/* ============================ Public Constants ============================ */
+
+#define BEMF_COMP                       COMP1
+#define BEMF_COMP_REG                   (COMP->Cmp1)
+#define BEMF_COMP_CLK                   (RCC_APB1_PERIPH_COMP | RCC_APB1_PERIPH_COMP_FILT)
+#define BEMF_COMP_EXTI_LINE             EXTI_LINE21
+#define BEMF_COMP_IRQn                  COMP_1_2_IRQn
+
+#define BEMF_COMP_U_INP                 COMP1_CTRL_INPSEL_PA0
+#define BEMF_COMP_V_INP                 COMP1_CTRL_INPSEL_PA2
+#define BEMF_COMP_W_INP                 COMP1_CTRL_INPSEL_PA12
+#define BEMF_COMP_NEUTRAL_INM           COMP1_CTRL_INMSEL_PB5
+
+#define BEMF_COMP_PHASE_GPIO            GPIOA
+#define BEMF_COMP_PHASE_PIN             (GPIO_PIN_0 | GPIO_PIN_2 | GPIO_PIN_12)
+#define BEMF_COMP_NEUTRAL_GPIO          GPIOB
+#define BEMF_COMP_NEUTRAL_PIN           GPIO_PIN_5
+#define BEMF_COMP_GPIO_CLK              (RCC_APB2_PERIPH_GPIOA | RCC_APB2_PERIPH_GPIOB | RCC_APB2_PERIPH_AFIO)
+
+#define BEMF_COMP_HYST                  COMP_CTRL_HYST_MID      // 15mV
+#define BEMF_COMP_FILTER_PSC            (27 - 1)                // filter clock PCLK1 27MHz -> 1us per sample
+#define BEMF_COMP_FILTER_WINDOW         (7)                     // 8 samples per window
+#define BEMF_COMP_FILTER_THRESH         (5)                     // must be > window / 2
+#define BEMF_COMP_FILTER_LATENCY_US     (BEMF_COMP_FILTER_THRESH)
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    void (*comp_cb)(void);
+}comp_irq_cb_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern comp_irq_cb_t comp_irq_cb;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* the interrupt is gated by the EXTI mask, a stale edge is dropped when enabling */
+#define BEMF_COMP_IRQ_ENABLE()  do { EXTI->PEND = BEMF_COMP_EXTI_LINE; EXTI->IMASK |= BEMF_COMP_EXTI_LINE; } while(0)
+#define BEMF_COMP_IRQ_DISABLE() (EXTI->IMASK &= ~BEMF_COMP_EXTI_LINE)
+#define BEMF_COMP_OUT()         ((BEMF_COMP_REG.CTRL & COMP_CTRL_OUT_MASK) != 0)
+
+/* ============================ Function Declarations ============================ */
+
+void bsp_comp_init(void (*irq_cb)(void));
+void bsp_comp_input_set(COMP_CTRL_INPSEL inp, FunctionalState invert);
+
+#ifdef UNIT_TEST
+uint8_t bsp_comp_filter_model(uint16_t *hist, uint8_t in, uint8_t blank);
+#endif /* UNIT_TEST */
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__BSP_COMP_H__*/
+
+
+/**
+  * @}
+  */
@@ -0,0 +1,61 @@
+/**
+ * @file bsp_comp_cb.c
+ * @brief Comparator interrupt callback
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_comp.h"
+#include "bsp_comp_cb.h"
+#include "motor_bemf.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief bemf comparator rising output: the zero cross of the floating phase
+ * 
+ * @param[in] None
+ * @return None
+ */
+void bsp_comp_irq_cb(void)
+{
+    if (EXTI_GetITStatus(BEMF_COMP_EXTI_LINE) != RESET)
+    {
+        EXTI_ClrITPendBit(BEMF_COMP_EXTI_LINE);
+        motor_bemf_comp_zc_isr();
+    }
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
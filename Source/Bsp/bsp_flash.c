@@ -0,0 +1,99 @@
+/**
+ * @file bsp_flash.c
+ * @brief Internal flash parameter page
+ * 
+ * @details
+ * The page is erased whole, then programmed word by word from where the data
+ * lives, no staging copy; it is read straight from its address.
+ * Erase and program stall the instruction fetch from flash, the interrupts
+ * included, for up to tens of milliseconds: only with the motor stopped.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_flash.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief erase the parameter page
+ * 
+ * @param[in] None
+ * @return 0 ok, 1 erase failed
+ */
+uint8_t bsp_flash_param_erase(void)
+{
+    uint8_t err;
+
+    FLASH_Unlock();
+    err = (FLASH_EraseOnePage(BSP_FLASH_PARAM_ADDR) != FLASH_COMPL) ? 1 : 0;
+    FLASH_Lock();
+
+    return err;
+}
+
+
+/**
+ * @brief program words into the erased parameter page, read back
+ * 
+ * @param[in] offset: byte offset in the page, word aligned
+ * @param[in] data: words to write
+ * @param[in] words: count, within the page
+ * @return 0 ok, 1 outside the page, program or read back failed
+ */
+uint8_t bsp_flash_param_program(uint32_t offset, const uint32_t *data, uint32_t words)
+{
+    const volatile uint32_t *flash = (const volatile uint32_t *)BSP_FLASH_PARAM_ADDR;
+    uint32_t i;
+    uint8_t  err = 0;
+
+    if(((offset & 3) != 0) || (offset + words * 4 > BSP_FLASH_PAGE_SIZE))
+    {
+        return 1;
+    }
+
+    FLASH_Unlock();
+    for(i = 0; (i < words) && (err == 0); i++)
+    {
+        if((FLASH_ProgramWord(BSP_FLASH_PARAM_ADDR + offset + i * 4, data[i]) != FLASH_COMPL) || (flash[offset / 4 + i] != data[i]))
+        {
+            err = 1;
+        }
+    }
+    FLASH_Lock();
+
+    return err;
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,61 @@
+/**
+ * @file bsp_flash.h
+ * @brief Driver bsp_flash Header
+ * 
+ * @details
+ * Parameter page in the internal flash: the last 2KB page, kept out of the
+ * program by the IROM1 size of the project (0x1F800).
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+#ifndef __BSP_FLASH_H__
+#define __BSP_FLASH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+
+/* ============================ Public Constants ============================ */
+
+#define BSP_FLASH_PAGE_SIZE             (2048)
+#define BSP_FLASH_PARAM_ADDR            (0x0801F800)        // last page of the 128KB
+
+/* ============================ Error Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+uint8_t bsp_flash_param_erase(void);
+uint8_t bsp_flash_param_program(uint32_t offset, const uint32_t *data, uint32_t words);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__BSP_FLASH_H__*/
+
+/**
+  * @}
+  */
@@ -0,0 +1,180 @@
+/**
+ * @file bsp_hall.c
+ * @brief Hall sensor timer interface
+ * 
+ * @details
+ * TIM4 runs in hall sensor mode: TI1 is the XOR of the three hall inputs, every edge
+ * resets the counter (slave reset mode on TI1F_ED) and OC2REF is routed to TRGO so
+ * TIM1 sees a trigger HALL_COM_DELAY ticks after the edge and applies the preloaded
+ * commutation pattern in hardware.
+ * The capture interrupt (every edge) and the overflow interrupt (no edge for
+ * 65ms, the update request is overflow only so the edge reset does not fire it)
+ * go to cap_cb. It is the only interrupt at preemption priority 0 (priority
+ * group 4 has no sub priority), one above the TIM1 COM interrupt: the capture
+ * of an edge is always handled before the COM interrupt of the same edge,
+ * even when both are pending.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include "bsp_hall.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+hall_irq_cb_t hall_irq_cb = {NULL};
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief hall clock config
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void bsp_hall_rcc_config(void)
+{
+    RCC_EnableAPB1PeriphClk(HALL_TIM_CLK, ENABLE);
+    RCC_EnableAPB2PeriphClk(HALL_GPIO_CLK | RCC_APB2_PERIPH_AFIO, ENABLE);
+}
+
+
+/**
+ * @brief hall io config
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void bsp_hall_io_config(void)
+{
+    GPIO_InitType GPIO_InitStructure;
+
+    GPIO_InitStruct(&GPIO_InitStructure);
+    GPIO_InitStructure.GPIO_Current   = GPIO_DC_2mA;
+    GPIO_InitStructure.GPIO_Mode      = GPIO_Mode_Input;
+    GPIO_InitStructure.GPIO_Pull      = GPIO_Pull_Up;
+    GPIO_InitStructure.GPIO_Slew_Rate = GPIO_Slew_Rate_High;
+    GPIO_InitStructure.GPIO_Alternate = HALL_GPIO_AF;
+
+    GPIO_InitStructure.Pin = HALL_A_PIN;
+    GPIO_InitPeripheral(HALL_A_GPIO, &GPIO_InitStructure);
+    GPIO_InitStructure.Pin = HALL_B_PIN;
+    GPIO_InitPeripheral(HALL_B_GPIO, &GPIO_InitStructure);
+    GPIO_InitStructure.Pin = HALL_C_PIN;
+    GPIO_InitPeripheral(HALL_C_GPIO, &GPIO_InitStructure);
+}
+
+
+/**
+ * @brief hall timer config
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void bsp_hall_tim_config(void)
+{
+    TIM_TimeBaseInitType TIM_TimeBaseStructure;
+    TIM_ICInitType TIM_ICInitStructure;
+    OCInitType TIM_OCInitStructure;
+
+    TIM_InitTimBaseStruct(&TIM_TimeBaseStructure);
+    TIM_TimeBaseStructure.Prescaler = HALL_TIM_PRESCALER;
+    TIM_TimeBaseStructure.CntMode   = TIM_CNT_MODE_UP;
+    TIM_TimeBaseStructure.Period    = 0xFFFF;
+    TIM_TimeBaseStructure.ClkDiv    = TIM_CLK_DIV1;
+    TIM_TimeBaseStructure.RepetCnt  = 0;
+    TIM_InitTimeBase(HALL_TIM, &TIM_TimeBaseStructure);
+
+    /* TI1 = CH1 ^ CH2 ^ CH3, captured into CCDAT1 on every edge */
+    TIM_SelectHallSensor(HALL_TIM, ENABLE);
+
+    TIM_InitIcStruct(&TIM_ICInitStructure);
+    TIM_ICInitStructure.Channel     = TIM_CH_1;
+    TIM_ICInitStructure.IcPolarity  = TIM_IC_POLARITY_RISING;
+    TIM_ICInitStructure.IcSelection = TIM_IC_SELECTION_TRC;
+    TIM_ICInitStructure.IcPrescaler = TIM_IC_PSC_DIV1;
+    TIM_ICInitStructure.IcFilter    = 0x0B;
+    TIM_ICInit(HALL_TIM, &TIM_ICInitStructure);
+
+    /* every hall edge restarts the counter */
+    TIM_SelectInputTrig(HALL_TIM, TIM_TRIG_SEL_TI1F_ED);
+    TIM_SelectSlaveMode(HALL_TIM, TIM_SLAVE_MODE_RESET);
+
+    /* OC2REF goes active HALL_COM_DELAY ticks after the edge and drives TRGO */
+    TIM_InitOcStruct(&TIM_OCInitStructure);
+    TIM_OCInitStructure.OcMode      = TIM_OCMODE_PWM2;
+    TIM_OCInitStructure.OutputState = TIM_OUTPUT_STATE_DISABLE;
+    TIM_OCInitStructure.Pulse       = HALL_COM_DELAY;
+    TIM_OCInitStructure.OcPolarity  = TIM_OC_POLARITY_HIGH;
+    TIM_InitOc2(HALL_TIM, &TIM_OCInitStructure);
+
+    TIM_SelectOutputTrig(HALL_TIM, TIM_TRGO_SRC_OC2REF);
+    TIM_SelectMasterSlaveMode(HALL_TIM, TIM_MASTER_SLAVE_MODE_ENABLE);
+
+    /* capture on every edge, update on overflow only */
+    TIM_ConfigUpdateRequestIntSrc(HALL_TIM, TIM_UPDATE_SRC_REGULAr);
+    TIM_ClrIntPendingBit(HALL_TIM, TIM_INT_CC1 | TIM_INT_UPDATE);
+    TIM_ConfigInt(HALL_TIM, TIM_INT_CC1 | TIM_INT_UPDATE, ENABLE);
+
+    TIM_Enable(HALL_TIM, ENABLE);
+}
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init the hall sensor interface
+ * 
+ * @param[in] cap_cb: the capture / overflow interrupt callback
+ * @return None
+ */
+void bsp_hall_init(void (*cap_cb)(void))
+{
+    NVIC_InitType NVIC_InitStructure;
+
+    if(cap_cb == NULL)
+    {
+        while(1);
+    }
+
+    hall_irq_cb.cap_cb = cap_cb;
+
+    bsp_hall_rcc_config();
+    bsp_hall_io_config();
+    bsp_hall_tim_config();
+
+    NVIC_InitStructure.NVIC_IRQChannel                   = HALL_TIM_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,92 @@
+/**
+ * @file bsp_hall.h
+ * @brief Driver bsp_hall Header
+ * 
+ * @details
+ * Hall sensor interface on TIM4 (CH1/CH2/CH3 XOR'ed on TI1). Every hall edge resets
+ * the timer and, after the commutation delay, pulses TRGO which fires the TIM1 COM event.
+ * The edge also captures the interval before it (CC1 interrupt), the overflow
+ * interrupt means no edge for a whole timer period.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+#ifndef __BSP_HALL_H__
+#define __BSP_HALL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+
+/* ============================ Public Constants ============================ */
+
+/* **************************** hall timer macro **************************** */
+#define HALL_TIM                        TIM4
+#define HALL_TIM_CLK                    RCC_APB1_PERIPH_TIM4
+#define HALL_TIM_PRESCALER              (54 - 1)  // 54MHz timer clock -> 1MHz hall tick
+#define HALL_TIM_FREQ_HZ                (1000000)
+#define HALL_COM_DELAY                  (1)       // hall edge to COM delay in hall ticks
+#define HALL_TIM_IRQn                   TIM4_IRQn
+
+#define HALL_A_GPIO                     GPIOB
+#define HALL_A_PIN                      GPIO_PIN_6
+#define HALL_B_GPIO                     GPIOB
+#define HALL_B_PIN                      GPIO_PIN_7
+#define HALL_C_GPIO                     GPIOB
+#define HALL_C_PIN                      GPIO_PIN_8
+#define HALL_GPIO_AF                    GPIO_AF2_TIM4
+#define HALL_GPIO_CLK                   RCC_APB2_PERIPH_GPIOB
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    void (*cap_cb)(void);
+}hall_irq_cb_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern hall_irq_cb_t hall_irq_cb;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* hall state C:B:A in bit2:bit0, the three pins are adjacent so it is a single load */
+#define HALL_STATE_READ()       ((uint8_t)((HALL_A_GPIO->PID >> 6) & 0x07))
+
+/* interval before the last edge, reading it clears the capture flag: only the capture interrupt reads it */
+#define HALL_CAPTURE_READ()     (HALL_TIM->CCDAT1)
+/* hall ticks since the last edge */
+#define HALL_CNT()              (HALL_TIM->CNT)
+
+/* ============================ Function Declarations ============================ */
+
+void bsp_hall_init(void (*cap_cb)(void));
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__BSP_HALL_H__*/
+
+
+/**
+  * @}
+  */
@@ -0,0 +1,69 @@
+/**
+ * @file bsp_hall_cb.c
+ * @brief Hall timer interrupt callback
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_hall.h"
+#include "bsp_hall_cb.h"
+#include "motor_hall_speed.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief hall timer: overflow (no edge for a timer period), then the edge capture
+ * 
+ * The overflow goes first: an edge right after it captured the time from the
+ * overflow, which the speed measurement only takes as a new reference.
+ * 
+ * @param[in] None
+ * @return None
+ */
+void bsp_hall_irq_cb(void)
+{
+    if (TIM_GetIntStatus(HALL_TIM, TIM_INT_UPDATE) != RESET)
+    {
+        TIM_ClrIntPendingBit(HALL_TIM, TIM_INT_UPDATE);
+        motor_hall_speed_timeout_isr();
+    }
+    if (TIM_GetIntStatus(HALL_TIM, TIM_INT_CC1) != RESET)
+    {
+        TIM_ClrIntPendingBit(HALL_TIM, TIM_INT_CC1);
+        motor_hall_speed_edge_isr(HALL_STATE_READ(), HALL_CAPTURE_READ());
+    }
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -57,7 +57,7 @@
 
 
 /**
- * @brief init the gpioc pin5
+ * @brief init the gpioc pin5 and the brake chopper output, chopper off
  * 
  * @param[in] None
  * @return None
@@ -76,6 +76,10 @@ void bsp_io_init(void)
 	GPIO_InitStructure.Pin            = GPIO_PIN_5;
 
 	GPIO_InitPeripheral(GPIOC, &GPIO_InitStructure);
+
+	BRAKE_CHOP_OFF();
+	GPIO_InitStructure.Pin            = BRAKE_CHOP_PIN;
+	GPIO_InitPeripheral(BRAKE_CHOP_GPIO, &GPIO_InitStructure);
 }
 
 
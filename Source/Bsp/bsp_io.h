@@ -53,6 +53,10 @@ extern "C" {
 
 /* ============================ Public Constants ============================ */
 
+/* brake chopper gate driver input, high = resistor across the dc bus */
+#define BRAKE_CHOP_GPIO                 GPIOC
+#define BRAKE_CHOP_PIN                  GPIO_PIN_4
+
 /* ============================ Error Code Enum Definitions ============================ */
 
 /* ============================ Data Structure Definitions ============================ */
@@ -66,6 +70,9 @@ extern "C" {
 #define ADC_TEST_IO_HIGH()	GPIO_SetBits(GPIOC, GPIO_PIN_5)
 #define ADC_TEST_IO_LOW()	GPIO_ResetBits(GPIOC, GPIO_PIN_5)
 
+#define BRAKE_CHOP_ON()		GPIO_SetBits(BRAKE_CHOP_GPIO, BRAKE_CHOP_PIN)
+#define BRAKE_CHOP_OFF()	GPIO_ResetBits(BRAKE_CHOP_GPIO, BRAKE_CHOP_PIN)
+
 /* ============================ Function Declarations ============================ */
 
 void bsp_io_init(void);
@@ -48,7 +48,7 @@
 
 /* ============================ Global Variables ============================ */
 
-pwm_irq_cb_t pwm_irq_cb = {NULL};
+pwm_irq_cb_t pwm_irq_cb = {NULL, NULL, NULL};
 
 /* ============================ Static Global Variables ============================ */
 
@@ -63,7 +63,9 @@ pwm_irq_cb_t pwm_irq_cb = {NULL};
 static void bsp_pwm_rcc_config(void)
 {
     /*Enable TIM1 clock*/
-    RCC_EnableAPB2PeriphClk(RCC_APB2_PERIPH_TIM1, ENABLE);
+    RCC_EnableAPB2PeriphClk(PWM_TIM_CLK, ENABLE);
+    /*Enable pwm io clock*/
+    RCC_EnableAPB2PeriphClk(PWM_GPIO_CLK | RCC_APB2_PERIPH_AFIO, ENABLE);
 }
 
 
@@ -75,6 +77,31 @@ static void bsp_pwm_rcc_config(void)
  */
 static void bsp_pwm_io_config(void)
 {
+    GPIO_InitType GPIO_InitStructure;
+
+    GPIO_InitStruct(&GPIO_InitStructure);
+    GPIO_InitStructure.GPIO_Current   = GPIO_DC_4mA;
+    GPIO_InitStructure.GPIO_Mode      = GPIO_Mode_AF_PP;
+    GPIO_InitStructure.GPIO_Pull      = GPIO_No_Pull;
+    GPIO_InitStructure.GPIO_Slew_Rate = GPIO_Slew_Rate_High;
+
+    /*high side: TIM1_CH1 / CH2 / CH3*/
+    GPIO_InitStructure.GPIO_Alternate = PWM_H_GPIO_AF;
+    GPIO_InitStructure.Pin            = PWM_UH_PIN;
+    GPIO_InitPeripheral(PWM_UH_GPIO, &GPIO_InitStructure);
+    GPIO_InitStructure.Pin            = PWM_VH_PIN;
+    GPIO_InitPeripheral(PWM_VH_GPIO, &GPIO_InitStructure);
+    GPIO_InitStructure.Pin            = PWM_WH_PIN;
+    GPIO_InitPeripheral(PWM_WH_GPIO, &GPIO_InitStructure);
+
+    /*low side: TIM1_CH1N / CH2N / CH3N*/
+    GPIO_InitStructure.GPIO_Alternate = PWM_L_GPIO_AF;
+    GPIO_InitStructure.Pin            = PWM_UL_PIN;
+    GPIO_InitPeripheral(PWM_UL_GPIO, &GPIO_InitStructure);
+    GPIO_InitStructure.Pin            = PWM_VL_PIN;
+    GPIO_InitPeripheral(PWM_VL_GPIO, &GPIO_InitStructure);
+    GPIO_InitStructure.Pin            = PWM_WL_PIN;
+    GPIO_InitPeripheral(PWM_WL_GPIO, &GPIO_InitStructure);
 }
 
 
@@ -89,55 +116,257 @@ static void bsp_pwm_io_config(void)
 void bsp_pwm_config(void)
 {
   TIM_TimeBaseInitType TIM1_TimeBaseStructure;
+  OCInitType TIM1_OCInitStructure;
+  TIM_BDTRInitType TIM1_BDTRInitStructure;
   NVIC_InitType NVIC_InitStructure;
 
   /* Time Base Configuration */
 //	TIM_DeInit(TIM1);
 	TIM_InitTimBaseStruct(&TIM1_TimeBaseStructure);
-	TIM1_TimeBaseStructure.Prescaler = 108 - 1;				  //预分频值：对定时器时钟做分频   1MHZ
-	TIM1_TimeBaseStructure.CntMode   = TIM_CNT_MODE_UP;	//计数器计数模式：向上计数
-	TIM1_TimeBaseStructure.Period    = 1000 - 1;				//周期值：这个值写入到自动重装载寄存器
+	TIM1_TimeBaseStructure.Prescaler = 0;				          //预分频值：不分频 108MHZ
+	TIM1_TimeBaseStructure.CntMode   = TIM_CNT_MODE_CENTER_ALIGN1;	//计数器计数模式：中心对齐
+	TIM1_TimeBaseStructure.Period    = PWM_PERIOD_MAX;			//周期值：20KHZ
 	TIM1_TimeBaseStructure.ClkDiv    = TIM_CLK_DIV1;	  //时钟分频：这里1分频也就是不做分频
-	TIM1_TimeBaseStructure.RepetCnt  = 0;					      //重复计数器：将重复计数器值设置为0
+	TIM1_TimeBaseStructure.RepetCnt  = PWM_REPET_CNT;			      //重复计数器：每个PWM周期只产生一次更新
 	
-	TIM_InitTimeBase(TIM1, &TIM1_TimeBaseStructure);
+	TIM_InitTimeBase(PWM_TIM, &TIM1_TimeBaseStructure);
+
+    /* Channel 1, 2 and 3 Configuration in PWM mode */
+    TIM_InitOcStruct(&TIM1_OCInitStructure);
+    TIM1_OCInitStructure.OcMode       = TIM_OCMODE_PWM1;
+    TIM1_OCInitStructure.OutputState  = TIM_OUTPUT_STATE_ENABLE;
+    TIM1_OCInitStructure.OutputNState = TIM_OUTPUT_NSTATE_ENABLE;
+    TIM1_OCInitStructure.Pulse        = 0;
+    TIM1_OCInitStructure.OcPolarity   = TIM_OC_POLARITY_HIGH;
+    TIM1_OCInitStructure.OcNPolarity  = TIM_OCN_POLARITY_HIGH;
+    TIM1_OCInitStructure.OcIdleState  = TIM_OC_IDLE_STATE_RESET;
+    TIM1_OCInitStructure.OcNIdleState = TIM_OCN_IDLE_STATE_RESET;
+    TIM_InitOc1(PWM_TIM, &TIM1_OCInitStructure);
+    TIM_InitOc2(PWM_TIM, &TIM1_OCInitStructure);
+    TIM_InitOc3(PWM_TIM, &TIM1_OCInitStructure);
+
+    TIM_ConfigOc1Preload(PWM_TIM, TIM_OC_PRE_LOAD_ENABLE);
+    TIM_ConfigOc2Preload(PWM_TIM, TIM_OC_PRE_LOAD_ENABLE);
+    TIM_ConfigOc3Preload(PWM_TIM, TIM_OC_PRE_LOAD_ENABLE);
+
+    /* Channel 4 PWM2 without output: OC4REF is the shunt current adc trigger */
+    TIM1_OCInitStructure.OcMode       = TIM_OCMODE_PWM2;
+    TIM1_OCInitStructure.OutputState  = TIM_OUTPUT_STATE_DISABLE;
+    TIM1_OCInitStructure.OutputNState = TIM_OUTPUT_NSTATE_DISABLE;
+    TIM1_OCInitStructure.Pulse        = PWM_PERIOD_MAX - PWM_ADC_TRIG_ADVANCE;
+    TIM_InitOc4(PWM_TIM, &TIM1_OCInitStructure);
+    TIM_ConfigOc4Preload(PWM_TIM, TIM_OC_PRE_LOAD_ENABLE);
+
+    /* Channel 5 PWM2: OC5REF is active while CNT >= CCDAT5, the comparator only
+       looks at the middle of the high side on-time, away from the switching edges */
+    TIM1_OCInitStructure.OutputState  = TIM_OUTPUT_STATE_ENABLE;
+    TIM1_OCInitStructure.Pulse        = 0;
+    TIM_InitOc5(PWM_TIM, &TIM1_OCInitStructure);
+    TIM_ConfigOc5Preload(PWM_TIM, TIM_OC_PRE_LOAD_ENABLE);
+    TIM_ConfigArPreload(PWM_TIM, ENABLE);
+
+    /* Dead time and off state configuration, the outputs stay off until bsp_pwm_output_enable() */
+    TIM_InitBkdtStruct(&TIM1_BDTRInitStructure);
+    TIM1_BDTRInitStructure.OssrState       = TIM_OSSR_STATE_ENABLE;
+    TIM1_BDTRInitStructure.OssiState       = TIM_OSSI_STATE_ENABLE;
+    TIM1_BDTRInitStructure.LockLevel       = TIM_LOCK_LEVEL_OFF;
+    TIM1_BDTRInitStructure.DeadTime        = PWM_DEADTIME;
+    TIM1_BDTRInitStructure.Break           = TIM_BREAK_IN_DISABLE;
+    TIM1_BDTRInitStructure.BreakPolarity   = TIM_BREAK_POLARITY_LOW;
+    TIM1_BDTRInitStructure.AutomaticOutput = TIM_AUTO_OUTPUT_DISABLE;
+    TIM_ConfigBkdt(PWM_TIM, &TIM1_BDTRInitStructure);
+
+    /* CCxE/CCxNE/OCxM are preloaded and only take effect on the COM event,
+       which is fired by the hall timer TRGO (or by software through PWM_COM_GENERATE) */
+    TIM_EnableCapCmpPreloadControl(PWM_TIM, ENABLE);
+    TIM_SelectInputTrig(PWM_TIM, PWM_COM_TRIG_HALL);
+    TIM_SelectComEvt(PWM_TIM, ENABLE);
+
+    /* TRGO on update (counter underflow) starts the ADC injected group */
+    TIM_SelectOutputTrig(PWM_TIM, PWM_ADC_TRIG_HIGH_SIDE);
+
 //	/* Prescaler configuration */
 //    TIM_ConfigPrescaler(TIM1, 65535 - 1, TIM_PSC_RELOAD_MODE_UPDATE);
 	/*IT about*/
-    TIM_ConfigInt(TIM1, TIM_INT_UPDATE, ENABLE);
+    TIM_ConfigInt(PWM_TIM, TIM_INT_UPDATE | TIM_INT_COM, ENABLE);
 	
-	/*Enable the TIM1 BRK Interrupt */
+	/*Enable the TIM1 UP Interrupt */
     NVIC_InitStructure.NVIC_IRQChannel                   = TIM1_UP_IRQn;
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 16;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+
+	/*Enable the TIM1 COM Interrupt, it must preempt the update interrupt */
+    NVIC_InitStructure.NVIC_IRQChannel                   = TIM1_TRG_COM_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+
+	/*Enable the TIM1 CC Interrupt (single shunt trigger steps), it must preempt the adc interrupt */
+    NVIC_InitStructure.NVIC_IRQChannel                   = TIM1_CC_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
     NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
     NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
     NVIC_Init(&NVIC_InitStructure);
 	
 	/* TIM1 counter enable */
-	TIM_Enable(TIM1, ENABLE);
+	TIM_Enable(PWM_TIM, ENABLE);
 }
 
 
 /**
  * @brief pwm config TIM1
  * 
- * @param[in] num: the led index
+ * @param[in] irq_cb: the update (once per pwm period, twice in single shunt mode) interrupt callback
+ * @param[in] com_cb: the commutation interrupt callback
+ * @param[in] cc_cb: the capture compare interrupt callback (single shunt adc trigger)
  * @return None
  */
-void bsp_pwm_init(void(*irq_cb)(void))
+void bsp_pwm_init(void(*irq_cb)(void), void(*com_cb)(void), void(*cc_cb)(void))
 {
-  if(irq_cb == NULL)
+  if((irq_cb == NULL) || (com_cb == NULL) || (cc_cb == NULL))
   {
     while(1);
   }
 
   pwm_irq_cb.pwm_cb = irq_cb;
+  pwm_irq_cb.com_cb = com_cb;
+  pwm_irq_cb.cc_cb  = cc_cb;
   bsp_pwm_rcc_config();
   bsp_pwm_io_config();
   bsp_pwm_config();
 }
 
 
+/**
+ * @brief enable or disable the TIM1 main output (MOE)
+ * 
+ * @param[in] cmd: ENABLE or DISABLE
+ * @return None
+ */
+void bsp_pwm_output_enable(FunctionalState cmd)
+{
+  TIM_EnableCtrlPwmOutputs(PWM_TIM, cmd);
+}
+
+
+/**
+ * @brief select which timer fires the TIM1 commutation event
+ * 
+ * @param[in] trig: PWM_COM_TRIG_HALL or PWM_COM_TRIG_TIMER
+ * @return None
+ */
+void bsp_pwm_com_trig_select(uint16_t trig)
+{
+  TIM_SelectInputTrig(PWM_TIM, trig);
+}
+
+
+/**
+ * @brief all three phases chopping complementary (sinusoidal / FOC), applied by a software COM
+ * 
+ * @param[in] None
+ * @return None
+ */
+void bsp_pwm_complementary_mode(void)
+{
+  PWM_TIM->CCMOD1 = (TIM_OCMODE_PWM1 | TIM_OC_PRE_LOAD_ENABLE) | ((TIM_OCMODE_PWM1 | TIM_OC_PRE_LOAD_ENABLE) << 8);
+  PWM_TIM->CCMOD2 = (TIM_OCMODE_PWM1 | TIM_OC_PRE_LOAD_ENABLE) | PWM_CCMOD2_CH4_CFG;
+  PWM_TIM->CCEN   = TIM_CCEN_CC1EN | TIM_CCEN_CC1NEN | TIM_CCEN_CC2EN | TIM_CCEN_CC2NEN
+                  | TIM_CCEN_CC3EN | TIM_CCEN_CC3NEN | PWM_CCEN_CH4_CFG | PWM_CCEN_CH5_CFG;
+  PWM_COM_GENERATE();
+}
+
+
+/**
+ * @brief select the TIM1 TRGO source that starts the adc injected group
+ * 
+ * @param[in] src: PWM_ADC_TRIG_HIGH_SIDE or PWM_ADC_TRIG_LOW_SIDE
+ * @return None
+ */
+void bsp_pwm_adc_trig_select(uint16_t src)
+{
+  TIM_SelectOutputTrig(PWM_TIM, src);
+}
+
+
+/**
+ * @brief dead time as programmed in the break / dead time register, in counter ticks
+ * 
+ * @details
+ * Decodes DTG[7:0] (steps of tDTS = 2^CKD timer clocks):
+ *   0xxxxxxx: DTG[6:0]             tDTS
+ *   10xxxxxx: (64 + DTG[5:0]) * 2  tDTS
+ *   110xxxxx: (32 + DTG[4:0]) * 8  tDTS
+ *   111xxxxx: (32 + DTG[4:0]) * 16 tDTS
+ * Read back from the register so a compensation can never disagree with the
+ * configuration.
+ * 
+ * @param[in] None
+ * @return dead time, TIM1 counter ticks
+ */
+uint16_t bsp_pwm_deadtime_get(void)
+{
+  uint32_t dtg = PWM_TIM->BKDT & TIM_BKDT_DTGN;
+  uint32_t dts;
+
+  if((dtg & 0x80) == 0)
+  {
+    dts = dtg;
+  }
+  else if((dtg & 0x40) == 0)
+  {
+    dts = (64 + (dtg & 0x3F)) * 2;
+  }
+  else if((dtg & 0x20) == 0)
+  {
+    dts = (32 + (dtg & 0x1F)) * 8;
+  }
+  else
+  {
+    dts = (32 + (dtg & 0x1F)) * 16;
+  }
+  dts <<= (PWM_TIM->CTRL1 & TIM_CTRL1_CLKD) >> 8;
+
+  return (uint16_t)(dts / (PWM_TIM->PSC + 1U));
+}
+
+
+
+/**
+ * @brief single shunt timing on / off, after bsp_pwm_complementary_mode() (which preloads CCDAT4 again)
+ * 
+ * @details
+ * On: an update at the counter peak too, so the counting up and the counting
+ * down half can have their own compare values (loaded from the preload at
+ * each update), CCDAT4 written directly and its CC event (counting down only
+ * in center aligned mode 1) with an interrupt, so the trigger can be moved
+ * between two conversions. Off: the two shunt / six-step timing.
+ * The repetition count takes effect from the next update.
+ * 
+ * @param[in] cmd: ENABLE or DISABLE
+ * @return None
+ */
+void bsp_pwm_single_shunt_mode(FunctionalState cmd)
+{
+  if(cmd != DISABLE)
+  {
+    PWM_TIM->REPCNT = PWM_REPET_CNT_SINGLE_SHUNT;
+    TIM_ConfigOc4Preload(PWM_TIM, TIM_OC_PRE_LOAD_DISABLE);
+    TIM_ClrIntPendingBit(PWM_TIM, TIM_INT_CC4);
+    TIM_ConfigInt(PWM_TIM, TIM_INT_CC4, ENABLE);
+  }
+  else
+  {
+    TIM_ConfigInt(PWM_TIM, TIM_INT_CC4, DISABLE);
+    TIM_ConfigOc4Preload(PWM_TIM, TIM_OC_PRE_LOAD_ENABLE);
+    PWM_ADC_TRIG_SET(PWM_PERIOD_MAX - PWM_ADC_TRIG_ADVANCE);
+    PWM_TIM->REPCNT = PWM_REPET_CNT;
+  }
+}
+
 /* ============================ Static Function Implementations ============================ */
 
 /* ============================ Unit Test Support ============================ */
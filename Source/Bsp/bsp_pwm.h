@@ -54,6 +54,52 @@ extern "C" {
 /* ============================ Public Constants ============================ */
 
 #define PWM_PERIOD_MAX    (2700)  // the pwm period max value
+#define PWM_FREQ_HZ       (20000) // center aligned, 108MHz / (2 * PWM_PERIOD_MAX)
+#define PWM_DEADTIME      (108)   // dead time in TIM1 clock ticks, 1us @108MHz
+
+/* **************************** pwm io macro **************************** */
+#define PWM_TIM                         TIM1
+#define PWM_TIM_CLK                     RCC_APB2_PERIPH_TIM1
+
+#define PWM_UH_GPIO                     GPIOA
+#define PWM_UH_PIN                      GPIO_PIN_8
+#define PWM_VH_GPIO                     GPIOA
+#define PWM_VH_PIN                      GPIO_PIN_9
+#define PWM_WH_GPIO                     GPIOA
+#define PWM_WH_PIN                      GPIO_PIN_10
+#define PWM_H_GPIO_AF                   GPIO_AF2_TIM1
+
+#define PWM_UL_GPIO                     GPIOB
+#define PWM_UL_PIN                      GPIO_PIN_13
+#define PWM_VL_GPIO                     GPIOB
+#define PWM_VL_PIN                      GPIO_PIN_14
+#define PWM_WL_GPIO                     GPIOB
+#define PWM_WL_PIN                      GPIO_PIN_15
+#define PWM_L_GPIO_AF                   GPIO_AF2_TIM1
+
+#define PWM_GPIO_CLK                    (RCC_APB2_PERIPH_GPIOA | RCC_APB2_PERIPH_GPIOB)
+
+/* TIM1 commutation event sources: hall timer TRGO (TIM4) or commutation delay timer TRGO (TIM2) */
+#define PWM_COM_TRIG_HALL               TIM_TRIG_SEL_IN_TR3
+#define PWM_COM_TRIG_TIMER              TIM_TRIG_SEL_IN_TR1
+
+/* channel 4 settings that every CCMOD2/CCEN write has to keep: PWM2 without pin, OC4REF
+   rises PWM_ADC_TRIG_ADVANCE ticks before the counter peak (middle of the low side on-time) */
+#define PWM_CCMOD2_CH4_CFG              ((TIM_OCMODE_PWM2 | TIM_OC_PRE_LOAD_ENABLE) << 8)
+#define PWM_CCEN_CH4_CFG                (0x00000000)
+#define PWM_ADC_TRIG_ADVANCE            (54)      // 0.5us, about half the injected conversion time
+
+/* TIM1 TRGO (ADC injected trigger): high side on-time centre (bemf) or low side on-time centre (shunt currents) */
+#define PWM_ADC_TRIG_HIGH_SIDE          TIM_TRGO_SRC_UPDATE
+#define PWM_ADC_TRIG_LOW_SIDE           TIM_TRGO_SRC_OC4REF
+
+/* channel 5 has no pin, OC5REF is the comparator blanking window (active = blanked) */
+#define PWM_CCEN_CH5_CFG                (TIM_CCEN_CC5EN)
+
+/* single shunt: update at the peak and the valley (repetition 0) for the asymmetric compares,
+   the CC4 event (counting down only, center aligned mode 1) triggers the adc, CCDAT4 unbuffered */
+#define PWM_REPET_CNT                   (1)
+#define PWM_REPET_CNT_SINGLE_SHUNT      (0)
 
 /* ============================ Code Enum Definitions ============================ */
 
@@ -62,6 +108,8 @@ extern "C" {
 typedef struct 
 {
     void (*pwm_cb)(void);
+    void (*com_cb)(void);
+    void (*cc_cb)(void);
 }pwm_irq_cb_t;
 
 
@@ -73,9 +121,22 @@ extern pwm_irq_cb_t pwm_irq_cb;
 
 /* ============================ Macro Function Declarations ============================ */
 
+#define PWM_DUTY_SET(u, v, w)     do { PWM_TIM->CCDAT1 = (u); PWM_TIM->CCDAT2 = (v); PWM_TIM->CCDAT3 = (w); } while(0)
+#define PWM_COM_GENERATE()        (PWM_TIM->EVTGEN = TIM_EVTGEN_CCUDGN)
+#define PWM_BLANK_SET(cmp)        (PWM_TIM->CCDAT5 = (cmp))
+#define PWM_ADC_TRIG_SET(cmp)     (PWM_TIM->CCDAT4 = (cmp))
+#define PWM_COUNTING_DOWN()       ((PWM_TIM->CTRL1 & TIM_CTRL1_DIR) != 0)
+#define PWM_OUTPUT_ENABLED()      ((PWM_TIM->BKDT & TIM_BKDT_MOEN) != 0)
+
 /* ============================ Function Declarations ============================ */
 
-void bsp_pwm_init(void (*irq_cb)(void));
+void bsp_pwm_init(void (*irq_cb)(void), void (*com_cb)(void), void (*cc_cb)(void));
+void bsp_pwm_output_enable(FunctionalState cmd);
+void bsp_pwm_complementary_mode(void);
+void bsp_pwm_adc_trig_select(uint16_t src);
+void bsp_pwm_com_trig_select(uint16_t trig);
+uint16_t bsp_pwm_deadtime_get(void);
+void bsp_pwm_single_shunt_mode(FunctionalState cmd);
 
 
 #ifdef __cplusplus
@@ -41,6 +41,7 @@
 
 #include "bsp_io.h"
 #include "bsp_pwm_cb.h"
+#include "motor_ctrl.h"
 
 /* ============================ Module Internal Constants ============================ */
 
@@ -57,7 +58,7 @@ static uint32_t timecnt;
 /* ============================ Public Function Implementations ============================ */
 
 /**
- * @brief pwm interrupt callback function
+ * @brief pwm interrupt callback function, the update at the peak only comes in single shunt mode
  * 
  * @param[in] None
  * @return None
@@ -67,6 +68,11 @@ void bsp_pwm_irq_cb(void)
 	if (TIM_GetIntStatus(TIM1, TIM_INT_UPDATE) != RESET)
     {
         TIM_ClrIntPendingBit(TIM1, TIM_INT_UPDATE);
+		if(PWM_COUNTING_DOWN())
+		{
+			motor_ctrl_pwm_peak_isr();
+			return;
+		}
 		timecnt++;
 		
 		if((timecnt % 2) == 0)
@@ -77,6 +83,40 @@ void bsp_pwm_irq_cb(void)
 		{
 			ADC_TEST_IO_LOW();
 		}
+
+		motor_ctrl_pwm_isr();
+	}
+}
+
+
+/**
+ * @brief pwm commutation interrupt callback function
+ * 
+ * @param[in] None
+ * @return None
+ */
+void bsp_pwm_com_irq_cb(void)
+{
+	if (TIM_GetIntStatus(TIM1, TIM_INT_COM) != RESET)
+    {
+        TIM_ClrIntPendingBit(TIM1, TIM_INT_COM);
+		motor_ctrl_com_isr();
+	}
+}
+
+
+/**
+ * @brief pwm capture compare interrupt callback function, channel 4: single shunt adc trigger
+ * 
+ * @param[in] None
+ * @return None
+ */
+void bsp_pwm_cc_irq_cb(void)
+{
+	if (TIM_GetIntStatus(TIM1, TIM_INT_CC4) != RESET)
+    {
+        TIM_ClrIntPendingBit(TIM1, TIM_INT_CC4);
+		motor_ctrl_cc_isr();
 	}
 }
 
@@ -68,6 +68,8 @@ extern "C" {
 /* ============================ Function Declarations ============================ */
 
 void bsp_pwm_irq_cb(void);
+void bsp_pwm_com_irq_cb(void);
+void bsp_pwm_cc_irq_cb(void);
 
 
 #ifdef __cplusplus
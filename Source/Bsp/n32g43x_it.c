@@ -35,6 +35,10 @@
 #include "n32g43x_it.h"
 #include "bsp_uart.h"
 #include "bsp_pwm.h"
+#include "bsp_adc.h"
+#include "bsp_comp.h"
+#include "bsp_com_tim.h"
+#include "bsp_hall.h"
 
 
 /** @addtogroup N32G43X_StdPeriph_Template
@@ -173,7 +177,7 @@ void UART5_IRQHandler(void)
  */
 void ADC_IRQHandler(void)
 {
-	
+	adc_irq_cb.adc_cb();
 }
 uint32_t BRK_CNT = 0;
 /**
@@ -189,7 +193,47 @@ void TIM1_BRK_IRQHandler(void)
  */
 void TIM1_UP_IRQHandler(void)
 {
-//	pwm_irq_cb.pwm_cb();
+	pwm_irq_cb.pwm_cb();
+}
+
+/**
+ * @brief  This function handles tim1 trigger and commutation interrupt request.
+ */
+void TIM1_TRG_COM_IRQHandler(void)
+{
+	pwm_irq_cb.com_cb();
+}
+
+/**
+ * @brief  This function handles tim1 capture compare interrupt request.
+ */
+void TIM1_CC_IRQHandler(void)
+{
+	pwm_irq_cb.cc_cb();
+}
+
+/**
+ * @brief  TIM2 interrupt.
+ */
+void TIM2_IRQHandler(void)
+{
+	com_tim_irq_cb.cc_cb();
+}
+
+/**
+ * @brief  TIM4 (hall timer) interrupt.
+ */
+void TIM4_IRQHandler(void)
+{
+	hall_irq_cb.cap_cb();
+}
+
+/**
+ * @brief  COMP1 & COMP2 interrupt (EXTI line 21/22).
+ */
+void COMP_1_2_IRQHandler(void)
+{
+	comp_irq_cb.comp_cb();
 }
 
 /**
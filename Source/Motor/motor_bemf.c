@@ -0,0 +1,589 @@
+/**
+ * @file motor_bemf.c
+ * @brief Sensorless six-step by BEMF zero cross detection
+ * 
+ * @details
+ * Sequence: align -> forced commutation ramp -> closed loop once the zero crosses
+ * are seen on BEMF_LOCK_STEPS consecutive sectors.
+ * 
+ * Per pwm period (ADC injected end of conversion) the floating phase voltage is
+ * compared with Vbus / 2. On a zero cross the crossing instant is interpolated
+ * between the last two samples and TIM2 is started with the remaining time to the
+ * 30 degree point; its TRGO fires the TIM1 COM event in hardware. At 60k eRPM a
+ * sector lasts 166us (3.3 pwm periods) and the commutation instant keeps the 1us
+ * resolution of the timer instead of the 50us pwm grid.
+ * 
+ * With the comparator detector the closed loop runs without the per period adc
+ * interrupt: TIM2 counts from each commutation, its CC1 ends the demagnetization
+ * blanking, the comparator edge moves its reload to the 30 degree point and a
+ * missing edge lets it expire at 60 degree (blind commutation).
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_adc.h"
+#include "bsp_com_tim.h"
+#include "bsp_comp.h"
+#include "motor_bemf.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+bemf_t bemf;
+
+/* ============================ Static Global Variables ============================ */
+
+/* floating phase of every sector, same sector order as motor_six_step_sector_preload() */
+static const uint8_t bemf_float_ch[MOTOR_DIR_MAX][SIX_STEP_SECTORS] =
+{
+    {ADC_BEMF_W_CH, ADC_BEMF_V_CH, ADC_BEMF_U_CH, ADC_BEMF_W_CH, ADC_BEMF_V_CH, ADC_BEMF_U_CH},
+    {ADC_BEMF_W_CH, ADC_BEMF_U_CH, ADC_BEMF_V_CH, ADC_BEMF_W_CH, ADC_BEMF_U_CH, ADC_BEMF_V_CH},
+};
+
+/* the floating phase falls through the neutral in the even sectors and rises in the odd ones */
+static const COMP_CTRL_INPSEL bemf_comp_inp[MOTOR_DIR_MAX][SIX_STEP_SECTORS] =
+{
+    {BEMF_COMP_W_INP, BEMF_COMP_V_INP, BEMF_COMP_U_INP, BEMF_COMP_W_INP, BEMF_COMP_V_INP, BEMF_COMP_U_INP},
+    {BEMF_COMP_W_INP, BEMF_COMP_U_INP, BEMF_COMP_V_INP, BEMF_COMP_W_INP, BEMF_COMP_U_INP, BEMF_COMP_V_INP},
+};
+
+static const int8_t bemf_slope[SIX_STEP_SECTORS] = {-1, 1, -1, 1, -1, 1};
+
+/* rank1 = floating phase (changed every sector), rank2 = Vbus */
+static const uint8_t bemf_adc_seq[2] = {ADC_BEMF_U_CH, ADC_VBUS_CH};
+
+static const uint8_t bemf_sector_next[SIX_STEP_SECTORS] = {1, 2, 3, 4, 5, 0};
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief stop on fault, the outputs are switched off
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_bemf_fault(void)
+{
+    bemf.state = BEMF_STATE_FAULT;
+    BEMF_COMP_IRQ_DISABLE();
+    COM_TIM_STOP();
+    ADC_INJ_IRQ_ENABLE();
+    motor_six_step_stop();
+}
+
+
+/**
+ * @brief comparator blanking compare: only the middle of the high side on-time is looked at,
+ *        and the mean latency the window adds to the zero cross
+ * 
+ * @param[in] duty: high side duty
+ * @return None
+ */
+static void motor_bemf_comp_window_set(uint16_t duty)
+{
+    PWM_BLANK_SET(BEMF_COMP_WINDOW(duty));
+    bemf.comp_latency_us = BEMF_COMP_LATENCY_US(duty) + BEMF_ISR_LATENCY_US;
+}
+
+
+/**
+ * @brief comparator closed loop, new sector: select the phase and arm the commutation timer
+ * 
+ * @param[in] sector: the sector just applied
+ * @return None
+ */
+static void motor_bemf_comp_sector_start(uint8_t sector)
+{
+    uint32_t blank;
+    uint32_t timeout;
+
+    BEMF_COMP_IRQ_DISABLE();
+
+    if(bemf.zc_found == 0)
+    {
+        /*TIM2 expired without an edge: the commutation was blind*/
+        bemf.lost_cnt++;
+        if(++bemf.lost_seq > BEMF_LOST_MAX)
+        {
+            motor_bemf_fault();
+            return;
+        }
+        bemf.com_delay_us = bemf.interval_us >> 1;
+    }
+    bemf.zc_found = 0;
+
+    bemf.out_duty = bemf.duty;
+    PWM_DUTY_SET(bemf.out_duty, bemf.out_duty, bemf.out_duty);
+    motor_bemf_comp_window_set(bemf.out_duty);
+    bsp_comp_input_set(bemf_comp_inp[bemf.dir][sector], (bemf_slope[sector] < 0) ? ENABLE : DISABLE);
+
+    blank   = bemf.interval_us >> 2;
+    blank   = (blank < BEMF_COMP_BLANK_MIN_US) ? BEMF_COMP_BLANK_MIN_US : blank;
+    timeout = (bemf.interval_us > 0xFFFF) ? 0xFFFF : bemf.interval_us;
+    timeout = (timeout <= blank) ? (blank + 1) : timeout;
+    COM_TIM_ARM(timeout, blank);
+}
+
+
+/**
+ * @brief leave the per period adc detection for the comparator
+ * 
+ * @param[in] delay_us: the commutation delay already scheduled on TIM2
+ * @return None
+ */
+static void motor_bemf_comp_handover(uint32_t delay_us)
+{
+    bemf.interval_us      = (bemf.interval_q8 * BEMF_PWM_PERIOD_US) >> 8;
+    bemf.prev_interval_us = bemf.interval_us;
+    bemf.com_delay_us     = delay_us + BEMF_ISR_LATENCY_US;
+    ADC_INJ_IRQ_DISABLE();
+}
+
+
+/**
+ * @brief zero cross found, schedule the commutation 30 degree later
+ * 
+ * @param[in] zc_q8: zero cross time in 1/256 pwm period
+ * @return None
+ */
+static void motor_bemf_zc_handle(uint32_t zc_q8)
+{
+    uint32_t interval = zc_q8 - bemf.last_zc_q8;
+    int32_t delay_q8;
+    int32_t delay_us;
+
+    /*the rising and falling crossings are offset by the neutral error, the mean of two cancels it*/
+    bemf.interval_q8      = (interval + bemf.prev_interval_q8) >> 1;
+    bemf.prev_interval_q8 = interval;
+    bemf.last_zc_q8       = zc_q8;
+    bemf.zc_found         = 1;
+    bemf.lost_seq         = 0;
+    bemf.zc_cnt++;
+
+    if(bemf.state == BEMF_STATE_RAMP)
+    {
+        if(++bemf.lock_cnt < BEMF_LOCK_STEPS)
+        {
+            return;
+        }
+        bemf.state = BEMF_STATE_RUN;
+    }
+
+    delay_q8 = (int32_t)(bemf.interval_q8 >> 1) - (int32_t)((bemf.tick << 8) - zc_q8);
+    delay_us = ((delay_q8 * BEMF_PWM_PERIOD_US) >> 8) - BEMF_ISR_LATENCY_US;
+    if(delay_us < 1)
+    {
+        delay_us = 1;
+    }
+    else if(delay_us > 0xFFFF)
+    {
+        delay_us = 0xFFFF;
+    }
+    COM_TIM_START((uint16_t)delay_us);
+
+    if(bemf.detector == BEMF_DET_COMP)
+    {
+        motor_bemf_comp_handover((uint32_t)delay_us);
+    }
+}
+
+
+/**
+ * @brief one bemf sample per pwm period
+ * 
+ * @param[in] bemf_raw: floating phase voltage, adc counts
+ * @param[in] vbus_raw: dc bus voltage, adc counts (same divider as the phases)
+ * @return None
+ */
+static void motor_bemf_sample_process(uint16_t bemf_raw, uint16_t vbus_raw)
+{
+    int32_t e = ((int32_t)bemf_raw - (int32_t)(vbus_raw >> 1)) * bemf_slope[bemf.sector];
+    uint32_t now_q8;
+    uint32_t frac;
+    uint32_t back;
+
+    bemf.tick++;
+    now_q8 = bemf.tick << 8;
+
+    switch(bemf.state)
+    {
+        case BEMF_STATE_ALIGN:
+            if((bemf.tick - bemf.com_tick) >= BEMF_ALIGN_PERIODS)
+            {
+                bemf.state        = BEMF_STATE_RAMP;
+                bemf.step_periods = BEMF_RAMP_START_PERIODS;
+                bemf.ramp_speed   = BEMF_RAMP_SPEED_ONE / BEMF_RAMP_START_PERIODS;
+                bemf.out_duty     = BEMF_RAMP_DUTY_START;
+                PWM_COM_GENERATE();
+            }
+            return;
+
+        case BEMF_STATE_RAMP:
+            if((bemf.tick - bemf.com_tick) >= bemf.step_periods)
+            {
+                if(bemf.zc_found == 0)
+                {
+                    bemf.lock_cnt = 0;
+                }
+                /*constant acceleration: the speed grows with the time of the step just ended*/
+                bemf.ramp_speed  += BEMF_RAMP_ACCEL * bemf.step_periods;
+                bemf.step_periods = (uint16_t)(BEMF_RAMP_SPEED_ONE / bemf.ramp_speed);
+                if(bemf.step_periods < BEMF_RAMP_END_PERIODS)
+                {
+                    bemf.step_periods = BEMF_RAMP_END_PERIODS;
+                }
+                bemf.out_duty += BEMF_RAMP_DUTY_STEP;
+                if(bemf.out_duty > BEMF_RAMP_DUTY_MAX)
+                {
+                    bemf.out_duty = BEMF_RAMP_DUTY_MAX;
+                }
+                PWM_DUTY_SET(bemf.out_duty, bemf.out_duty, bemf.out_duty);
+                PWM_COM_GENERATE();
+                return;
+            }
+            break;
+
+        case BEMF_STATE_RUN:
+            /*no zero cross 60 degree after the commutation: commutate blind*/
+            if((bemf.zc_found == 0) && ((now_q8 - (bemf.com_tick << 8)) > bemf.interval_q8))
+            {
+                bemf.lost_cnt++;
+                if(++bemf.lost_seq > BEMF_LOST_MAX)
+                {
+                    motor_bemf_fault();
+                    return;
+                }
+                bemf.last_zc_q8 = now_q8 - (bemf.interval_q8 >> 1);
+                PWM_COM_GENERATE();
+                return;
+            }
+            /*slew from the ramp duty, a torque step right after the handover outruns the interval estimate*/
+            if(bemf.out_duty < bemf.duty)
+            {
+                bemf.out_duty = ((bemf.duty - bemf.out_duty) > BEMF_RUN_DUTY_SLEW) ? (bemf.out_duty + BEMF_RUN_DUTY_SLEW) : bemf.duty;
+            }
+            else
+            {
+                bemf.out_duty = bemf.duty;
+            }
+            PWM_DUTY_SET(bemf.out_duty, bemf.out_duty, bemf.out_duty);
+            break;
+
+        default:
+            return;
+    }
+
+    if(bemf.blank != 0)
+    {
+        bemf.blank--;
+        return;
+    }
+
+    if(bemf.zc_found != 0)
+    {
+        return;
+    }
+
+    /*the freewheeling diode still holds the floating phase on a rail: demagnetization outlasting the blanking*/
+    if((bemf_raw <= BEMF_DEMAG_RAIL_LSB) || ((uint32_t)bemf_raw + BEMF_DEMAG_RAIL_LSB >= vbus_raw))
+    {
+        return;
+    }
+
+    /*arm on the pre crossing side first, a positive sample right after blanking is demagnetization,
+      and only clear of the noise: a stalled rotor leaves the floating phase on Vbus / 2*/
+    if(e < 0)
+    {
+        bemf.prev_e      = e;
+        bemf.prev_valid |= (e <= -BEMF_ZC_ARM_LSB);
+        return;
+    }
+
+    if(bemf.prev_valid != 0)
+    {
+        bemf.zc_slope = (uint32_t)(e - bemf.prev_e);
+        frac = ((uint32_t)(-bemf.prev_e) << 8) / bemf.zc_slope;
+        motor_bemf_zc_handle(now_q8 - 256 + frac);
+    }
+    else if(e >= BEMF_ZC_ARM_LSB)
+    {
+        /*the rotor leads the field, it crossed inside the blanking: back along the slope of the last crossing,
+          not before the commutation*/
+        back = (bemf.zc_slope != 0) ? (((uint32_t)e << 8) / bemf.zc_slope) : 0;
+        back = (back > (now_q8 - (bemf.com_tick << 8))) ? (now_q8 - (bemf.com_tick << 8)) : back;
+        motor_bemf_zc_handle(now_q8 - back);
+    }
+}
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init the sensorless six-step state
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_bemf_init(void)
+{
+    bemf.state       = BEMF_STATE_IDLE;
+    bemf.detector    = BEMF_DET_ADC;
+    bemf.dir         = MOTOR_DIR_CW;
+    bemf.duty        = 0;
+    bemf.zc_cnt      = 0;
+    bemf.lost_cnt    = 0;
+    bemf.start_known = 0;
+}
+
+
+/**
+ * @brief align the rotor on sector 0, the ramp and the closed loop follow from the adc interrupt.
+ *        With a start angle set, the ramp begins right away from the sector matching it.
+ * 
+ * @param[in] dir: rotation direction
+ * @return None
+ */
+void motor_bemf_start(motor_dir_e dir)
+{
+    uint8_t start_sector;
+
+    BEMF_COMP_IRQ_DISABLE();
+    COM_TIM_STOP();
+    ADC_INJ_IRQ_ENABLE();
+
+    bemf.dir              = dir;
+    bemf.sector           = SIX_STEP_SECTORS - 1;
+    bemf.blank            = 0;
+    bemf.zc_found         = 0;
+    bemf.prev_valid       = 0;
+    bemf.lock_cnt         = 0;
+    bemf.lost_seq         = 0;
+    bemf.out_duty         = BEMF_ALIGN_DUTY;
+    bemf.tick             = 0;
+    bemf.com_tick         = 0;
+    bemf.last_zc_q8       = 0;
+    bemf.prev_interval_q8 = 0;
+    bemf.interval_q8      = 0;
+    bemf.zc_slope         = 0;
+    bemf.state            = BEMF_STATE_ALIGN;
+    if(bemf.start_known != 0)
+    {
+        /*the com interrupt of the first COM event moves on to the preloaded sector*/
+        start_sector      = motor_six_step_angle_sector(dir, bemf.start_theta);
+        bemf.sector       = (uint8_t)((start_sector + SIX_STEP_SECTORS - 1) % SIX_STEP_SECTORS);
+        bemf.step_periods = BEMF_RAMP_START_PERIODS;
+        bemf.ramp_speed   = BEMF_RAMP_SPEED_ONE / BEMF_RAMP_START_PERIODS;
+        bemf.out_duty     = BEMF_RAMP_DUTY_START;
+        bemf.state        = BEMF_STATE_RAMP;
+        bemf.start_known  = 0;
+    }
+
+    bsp_pwm_com_trig_select(PWM_COM_TRIG_TIMER);
+    bsp_adc_inj_seq_set(bemf_adc_seq, 2);
+    bsp_pwm_adc_trig_select(PWM_ADC_TRIG_HIGH_SIDE);
+    PWM_DUTY_SET(bemf.out_duty, bemf.out_duty, bemf.out_duty);
+    motor_six_step_sector_preload(dir, bemf_sector_next[bemf.sector]);
+    PWM_COM_GENERATE();
+    bsp_pwm_output_enable(ENABLE);
+}
+
+
+/**
+ * @brief rotor angle known from a position detection: the next start skips the alignment
+ * 
+ * @param[in] theta: electrical angle of the d axis, 65536 = 360 degree
+ * @return None
+ */
+void motor_bemf_start_angle_set(uint16_t theta)
+{
+    bemf.start_theta = theta;
+    bemf.start_known = 1;
+}
+
+
+/**
+ * @brief stop, all phases off
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_bemf_stop(void)
+{
+    bemf.state = BEMF_STATE_IDLE;
+    BEMF_COMP_IRQ_DISABLE();
+    COM_TIM_STOP();
+    ADC_INJ_IRQ_ENABLE();
+    motor_six_step_stop();
+}
+
+
+/**
+ * @brief set the closed loop duty
+ * 
+ * @param[in] duty: 0 ~ PWM_PERIOD_MAX
+ * @return None
+ */
+void motor_bemf_duty_set(uint16_t duty)
+{
+    bemf.duty = (duty > PWM_PERIOD_MAX) ? PWM_PERIOD_MAX : duty;
+}
+
+
+/**
+ * @brief adc injected end of conversion, rank1 = floating phase, rank2 = vbus
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_bemf_adc_isr(void)
+{
+    motor_bemf_sample_process(ADC_INJ_DAT1(), ADC_INJ_DAT2());
+}
+
+
+/**
+ * @brief commutation done (timer, software or forced), move to the next sector
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_bemf_com_isr(void)
+{
+    uint8_t sector;
+    uint32_t blank;
+
+    if((bemf.state == BEMF_STATE_IDLE) || (bemf.state == BEMF_STATE_FAULT))
+    {
+        return;
+    }
+
+    sector      = bemf_sector_next[bemf.sector];
+    bemf.sector = sector;
+    motor_six_step_sector_preload(bemf.dir, bemf_sector_next[sector]);
+
+    if((bemf.detector == BEMF_DET_COMP) && (bemf.state == BEMF_STATE_RUN))
+    {
+        motor_bemf_comp_sector_start(sector);
+        return;
+    }
+
+    bsp_adc_inj_channel_set(1, bemf_float_ch[bemf.dir][sector]);
+
+    /*blank a quarter of the last sector (15 degree) for the freewheeling current*/
+    blank = (bemf.tick - bemf.com_tick) >> 2;
+    bemf.blank      = (blank == 0) ? 1 : ((blank > 0xFF) ? 0xFF : (uint8_t)blank);
+    bemf.zc_found   = 0;
+    bemf.prev_valid = 0;
+    bemf.com_tick   = bemf.tick;
+}
+
+
+/**
+ * @brief select the zero cross detector, ignored while running
+ * 
+ * @param[in] det: BEMF_DET_ADC or BEMF_DET_COMP
+ * @return None
+ */
+void motor_bemf_detector_set(bemf_det_e det)
+{
+    if((bemf.state != BEMF_STATE_IDLE) && (bemf.state != BEMF_STATE_FAULT))
+    {
+        return;
+    }
+    bemf.detector = det;
+}
+
+
+/**
+ * @brief comparator zero cross, from the EXTI interrupt
+ * 
+ * TIM2 counts from the commutation, the zero cross time is its count minus the
+ * filter, window and interrupt latency. Moving the reload to that time plus half an
+ * interval makes the TIM2 update (and the TIM1 COM) land on the 30 degree point.
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_bemf_comp_zc_isr(void)
+{
+    int32_t zc_us = (int32_t)COM_TIM_CNT() - (int32_t)bemf.comp_latency_us;
+    uint32_t interval;
+    uint32_t reload;
+    uint32_t now;
+
+    BEMF_COMP_IRQ_DISABLE();
+    if((bemf.zc_found != 0) || (bemf.state != BEMF_STATE_RUN))
+    {
+        return;
+    }
+
+    zc_us    = (zc_us < 0) ? 0 : zc_us;
+    interval = bemf.com_delay_us + (uint32_t)zc_us;
+    bemf.interval_us      = (interval + bemf.prev_interval_us) >> 1;
+    bemf.prev_interval_us = interval;
+    bemf.com_delay_us     = bemf.interval_us >> 1;
+    bemf.zc_found         = 1;
+    bemf.lost_seq         = 0;
+    bemf.zc_cnt++;
+
+    reload = (uint32_t)zc_us + bemf.com_delay_us;
+    now    = COM_TIM_CNT() + 2;
+    reload = (reload < now) ? now : reload;
+    COM_TIM_RELOAD_SET((reload > 0xFFFF) ? 0xFFFF : reload);
+}
+
+
+/**
+ * @brief end of the demagnetization blanking, from the TIM2 CC1 interrupt
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_bemf_comp_blank_isr(void)
+{
+    BEMF_COMP_IRQ_ENABLE();
+
+    /*crossed inside the blanking and the window is open: no edge will come*/
+    if(BEMF_COMP_OUT())
+    {
+        motor_bemf_comp_zc_isr();
+    }
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+/**
+ * @brief feed one sample as the adc interrupt would, for the host motor model
+ * 
+ * @param[in] bemf_raw: floating phase voltage, adc counts
+ * @param[in] vbus_raw: dc bus voltage, adc counts
+ * @return None
+ */
+void motor_bemf_sample(uint16_t bemf_raw, uint16_t vbus_raw)
+{
+    motor_bemf_sample_process(bemf_raw, vbus_raw);
+}
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,155 @@
+/**
+ * @file motor_bemf.h
+ * @brief Driver motor_bemf Header
+ * 
+ * @details
+ * Sensorless six-step: the floating phase BEMF is sampled by the ADC at the pwm
+ * center and compared with the virtual neutral (Vbus / 2). The zero cross time is
+ * interpolated between two samples and the 30 degree commutation delay is counted
+ * by the commutation timer, so the commutation instant is not quantized to the pwm period.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_BEMF_H__
+#define __MOTOR_BEMF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "bsp_pwm.h"
+#include "bsp_comp.h"
+#include "motor_six_step.h"
+
+/* ============================ Public Constants ============================ */
+
+#define BEMF_PWM_PERIOD_US          (1000000 / PWM_FREQ_HZ)     // 50us
+#define BEMF_ISR_LATENCY_US         (2)                         // trigger -> timer start, adc conversion + isr entry
+
+#define BEMF_ALIGN_PERIODS          (4000)                      // 200ms rotor alignment
+#define BEMF_ALIGN_DUTY             (PWM_PERIOD_MAX / 10)
+#define BEMF_RAMP_START_PERIODS     (400)                       // first forced step 20ms
+#define BEMF_RAMP_END_PERIODS       (30)                        // fastest forced step 1.5ms
+#define BEMF_RAMP_SPEED_ONE         (1UL << 24)                 // ramp speed unit: 1 sector per pwm period
+#define BEMF_RAMP_ACCEL             (52)                        // ramp speed added per pwm period, start -> end in 0.5s
+#define BEMF_RAMP_DUTY_START        (PWM_PERIOD_MAX / 10)
+#define BEMF_RAMP_DUTY_STEP         (4)                         // duty added every forced step
+#define BEMF_RAMP_DUTY_MAX          (PWM_PERIOD_MAX / 4)
+#define BEMF_RUN_DUTY_SLEW          (1)                         // closed loop duty rise per pwm period, 0 -> max in 135ms
+#define BEMF_LOCK_STEPS             (12)                        // consecutive zero crosses before closing the loop
+#define BEMF_LOST_MAX               (6)                         // consecutive missed zero crosses before stopping
+#define BEMF_ZC_ARM_LSB             (8)                         // pre crossing sample below Vbus / 2 needed to arm, 0.14V
+#define BEMF_DEMAG_RAIL_LSB         (16)                        // floating phase this close to 0 or Vbus is still freewheeling, 0.27V
+
+#define BEMF_COMP_BLANK_MIN_US      (10)                        // shortest demagnetization blanking
+#define BEMF_COMP_EDGE_MARGIN       (3 * PWM_DEADTIME)          // TIM1 ticks kept blanked around the high side edges
+
+/* ============================ Code Enum Definitions ============================ */
+
+typedef enum
+{
+    BEMF_STATE_IDLE = 0,
+    BEMF_STATE_ALIGN,
+    BEMF_STATE_RAMP,
+    BEMF_STATE_RUN,
+    BEMF_STATE_FAULT,
+}bemf_state_e;
+
+typedef enum
+{
+    BEMF_DET_ADC = 0,                   /*adc sample every pwm period*/
+    BEMF_DET_COMP,                      /*comparator edge interrupt once per sector, closed loop only*/
+}bemf_det_e;
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    bemf_state_e state;
+    bemf_det_e   detector;
+    motor_dir_e  dir;
+    uint8_t      sector;            /*sector currently applied*/
+    uint8_t      blank;             /*samples still ignored after the commutation*/
+    uint8_t      zc_found;          /*zero cross of this sector seen*/
+    uint8_t      prev_valid;
+    uint8_t      lock_cnt;
+    uint8_t      lost_seq;
+    uint8_t      start_known;       /*start_theta valid for the next start: no alignment*/
+    uint16_t     start_theta;
+    uint16_t     duty;              /*duty requested for the closed loop*/
+    uint16_t     out_duty;          /*duty applied*/
+    uint16_t     step_periods;      /*forced step length during the ramp*/
+    uint32_t     ramp_speed;        /*forced speed, BEMF_RAMP_SPEED_ONE = 1 sector per pwm period*/
+    int32_t      prev_e;
+    uint32_t     tick;              /*pwm periods since start*/
+    uint32_t     com_tick;          /*tick of the last commutation*/
+    uint32_t     last_zc_q8;        /*time of the last zero cross, 1/256 pwm period*/
+    uint32_t     prev_interval_q8;
+    uint32_t     interval_q8;       /*60 degree interval, mean of the last two zero cross intervals*/
+    uint32_t     zc_slope;          /*bemf change over the pwm period of the last crossing, adc counts*/
+    uint32_t     com_delay_us;      /*comparator: zero cross to commutation*/
+    uint32_t     prev_interval_us;
+    uint32_t     interval_us;       /*comparator: 60 degree interval*/
+    uint32_t     comp_latency_us;   /*comparator: zero cross to edge interrupt, mean*/
+    uint32_t     zc_cnt;
+    uint32_t     lost_cnt;
+}bemf_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern bemf_t bemf;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* comparator blanking compare (OC5 PWM2): only the middle of the high side on-time is looked at */
+#define BEMF_COMP_WINDOW(duty)      (((duty) > (2 * BEMF_COMP_EDGE_MARGIN)) ? ((duty) - BEMF_COMP_EDGE_MARGIN) : ((duty) >> 1))
+#define BEMF_COMP_BLANKED_US(duty)  (BEMF_PWM_PERIOD_US - (BEMF_COMP_WINDOW(duty) * BEMF_PWM_PERIOD_US) / PWM_PERIOD_MAX)
+
+/* crossing to filtered edge, mean: the filter, plus the wait for the next window when the crossing
+   comes too late in the current one to pass the filter (x^2 / 2 per period over that dead span) */
+#define BEMF_COMP_DEAD_US(duty)     (BEMF_COMP_BLANKED_US(duty) + BEMF_COMP_FILTER_LATENCY_US)
+#define BEMF_COMP_LATENCY_US(duty)  (BEMF_COMP_FILTER_LATENCY_US + (BEMF_COMP_DEAD_US(duty) * BEMF_COMP_DEAD_US(duty)) / (2 * BEMF_PWM_PERIOD_US))
+
+/* ============================ Function Declarations ============================ */
+
+void motor_bemf_init(void);
+void motor_bemf_start(motor_dir_e dir);
+void motor_bemf_stop(void);
+void motor_bemf_duty_set(uint16_t duty);
+void motor_bemf_start_angle_set(uint16_t theta);
+void motor_bemf_adc_isr(void);
+void motor_bemf_com_isr(void);
+void motor_bemf_detector_set(bemf_det_e det);
+void motor_bemf_comp_zc_isr(void);
+void motor_bemf_comp_blank_isr(void);
+
+#ifdef UNIT_TEST
+void motor_bemf_sample(uint16_t bemf_raw, uint16_t vbus_raw);
+#endif /* UNIT_TEST */
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_BEMF_H__*/
+
+
+/**
+  * @}
+  */
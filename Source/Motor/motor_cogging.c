@@ -0,0 +1,352 @@
+/**
+ * @file motor_cogging.c
+ * @brief Cogging torque compensation, table learned at runtime
+ * 
+ * @details
+ * The cogging torque repeats lcm(slots, 2p) / p times per electrical turn, so
+ * a table over the electrical angle holds it (not the per magnet differences,
+ * which repeat per mechanical turn). COGGING_BINS entries of q current; each
+ * pwm period the current loop adds the table at foc.theta, interpolated
+ * between the two neighbouring bins, to the q reference: about 15 cycles.
+ * Not in open loop, where foc.theta is not the rotor's.
+ * 
+ * Learning, motor_cogging_learn_start() in speed mode once the loops run
+ * closed: the speed loop holds COGGING_LEARN_INC, and what it still has to
+ * give against the cogging is in its q reference. Each pass records that
+ * reference per bin over COGGING_LEARN_TURNS turns, averages it, removes the
+ * mean (load, friction) and adds the rest, COGGING_LEARN_GAIN_SHIFT scaled,
+ * to the table that was applied meanwhile. The passes converge even where
+ * the speed loop only follows the cogging in part, with lag. The per bin
+ * division and the table update run one bin per period after the pass.
+ * The angle has to be right at the learning speed: HFI or a sensor.
+ * 
+ * The table goes to the flash parameter page with motor_cogging_save(),
+ * motor stopped in every mode (motor_ctrl not running, TIM1 main output
+ * off), and is loaded and enabled at init when the page holds one.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include <stddef.h>
+#include <string.h>
+#include "bsp_flash.h"
+#include "bsp_pwm.h"
+#include "motor_ctrl.h"
+#include "motor_foc.h"
+#include "motor_loop.h"
+#include "motor_cogging.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define COGGING_FRAC_MASK               ((1 << (16 - COGGING_BINS_SHIFT)) - 1)
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+cogging_t cogging;
+
+/* ============================ Static Global Variables ============================ */
+
+static int16_t cogging_backup[COGGING_BINS];   /*table before the learning, back on a failure*/
+static uint8_t cogging_enable_backup;          /*enable before the learning, back on a failure*/
+
+/* ============================ Static Function Declarations ============================ */
+
+static uint32_t motor_cogging_check(uint32_t magic, const int16_t *table);
+static void motor_cogging_learn_step(uint16_t theta, int16_t iq_ref);
+static void motor_cogging_learn_fail(void);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init: the table of the flash parameter page and enabled, or none and disabled
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_cogging_init(void)
+{
+    const cogging_flash_t *blk = (const cogging_flash_t *)BSP_FLASH_PARAM_ADDR;
+
+    cogging.learn  = COGGING_LEARN_IDLE;
+    cogging.ff     = 0;
+    cogging.loaded = ((blk->magic == COGGING_FLASH_MAGIC) && (blk->check == motor_cogging_check(blk->magic, blk->table))) ? 1 : 0;
+    if(cogging.loaded != 0)
+    {
+        memcpy(cogging.table, blk->table, sizeof(cogging.table));
+    }
+    else
+    {
+        memset(cogging.table, 0, sizeof(cogging.table));
+    }
+    cogging.enable = cogging.loaded;
+}
+
+
+/**
+ * @brief at stop: a learning in progress fails, the table goes back to what it was
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_cogging_reset(void)
+{
+    cogging.ff = 0;
+    if((cogging.learn != COGGING_LEARN_IDLE) && (cogging.learn < COGGING_LEARN_DONE))
+    {
+        motor_cogging_learn_fail();
+    }
+}
+
+
+/**
+ * @brief apply the table or not, can be switched while running; disabling stops a learning
+ * 
+ * @param[in] enable: 1 on, 0 off
+ * @return None
+ */
+void motor_cogging_enable(uint8_t enable)
+{
+    if(enable == 0)
+    {
+        motor_cogging_reset();
+    }
+    cogging.ff     = 0;
+    cogging.enable = enable;
+}
+
+
+/**
+ * @brief start the learning: speed mode at COGGING_LEARN_INC in the running direction, the table refined
+ * 
+ * @param[in] None
+ * @return 0 started, 1 the loops do not run closed or a learning is in progress
+ */
+uint8_t motor_cogging_learn_start(void)
+{
+    if((foc.state != FOC_STATE_RUN) || (foc.theta_src == FOC_THETA_OPEN_LOOP) || (loop.running == 0)
+       || ((cogging.learn != COGGING_LEARN_IDLE) && (cogging.learn < COGGING_LEARN_DONE)))
+    {
+        return 1;
+    }
+
+    memcpy(cogging_backup, cogging.table, sizeof(cogging_backup));
+    memset(cogging.sum, 0, sizeof(cogging.sum));
+    memset(cogging.cnt, 0, sizeof(cogging.cnt));
+    if(loop.mode != LOOP_MODE_SPEED)
+    {
+        motor_loop_mode_set(LOOP_MODE_SPEED);
+    }
+    motor_loop_speed_ref_set((loop.speed < 0) ? -COGGING_LEARN_INC : COGGING_LEARN_INC, 0);
+    cogging.pass   = 0;
+    cogging.wait   = COGGING_SETTLE_PERIODS;
+    cogging_enable_backup = cogging.enable;
+    cogging.enable = 1;
+    cogging.learn  = COGGING_LEARN_SETTLE;
+
+    return 0;
+}
+
+
+/**
+ * @brief write the table to the flash parameter page, motor stopped: the erase stalls the interrupts
+ * 
+ * @details
+ * Stopped in any mode: the six-step, BEMF and hall sine modes leave foc.state
+ * idle while the bridge switches, so the control state and the main output
+ * are checked, not the FOC state.
+ * 
+ * @param[in] None
+ * @return 0 written, 1 motor running, outputs on, learning or flash error
+ */
+uint8_t motor_cogging_save(void)
+{
+    uint32_t magic;
+    uint32_t check;
+
+    if((motor_ctrl.running != 0) || PWM_OUTPUT_ENABLED() || (foc.state != FOC_STATE_IDLE)
+       || ((cogging.learn != COGGING_LEARN_IDLE) && (cogging.learn < COGGING_LEARN_DONE)))
+    {
+        return 1;
+    }
+
+    magic = COGGING_FLASH_MAGIC;
+    check = motor_cogging_check(magic, cogging.table);
+
+    /*straight from the table, the magic last: a write cut short leaves no valid block*/
+    if((bsp_flash_param_erase() != 0)
+       || (bsp_flash_param_program(offsetof(cogging_flash_t, table), (const uint32_t *)cogging.table, sizeof(cogging.table) / 4) != 0)
+       || (bsp_flash_param_program(offsetof(cogging_flash_t, check), &check, 1) != 0))
+    {
+        return 1;
+    }
+
+    return bsp_flash_param_program(offsetof(cogging_flash_t, magic), &magic, 1);
+}
+
+
+/**
+ * @brief one pwm period: the feedforward at the angle, and the learning
+ * 
+ * @param[in] theta: electrical angle of the period
+ * @param[in] iq_ref: q reference of the speed loop, without the feedforward, q15
+ * @return feedforward to add to the q reference, q15
+ */
+int16_t motor_cogging_update(uint16_t theta, int16_t iq_ref)
+{
+    uint32_t bin = theta >> (16 - COGGING_BINS_SHIFT);
+    int32_t  a   = cogging.table[bin];
+    int32_t  b   = cogging.table[(bin + 1) & (COGGING_BINS - 1)];
+
+    cogging.ff = (int16_t)(a + (((b - a) * (int32_t)(theta & COGGING_FRAC_MASK)) >> (16 - COGGING_BINS_SHIFT)));
+    if((cogging.learn != COGGING_LEARN_IDLE) && (cogging.learn < COGGING_LEARN_DONE))
+    {
+        motor_cogging_learn_step(theta, iq_ref);
+    }
+
+    return cogging.ff;
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief check word of a flash block
+ * 
+ * @param[in] magic: magic word of the block
+ * @param[in] table: the table, word aligned
+ * @return ~(magic + sum of the table as words)
+ */
+static uint32_t motor_cogging_check(uint32_t magic, const int16_t *table)
+{
+    const uint32_t *w   = (const uint32_t *)table;
+    uint32_t        sum = magic;
+    uint32_t        i;
+
+    for(i = 0; i < (COGGING_BINS * sizeof(int16_t) / 4); i++)
+    {
+        sum += w[i];
+    }
+
+    return ~sum;
+}
+
+
+/**
+ * @brief one period of the learning
+ * 
+ * @param[in] theta: electrical angle of the period
+ * @param[in] iq_ref: q reference of the speed loop, q15
+ * @return None
+ */
+static void motor_cogging_learn_step(uint16_t theta, int16_t iq_ref)
+{
+    uint32_t bin;
+    int32_t  d;
+    int32_t  v;
+
+    switch(cogging.learn)
+    {
+        case COGGING_LEARN_SETTLE:
+            if(--cogging.wait == 0)
+            {
+                cogging.periods    = 0;
+                cogging.progress   = 0;
+                cogging.theta_prev = theta;
+                cogging.learn      = COGGING_LEARN_RECORD;
+            }
+            break;
+
+        case COGGING_LEARN_RECORD:
+            bin = theta >> (16 - COGGING_BINS_SHIFT);
+            if(cogging.cnt[bin] < COGGING_CNT_MAX)
+            {
+                cogging.sum[bin] += iq_ref;
+                cogging.cnt[bin]++;
+            }
+            d = (int16_t)(theta - cogging.theta_prev);
+            cogging.theta_prev = theta;
+            cogging.progress  += (d < 0) ? -d : d;
+            cogging.periods++;
+            if(cogging.progress >= ((uint32_t)COGGING_LEARN_TURNS << 16))
+            {
+                cogging.bin   = 0;
+                cogging.mean  = 0;
+                cogging.learn = COGGING_LEARN_AVERAGE;
+            }
+            else if(cogging.periods >= COGGING_PASS_TIMEOUT)
+            {
+                motor_cogging_learn_fail();
+            }
+            break;
+
+        case COGGING_LEARN_AVERAGE:
+            bin = cogging.bin;
+            if(cogging.cnt[bin] == 0)
+            {
+                motor_cogging_learn_fail();
+                break;
+            }
+            cogging.sum[bin] /= cogging.cnt[bin];
+            cogging.mean     += cogging.sum[bin];
+            if(++cogging.bin == COGGING_BINS)
+            {
+                cogging.mean  = cogging.mean / COGGING_BINS;
+                cogging.bin   = 0;
+                cogging.learn = COGGING_LEARN_UPDATE;
+            }
+            break;
+
+        case COGGING_LEARN_UPDATE:
+            bin = cogging.bin;
+            v   = cogging.table[bin] + ((cogging.sum[bin] - cogging.mean) >> COGGING_LEARN_GAIN_SHIFT);
+            cogging.table[bin] = (int16_t)((v > COGGING_FF_MAX) ? COGGING_FF_MAX : ((v < -COGGING_FF_MAX) ? -COGGING_FF_MAX : v));
+            cogging.sum[bin]   = 0;
+            cogging.cnt[bin]   = 0;
+            if(++cogging.bin == COGGING_BINS)
+            {
+                cogging.pass++;
+                cogging.wait  = COGGING_PASS_SETTLE_PERIODS;
+                cogging.learn = (cogging.pass >= COGGING_LEARN_PASSES) ? COGGING_LEARN_DONE : COGGING_LEARN_SETTLE;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/**
+ * @brief learning failed: the table and the enable before it back
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_cogging_learn_fail(void)
+{
+    memcpy(cogging.table, cogging_backup, sizeof(cogging.table));
+    cogging.enable = cogging_enable_backup;
+    cogging.learn = COGGING_LEARN_FAIL;
+}
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,119 @@
+/**
+ * @file motor_cogging.h
+ * @brief Driver motor_cogging Header
+ * 
+ * @details
+ * Cogging torque table against the electrical angle: learned at a constant
+ * slow speed, applied as q current feedforward, kept in the flash parameter page.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_COGGING_H__
+#define __MOTOR_COGGING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+#define COGGING_BINS_SHIFT              (8)
+#define COGGING_BINS                    (1 << COGGING_BINS_SHIFT)   // per electrical turn
+#define COGGING_FF_MAX                  (Q15(0.25f * MOTOR_RATED_CURRENT_A / MOTOR_I_BASE_A))  // table entries within +-
+
+/* learning: speed loop at COGGING_LEARN_INC, the cogging harmonics well under its bandwidth */
+#define COGGING_LEARN_INC               ((int16_t)MOTOR_RPM_TO_INC(30.0f))  // about 30rpm, 0.5s per electrical turn
+#define COGGING_LEARN_TURNS             (4)                 // electrical turns recorded per pass
+#define COGGING_LEARN_PASSES            (8)
+#define COGGING_LEARN_GAIN_SHIFT        (1)                 // table += residual / 2 per pass
+#define COGGING_SETTLE_PERIODS          (20000)             // speed change to the learning speed
+#define COGGING_PASS_SETTLE_PERIODS     (2000)              // after each table update
+#define COGGING_PASS_TIMEOUT            (5UL * PWM_FREQ_HZ) // one pass, twice its time at the learning speed
+#define COGGING_CNT_MAX                 (0xFFFF)            // samples per bin and pass, the sum stays within int32
+
+#define COGGING_FLASH_MAGIC             (0x43474731UL)      // "CGG1"
+
+/* ============================ Code Enum Definitions ============================ */
+
+typedef enum
+{
+    COGGING_LEARN_IDLE = 0,
+    COGGING_LEARN_SETTLE,
+    COGGING_LEARN_RECORD,               /*q reference summed per bin over COGGING_LEARN_TURNS*/
+    COGGING_LEARN_AVERAGE,              /*one bin per period*/
+    COGGING_LEARN_UPDATE,               /*one bin per period*/
+    COGGING_LEARN_DONE,
+    COGGING_LEARN_FAIL,                 /*stopped, timeout or a bin never reached; the table is kept as it was*/
+}cogging_learn_e;
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    uint32_t magic;
+    int16_t  table[COGGING_BINS];
+    uint32_t check;                     /*~(magic + the table words)*/
+}cogging_flash_t;
+
+typedef struct
+{
+    uint8_t          enable;            /*feedforward applied*/
+    uint8_t          loaded;            /*table read from the flash at init*/
+    cogging_learn_e  learn;
+    uint8_t          pass;
+    uint16_t         bin;               /*average / update stages*/
+    uint16_t         theta_prev;
+    uint32_t         wait;              /*settle periods left*/
+    uint32_t         periods;           /*of the pass*/
+    uint32_t         progress;          /*angle recorded in the pass, 65536 per electrical turn*/
+    int32_t          mean;              /*load and friction of the pass, q15*/
+    int16_t          table[COGGING_BINS];   /*q current, q15; word aligned, programmed as words*/
+    int16_t          ff;                /*feedforward of the last period, q15*/
+    int32_t          sum[COGGING_BINS];
+    uint16_t         cnt[COGGING_BINS];     /*saturates at COGGING_CNT_MAX, the bin is not summed beyond*/
+}cogging_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern cogging_t cogging;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_cogging_init(void);
+void motor_cogging_reset(void);
+void motor_cogging_enable(uint8_t enable);
+uint8_t motor_cogging_learn_start(void);
+uint8_t motor_cogging_save(void);
+int16_t motor_cogging_update(uint16_t theta, int16_t iq_ref);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_COGGING_H__*/
+
+
+/**
+  * @}
+  */
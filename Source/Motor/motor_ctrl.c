@@ -0,0 +1,359 @@
+/**
+ * @file motor_ctrl.c
+ * @brief Motor control mode selection
+ * 
+ * @details
+ * The mode can only be changed while the motor is stopped. Unused hooks point to
+ * an empty function so the interrupts never test for NULL.
+ * 
+ * With a position detection selected, a start in a sensorless mode first runs
+ * the pulse test through the ipd hooks; when it is done the detected angle is
+ * handed to the mode and the mode hooks take over from the adc interrupt.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_pwm.h"
+#include "bsp_hall.h"
+#include "bsp_adc.h"
+#include "motor_six_step.h"
+#include "motor_bemf.h"
+#include "motor_hall_sin.h"
+#include "motor_foc.h"
+#include "motor_startup.h"
+#include "motor_loop.h"
+#include "motor_ipd.h"
+#include "motor_param_id.h"
+#include "motor_tune.h"
+#include "motor_regen.h"
+#include "motor_ctrl.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+motor_ctrl_t motor_ctrl;
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+static void motor_ctrl_none(void)
+{
+}
+
+
+static void motor_ctrl_angle_none(uint16_t theta)
+{
+    (void)theta;
+}
+
+
+static void motor_ctrl_hall_start(motor_dir_e dir)
+{
+    bsp_pwm_com_trig_select(PWM_COM_TRIG_HALL);
+    motor_six_step_start(dir, six_step.duty);
+}
+
+
+static void motor_ctrl_hall_com_isr(void)
+{
+    motor_six_step_commutate(HALL_STATE_READ());
+}
+
+
+static void motor_ctrl_foc_start(motor_dir_e dir)
+{
+    motor_loop_reset();
+    motor_startup_start(dir);
+}
+
+
+static void motor_ctrl_foc_pwm_isr(void)
+{
+    if(foc.shunt == FOC_SHUNT_SINGLE)
+    {
+        motor_single_shunt_valley_isr();
+    }
+    motor_startup_pwm_isr();
+    if(startup.state == STARTUP_STATE_RUN)
+    {
+        motor_loop_pwm_isr();
+    }
+}
+
+
+static const motor_mode_ops_t motor_mode_ops[MOTOR_MODE_MAX] =
+{
+    /*MOTOR_MODE_HALL_SIX_STEP*/
+    {motor_ctrl_hall_start, motor_six_step_stop, motor_six_step_pwm_update, motor_ctrl_hall_com_isr, motor_ctrl_none,    motor_ctrl_angle_none},
+    /*MOTOR_MODE_BEMF_SIX_STEP*/
+    {motor_bemf_start,      motor_bemf_stop,     motor_ctrl_none,           motor_bemf_com_isr,      motor_bemf_adc_isr, motor_bemf_start_angle_set},
+    /*MOTOR_MODE_FOC*/
+    {motor_ctrl_foc_start,  motor_startup_stop,  motor_ctrl_foc_pwm_isr,    motor_ctrl_none,         motor_foc_adc_isr,  motor_startup_angle_set},
+    /*MOTOR_MODE_HALL_SIN*/
+    {motor_hall_sin_start,  motor_hall_sin_stop, motor_hall_sin_pwm_isr,    motor_hall_sin_com_isr,  motor_ctrl_none,    motor_ctrl_angle_none},
+};
+
+
+static void motor_ctrl_ipd_start(motor_dir_e dir)
+{
+    (void)dir;
+    motor_ipd_start(motor_ctrl.ipd);
+}
+
+
+static void motor_ctrl_ipd_adc_isr(void)
+{
+    motor_ipd_adc_isr();
+    if(ipd.state == IPD_STATE_DONE)
+    {
+        motor_ctrl.ops = &motor_mode_ops[motor_ctrl.mode];
+        motor_ctrl.ops->angle_set(ipd.theta);
+        motor_ctrl.ops->start(motor_ctrl.dir);
+    }
+}
+
+
+static const motor_mode_ops_t motor_ipd_ops =
+{
+    motor_ctrl_ipd_start,   motor_ipd_stop,      motor_ctrl_none,           motor_ctrl_none,         motor_ctrl_ipd_adc_isr, motor_ctrl_angle_none
+};
+
+
+static void motor_ctrl_param_id_start(motor_dir_e dir)
+{
+    (void)dir;
+    motor_param_id_start();
+}
+
+
+static void motor_ctrl_param_id_adc_isr(void)
+{
+    motor_param_id_adc_isr();
+    if(param_id.state == PARAM_ID_STATE_DONE)
+    {
+        motor_ctrl.tune_pending = 1;
+    }
+    if((param_id.state == PARAM_ID_STATE_DONE) || (param_id.state == PARAM_ID_STATE_FAIL))
+    {
+        motor_ctrl.ops     = &motor_mode_ops[motor_ctrl.mode];
+        motor_ctrl.running = 0;
+    }
+}
+
+
+static const motor_mode_ops_t motor_param_id_ops =
+{
+    motor_ctrl_param_id_start, motor_param_id_stop, motor_ctrl_none, motor_ctrl_none, motor_ctrl_param_id_adc_isr, motor_ctrl_angle_none
+};
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init the motor control with the given mode, motor stopped
+ * 
+ * @param[in] mode: control mode
+ * @return None
+ */
+void motor_ctrl_init(motor_mode_e mode)
+{
+    motor_ctrl.mode         = (mode < MOTOR_MODE_MAX) ? mode : MOTOR_MODE_HALL_SIX_STEP;
+    motor_ctrl.dir          = MOTOR_DIR_CW;
+    motor_ctrl.running      = 0;
+    motor_ctrl.ipd          = IPD_OFF;
+    motor_ctrl.tune_pending = 0;
+    motor_ctrl.ops          = &motor_mode_ops[motor_ctrl.mode];
+}
+
+
+/**
+ * @brief change the control mode, ignored while running
+ * 
+ * @param[in] mode: control mode
+ * @return None
+ */
+void motor_ctrl_mode_set(motor_mode_e mode)
+{
+    if((motor_ctrl.running != 0) || (mode >= MOTOR_MODE_MAX))
+    {
+        return;
+    }
+    motor_ctrl.mode = mode;
+    motor_ctrl.ops  = &motor_mode_ops[mode];
+}
+
+
+/**
+ * @brief select the position detection run before a sensorless start, ignored while running
+ * 
+ * @param[in] pulses: IPD_OFF to align as before, IPD_PULSES_6 or IPD_PULSES_12
+ * @return None
+ */
+void motor_ctrl_ipd_set(ipd_pulses_e pulses)
+{
+    if(motor_ctrl.running != 0)
+    {
+        return;
+    }
+    motor_ctrl.ipd = pulses;
+}
+
+
+/**
+ * @brief start the motor in the selected mode, after the position detection if one is selected
+ * 
+ * @param[in] dir: rotation direction
+ * @return None
+ */
+void motor_ctrl_start(motor_dir_e dir)
+{
+    motor_ctrl.dir     = dir;
+    motor_ctrl.running = 1;
+    motor_ctrl.ops     = &motor_mode_ops[motor_ctrl.mode];
+    if((motor_ctrl.ipd != IPD_OFF) && (motor_ctrl.ops->angle_set != motor_ctrl_angle_none))
+    {
+        motor_ctrl.ops = &motor_ipd_ops;
+    }
+    motor_ctrl.ops->start(dir);
+}
+
+
+/**
+ * @brief identify the motor parameters (unloaded motor), ignored while running
+ * 
+ * @details
+ * Back to the selected mode when done, param_id.state tells the result and
+ * param_id.block holds the parameters; on success the current and speed PI
+ * gains are tuned from them (motor_tune_apply) by the next motor_ctrl_task(),
+ * out of the interrupts.
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_ctrl_param_id_run(void)
+{
+    if(motor_ctrl.running != 0)
+    {
+        return;
+    }
+    motor_ctrl.running = 1;
+    motor_ctrl.ops     = &motor_param_id_ops;
+    motor_ctrl.ops->start(motor_ctrl.dir);
+}
+
+
+/**
+ * @brief stop the motor
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_ctrl_stop(void)
+{
+    motor_ctrl.ops->stop();
+    motor_ctrl.ops     = &motor_mode_ops[motor_ctrl.mode];
+    motor_ctrl.running = 0;
+}
+
+
+/**
+ * @brief main loop work of the motor control: the gain tuning after an identification
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_ctrl_task(void)
+{
+    if(motor_ctrl.tune_pending != 0)
+    {
+        motor_ctrl.tune_pending = 0;
+        motor_tune_apply(&param_id.block);
+    }
+}
+
+
+/**
+ * @brief TIM1 update interrupt hook, the bus overvoltage control first: every period in every mode
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_ctrl_pwm_isr(void)
+{
+    if(adc_vbus_rank != ADC_VBUS_RANK_NONE)
+    {
+        motor_regen_bus_update(ADC_INJ_VBUS());
+    }
+    motor_ctrl.ops->pwm_isr();
+}
+
+
+/**
+ * @brief TIM1 COM interrupt hook
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_ctrl_com_isr(void)
+{
+    motor_ctrl.ops->com_isr();
+}
+
+
+/**
+ * @brief ADC injected end of conversion hook
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_ctrl_adc_isr(void)
+{
+    motor_ctrl.ops->adc_isr();
+}
+
+
+/**
+ * @brief TIM1 update at the counter peak, single shunt mode only
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_ctrl_pwm_peak_isr(void)
+{
+    motor_single_shunt_peak_isr();
+}
+
+
+/**
+ * @brief TIM1 CC4 interrupt hook, single shunt mode only
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_ctrl_cc_isr(void)
+{
+    motor_single_shunt_trig_isr();
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+/**
+  * @}
+  */
@@ -0,0 +1,103 @@
+/**
+ * @file motor_ctrl.h
+ * @brief Driver motor_ctrl Header
+ * 
+ * @details
+ * Motor control mode selection. Every mode provides the same set of
+ * start/stop/interrupt hooks, the bsp interrupt callbacks only call motor_ctrl.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_CTRL_H__
+#define __MOTOR_CTRL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_six_step.h"
+#include "motor_ipd.h"
+#include "motor_param_id.h"
+
+/* ============================ Public Constants ============================ */
+
+/* ============================ Code Enum Definitions ============================ */
+
+typedef enum
+{
+    MOTOR_MODE_HALL_SIX_STEP = 0,
+    MOTOR_MODE_BEMF_SIX_STEP,
+    MOTOR_MODE_FOC,
+    MOTOR_MODE_HALL_SIN,                /*hall interpolated sine, six-step at low speed*/
+    MOTOR_MODE_MAX,
+}motor_mode_e;
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    void (*start)(motor_dir_e dir);
+    void (*stop)(void);
+    void (*pwm_isr)(void);
+    void (*com_isr)(void);
+    void (*adc_isr)(void);
+    void (*angle_set)(uint16_t theta);  /*start angle for the next start, sensorless modes only*/
+}motor_mode_ops_t;
+
+typedef struct
+{
+    motor_mode_e            mode;
+    motor_dir_e             dir;
+    uint8_t                 running;
+    ipd_pulses_e            ipd;        /*position detection before a sensorless start*/
+    volatile uint8_t        tune_pending;   /*identification done, the gains tuned by motor_ctrl_task()*/
+    const motor_mode_ops_t *ops;
+}motor_ctrl_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern motor_ctrl_t motor_ctrl;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_ctrl_init(motor_mode_e mode);
+void motor_ctrl_mode_set(motor_mode_e mode);
+void motor_ctrl_ipd_set(ipd_pulses_e pulses);
+void motor_ctrl_param_id_run(void);
+void motor_ctrl_start(motor_dir_e dir);
+void motor_ctrl_stop(void);
+void motor_ctrl_task(void);
+void motor_ctrl_pwm_isr(void);
+void motor_ctrl_com_isr(void);
+void motor_ctrl_adc_isr(void);
+void motor_ctrl_pwm_peak_isr(void);
+void motor_ctrl_cc_isr(void);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_CTRL_H__*/
+
+
+/**
+  * @}
+  */
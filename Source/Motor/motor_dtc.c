@@ -0,0 +1,174 @@
+/**
+ * @file motor_dtc.c
+ * @brief Dead time compensation on the current polarity
+ * 
+ * @details
+ * In the dead time both switches of a leg are off and the diodes set the
+ * phase: to the low rail for a current out of the leg, to the high rail for a
+ * current into it. Centre aligned, one dead time per period moves the
+ * average phase voltage by deadtime / (2 * period) of the bus against the
+ * current, in compare ticks deadtime / 2 whatever the duty:
+ *   v_dt = (deadtime + delay) / 2 * 32768 / SVPWM_GAIN
+ * The dead time is read back from the TIM1 break / dead time register
+ * (bsp_pwm_deadtime_get()), so the two cannot disagree.
+ * 
+ * The polarity comes from the current reference (the measured current crosses
+ * zero with ripple and noise and would chatter), linear within +-band:
+ *   v_x = clamp(i_x * v_dt / band, -v_dt, v_dt)    x = a, b, c
+ * The diodes take the sign of the current at the switching instant, ripple
+ * included, so the mean voltage goes over from one polarity to the other
+ * within about the ripple amplitude. That grows with the applied voltage:
+ *   band = i_band + |v| * Ts / (4 * L)
+ * A fixed 0.2A band left 1.5-2% THD at 2A and 13.6% at 0.5A where the ripple
+ * is a few 10mA; 0.01A overcompensated at 3000rpm and 0.5A, 9% against 4.9%
+ * without (Tools/motor_dtc_sim.c).
+ * The three phase terms go back to alpha / beta, the zero sequence dropped
+ * (SVPWM sets its own), and are added to the SVPWM input only: foc.v_alpha /
+ * foc.v_beta stay the voltage the current loop asked for, which is what the
+ * compensated bridge applies, so the observers keep seeing that.
+ * A leg that was held on a rail in the last period (svpwm.clamp) gets no
+ * compensation: it does not switch, it has no dead time.
+ * Cost: a sqrt, a division, three multiplies and clamps and the Clarke
+ * transform, about 90 cycles.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_pwm.h"
+#include "motor_svpwm.h"
+#include "motor_dtc.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+dtc_t dtc;
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+static int32_t motor_dtc_phase(int32_t i);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init from the dead time TIM1 is running with, enabled; after bsp_pwm_init()
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_dtc_init(void)
+{
+    dtc.enable   = 1;
+    dtc.deadtime = bsp_pwm_deadtime_get();
+    dtc.v_alpha  = 0;
+    dtc.v_beta   = 0;
+    motor_dtc_set((int16_t)(((int32_t)(dtc.deadtime + DTC_DELAY_TICKS) << 14) / SVPWM_GAIN), DTC_I_BAND);
+}
+
+
+/**
+ * @brief enable or disable, can be switched while running
+ * 
+ * @param[in] enable: 1 on, 0 off
+ * @return None
+ */
+void motor_dtc_enable(uint8_t enable)
+{
+    dtc.enable  = enable;
+    dtc.v_alpha = 0;
+    dtc.v_beta  = 0;
+}
+
+
+/**
+ * @brief compensation voltage and polarity band, for tuning on the bench
+ * 
+ * @param[in] v_dt: phase voltage per polarity, q15 of 2/3 Vbus
+ * @param[in] i_band: current of full compensation at zero voltage, q15
+ * @return None
+ */
+void motor_dtc_set(int16_t v_dt, int16_t i_band)
+{
+    dtc.v_dt     = (v_dt < 0) ? 0 : v_dt;
+    dtc.i_band   = (i_band < 1) ? 1 : i_band;
+    dtc.band     = dtc.i_band;
+    dtc.slope_q8 = ((int32_t)dtc.v_dt << 8) / dtc.band;
+}
+
+
+/**
+ * @brief add the compensation to a voltage vector, every pwm period before the SVPWM
+ * 
+ * @param[in] i_alpha: phase current reference, q15
+ * @param[in] i_beta: phase current reference, q15
+ * @param[in,out] v_alpha: q15 of 2/3 Vbus
+ * @param[in,out] v_beta: q15 of 2/3 Vbus
+ * @return None
+ */
+void motor_dtc_apply(int16_t i_alpha, int16_t i_beta, int16_t *v_alpha, int16_t *v_beta)
+{
+    int32_t ib = (-((int32_t)i_alpha << 14) + (int32_t)i_beta * SVPWM_SQRT3_2) >> 15;
+    int32_t ic = -(int32_t)i_alpha - ib;
+    int32_t v_mag = motor_math_sqrt((uint32_t)(*v_alpha * *v_alpha) + (uint32_t)(*v_beta * *v_beta));
+    int32_t va;
+    int32_t vb;
+    int32_t vc;
+
+    /*the ripple grows with the voltage the current loop asks for*/
+    dtc.band     = (int16_t)(dtc.i_band + ((v_mag * DTC_BAND_PER_V) >> 15));
+    dtc.slope_q8 = ((int32_t)dtc.v_dt << 8) / dtc.band;
+
+    va = motor_dtc_phase(i_alpha);
+    vb = motor_dtc_phase(ib);
+    vc = motor_dtc_phase(ic);
+
+    /*a leg held on a rail (discontinuous pwm, overmodulation) has no dead time, as last period*/
+    va = ((svpwm.clamp & 0x01) != 0) ? 0 : va;
+    vb = ((svpwm.clamp & 0x02) != 0) ? 0 : vb;
+    vc = ((svpwm.clamp & 0x04) != 0) ? 0 : vc;
+
+    dtc.v_alpha = (int16_t)(((2 * va - vb - vc) * SVPWM_ONE_THIRD) >> 15);
+    dtc.v_beta  = (int16_t)(((vb - vc) * SVPWM_INV_SQRT3) >> 15);
+    *v_alpha    = Q15_SAT(*v_alpha + dtc.v_alpha);
+    *v_beta     = Q15_SAT(*v_beta + dtc.v_beta);
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief compensation of one phase, linear around zero current
+ * 
+ * @param[in] i: phase current, q15
+ * @return phase voltage, q15 of 2/3 Vbus
+ */
+static int32_t motor_dtc_phase(int32_t i)
+{
+    int32_t v = (i * dtc.slope_q8) >> 8;
+
+    return (v > dtc.v_dt) ? dtc.v_dt : ((v < -dtc.v_dt) ? -dtc.v_dt : v);
+}
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,86 @@
+/**
+ * @file motor_dtc.h
+ * @brief Driver motor_dtc Header
+ * 
+ * @details
+ * Dead time compensation: the voltage lost in the dead time of every phase,
+ * by the polarity of its current, added to the SVPWM input.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_DTC_H__
+#define __MOTOR_DTC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+/* switching delay of the bridge on top of the programmed dead time, counter ticks, calibration */
+#define DTC_DELAY_TICKS                 (0)
+
+/* polarity is linear within +-band around zero current, full compensation outside: the pwm
+   current ripple spreads the diode transition over about its amplitude, |v| * Ts / (4 * L) with
+   L the mean of Ld and Lq, about 0.17A at 3000rpm and 0.02A at 100rpm for this motor at 24V */
+#define DTC_I_BAND                      (Q15(0.01f / MOTOR_I_BASE_A))  // at zero voltage
+#define DTC_BAND_PER_V                  (Q15(MOTOR_TS_S / (2.0f * (MOTOR_LD_H + MOTOR_LQ_H)) * MOTOR_V_BASE_V / MOTOR_I_BASE_A))
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    uint8_t  enable;
+    uint16_t deadtime;              /*counter ticks, read back from TIM1*/
+    int16_t  v_dt;                  /*phase voltage lost per polarity, q15 of 2/3 Vbus*/
+    int16_t  i_band;                /*q15 at zero voltage, > 0*/
+    int16_t  band;                  /*i_band widened by the ripple of the voltage asked for, q15*/
+    int32_t  slope_q8;              /*v_dt / band, q8*/
+    int16_t  v_alpha;               /*compensation of the last period*/
+    int16_t  v_beta;
+}dtc_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern dtc_t dtc;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_dtc_init(void);
+void motor_dtc_enable(uint8_t enable);
+void motor_dtc_set(int16_t v_dt, int16_t i_band);
+void motor_dtc_apply(int16_t i_alpha, int16_t i_beta, int16_t *v_alpha, int16_t *v_beta);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_DTC_H__*/
+
+
+/**
+  * @}
+  */
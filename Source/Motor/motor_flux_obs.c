@@ -0,0 +1,163 @@
+/**
+ * @file motor_flux_obs.c
+ * @brief Non-linear active flux observer
+ * 
+ * @details
+ *   x'   = v - Rs * i + gain * psi * (psi_ref^2 - |psi|^2)
+ *   psi  = x - Lq * i                   (active flux, along the rotor d axis)
+ *   psi_ref = psi_m + (Ld - Lq) * id
+ * The angle is atan2 of the active flux (no filter lag), a PLL on it gives the
+ * speed. Estimated cost about 200 cycles per period.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_flux_obs.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+flux_obs_t flux_obs;
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init the observer
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_flux_obs_init(void)
+{
+    flux_obs.gain = FLUX_OBS_GAIN_DEFAULT;
+    motor_flux_obs_reset(0, 0);
+}
+
+
+/**
+ * @brief restart from a known angle: the integral is loaded with the magnet flux there
+ * 
+ * @param[in] theta: electrical angle
+ * @param[in] speed: angle step per period the PLL starts from
+ * @return None
+ */
+void motor_flux_obs_reset(uint16_t theta, int16_t speed)
+{
+    flux_obs.x_alpha     = ((int32_t)motor_math_cos(theta) * FLUX_OBS_PSI) >> (15 - FLUX_OBS_STATE_SHIFT);
+    flux_obs.x_beta      = ((int32_t)motor_math_sin(theta) * FLUX_OBS_PSI) >> (15 - FLUX_OBS_STATE_SHIFT);
+    flux_obs.psi_alpha   = (int16_t)(flux_obs.x_alpha >> FLUX_OBS_STATE_SHIFT);
+    flux_obs.psi_beta    = (int16_t)(flux_obs.x_beta >> FLUX_OBS_STATE_SHIFT);
+    flux_obs.psi_err     = 0;
+    flux_obs.theta       = theta;
+    flux_obs.theta_pll   = theta;
+    flux_obs.omega_i_q16 = (int32_t)speed << 16;
+    flux_obs.omega_q16   = flux_obs.omega_i_q16;
+    flux_obs.speed       = speed;
+    flux_obs.speed_acc   = (int32_t)speed << FLUX_OBS_SPEED_SHIFT;
+}
+
+
+/**
+ * @brief set the magnitude correction gain, can be changed while running
+ * 
+ * @param[in] gain: q15, fraction of the flux error corrected per period
+ * @return None
+ */
+void motor_flux_obs_gain_set(int16_t gain)
+{
+    flux_obs.gain = (gain < 0) ? 0 : gain;
+}
+
+
+/**
+ * @brief one observer step
+ * 
+ * @param[in] v_alpha: voltage applied during the past period, q15 of 2/3 Vbus
+ * @param[in] v_beta: voltage applied during the past period
+ * @param[in] i_alpha: current measured at the end of the period, q15
+ * @param[in] i_beta: current measured at the end of the period
+ * @return None
+ */
+void motor_flux_obs_update(int16_t v_alpha, int16_t v_beta, int16_t i_alpha, int16_t i_beta)
+{
+    int32_t psi_a;
+    int32_t psi_b;
+    int32_t psi_ref;
+    int32_t id;
+    int32_t err;
+    int32_t mag;
+    int32_t pll;
+
+    /*voltage model integral*/
+    flux_obs.x_alpha += ((int32_t)v_alpha - ((FLUX_OBS_RS * i_alpha) >> 15)) * FLUX_OBS_KV;
+    flux_obs.x_beta  += ((int32_t)v_beta  - ((FLUX_OBS_RS * i_beta)  >> 15)) * FLUX_OBS_KV;
+
+    psi_a = (flux_obs.x_alpha >> FLUX_OBS_STATE_SHIFT) - ((FLUX_OBS_LQ_Q12 * i_alpha) >> 12);
+    psi_b = (flux_obs.x_beta  >> FLUX_OBS_STATE_SHIFT) - ((FLUX_OBS_LQ_Q12 * i_beta)  >> 12);
+    psi_a = Q15_SAT(psi_a);
+    psi_b = Q15_SAT(psi_b);
+
+    /*pull the magnitude onto the reference: x += gain * psi * (ref^2 - |psi|^2),
+      id in the observer's own frame: the control frame may be an open loop one*/
+    id      = (i_alpha * motor_math_cos(flux_obs.theta) + i_beta * motor_math_sin(flux_obs.theta)) >> 15;
+    psi_ref = FLUX_OBS_PSI + ((FLUX_OBS_LDQ_Q12 * id) >> 12);
+    err     = (int32_t)((uint32_t)(psi_ref * psi_ref) >> 15)
+            - (int32_t)(((uint32_t)(psi_a * psi_a) + (uint32_t)(psi_b * psi_b)) >> 15);
+    err     = Q15_SAT(err);
+    flux_obs.x_alpha += (flux_obs.gain * ((psi_a * err) >> 15)) >> (15 - FLUX_OBS_STATE_SHIFT);
+    flux_obs.x_beta  += (flux_obs.gain * ((psi_b * err) >> 15)) >> (15 - FLUX_OBS_STATE_SHIFT);
+
+    flux_obs.psi_alpha = (int16_t)psi_a;
+    flux_obs.psi_beta  = (int16_t)psi_b;
+    flux_obs.psi_err   = (int16_t)err;
+    flux_obs.theta     = motor_math_atan2((int16_t)psi_b, (int16_t)psi_a);
+
+    /*psi = |psi| * (cos, sin): pll error = psi_b * cos - psi_a * sin = |psi| * sin(theta - theta_pll)*/
+    mag = motor_math_sqrt((uint32_t)(psi_a * psi_a) + (uint32_t)(psi_b * psi_b));
+    if(mag > FLUX_OBS_PSI_MIN)
+    {
+        pll = (psi_b * motor_math_cos(flux_obs.theta_pll) - psi_a * motor_math_sin(flux_obs.theta_pll)) >> 15;
+        pll = (pll << 15) / mag;
+    }
+    else
+    {
+        pll = 0;
+    }
+    flux_obs.omega_i_q16 += FLUX_OBS_PLL_KI * pll;
+    flux_obs.omega_q16    = flux_obs.omega_i_q16 + FLUX_OBS_PLL_KP * pll;
+    flux_obs.theta_pll   += (uint16_t)(flux_obs.omega_q16 >> 16);
+
+    flux_obs.speed_acc += (flux_obs.omega_q16 >> 16) - (flux_obs.speed_acc >> FLUX_OBS_SPEED_SHIFT);
+    flux_obs.speed      = (int16_t)(flux_obs.speed_acc >> FLUX_OBS_SPEED_SHIFT);
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
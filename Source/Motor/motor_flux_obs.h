@@ -0,0 +1,104 @@
+/**
+ * @file motor_flux_obs.h
+ * @brief Driver motor_flux_obs Header
+ * 
+ * @details
+ * Non-linear (active) flux observer: the stator flux integral is pulled onto
+ * the expected active flux magnitude, which removes the drift of the pure
+ * integrator and keeps the estimate usable at a few percent of rated speed.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_FLUX_OBS_H__
+#define __MOTOR_FLUX_OBS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+/* flux base: q15 1.0 = 2 * magnet flux, the state is q27 (q15 << 12) */
+#define FLUX_OBS_BASE_WB                (2.0f * MOTOR_FLUX_WB)
+#define FLUX_OBS_STATE_SHIFT            (12)
+#define FLUX_OBS_PSI                    (16384)             // magnet flux, q15
+#define FLUX_OBS_KV                     ((int32_t)(MOTOR_V_BASE_V * MOTOR_TS_S / FLUX_OBS_BASE_WB * 4096.0f + 0.5f))
+#define FLUX_OBS_RS                     ((int32_t)(MOTOR_RS_OHM * MOTOR_I_BASE_A / MOTOR_V_BASE_V * 32768.0f))
+#define FLUX_OBS_LQ_Q12                 ((int32_t)(MOTOR_LQ_H * MOTOR_I_BASE_A / FLUX_OBS_BASE_WB * 4096.0f))
+#define FLUX_OBS_LDQ_Q12                ((int32_t)((MOTOR_LD_H - MOTOR_LQ_H) * MOTOR_I_BASE_A / FLUX_OBS_BASE_WB * 4096.0f))
+
+/* magnitude correction per period, runtime tunable. The d current of the reference is taken
+   on the estimated angle, an angle error moves the reference; the higher the gain the more
+   that pulls at low speed (0.10: 6 degree at 2% of the rated speed, 0.02: 0.3 degree) */
+#define FLUX_OBS_GAIN_DEFAULT           (Q15(0.02))
+
+/* PLL on the flux angle, same scaling as the SMO one */
+#define FLUX_OBS_PLL_BW_HZ              (60.0f)
+#define FLUX_OBS_PLL_WN_TS              (6.2831853f * FLUX_OBS_PLL_BW_HZ * MOTOR_TS_S)
+#define FLUX_OBS_PLL_KP                 ((int32_t)(1.4142136f * FLUX_OBS_PLL_WN_TS * 20860.76f))
+#define FLUX_OBS_PLL_KI                 ((int32_t)(FLUX_OBS_PLL_WN_TS * FLUX_OBS_PLL_WN_TS * 20860.76f + 0.5f))
+#define FLUX_OBS_SPEED_SHIFT            (6)
+#define FLUX_OBS_PSI_MIN                (FLUX_OBS_PSI / 4)  // below: no valid angle yet
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    int32_t  x_alpha;               /*stator flux integral, q27*/
+    int32_t  x_beta;
+    int16_t  psi_alpha;             /*active flux, q15*/
+    int16_t  psi_beta;
+    int16_t  psi_err;               /*target^2 - |psi|^2, q15*/
+    int16_t  gain;                  /*magnitude correction gain, q15*/
+    uint16_t theta;                 /*angle of the active flux*/
+    uint16_t theta_pll;
+    int32_t  omega_q16;
+    int32_t  omega_i_q16;
+    int16_t  speed;                 /*filtered angle step per period*/
+    int32_t  speed_acc;
+}flux_obs_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern flux_obs_t flux_obs;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_flux_obs_init(void);
+void motor_flux_obs_reset(uint16_t theta, int16_t speed);
+void motor_flux_obs_gain_set(int16_t gain);
+void motor_flux_obs_update(int16_t v_alpha, int16_t v_beta, int16_t i_alpha, int16_t i_beta);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_FLUX_OBS_H__*/
+
+
+/**
+  * @}
+  */
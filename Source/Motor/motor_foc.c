@@ -0,0 +1,785 @@
+/**
+ * @file motor_foc.c
+ * @brief Field oriented current loop
+ * 
+ * @details
+ * Clarke -> Park -> PI (d, q) -> voltage circle limit -> inverse Park -> SVPWM,
+ * all in q15/q31 with the CMSIS-DSP inline primitives (arm_clarke_q31,
+ * arm_park_q31, arm_pid_q15, arm_inv_park_q31) and the motor_math sine table.
+ * 
+ * Cycle budget at 20kHz / 108MHz: 5400 cycles per pwm period. Estimated cost of
+ * the interrupt: entry/exit and adc reads 40, Clarke 12, sin/cos 24, Park 16,
+ * two PI 30, circle limit with sqrt 70, inverse Park 16, SVPWM 40: about 250
+ * cycles (under 5%), the SMO + PLL about 250 more, the flux observer about 200,
+ * the injection (only with FOC_THETA_HFI) about 60 plus a division every
+ * HFI_DECIM periods, the field weakening about 150, the dead time
+ * compensation about 60 (with its inverse Park).
+ * The real figures are kept in foc.cycles / foc.cycles_max / foc.smo_cycles /
+ * foc.flux_cycles (DWT).
+ * 
+ * The angle estimators run after the duties are written, with the voltage of
+ * the period that just ended, and give the angle of the next period. Both run
+ * whatever the angle source, so they can be compared on the same data and the
+ * source can be switched without a restart.
+ * 
+ * The PI is the incremental arm_pid_q15; the clamped output is written back to
+ * its state so the integral does not wind up against the voltage limit.
+ * Above base speed motor_fw adds a negative d current from the voltage
+ * magnitude of the period; foc.id_ref / foc.iq_ref stay the application's.
+ * While braking with the bus near its limit motor_regen adds a loss current
+ * on d and cuts the braking q current (the bus sample of the period).
+ * motor_cogging adds its table at the angle to the q reference first, the
+ * limits apply to the sum.
+ * motor_dtc adds the dead time voltage to the SVPWM input, foc.v_alpha /
+ * foc.v_beta are without it.
+ * With overmodulation (motor_foc_ovm_set()) the voltage circle grows to the
+ * limit of the mode, up to six-step, and the weakening target moves with it.
+ * With a single dc link shunt (foc.shunt) motor_single_shunt reconstructs the
+ * phase currents and plans the compares, the pwm interrupts write them.
+ * With three low side shunts the phase of the largest duty, the narrowest low
+ * side window, is left out of the next conversions and follows from the sum
+ * of the other two: one store of a prepared injected sequence after the
+ * duties are written, the conversions of this period are done by then. Only
+ * when the second largest duty is over FOC_SHUNT_DUTY_MAX too (high
+ * modulation at a vertex) are the currents of the last period held.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_pwm.h"
+#include "bsp_adc.h"
+#include "motor_svpwm.h"
+#include "motor_mtpa.h"
+#include "motor_foc.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+foc_t foc;
+
+/* ============================ Static Global Variables ============================ */
+
+/* rank1 = phase U current, rank2 = phase V current, rank3 = Vbus */
+static const uint8_t foc_adc_seq[3] = {ADC_IU_CH, ADC_IV_CH, ADC_VBUS_CH};
+
+/* three shunts, by the phase left out: rank1 / rank2 = the other two in phase order, rank3 = Vbus */
+static const uint8_t foc_adc_seq_three[3][3] =
+{
+    {ADC_IV_CH, ADC_IW_CH, ADC_VBUS_CH},
+    {ADC_IU_CH, ADC_IW_CH, ADC_VBUS_CH},
+    {ADC_IU_CH, ADC_IV_CH, ADC_VBUS_CH},
+};
+
+/* JSEQ images of foc_adc_seq_three, built at the start */
+static uint32_t foc_adc_jseq_three[3];
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief PI coefficients of the incremental arm_pid_q15 (Kd = 0), the state is kept
+ * 
+ * @param[in] pid: the controller
+ * @param[in] kp: q15
+ * @param[in] ki: q15, per pwm period
+ * @return None
+ */
+static void motor_foc_pid_gain_set(arm_pid_instance_q15 *pid, int16_t kp, int16_t ki)
+{
+    pid->Kp = kp;
+    pid->Ki = ki;
+    pid->Kd = 0;
+    pid->A0 = (q15_t)__SSAT((int32_t)kp + ki, 16);
+#if defined (ARM_MATH_DSP)
+    /*packed A1 = (-Kp - 2Kd) | (Kd << 16)*/
+    pid->A1 = (q31_t)(uint16_t)(-kp);
+#else
+    pid->A1 = (q15_t)(-kp);
+    pid->A2 = 0;
+#endif
+}
+
+
+/**
+ * @brief clear the controller history
+ * 
+ * @param[in] pid: the controller
+ * @return None
+ */
+static void motor_foc_pid_reset(arm_pid_instance_q15 *pid)
+{
+    pid->state[0] = 0;
+    pid->state[1] = 0;
+    pid->state[2] = 0;
+}
+
+
+/**
+ * @brief one current loop step on foc.ia / foc.ib at foc.theta, result in foc.duty
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_foc_current_loop(void)
+{
+    q31_t sin_val = (q31_t)motor_math_sin(foc.theta) << 16;
+    q31_t cos_val = (q31_t)motor_math_cos(foc.theta) << 16;
+    q31_t alpha;
+    q31_t beta;
+    q31_t d;
+    q31_t q;
+    int32_t vd;
+    int32_t vq;
+    int32_t vq_max;
+    int32_t v_max  = (svpwm.ovm != SVPWM_OVM_OFF) ? svpwm.v_max : FOC_V_MAX;
+    int32_t id_ref = foc.id_ref;
+    int32_t iq_ref = foc.iq_ref;
+    int16_t v_alpha;
+    int16_t v_beta;
+
+    arm_clarke_q31((q31_t)foc.ia << 16, (q31_t)foc.ib << 16, &alpha, &beta);
+    foc.i_alpha = (int16_t)(alpha >> 16);
+    foc.i_beta  = (int16_t)(beta >> 16);
+    if(foc.theta_src == FOC_THETA_HFI)
+    {
+        /*regulate the carrier free current*/
+        motor_hfi_demod(foc.i_alpha, foc.i_beta);
+        alpha = (q31_t)hfi.i_alpha << 16;
+        beta  = (q31_t)hfi.i_beta << 16;
+    }
+    arm_park_q31(alpha, beta, &d, &q, sin_val, cos_val);
+    foc.id      = (int16_t)(d >> 16);
+    foc.iq      = (int16_t)(q >> 16);
+
+    /*cogging feedforward on the q reference, the angle is the rotor's only in closed loop*/
+    if((cogging.enable != 0) && (foc.theta_src != FOC_THETA_OPEN_LOOP))
+    {
+        iq_ref += motor_cogging_update(foc.theta, foc.iq_ref);
+    }
+
+    /*field weakening: negative d current on top, q limited to what is left of the current vector*/
+    if(fw.enable != 0)
+    {
+        id_ref += fw.id;
+        id_ref  = (id_ref < -fw.i_max) ? -fw.i_max : id_ref;
+        iq_ref  = (iq_ref > fw.iq_max) ? fw.iq_max : ((iq_ref < -fw.iq_max) ? -fw.iq_max : iq_ref);
+    }
+
+    /*bus overvoltage while braking: loss current on d, then less braking current on q*/
+    if(regen.enable != 0)
+    {
+        motor_regen_update(foc.vq, foc.iq, (int16_t)iq_ref);
+        if(regen.braking != 0)
+        {
+            id_ref -= regen.id_loss;
+            id_ref  = (id_ref < -REGEN_I_MAX) ? -REGEN_I_MAX : id_ref;
+            iq_ref  = (iq_ref > regen.iq_max) ? regen.iq_max : ((iq_ref < -regen.iq_max) ? -regen.iq_max : iq_ref);
+        }
+    }
+
+    vd = arm_pid_q15(&foc.pid_d, Q15_SAT(id_ref - foc.id));
+    vq = arm_pid_q15(&foc.pid_q, Q15_SAT(iq_ref - foc.iq));
+
+    /*d axis first, q gets what is left of the circle*/
+    if(vd > v_max)
+    {
+        vd = v_max;
+    }
+    else if(vd < -v_max)
+    {
+        vd = -v_max;
+    }
+    vq_max = motor_math_sqrt((uint32_t)(v_max * v_max) - (uint32_t)(vd * vd));
+    if(vq > vq_max)
+    {
+        vq = vq_max;
+    }
+    else if(vq < -vq_max)
+    {
+        vq = -vq_max;
+    }
+    foc.pid_d.state[2] = (q15_t)vd;
+    foc.pid_q.state[2] = (q15_t)vq;
+    foc.vd = (int16_t)vd;
+    foc.vq = (int16_t)vq;
+    motor_fw_update(foc.vd, foc.vq);
+    if(foc.theta_src == FOC_THETA_HFI)
+    {
+        /*once per period: Q15_SAT() evaluates its argument more than once*/
+        vd += motor_hfi_carrier();
+        vd  = Q15_SAT(vd);
+    }
+
+    arm_inv_park_q31((q31_t)vd << 16, (q31_t)vq << 16, &alpha, &beta, sin_val, cos_val);
+    foc.v_alpha = (int16_t)(alpha >> 16);
+    foc.v_beta  = (int16_t)(beta >> 16);
+    v_alpha     = foc.v_alpha;
+    v_beta      = foc.v_beta;
+
+    /*dead time: polarity of the current reference, only the bridge sees the compensation*/
+    if(dtc.enable != 0)
+    {
+        arm_inv_park_q31((q31_t)id_ref << 16, (q31_t)iq_ref << 16, &alpha, &beta, sin_val, cos_val);
+        motor_dtc_apply((int16_t)(alpha >> 16), (int16_t)(beta >> 16), &v_alpha, &v_beta);
+    }
+
+    motor_svpwm_calc(v_alpha, v_beta, foc.duty);
+
+    /*overmodulated: the estimators get what the clipping left of the vector*/
+    foc.v_alpha = Q15_SAT(foc.v_alpha + svpwm.v_alpha - v_alpha);
+    foc.v_beta  = Q15_SAT(foc.v_beta + svpwm.v_beta - v_beta);
+}
+
+/**
+ * @brief run the estimators and set the angle of the next period
+ * 
+ * @param[in] v_alpha: voltage applied during the period that just ended
+ * @param[in] v_beta: voltage applied during the period that just ended
+ * @return None
+ */
+static void motor_foc_theta_update(int16_t v_alpha, int16_t v_beta)
+{
+    uint32_t start = DWT->CYCCNT;
+
+    motor_smo_update(v_alpha, v_beta, foc.i_alpha, foc.i_beta);
+    foc.smo_cycles = DWT->CYCCNT - start;
+
+    start = DWT->CYCCNT;
+    motor_flux_obs_update(v_alpha, v_beta, foc.i_alpha, foc.i_beta);
+    foc.flux_cycles = DWT->CYCCNT - start;
+
+    switch(foc.theta_src)
+    {
+        case FOC_THETA_SMO:
+            foc.theta = (uint16_t)(smo.theta + smo.speed);
+            break;
+
+        case FOC_THETA_FLUX:
+            foc.theta = (uint16_t)(flux_obs.theta + flux_obs.speed);
+            break;
+
+        case FOC_THETA_HFI:
+            foc.theta = hfi.theta;
+            break;
+
+        default:
+            foc.theta += (uint16_t)((foc.dir == MOTOR_DIR_CW) ? foc.theta_inc : -foc.theta_inc);
+            break;
+    }
+}
+
+
+/**
+ * @brief three shunts: leave a phase out of the conversions from the next trigger on
+ * 
+ * @param[in] skip: PHASE_U, PHASE_V or PHASE_W
+ * @return None
+ */
+static void motor_foc_three_shunt_load(uint8_t skip)
+{
+    ADC_INJ_SEQ_LOAD(foc_adc_jseq_three[skip]);
+    foc.shunt_skip = skip;
+}
+
+
+/**
+ * @brief three shunts: foc.ia / foc.ib from the two phases sampled, held if their windows were too narrow
+ * 
+ * @param[in] raw_1: adc counts of rank 1
+ * @param[in] raw_2: adc counts of rank 2
+ * @return None
+ */
+static void motor_foc_three_shunt_currents(uint16_t raw_1, uint16_t raw_2)
+{
+    int32_t i_1;
+    int32_t i_2;
+
+    if(foc.shunt_valid == 0)
+    {
+        foc.shunt_hold_cnt++;
+        return;
+    }
+
+    switch(foc.shunt_skip)
+    {
+        case PHASE_U:
+            i_1    = Q15_SAT(((int32_t)foc.offset_b - raw_1) << FOC_CURRENT_SHIFT);
+            i_2    = Q15_SAT(((int32_t)foc.offset_c - raw_2) << FOC_CURRENT_SHIFT);
+            foc.ia = Q15_SAT(-i_1 - i_2);
+            foc.ib = (int16_t)i_1;
+            break;
+
+        case PHASE_V:
+            i_1    = Q15_SAT(((int32_t)foc.offset_a - raw_1) << FOC_CURRENT_SHIFT);
+            i_2    = Q15_SAT(((int32_t)foc.offset_c - raw_2) << FOC_CURRENT_SHIFT);
+            foc.ia = (int16_t)i_1;
+            foc.ib = Q15_SAT(-i_1 - i_2);
+            break;
+
+        default:
+            foc.ia = Q15_SAT(((int32_t)foc.offset_a - raw_1) << FOC_CURRENT_SHIFT);
+            foc.ib = Q15_SAT(((int32_t)foc.offset_b - raw_2) << FOC_CURRENT_SHIFT);
+            break;
+    }
+}
+
+
+/**
+ * @brief three shunts: the phase of the largest duty of foc.duty is left out of the next conversions
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_foc_three_shunt_select(void)
+{
+    const uint16_t *d = foc.duty;
+    uint8_t hi = (d[PHASE_U] >= d[PHASE_V]) ? PHASE_U : PHASE_V;
+    uint8_t p_1;
+    uint8_t p_2;
+
+    hi  = (d[PHASE_W] > d[hi]) ? PHASE_W : hi;
+    p_1 = (hi == PHASE_U) ? PHASE_V : PHASE_U;
+    p_2 = (uint8_t)(PHASE_U + PHASE_V + PHASE_W - hi - p_1);
+    foc.shunt_valid = (uint8_t)((d[p_1] <= FOC_SHUNT_DUTY_MAX) && (d[p_2] <= FOC_SHUNT_DUTY_MAX));
+    if(hi != foc.shunt_skip)
+    {
+        motor_foc_three_shunt_load(hi);
+    }
+}
+
+
+/**
+ * @brief current offsets with the outputs off, then the loop; three shunts take a second
+ *        round with U left out for the offset of W
+ * 
+ * @param[in] raw_1: adc counts of rank 1
+ * @param[in] raw_2: adc counts of rank 2
+ * @return None
+ */
+static void motor_foc_offset_update(uint16_t raw_1, uint16_t raw_2)
+{
+    if(foc.offset_cnt < FOC_OFFSET_SAMPLES)
+    {
+        foc.offset_acc_a += raw_1;
+        foc.offset_acc_b += raw_2;
+    }
+    else
+    {
+        foc.offset_acc_c += raw_2;
+    }
+
+    if(++foc.offset_cnt == FOC_OFFSET_SAMPLES)
+    {
+        foc.offset_a = (uint16_t)(foc.offset_acc_a >> FOC_OFFSET_SHIFT);
+        foc.offset_b = (uint16_t)(foc.offset_acc_b >> FOC_OFFSET_SHIFT);
+        if(foc.shunt == FOC_SHUNT_THREE)
+        {
+            motor_foc_three_shunt_load(PHASE_U);
+            return;
+        }
+    }
+    else if(foc.offset_cnt == 2 * FOC_OFFSET_SAMPLES)
+    {
+        foc.offset_c = (uint16_t)(foc.offset_acc_c >> FOC_OFFSET_SHIFT);
+    }
+    else
+    {
+        return;
+    }
+
+    foc.state = FOC_STATE_RUN;
+    bsp_pwm_output_enable(ENABLE);
+}
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init the current loop, enables the DWT cycle counter for the budget measurement
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_foc_init(void)
+{
+    foc.state      = FOC_STATE_IDLE;
+    foc.theta_src  = FOC_THETA_OPEN_LOOP;
+    foc.dir        = MOTOR_DIR_CW;
+    foc.id_ref     = 0;
+    foc.iq_ref     = 0;
+    foc.theta      = 0;
+    foc.theta_inc  = 0;
+    foc.cycles     = 0;
+    foc.cycles_max = 0;
+    motor_foc_pid_gain_set(&foc.pid_d, FOC_ID_KP, FOC_ID_KI);
+    motor_foc_pid_gain_set(&foc.pid_q, FOC_IQ_KP, FOC_IQ_KI);
+    motor_smo_init();
+    motor_flux_obs_init();
+    motor_hfi_init();
+    motor_fw_init();
+    motor_dtc_init();
+    motor_regen_init();
+    motor_cogging_init();
+    motor_single_shunt_init();
+    motor_foc_shunt_set(FOC_SHUNT_DEFAULT);
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+
+/**
+ * @brief start: current offsets with the outputs off, then the loop with all phases chopping
+ * 
+ * @param[in] dir: rotation direction, sets the sign of the open loop angle step
+ * @return None
+ */
+void motor_foc_start(motor_dir_e dir)
+{
+    uint8_t i;
+
+    bsp_pwm_output_enable(DISABLE);
+
+    foc.dir          = dir;
+    foc.offset_acc_a = 0;
+    foc.offset_acc_b = 0;
+    foc.offset_acc_c = 0;
+    foc.offset_cnt   = 0;
+    motor_foc_pid_reset(&foc.pid_d);
+    motor_foc_pid_reset(&foc.pid_q);
+    motor_smo_reset(foc.theta, 0);
+    motor_flux_obs_reset(foc.theta, 0);
+    motor_hfi_reset(foc.theta);
+    motor_fw_reset();
+    motor_regen_reset();
+    foc.v_alpha = 0;
+    foc.v_beta  = 0;
+
+    PWM_DUTY_SET(SVPWM_HALF, SVPWM_HALF, SVPWM_HALF);
+    bsp_pwm_complementary_mode();
+    if(foc.shunt == FOC_SHUNT_SINGLE)
+    {
+        motor_single_shunt_start();
+    }
+    else if(foc.shunt == FOC_SHUNT_THREE)
+    {
+        /*the bus is on rank 3 of all three images: loaded once so adc_vbus_rank follows*/
+        bsp_adc_inj_seq_set(foc_adc_seq_three[PHASE_W], 3);
+        for(i = 0; i < 3; i++)
+        {
+            foc_adc_jseq_three[i] = bsp_adc_inj_seq_image(foc_adc_seq_three[i], 3);
+        }
+        foc.shunt_valid    = 1;
+        foc.shunt_hold_cnt = 0;
+        motor_foc_three_shunt_load(PHASE_W);
+        bsp_pwm_adc_trig_select(PWM_ADC_TRIG_LOW_SIDE);
+    }
+    else
+    {
+        bsp_adc_inj_seq_set(foc_adc_seq, 3);
+        bsp_pwm_adc_trig_select(PWM_ADC_TRIG_LOW_SIDE);
+    }
+
+    foc.state = FOC_STATE_OFFSET;
+}
+
+
+/**
+ * @brief stop, all phases off
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_foc_stop(void)
+{
+    foc.state = FOC_STATE_IDLE;
+    motor_six_step_stop();
+    motor_regen_reset();
+    motor_cogging_reset();
+    if(foc.shunt == FOC_SHUNT_SINGLE)
+    {
+        motor_single_shunt_stop();
+    }
+}
+
+
+/**
+ * @brief set the current references
+ * 
+ * @param[in] id_ref: q15
+ * @param[in] iq_ref: q15
+ * @return None
+ */
+void motor_foc_current_ref_set(int16_t id_ref, int16_t iq_ref)
+{
+    foc.id_ref = id_ref;
+    foc.iq_ref = iq_ref;
+}
+
+
+/**
+ * @brief set the references from a torque request along the MTPA curve
+ * 
+ * @param[in] torque: torque equivalent current (q current giving it with id = 0), q15
+ * @return None
+ */
+void motor_foc_torque_ref_set(int16_t torque)
+{
+    motor_mtpa_ref(torque, &foc.id_ref, &foc.iq_ref);
+}
+
+
+/**
+ * @brief set the d and q current PI gains, can be changed while running: both axes in one
+ *        masked section, no current loop period runs with mixed gains
+ * 
+ * @param[in] kp_d: q15 of 2/3 Vbus per q15 current
+ * @param[in] ki_d: same unit, per pwm period
+ * @param[in] kp_q: as kp_d, q axis
+ * @param[in] ki_q: as ki_d, q axis
+ * @return None
+ */
+void motor_foc_current_pi_set(int16_t kp_d, int16_t ki_d, int16_t kp_q, int16_t ki_q)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    motor_foc_pid_gain_set(&foc.pid_d, kp_d, ki_d);
+    motor_foc_pid_gain_set(&foc.pid_q, kp_q, ki_q);
+    __set_PRIMASK(primask);
+}
+
+
+/**
+ * @brief set the electrical angle (sensor or estimator), used by the next period
+ * 
+ * @param[in] theta: 0 ~ 65535 = 0 ~ 360 degree
+ * @return None
+ */
+void motor_foc_theta_set(uint16_t theta)
+{
+    foc.theta = theta;
+}
+
+
+/**
+ * @brief speed of the angle source in use
+ * 
+ * @param[in] None
+ * @return angle step per pwm period, negative turning backwards
+ */
+int16_t motor_foc_speed(void)
+{
+    switch(foc.theta_src)
+    {
+        case FOC_THETA_SMO:
+            return smo.speed;
+
+        case FOC_THETA_FLUX:
+            return flux_obs.speed;
+
+        case FOC_THETA_HFI:
+            return hfi.speed;
+
+        default:
+            return (foc.dir == MOTOR_DIR_CW) ? foc.theta_inc : (int16_t)-foc.theta_inc;
+    }
+}
+
+
+/**
+ * @brief jump to another angle keeping the output voltage: the PI outputs are rotated into the new frame
+ * 
+ * @param[in] theta: new angle
+ * @return None
+ */
+void motor_foc_frame_shift(uint16_t theta)
+{
+    uint16_t delta = (uint16_t)(theta - foc.theta);
+    int32_t  s     = motor_math_sin(delta);
+    int32_t  c     = motor_math_cos(delta);
+    int32_t  vd    = foc.pid_d.state[2];
+    int32_t  vq    = foc.pid_q.state[2];
+
+    foc.pid_d.state[2] = (q15_t)((vd * c + vq * s) >> 15);
+    foc.pid_q.state[2] = (q15_t)((vq * c - vd * s) >> 15);
+    foc.theta          = theta;
+}
+
+
+/**
+ * @brief open loop angle step added every pwm period, 0 when the angle comes from outside
+ * 
+ * @param[in] theta_inc: angle per pwm period, positive for CW
+ * @return None
+ */
+void motor_foc_theta_inc_set(int16_t theta_inc)
+{
+    foc.theta_inc = theta_inc;
+}
+
+
+/**
+ * @brief select where the angle comes from, can be switched while running
+ * 
+ * @param[in] src: angle source
+ * @return None
+ */
+void motor_foc_theta_src_set(foc_theta_src_e src)
+{
+    if(src < FOC_THETA_MAX)
+    {
+        if((src == FOC_THETA_HFI) && (foc.theta_src != FOC_THETA_HFI))
+        {
+            /*the tracker starts where the angle is now, that also fixes the polarity*/
+            motor_hfi_reset(foc.theta);
+        }
+        foc.theta_src = src;
+    }
+}
+
+
+/**
+ * @brief overmodulation mode, can be switched while running: the voltage circle becomes the
+ *        limit of the mode and the weakening target keeps its headroom under it
+ * 
+ * @param[in] ovm: SVPWM_OVM_OFF, SVPWM_OVM_I or SVPWM_OVM_II
+ * @return None
+ */
+void motor_foc_ovm_set(svpwm_ovm_e ovm)
+{
+    if(ovm < SVPWM_OVM_MAX)
+    {
+        motor_svpwm_ovm_set(ovm);
+        motor_fw_limits_set((int16_t)(((ovm != SVPWM_OVM_OFF) ? svpwm.v_max : FOC_V_MAX) - (FOC_V_MAX - FW_V_REF)),
+                            fw.id_min, fw.i_max);
+    }
+}
+
+
+/**
+ * @brief current sensing of the board, only while stopped
+ * 
+ * @param[in] shunt: FOC_SHUNT_TWO, FOC_SHUNT_SINGLE or FOC_SHUNT_THREE
+ * @return None
+ */
+void motor_foc_shunt_set(foc_shunt_e shunt)
+{
+    if((foc.state == FOC_STATE_IDLE) && (shunt < FOC_SHUNT_MAX))
+    {
+        foc.shunt = shunt;
+        /*the other modes sample whatever phase is held high*/
+        motor_svpwm_shunt_phases_set((shunt == FOC_SHUNT_TWO) ? SVPWM_SHUNT_PHASES : 0);
+    }
+}
+
+
+/**
+ * @brief adc injected end of conversion: rank1 = Iu, rank2 = Iv, rank3 = Vbus,
+ *        single shunt rank1 = Vbus, rank2 / rank3 = the bus current in window 1 / 2,
+ *        three shunts rank1 / rank2 = the two phases sampled, rank3 = Vbus
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_foc_adc_isr(void)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint16_t raw_a;
+    uint16_t raw_b;
+    int16_t v_alpha = foc.v_alpha;
+    int16_t v_beta  = foc.v_beta;
+
+    if(foc.shunt == FOC_SHUNT_SINGLE)
+    {
+        foc.vbus = ADC_INJ_DAT1();
+        raw_a    = ADC_INJ_DAT2();
+        raw_b    = ADC_INJ_DAT3();
+    }
+    else
+    {
+        raw_a    = ADC_INJ_DAT1();
+        raw_b    = ADC_INJ_DAT2();
+        foc.vbus = ADC_INJ_DAT3();
+    }
+
+    if(foc.state == FOC_STATE_OFFSET)
+    {
+        motor_foc_offset_update(raw_a, raw_b);
+        return;
+    }
+    if(foc.state != FOC_STATE_RUN)
+    {
+        return;
+    }
+
+    if(foc.shunt == FOC_SHUNT_SINGLE)
+    {
+        /*the bus amplifier output rises with the current drawn from the supply*/
+        motor_single_shunt_currents(Q15_SAT(((int32_t)raw_a - foc.offset_a) << FOC_CURRENT_SHIFT),
+                                    Q15_SAT(((int32_t)raw_b - foc.offset_b) << FOC_CURRENT_SHIFT), &foc.ia, &foc.ib);
+        motor_foc_current_loop();
+        motor_single_shunt_plan(foc.duty);
+    }
+    else if(foc.shunt == FOC_SHUNT_THREE)
+    {
+        motor_foc_three_shunt_currents(raw_a, raw_b);
+        motor_foc_current_loop();
+        PWM_DUTY_SET(foc.duty[0], foc.duty[1], foc.duty[2]);
+        motor_foc_three_shunt_select();
+    }
+    else
+    {
+        /*the shunt amplifier output falls for a positive (outgoing) phase current*/
+        foc.ia = Q15_SAT(((int32_t)foc.offset_a - raw_a) << FOC_CURRENT_SHIFT);
+        foc.ib = Q15_SAT(((int32_t)foc.offset_b - raw_b) << FOC_CURRENT_SHIFT);
+        motor_foc_current_loop();
+        PWM_DUTY_SET(foc.duty[0], foc.duty[1], foc.duty[2]);
+    }
+    motor_foc_theta_update(v_alpha, v_beta);
+
+    foc.cycles = DWT->CYCCNT - start;
+    if(foc.cycles > foc.cycles_max)
+    {
+        foc.cycles_max = foc.cycles;
+    }
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+/**
+ * @brief one current loop step on given phase currents, for the comparison with a float model
+ * 
+ * @param[in] ia: phase U current, q15
+ * @param[in] ib: phase V current, q15
+ * @return None
+ */
+void motor_foc_step(int16_t ia, int16_t ib)
+{
+    foc.ia = ia;
+    foc.ib = ib;
+    motor_foc_current_loop();
+}
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
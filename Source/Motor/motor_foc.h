@@ -0,0 +1,171 @@
+/**
+ * @file motor_foc.h
+ * @brief Driver motor_foc Header
+ * 
+ * @details
+ * Field oriented current loop in q15/q31, run from the adc injected interrupt
+ * (currents sampled in the middle of the low side on-time). Currents are q15 of
+ * the adc full scale, voltages q15 of 2/3 Vbus, angles uint16_t electrical.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_FOC_H__
+#define __MOTOR_FOC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "arm_math.h"
+#include "motor_six_step.h"
+#include "motor_math.h"
+#include "motor_smo.h"
+#include "motor_flux_obs.h"
+#include "motor_hfi.h"
+#include "motor_fw.h"
+#include "motor_dtc.h"
+#include "motor_regen.h"
+#include "motor_cogging.h"
+#include "motor_svpwm.h"
+#include "motor_single_shunt.h"
+
+/* ============================ Public Constants ============================ */
+
+#define FOC_CURRENT_SHIFT               (4)                 // 12bit adc offset removed -> q15
+#define FOC_OFFSET_SHIFT                (8)
+#define FOC_OFFSET_SAMPLES              (1 << FOC_OFFSET_SHIFT)
+
+#define FOC_V_MAX                       (Q15(0.95f * MOTOR_V_LINEAR))   // voltage circle, leaves room for the deadtime
+#define FOC_ID_KP                       (Q15(0.30f * MOTOR_V_LINEAR))
+#define FOC_ID_KI                       (Q15(0.02f * MOTOR_V_LINEAR))
+#define FOC_IQ_KP                       (Q15(0.30f * MOTOR_V_LINEAR))
+#define FOC_IQ_KI                       (Q15(0.02f * MOTOR_V_LINEAR))
+
+/* current sensing of the board, motor_foc_shunt_set() while stopped */
+#define FOC_SHUNT_DEFAULT               FOC_SHUNT_TWO
+
+/* largest duty whose low side window holds the sample at the counter peak:
+   the low side turns on a dead time after the compare, then rings like the bus current */
+#define FOC_SHUNT_DUTY_MAX              (PWM_PERIOD_MAX - PWM_ADC_TRIG_ADVANCE - SINGLE_SHUNT_T_RISE)
+
+/* ============================ Code Enum Definitions ============================ */
+
+typedef enum
+{
+    FOC_STATE_IDLE = 0,
+    FOC_STATE_OFFSET,                   /*outputs off, current offsets averaged*/
+    FOC_STATE_RUN,
+}foc_state_e;
+
+typedef enum
+{
+    FOC_THETA_OPEN_LOOP = 0,            /*foc.theta_inc every period, or motor_foc_theta_set()*/
+    FOC_THETA_SMO,                      /*sliding mode observer + PLL*/
+    FOC_THETA_FLUX,                     /*non-linear active flux observer*/
+    FOC_THETA_HFI,                      /*high frequency injection, standstill and low speed*/
+    FOC_THETA_MAX,
+}foc_theta_src_e;
+
+typedef enum
+{
+    FOC_SHUNT_TWO = 0,                  /*low side shunts of U and V, sampled at the counter peak*/
+    FOC_SHUNT_SINGLE,                   /*dc link shunt, two samples per period, motor_single_shunt*/
+    FOC_SHUNT_THREE,                    /*low side shunts of all phases, the two widest low side windows sampled*/
+    FOC_SHUNT_MAX,
+}foc_shunt_e;
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    foc_state_e          state;
+    foc_theta_src_e      theta_src;
+    foc_shunt_e          shunt;
+    motor_dir_e          dir;
+    uint16_t             offset_a;
+    uint16_t             offset_b;
+    uint16_t             offset_c;          /*three shunts only*/
+    uint32_t             offset_acc_a;
+    uint32_t             offset_acc_b;
+    uint32_t             offset_acc_c;
+    uint16_t             offset_cnt;
+    uint8_t              shunt_skip;        /*three shunts: phase left out of the conversions in flight*/
+    uint8_t              shunt_valid;       /*three shunts: both sampled low side windows wide enough*/
+    uint32_t             shunt_hold_cnt;    /*three shunts: periods the currents were held*/
+    uint16_t             vbus;              /*adc counts*/
+    int16_t              ia;
+    int16_t              ib;
+    int16_t              i_alpha;
+    int16_t              i_beta;
+    int16_t              id;
+    int16_t              iq;
+    int16_t              id_ref;
+    int16_t              iq_ref;
+    int16_t              vd;
+    int16_t              vq;
+    int16_t              v_alpha;
+    int16_t              v_beta;
+    uint16_t             theta;             /*electrical angle used by the transforms*/
+    int16_t              theta_inc;         /*open loop angle step per pwm period*/
+    uint16_t             duty[3];
+    arm_pid_instance_q15 pid_d;
+    arm_pid_instance_q15 pid_q;
+    uint32_t             cycles;            /*last interrupt, cpu cycles*/
+    uint32_t             cycles_max;
+    uint32_t             smo_cycles;        /*estimator share of cycles, both run side by side*/
+    uint32_t             flux_cycles;
+}foc_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern foc_t foc;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_foc_init(void);
+void motor_foc_start(motor_dir_e dir);
+void motor_foc_stop(void);
+void motor_foc_current_ref_set(int16_t id_ref, int16_t iq_ref);
+void motor_foc_torque_ref_set(int16_t torque);
+void motor_foc_current_pi_set(int16_t kp_d, int16_t ki_d, int16_t kp_q, int16_t ki_q);
+void motor_foc_theta_set(uint16_t theta);
+int16_t motor_foc_speed(void);
+void motor_foc_frame_shift(uint16_t theta);
+void motor_foc_theta_inc_set(int16_t theta_inc);
+void motor_foc_theta_src_set(foc_theta_src_e src);
+void motor_foc_ovm_set(svpwm_ovm_e ovm);
+void motor_foc_shunt_set(foc_shunt_e shunt);
+void motor_foc_adc_isr(void);
+
+#ifdef UNIT_TEST
+void motor_foc_step(int16_t ia, int16_t ib);
+#endif /* UNIT_TEST */
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_FOC_H__*/
+
+
+/**
+  * @}
+  */
@@ -0,0 +1,187 @@
+/**
+ * @file motor_fw.c
+ * @brief Field weakening from the voltage vector magnitude
+ * 
+ * @details
+ * Runs every pwm period in the current loop on the limited vd / vq of the
+ * period. While |v| stays above v_ref the integrator pushes id negative,
+ * below it id goes back to 0:
+ *   id += ki * (v_ref - |v|), at most id_slew per period, clamped to [id_min, 0]
+ * The clamp is the anti-windup: the integrator never runs past what is applied.
+ * The slew limit bounds the transition, a bus sag raises |v| at once (the
+ * voltages are fractions of the actual bus) and id follows at a bounded rate
+ * while the circle limit, d axis first, holds the current loop.
+ * The q reference is limited to sqrt(i_max^2 - id^2) so the weakening current
+ * does not push the vector over the current limit.
+ * The loop gain d|v| / d(id) is w * Ld, it grows with the speed the weakening
+ * is for, and once the q reference is on its limit a deeper id also takes q
+ * current (and w * Lq * iq of vd) away: 1.6x the base speed of 24V on a bus
+ * sagged to 20V, on the q limit, has about 8 times the gain of the onset and
+ * id went into a limit cycle at 7Hz. The step is scaled by iq_max^2 / i_max^2
+ * of the last period, 1 at the onset, down to FW_GAIN_MIN at the deepest id
+ * (Tools/motor_fw_sim.c).
+ * Cost: two sqrt, one division and a few multiplies, about 170 cycles.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_fw.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+fw_t fw;
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init with the default limits, enabled: nothing happens below base speed
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_fw_init(void)
+{
+    fw.enable      = 1;
+    fw.v_ref       = FW_V_REF;
+    fw.ki          = FW_KI;
+    fw.id_min      = FW_ID_MIN;
+    fw.i_max       = FW_I_MAX;
+    fw.id_slew_q16 = FW_ID_SLEW_Q16;
+    motor_fw_reset();
+}
+
+
+/**
+ * @brief back to no weakening, at every start
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_fw_reset(void)
+{
+    fw.id_q16 = 0;
+    fw.id     = 0;
+    fw.iq_max = fw.i_max;
+    fw.v_mag  = 0;
+}
+
+
+/**
+ * @brief enable or disable, disabling drops the weakening current at once
+ * 
+ * @param[in] enable: 1 on, 0 off
+ * @return None
+ */
+void motor_fw_enable(uint8_t enable)
+{
+    fw.enable = enable;
+    if(enable == 0)
+    {
+        motor_fw_reset();
+    }
+}
+
+
+/**
+ * @brief change the limits, can be changed while running
+ * 
+ * @param[in] v_ref: |v| kept below, q15 of 2/3 Vbus
+ * @param[in] id_min: deepest weakening current, q15 (negative)
+ * @param[in] i_max: current vector limit, q15
+ * @return None
+ */
+void motor_fw_limits_set(int16_t v_ref, int16_t id_min, int16_t i_max)
+{
+    fw.v_ref  = v_ref;
+    fw.id_min = (id_min > 0) ? (int16_t)-id_min : id_min;
+    fw.i_max  = i_max;
+}
+
+
+/**
+ * @brief one step on the voltage just applied, gives fw.id and fw.iq_max for the next period
+ * 
+ * @param[in] vd: limited d voltage of the period, q15
+ * @param[in] vq: limited q voltage of the period, q15
+ * @return None
+ */
+void motor_fw_update(int16_t vd, int16_t vq)
+{
+    int32_t step;
+    int32_t scale;
+    int32_t id_min_q16 = (int32_t)fw.id_min << 16;
+
+    fw.v_mag = (int16_t)motor_math_sqrt((uint32_t)(vd * vd) + (uint32_t)(vq * vq));
+    if(fw.enable == 0)
+    {
+        return;
+    }
+
+    /*q15 * q15 = q30, as q15 << 16 = q31*/
+    step = ((int32_t)fw.ki * ((int32_t)fw.v_ref - fw.v_mag)) << 1;
+
+    /*the loop gain grows with the depth, iq_max^2 / i_max^2 takes it back*/
+    scale = ((int32_t)fw.iq_max * fw.iq_max) / ((((int32_t)fw.i_max * fw.i_max) >> 15) + 1);
+    scale = (scale < FW_GAIN_MIN) ? FW_GAIN_MIN : scale;
+    step  = (int32_t)(((int64_t)step * scale) >> 15);
+
+    if(step > fw.id_slew_q16)
+    {
+        step = fw.id_slew_q16;
+    }
+    else if(step < -fw.id_slew_q16)
+    {
+        step = -fw.id_slew_q16;
+    }
+
+    fw.id_q16 += step;
+    if(fw.id_q16 > 0)
+    {
+        fw.id_q16 = 0;
+    }
+    else if(fw.id_q16 < id_min_q16)
+    {
+        fw.id_q16 = id_min_q16;
+    }
+    fw.id = (int16_t)(fw.id_q16 >> 16);
+
+    if(-fw.id >= fw.i_max)
+    {
+        fw.iq_max = 0;
+    }
+    else
+    {
+        fw.iq_max = (int16_t)motor_math_sqrt((uint32_t)(fw.i_max * fw.i_max) - (uint32_t)(fw.id * fw.id));
+    }
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
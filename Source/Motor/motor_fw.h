@@ -0,0 +1,94 @@
+/**
+ * @file motor_fw.h
+ * @brief Driver motor_fw Header
+ * 
+ * @details
+ * Field weakening: negative id from the voltage vector magnitude at the
+ * circle limit, for speeds above the base speed of the bus.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_FW_H__
+#define __MOTOR_FW_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+#define FW_V_REF                        (Q15(0.90f * MOTOR_V_LINEAR))   // |v| kept below, under FOC_V_MAX so the current loop keeps some headroom
+#define FW_I_MAX                        (Q15(MOTOR_RATED_CURRENT_A / MOTOR_I_BASE_A))   // |i| with the weakening current
+#define FW_ID_MIN                       (Q15(-MOTOR_RATED_CURRENT_A / MOTOR_I_BASE_A))  // deepest weakening current
+
+/* integrator: loop gain d|v| / d(id) = w * Ld at base speed, about 0.58 pu; crossover well
+   under the current loop, 50Hz already beats against it above 1.3x base speed */
+#define FW_BW_HZ                        (7.0f)
+#define FW_KI                           (Q15(6.2831853f * FW_BW_HZ * MOTOR_TS_S / 0.58f))
+#define FW_GAIN_MIN                     (Q15(0.125f))                   // least step scale at depth, id still comes back from id_min
+
+/* bounded transition: id moves at most from 0 to FW_ID_MIN in 20ms, also on a bus sag */
+#define FW_SLEW_PERIODS                 (400)
+#define FW_ID_SLEW_Q16                  ((int32_t)(MOTOR_RATED_CURRENT_A / MOTOR_I_BASE_A * 32767.0f * 65536.0f / FW_SLEW_PERIODS))
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    uint8_t  enable;
+    int16_t  v_ref;                 /*q15 of 2/3 Vbus*/
+    int16_t  ki;                    /*id per voltage error per period, q15*/
+    int16_t  id_min;                /*q15, negative*/
+    int16_t  i_max;                 /*q15*/
+    int32_t  id_slew_q16;           /*largest id change per period*/
+    int32_t  id_q16;                /*integrator, clamped to [id_min, 0]*/
+    int16_t  id;                    /*weakening current added to the d reference*/
+    int16_t  iq_max;                /*q reference limit left by the weakening current*/
+    int16_t  v_mag;                 /*|v| of the last period*/
+}fw_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern fw_t fw;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_fw_init(void);
+void motor_fw_reset(void);
+void motor_fw_enable(uint8_t enable);
+void motor_fw_limits_set(int16_t v_ref, int16_t id_min, int16_t i_max);
+void motor_fw_update(int16_t vd, int16_t vq);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_FW_H__*/
+
+
+/**
+  * @}
+  */
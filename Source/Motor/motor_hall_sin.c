@@ -0,0 +1,327 @@
+/**
+ * @file motor_hall_sin.c
+ * @brief Hall interpolated sinusoidal drive with six-step fallback
+ * 
+ * @details
+ * The hall timer counter restarts on every hall edge and captures the
+ * interval before it (taken by motor_hall_speed in the capture interrupt,
+ * which preempts the COM interrupt, so it is always handled first), the
+ * edge also fires the TIM1 COM interrupt. So the angle is known at every
+ * edge (the sector boundary) and the counter is the time since that edge:
+ *   edge:   theta_edge = boundary + offset, rate = 60 degree / interval (the only division)
+ *   period: theta = theta_edge +- min(cnt * rate, 60 degree)
+ * The interval is the one of the motor_hall_speed snapshot, the first edge
+ * after a stall has none (0): then the speed is unknown, the rate is 0 and the
+ * angle is held at the edge. A glitch edge (a bounce, merged by
+ * motor_hall_speed) is not an edge here: it restarted the counter, so the
+ * time merged so far is added to it.
+ * The clamp keeps the angle in the sector when the motor slows down, the next
+ * edge corrects what the last interval got wrong. Per pwm period this is one
+ * multiply, the sin / cos table lookup and the SVPWM, no division.
+ * 
+ * The voltage vector is v_ref at 90 degree + advance ahead of the d axis in
+ * the running direction, open loop voltage drive as the six-step duty.
+ * 
+ * The six-step engine starts the motor. After HALL_SIN_ENTER_EDGES edges in
+ * the running direction faster than the enter speed the drive switches to
+ * sinusoidal at an edge, where the angle is exact. It falls back to six-step
+ * on an edge slower than the exit speed, no edge for that long (stall), an
+ * edge against the direction or an invalid hall state. The six-step duty
+ * gives the same fundamental line voltage, so the torque carries over.
+ * 
+ * Hall state to angle, alpha axis on phase U as the FOC modes
+ * (see motor_six_step_angle_sector()): sector k covers -30 + 60 * k degree,
+ *   sector 0 1 2 3 4 5
+ *   hall   6 2 3 1 5 4
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_pwm.h"
+#include "bsp_hall.h"
+#include "motor_svpwm.h"
+#include "motor_hall_speed.h"
+#include "motor_hall_sin.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define HALL_SIN_SECTOR0_THETA          ((uint16_t)(65536 - HALL_SIN_SECTOR / 2))   // -30 degree
+#define HALL_SIN_LEAD_Q                 (16384)                                     // 90 degree
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+hall_sin_t hall_sin;
+
+/* ============================ Static Global Variables ============================ */
+
+static const uint8_t hall_sin_sector_of_hall[SIX_STEP_HALL_STATES] =
+{
+    HALL_SIN_SECTOR_INVALID, 3, 1, 2, 5, 4, 0, HALL_SIN_SECTOR_INVALID
+};
+
+/* sector step of an edge in the running direction */
+static const uint8_t hall_sin_forward_step[MOTOR_DIR_MAX] = {1, SIX_STEP_SECTORS - 1};
+
+/* ============================ Static Function Declarations ============================ */
+
+static void motor_hall_sin_output(uint16_t theta);
+static void motor_hall_sin_enter(void);
+static void motor_hall_sin_fallback(void);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init, motor stopped
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_hall_sin_init(void)
+{
+    hall_sin.state        = HALL_SIN_STATE_IDLE;
+    hall_sin.dir          = MOTOR_DIR_CW;
+    hall_sin.sector       = HALL_SIN_SECTOR_INVALID;
+    hall_sin.edge_cnt     = 0;
+    hall_sin.v_ref        = 0;
+    hall_sin.sine_cnt     = 0;
+    hall_sin.fallback_cnt = 0;
+    motor_hall_sin_angle_set(HALL_SIN_OFFSET, HALL_SIN_ADVANCE);
+}
+
+
+/**
+ * @brief start in six-step, the hall edges fire the commutation
+ * 
+ * @param[in] dir: rotation direction
+ * @return None
+ */
+void motor_hall_sin_start(motor_dir_e dir)
+{
+    hall_sin.dir      = dir;
+    hall_sin.sector   = hall_sin_sector_of_hall[HALL_STATE_READ()];
+    hall_sin.edge_cnt = 0;
+    motor_hall_sin_angle_set(hall_sin.offset, hall_sin.advance);
+    motor_hall_sin_voltage_set(hall_sin.v_ref);
+
+    bsp_pwm_com_trig_select(PWM_COM_TRIG_HALL);
+    hall_sin.state = HALL_SIN_STATE_SIX_STEP;
+    motor_six_step_start(dir, six_step.duty);
+}
+
+
+/**
+ * @brief stop, all phases off
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_hall_sin_stop(void)
+{
+    hall_sin.state = HALL_SIN_STATE_IDLE;
+    motor_six_step_stop();
+}
+
+
+/**
+ * @brief voltage command, used by both drives
+ * 
+ * @param[in] v_ref: sine amplitude, q15 of 2/3 Vbus
+ * @return None
+ */
+void motor_hall_sin_voltage_set(int16_t v_ref)
+{
+    v_ref          = (v_ref < 0) ? 0 : ((v_ref > HALL_SIN_V_MAX) ? HALL_SIN_V_MAX : v_ref);
+    hall_sin.v_ref = v_ref;
+    motor_six_step_duty_set((uint16_t)(((int32_t)v_ref * HALL_SIN_SIX_STEP_GAIN) >> 15));
+}
+
+
+/**
+ * @brief hall calibration and voltage lead, can be changed while running
+ * 
+ * @param[in] offset: angle added to the nominal hall edge angles
+ * @param[in] advance: voltage lead beyond 90 degree from the d axis
+ * @return None
+ */
+void motor_hall_sin_angle_set(uint16_t offset, uint16_t advance)
+{
+    int16_t lead = (int16_t)(HALL_SIN_LEAD_Q + advance);
+
+    hall_sin.offset  = offset;
+    hall_sin.advance = advance;
+    hall_sin.lead    = (hall_sin.dir == MOTOR_DIR_CW) ? lead : (int16_t)-lead;
+}
+
+
+/**
+ * @brief TIM1 COM interrupt, HALL_COM_DELAY after every hall edge
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_hall_sin_com_isr(void)
+{
+    uint8_t  hall     = HALL_STATE_READ();
+    uint8_t  sector   = hall_sin_sector_of_hall[hall];
+    uint16_t interval = motor_hall_speed_snap()->interval;
+    uint8_t  forward  = 0;
+
+    /*a glitch edge (bounce) merged by motor_hall_speed: the rotor is still in the sector of the last edge*/
+    if((sector != HALL_SIN_SECTOR_INVALID) && (motor_hall_speed_pending() != 0))
+    {
+        if(hall_sin.state == HALL_SIN_STATE_SIX_STEP)
+        {
+            motor_six_step_commutate(hall);
+        }
+        return;
+    }
+
+    if((sector != HALL_SIN_SECTOR_INVALID) && (hall_sin.sector != HALL_SIN_SECTOR_INVALID))
+    {
+        forward = (uint8_t)(((sector + SIX_STEP_SECTORS - hall_sin.sector) % SIX_STEP_SECTORS) == hall_sin_forward_step[hall_sin.dir]);
+    }
+    hall_sin.sector   = sector;
+    hall_sin.interval = interval;
+    if((forward != 0) && (interval != 0) && (interval < HALL_SIN_ENTER_INTERVAL))
+    {
+        hall_sin.edge_cnt += (hall_sin.edge_cnt < HALL_SIN_ENTER_EDGES) ? 1 : 0;
+    }
+    else
+    {
+        hall_sin.edge_cnt = 0;
+    }
+
+    if(hall_sin.state == HALL_SIN_STATE_SINE)
+    {
+        if((forward == 0) || (interval == 0) || (interval > HALL_SIN_EXIT_INTERVAL))
+        {
+            motor_hall_sin_fallback();
+            return;
+        }
+    }
+    else if(hall_sin.state == HALL_SIN_STATE_SIX_STEP)
+    {
+        motor_six_step_commutate(hall);
+        if(hall_sin.edge_cnt < HALL_SIN_ENTER_EDGES)
+        {
+            return;
+        }
+    }
+    else
+    {
+        return;
+    }
+
+    /*entering the sector: its low boundary CW, its high boundary CCW*/
+    hall_sin.edge_theta = (uint16_t)(HALL_SIN_SECTOR0_THETA + sector * HALL_SIN_SECTOR + hall_sin.offset
+                                   + ((hall_sin.dir == MOTOR_DIR_CW) ? 0 : HALL_SIN_SECTOR));
+    hall_sin.rate_q16   = (interval != 0) ? (((uint32_t)HALL_SIN_SECTOR << 16) / interval) : 0;
+    if(hall_sin.state == HALL_SIN_STATE_SIX_STEP)
+    {
+        motor_hall_sin_enter();
+    }
+}
+
+
+/**
+ * @brief TIM1 update interrupt, every pwm period
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_hall_sin_pwm_isr(void)
+{
+    uint32_t cnt;
+    uint32_t delta;
+
+    if(hall_sin.state != HALL_SIN_STATE_SINE)
+    {
+        motor_six_step_pwm_update();
+        return;
+    }
+
+    /*no edge for an exit interval: slowed down or stalled; a glitch edge restarted the counter*/
+    cnt = motor_hall_speed_pending();
+    cnt += HALL_CNT();
+    if(cnt > HALL_SIN_EXIT_INTERVAL)
+    {
+        motor_hall_sin_fallback();
+        return;
+    }
+
+    delta = (uint32_t)(((uint64_t)cnt * hall_sin.rate_q16) >> 16);
+    delta = (delta > HALL_SIN_SECTOR) ? HALL_SIN_SECTOR : delta;
+    hall_sin.theta = (hall_sin.dir == MOTOR_DIR_CW) ? (uint16_t)(hall_sin.edge_theta + delta)
+                                                    : (uint16_t)(hall_sin.edge_theta - delta);
+    motor_hall_sin_output(hall_sin.theta);
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief sine voltage for a d axis angle into the compare registers
+ * 
+ * @param[in] theta: d axis angle
+ * @return None
+ */
+static void motor_hall_sin_output(uint16_t theta)
+{
+    uint16_t phi = (uint16_t)(theta + hall_sin.lead);
+
+    motor_svpwm_calc(Q15_MUL(hall_sin.v_ref, motor_math_cos(phi)), Q15_MUL(hall_sin.v_ref, motor_math_sin(phi)), hall_sin.duty);
+    PWM_DUTY_SET(hall_sin.duty[0], hall_sin.duty[1], hall_sin.duty[2]);
+}
+
+
+/**
+ * @brief six-step to sinusoidal at an edge: duties of the edge angle, all phases chopping
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_hall_sin_enter(void)
+{
+    hall_sin.theta = hall_sin.edge_theta;
+    motor_hall_sin_output(hall_sin.theta);
+    bsp_pwm_complementary_mode();
+    hall_sin.state = HALL_SIN_STATE_SINE;
+    hall_sin.sine_cnt++;
+}
+
+
+/**
+ * @brief sinusoidal to six-step: the pattern of the present hall state at once, the next one on the edge
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_hall_sin_fallback(void)
+{
+    hall_sin.state    = HALL_SIN_STATE_SIX_STEP;
+    hall_sin.edge_cnt = 0;
+    hall_sin.fallback_cnt++;
+    motor_six_step_start(hall_sin.dir, six_step.duty);
+}
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,117 @@
+/**
+ * @file motor_hall_sin.h
+ * @brief Driver motor_hall_sin Header
+ * 
+ * @details
+ * Hall sinusoidal drive: the rotor angle is interpolated between the hall
+ * edges from the hall timer and the three phases chop a sine voltage.
+ * Below a minimum speed the six-step engine drives the motor.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_HALL_SIN_H__
+#define __MOTOR_HALL_SIN_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "bsp_hall.h"
+#include "motor_param.h"
+#include "motor_math.h"
+#include "motor_six_step.h"
+
+/* ============================ Public Constants ============================ */
+
+#define HALL_SIN_SECTOR                 (10923)             // 60 degree, one hall state
+#define HALL_SIN_SECTOR_INVALID         (0xFF)
+
+/* 60 degree interval at a speed, hall timer ticks */
+#define HALL_SIN_INTERVAL(rpm)          ((uint32_t)(HALL_TIM_FREQ_HZ * 10.0f / ((rpm) * MOTOR_POLE_PAIRS)))
+
+/* sinusoidal above ENTER after ENTER_EDGES edges in the running direction, six-step again below EXIT */
+#define HALL_SIN_ENTER_RPM              (300)
+#define HALL_SIN_EXIT_RPM               (200)
+#define HALL_SIN_ENTER_INTERVAL         HALL_SIN_INTERVAL(HALL_SIN_ENTER_RPM)
+#define HALL_SIN_EXIT_INTERVAL          HALL_SIN_INTERVAL(HALL_SIN_EXIT_RPM)    // under the 16 bit hall timer wrap
+#define HALL_SIN_ENTER_EDGES            (6)
+
+#define HALL_SIN_V_MAX                  (Q15(0.95f * MOTOR_V_LINEAR))   // voltage circle, as FOC_V_MAX
+#define HALL_SIN_OFFSET                 (ANGLE_DEG(0))      // hall edge angle error of the motor, calibration
+#define HALL_SIN_ADVANCE                (ANGLE_DEG(0))      // voltage lead beyond the q axis
+
+/* six-step duty of the same fundamental line voltage: pi / 3 of the period per unit voltage */
+#define HALL_SIN_SIX_STEP_GAIN          ((int32_t)(PWM_PERIOD_MAX * 1.0471976f + 0.5f))
+
+/* ============================ Code Enum Definitions ============================ */
+
+typedef enum
+{
+    HALL_SIN_STATE_IDLE = 0,
+    HALL_SIN_STATE_SIX_STEP,            /*start and low speed, six-step engine*/
+    HALL_SIN_STATE_SINE,                /*interpolated angle, all phases chopping*/
+}hall_sin_state_e;
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    hall_sin_state_e state;
+    motor_dir_e      dir;
+    uint8_t          sector;            /*0 ~ 5 from -30 degree in 60 degree steps, last edge*/
+    uint8_t          edge_cnt;          /*consecutive edges in the running direction under the enter interval*/
+    int16_t          v_ref;             /*sine amplitude, q15 of 2/3 Vbus*/
+    uint16_t         offset;
+    uint16_t         advance;
+    uint16_t         edge_theta;        /*d axis angle at the last edge*/
+    int16_t          lead;              /*voltage angle from the d axis, signed by the direction*/
+    uint16_t         theta;             /*interpolated d axis angle*/
+    uint16_t         interval;          /*last 60 degree interval, hall timer ticks*/
+    uint32_t         rate_q16;          /*angle per hall timer tick, q16*/
+    uint16_t         duty[3];
+    uint32_t         sine_cnt;          /*switches to sinusoidal*/
+    uint32_t         fallback_cnt;      /*switches back to six-step*/
+}hall_sin_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern hall_sin_t hall_sin;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_hall_sin_init(void);
+void motor_hall_sin_start(motor_dir_e dir);
+void motor_hall_sin_stop(void);
+void motor_hall_sin_voltage_set(int16_t v_ref);
+void motor_hall_sin_angle_set(uint16_t offset, uint16_t advance);
+void motor_hall_sin_com_isr(void);
+void motor_hall_sin_pwm_isr(void);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_HALL_SIN_H__*/
+
+
+/**
+  * @}
+  */
@@ -0,0 +1,256 @@
+/**
+ * @file motor_hall_speed.c
+ * @brief Hall speed measurement, M/T method
+ * 
+ * @details
+ * The hall timer captures the interval before every edge in hardware (the
+ * XOR of the three halls on TI1, the edge resets the counter), the capture
+ * interrupt hands it here. At every edge, M edges spanning exactly T ticks:
+ *   speed = M * 60 degree / T
+ * - period method, M = 1: T is the last interval, at low speed
+ * - count method, M = 6: T is the last electrical turn, once a turn is under
+ *   HALL_SPEED_TURN_MAX; summing a whole turn cancels the hall placement
+ *   error (a few degree, 5 ~ 10% on a single interval)
+ * with a hysteresis between them. The division runs once per edge, at most
+ * the edge rate, with the unit conversion folded into one constant.
+ * 
+ * The last turn of intervals is kept in a ring. An interval under a quarter
+ * of its mean (of the last interval while the ring fills) is a glitch (hall bounce, noise on the XOR input) and is merged
+ * into the next one, so T stays exact and M does not count it. Edges that
+ * skip a hall state count two, invalid states are merged as glitches, a
+ * reversal empties the ring.
+ * 
+ * The result is written to the free one of two snapshots and then the index
+ * is flipped: a control interrupt reading it, preempted or not, always sees a
+ * complete snapshot, without a lock and without masking interrupts. The
+ * snapshot also carries the last accepted edge interval, a glitch
+ * edge leaves it as it was.
+ * No edge for a whole timer period (65ms, about 40rpm) publishes 0 and the
+ * next capture only restarts the measurement.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_hall_speed.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+hall_speed_t hall_speed;
+
+/* ============================ Static Global Variables ============================ */
+
+/* sector 0 ~ 5 from -30 degree in 60 degree steps, as motor_hall_sin */
+static const uint8_t hall_speed_sector_of_hall[SIX_STEP_HALL_STATES] =
+{
+    HALL_SPEED_SECTOR_INVALID, 3, 1, 2, 5, 4, 0, HALL_SPEED_SECTOR_INVALID
+};
+
+/* sectors moved for a sector difference, 0: not a direction (3 sectors or none) */
+static const int8_t hall_speed_step[SIX_STEP_SECTORS] = {0, 1, 2, 0, -2, -1};
+
+/* ============================ Static Function Declarations ============================ */
+
+static void motor_hall_speed_publish(int32_t speed_q8, uint32_t window);
+static void motor_hall_speed_restart(void);
+static void motor_hall_speed_ring_clear(void);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init, motor at standstill
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_hall_speed_init(void)
+{
+    hall_speed.idx        = 0;
+    hall_speed.sector     = hall_speed_sector_of_hall[HALL_STATE_READ()];
+    hall_speed.dir        = 1;
+    hall_speed.interval   = 0;
+    hall_speed.sectors    = 0;
+    hall_speed.glitch_cnt = 0;
+    hall_speed.stall_cnt  = 0;
+    motor_hall_speed_restart();
+}
+
+
+/**
+ * @brief hall edge, from the hall timer capture interrupt
+ * 
+ * @param[in] hall: hall state after the edge
+ * @param[in] interval: captured hall ticks since the edge before
+ * @return None
+ */
+void motor_hall_speed_edge_isr(uint8_t hall, uint16_t interval)
+{
+    uint8_t  sector = hall_speed_sector_of_hall[hall & 0x07];
+    uint32_t t      = interval + hall_speed.pending;
+    int8_t   step   = 0;
+    uint8_t  edges;
+    uint32_t per;
+    uint32_t ref;
+    int32_t  speed_q8;
+
+    if((sector != HALL_SPEED_SECTOR_INVALID) && (hall_speed.sector != HALL_SPEED_SECTOR_INVALID))
+    {
+        step = hall_speed_step[(sector + SIX_STEP_SECTORS - hall_speed.sector) % SIX_STEP_SECTORS];
+    }
+    if(sector != HALL_SPEED_SECTOR_INVALID)
+    {
+        hall_speed.sector = sector;
+    }
+
+    /*first edge after a stall: the capture counts from the overflow, only the reference*/
+    if(hall_speed.stalled != 0)
+    {
+        hall_speed.stalled  = 0;
+        hall_speed.dir      = (step < 0) ? -1 : 1;
+        hall_speed.sectors += step;
+        return;
+    }
+
+    /*glitch: against the mean of the last turn, or the last interval until the ring is full*/
+    edges = (uint8_t)((step < 0) ? -step : step);
+    ref   = (hall_speed.ring_cnt == SIX_STEP_SECTORS) ? hall_speed.ring_sum : ((uint32_t)hall_speed.interval * SIX_STEP_SECTORS);
+    if((edges == 0) || (t == 0) || ((t >> (edges - 1)) * (SIX_STEP_SECTORS << HALL_SPEED_GLITCH_SHIFT) < ref))
+    {
+        hall_speed.pending = t;
+        hall_speed.glitch_cnt++;
+        return;
+    }
+    hall_speed.pending  = 0;
+    hall_speed.interval = (uint16_t)((t > 0xFFFF) ? 0xFFFF : t);
+    hall_speed.sectors += step;
+
+    /*a reversal: the turn in the ring was the other way*/
+    if((step > 0) != (hall_speed.dir > 0))
+    {
+        hall_speed.dir = (step > 0) ? 1 : -1;
+        motor_hall_speed_ring_clear();
+    }
+
+    /*ring of the last turn, per 60 degree*/
+    per                  = (uint32_t)hall_speed.interval >> (edges - 1);
+    hall_speed.ring_sum += per - hall_speed.ring[hall_speed.ring_pos];
+    hall_speed.ring[hall_speed.ring_pos] = (uint16_t)per;
+    hall_speed.ring_pos  = (hall_speed.ring_pos + 1 < SIX_STEP_SECTORS) ? (hall_speed.ring_pos + 1) : 0;
+    hall_speed.ring_cnt += (hall_speed.ring_cnt < SIX_STEP_SECTORS) ? 1 : 0;
+
+    if((hall_speed.ring_cnt == SIX_STEP_SECTORS) && (hall_speed.ring_sum < HALL_SPEED_TURN_MAX))
+    {
+        hall_speed.count_mode = 1;
+    }
+    else if((hall_speed.ring_cnt < SIX_STEP_SECTORS) || (hall_speed.ring_sum > HALL_SPEED_TURN_MAX + HALL_SPEED_TURN_HYST))
+    {
+        hall_speed.count_mode = 0;
+    }
+
+    if(hall_speed.count_mode != 0)
+    {
+        speed_q8 = (int32_t)(SIX_STEP_SECTORS * HALL_SPEED_SCALE_Q8 / hall_speed.ring_sum);
+        motor_hall_speed_publish((hall_speed.dir > 0) ? speed_q8 : -speed_q8, hall_speed.ring_sum);
+    }
+    else
+    {
+        speed_q8 = (int32_t)(edges * HALL_SPEED_SCALE_Q8 / t);
+        motor_hall_speed_publish((hall_speed.dir > 0) ? speed_q8 : -speed_q8, t);
+    }
+}
+
+
+/**
+ * @brief no edge for a whole hall timer period, from the overflow interrupt
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_hall_speed_timeout_isr(void)
+{
+    hall_speed.stall_cnt += (hall_speed.stalled == 0) ? 1 : 0;
+    motor_hall_speed_restart();
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief fill the free snapshot, then hand it over
+ * 
+ * @param[in] speed_q8: angle step per pwm period, q8
+ * @param[in] window: hall ticks measured over
+ * @return None
+ */
+static void motor_hall_speed_publish(int32_t speed_q8, uint32_t window)
+{
+    hall_speed_snap_t *s = &hall_speed.snap[hall_speed.idx ^ 1];
+
+    s->speed_q8 = speed_q8;
+    s->speed    = (int16_t)(speed_q8 >> 8);
+    s->window   = window;
+    s->sectors  = hall_speed.sectors;
+    s->interval = hall_speed.interval;
+    __DMB();
+    hall_speed.idx ^= 1;
+}
+
+
+/**
+ * @brief standstill: speed 0, the next edge is the new reference
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_hall_speed_restart(void)
+{
+    hall_speed.stalled  = 1;
+    hall_speed.pending  = 0;
+    hall_speed.interval = 0;
+    motor_hall_speed_ring_clear();
+    motor_hall_speed_publish(0, 0);
+}
+
+
+/**
+ * @brief empty the ring, back to the period method
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_hall_speed_ring_clear(void)
+{
+    uint8_t i;
+
+    hall_speed.count_mode = 0;
+    hall_speed.ring_pos   = 0;
+    hall_speed.ring_cnt   = 0;
+    hall_speed.ring_sum   = 0;
+    for(i = 0; i < SIX_STEP_SECTORS; i++)
+    {
+        hall_speed.ring[i] = 0;
+    }
+}
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,133 @@
+/**
+ * @file motor_hall_speed.h
+ * @brief Driver motor_hall_speed Header
+ * 
+ * @details
+ * Hall speed measurement: M/T method on the hall edge intervals captured by
+ * the hall timer, published as a double buffered snapshot for the control
+ * interrupts.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_HALL_SPEED_H__
+#define __MOTOR_HALL_SPEED_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "bsp_pwm.h"
+#include "bsp_hall.h"
+#include "motor_six_step.h"
+
+/* ============================ Public Constants ============================ */
+
+#define HALL_SPEED_SECTOR_INVALID       (0xFF)
+
+/* count method (M = one turn) below this turn time, period method (M = 1) above it + 1/4 */
+#define HALL_SPEED_TURN_MAX             (HALL_TIM_FREQ_HZ / 50)     // 20ms in hall ticks, 750rpm
+#define HALL_SPEED_TURN_HYST            (HALL_SPEED_TURN_MAX / 4)
+
+/* an interval under 1 / 2^shift of the mean of the last turn is a glitch, merged into the next */
+#define HALL_SPEED_GLITCH_SHIFT         (2)
+
+/* 60 degree in angle steps per pwm period times hall ticks, q8: speed_q8 = edges * scale / ticks */
+#define HALL_SPEED_SCALE_Q8             ((uint32_t)10923 * (HALL_TIM_FREQ_HZ / PWM_FREQ_HZ) * 256)
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    int32_t  speed_q8;                  /*angle step per pwm period, q8, signed*/
+    int16_t  speed;                     /*angle step per pwm period, as the observers*/
+    uint32_t window;                    /*hall ticks the value was measured over*/
+    int32_t  sectors;                   /*60 degree steps counted, signed*/
+    uint16_t interval;                  /*last accepted edge interval, hall ticks, 0: unknown*/
+}hall_speed_snap_t;
+
+typedef struct
+{
+    hall_speed_snap_t snap[2];
+    volatile uint8_t  idx;              /*snapshot the readers take*/
+    uint8_t           stalled;          /*no edge for a timer period: the next capture is no interval*/
+    uint8_t           count_mode;       /*1: M = one turn, 0: M = 1*/
+    uint8_t           sector;           /*0 ~ 5 of the last valid hall state*/
+    int8_t            dir;              /*+1 / -1, direction of the last edge*/
+    uint16_t          interval;         /*last accepted edge interval, hall ticks*/
+    uint16_t          ring[SIX_STEP_SECTORS];
+    uint8_t           ring_pos;
+    uint8_t           ring_cnt;
+    uint32_t          ring_sum;         /*last turn of intervals*/
+    uint32_t          pending;          /*glitch intervals, added to the next edge*/
+    int32_t           sectors;
+    uint32_t          glitch_cnt;
+    uint32_t          stall_cnt;
+}hall_speed_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern hall_speed_t hall_speed;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_hall_speed_init(void);
+void motor_hall_speed_edge_isr(uint8_t hall, uint16_t interval);
+void motor_hall_speed_timeout_isr(void);
+
+
+/**
+ * @brief the published measurement, no lock and no division: use it within the calling interrupt
+ * 
+ * @param[in] None
+ * @return the snapshot
+ */
+static __INLINE const hall_speed_snap_t *motor_hall_speed_snap(void)
+{
+    return &hall_speed.snap[hall_speed.idx];
+}
+
+
+/**
+ * @brief hall ticks from the last accepted edge to the glitch edges merged since, 0 when there was none
+ * 
+ * The hall timer restarts on a glitch edge too: the time since the last
+ * accepted edge is this plus HALL_CNT().
+ * 
+ * @param[in] None
+ * @return hall ticks
+ */
+static __INLINE uint32_t motor_hall_speed_pending(void)
+{
+    return hall_speed.pending;
+}
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_HALL_SPEED_H__*/
+
+
+/**
+  * @}
+  */
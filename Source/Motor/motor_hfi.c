@@ -0,0 +1,203 @@
+/**
+ * @file motor_hfi.c
+ * @brief High frequency injection angle tracker
+ * 
+ * @details
+ * A square wave of +-vh is added to vd, two pwm periods on each side (carrier
+ * at fpwm / 4). The currents are sampled at the counter peak and the duties
+ * computed on them load at the next underflow, so the step between two samples
+ * sees half a period of each of the last two carrier values: vh * Ts * inv(L)
+ * when they agree, nothing when they differ (an fpwm / 2 carrier would cancel
+ * on every step). Along the estimated d axis the step is the injection; across
+ * it (estimated q axis) it is proportional to (1 / Ld - 1 / Lq) * sin(2 * dtheta).
+ * Multiplying the step with the carrier of the two half periods (heterodyne)
+ * and summing over HFI_DECIM periods removes the fundamental: a slowly moving
+ * current gives the same step with alternating signs.
+ * 
+ * The q sum divided by the d sum gives an error independent of vh and Vbus,
+ * which a PI tracker runs on every HFI_DECIM periods. Per period the cost is
+ * fixed (differences, one rotation, two sums, about 60 cycles), plus one
+ * division and the PI on every tracker step.
+ * 
+ * The mean of a sample and the one two periods before has no carrier in it
+ * and is what the current loop regulates, so the PI does not fight the
+ * injection.
+ * 
+ * The saliency repeats every 180 degree: the tracker locks onto the d axis or
+ * its opposite, the polarity has to come from the start angle (motor_hfi_reset).
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_hfi.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+hfi_t hfi;
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+static void motor_hfi_track(void);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init the injection
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_hfi_init(void)
+{
+    hfi.vh = HFI_VH_DEFAULT;
+    motor_hfi_reset(0);
+}
+
+
+/**
+ * @brief restart the tracker at an angle, standing still
+ * 
+ * @param[in] theta: start angle, also decides the polarity
+ * @return None
+ */
+void motor_hfi_reset(uint16_t theta)
+{
+    hfi.phase         = 1;             /*one period of +vh first: the carrier current swings around zero*/
+    hfi.sign_prev     = 0;             /*first steps have no carrier to demodulate*/
+    hfi.sign_prev2    = 0;
+    hfi.i_alpha_prev  = 0;
+    hfi.i_beta_prev   = 0;
+    hfi.i_alpha_prev2 = 0;
+    hfi.i_beta_prev2  = 0;
+    hfi.i_alpha       = 0;
+    hfi.i_beta        = 0;
+    hfi.acc_d         = 0;
+    hfi.acc_q         = 0;
+    hfi.cnt           = 0;
+    hfi.err           = 0;
+    hfi.theta         = theta;
+    hfi.theta_q16     = (uint32_t)theta << 16;
+    hfi.omega_q16     = 0;
+    hfi.omega_i_q16   = 0;
+    hfi.speed         = 0;
+}
+
+
+/**
+ * @brief set the injected amplitude, can be changed while running
+ * 
+ * @param[in] vh: q15 of 2/3 Vbus
+ * @return None
+ */
+void motor_hfi_amplitude_set(int16_t vh)
+{
+    hfi.vh = (vh < 0) ? 0 : vh;
+}
+
+
+/**
+ * @brief demodulate a new current sample and advance the angle, every pwm period
+ * 
+ * @param[in] i_alpha: raw current sample, q15
+ * @param[in] i_beta: raw current sample, q15
+ * @return None
+ */
+void motor_hfi_demod(int16_t i_alpha, int16_t i_beta)
+{
+    int32_t s = motor_math_sin(hfi.theta);
+    int32_t c = motor_math_cos(hfi.theta);
+    int32_t w = (hfi.sign_prev + hfi.sign_prev2) >> 1;      /*carrier of the two half periods: -1, 0, 1*/
+    int32_t di_a = ((int32_t)i_alpha - hfi.i_alpha_prev) * w;
+    int32_t di_b = ((int32_t)i_beta  - hfi.i_beta_prev)  * w;
+
+    hfi.i_alpha = (int16_t)(((int32_t)i_alpha + hfi.i_alpha_prev2) >> 1);
+    hfi.i_beta  = (int16_t)(((int32_t)i_beta  + hfi.i_beta_prev2)  >> 1);
+    hfi.i_alpha_prev2 = hfi.i_alpha_prev;
+    hfi.i_beta_prev2  = hfi.i_beta_prev;
+    hfi.i_alpha_prev  = i_alpha;
+    hfi.i_beta_prev   = i_beta;
+
+    hfi.acc_d += (di_a * c + di_b * s) >> 15;
+    hfi.acc_q += (di_b * c - di_a * s) >> 15;
+    if(++hfi.cnt >= HFI_DECIM)
+    {
+        motor_hfi_track();
+    }
+
+    hfi.theta_q16 += (uint32_t)hfi.omega_q16;
+    hfi.theta      = (uint16_t)(hfi.theta_q16 >> 16);
+}
+
+
+/**
+ * @brief carrier for the coming period, to be added to vd
+ * 
+ * @param[in] None
+ * @return injected d voltage, q15
+ */
+int16_t motor_hfi_carrier(void)
+{
+    hfi.sign_prev2 = hfi.sign_prev;
+    hfi.sign_prev  = (hfi.phase < 2) ? 1 : -1;
+    hfi.phase      = (hfi.phase + 1) & 3;
+    return (hfi.sign_prev > 0) ? hfi.vh : -hfi.vh;
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief decimated tracker step on the summed response
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_hfi_track(void)
+{
+    int32_t err = 0;
+
+    if(hfi.acc_d > HFI_D_MIN)
+    {
+        err = (hfi.acc_q << 15) / hfi.acc_d;
+        err = Q15_SAT(err);
+    }
+    if(MOTOR_LD_H > MOTOR_LQ_H)
+    {
+        err = -err;
+    }
+    hfi.err   = (int16_t)err;
+    hfi.acc_d = 0;
+    hfi.acc_q = 0;
+    hfi.cnt   = 0;
+
+    hfi.omega_i_q16 += HFI_PLL_KI * err;
+    hfi.omega_q16    = hfi.omega_i_q16 + HFI_PLL_KP * err;
+    hfi.speed        = (int16_t)(hfi.omega_q16 >> 16);
+}
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,103 @@
+/**
+ * @file motor_hfi.h
+ * @brief Driver motor_hfi Header
+ * 
+ * @details
+ * High frequency injection for standstill and low speed angle sensing on a
+ * salient motor (Ld != Lq).
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_HFI_H__
+#define __MOTOR_HFI_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+#define HFI_VH_DEFAULT                  (Q15(0.20f * MOTOR_V_LINEAR))   // injected square wave on d, q15 of 2/3 Vbus
+#define HFI_DECIM_SHIFT                 (3)
+#define HFI_DECIM                       (1 << HFI_DECIM_SHIFT)  // periods per tracker step, whole carrier cycles
+#define HFI_D_MIN                       (64)                // d response below: no injection reaching the motor
+
+/* normalised error (q response / d response) = (Lq - Ld) / Lq * dtheta: q15 per angle count */
+#define HFI_ERR_PER_COUNT               ((MOTOR_LQ_H - MOTOR_LD_H) / MOTOR_LQ_H * 3.1415927f)
+
+/* tracker: PI on the normalised error, run every HFI_DECIM periods, speed in q16 angle counts per period */
+#define HFI_PLL_BW_HZ                   (40.0f)
+#define HFI_PLL_WN_TS                   (6.2831853f * HFI_PLL_BW_HZ * MOTOR_TS_S)
+#define HFI_PLL_KP                      ((int32_t)(1.4142136f * HFI_PLL_WN_TS * 65536.0f / HFI_ERR_PER_COUNT))
+#define HFI_PLL_KI                      ((int32_t)(HFI_PLL_WN_TS * HFI_PLL_WN_TS * HFI_DECIM * 65536.0f / HFI_ERR_PER_COUNT + 0.5f))
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    int16_t  vh;                    /*injection amplitude, q15*/
+    uint8_t  phase;                 /*carrier position, two periods +vh then two -vh*/
+    int16_t  sign_prev;             /*carrier of the duties computed last, +1 / -1*/
+    int16_t  sign_prev2;            /*and of the ones before*/
+    int16_t  i_alpha_prev;          /*raw sample of the previous period*/
+    int16_t  i_beta_prev;
+    int16_t  i_alpha_prev2;         /*and of the one before*/
+    int16_t  i_beta_prev2;
+    int16_t  i_alpha;               /*carrier free current, mean of two samples two periods apart*/
+    int16_t  i_beta;
+    int32_t  acc_d;                 /*demodulated response along / across the injection*/
+    int32_t  acc_q;
+    uint8_t  cnt;
+    int16_t  err;                   /*last normalised angle error, q15*/
+    uint32_t theta_q16;
+    uint16_t theta;
+    int32_t  omega_q16;             /*angle counts per period, q16*/
+    int32_t  omega_i_q16;
+    int16_t  speed;
+}hfi_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern hfi_t hfi;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_hfi_init(void);
+void motor_hfi_reset(uint16_t theta);
+void motor_hfi_amplitude_set(int16_t vh);
+void motor_hfi_demod(int16_t i_alpha, int16_t i_beta);
+int16_t motor_hfi_carrier(void);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_HFI_H__*/
+
+
+/**
+  * @}
+  */
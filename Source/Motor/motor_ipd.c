@@ -0,0 +1,330 @@
+/**
+ * @file motor_ipd.c
+ * @brief Initial rotor position detection
+ * 
+ * @details
+ * N voltage pulses (6 or 12, evenly spread over 360 degree) are fired through
+ * TIM1, each followed by the reversed pulse until the current is back at zero
+ * (keeps the rotor still and leaves no current for the next pulse; its last
+ * period is trimmed to the zero crossing), then a short zero vector. The current along
+ * each pulse is read at its end with the low side shunts.
+ * 
+ * Along the d axis the inductance is lowest (Ld < Lq), and of the two d
+ * directions the one adding to the magnet flux saturates the iron, so the
+ * largest peak points to the north pole. The maximum is refined with a
+ * parabola through its two neighbours, better than +-15 degree with 6 pulses.
+ * 
+ * Timing with the defaults: 1.6ms offset, about 0.55ms per pulse: 4.9ms for 6
+ * pulses, 8.2ms for 12, reported in ipd.time_us.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_pwm.h"
+#include "bsp_adc.h"
+#include "motor_six_step.h"
+#include "motor_svpwm.h"
+#include "motor_foc.h"
+#include "motor_ipd.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define IPD_INV_SQRT3           (18919)     // 1 / sqrt(3), q15
+#define IPD_STEP_REST           (IPD_PULSE_PERIODS + IPD_REVERSE_MAX)
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+ipd_t ipd;
+
+/* ============================ Static Global Variables ============================ */
+
+static const uint8_t ipd_adc_seq[3] = {ADC_IU_CH, ADC_IV_CH, ADC_VBUS_CH};
+
+/* ============================ Static Function Declarations ============================ */
+
+static void motor_ipd_reset(ipd_pulses_e pulses);
+static void motor_ipd_vector(uint16_t theta, int32_t v);
+static void motor_ipd_step(int16_t ia, int16_t ib);
+static void motor_ipd_resolve(void);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief start the test: current offsets with the outputs off, then the pulses
+ * 
+ * @param[in] pulses: IPD_PULSES_6 or IPD_PULSES_12
+ * @return None
+ */
+void motor_ipd_start(ipd_pulses_e pulses)
+{
+    bsp_pwm_output_enable(DISABLE);
+    motor_ipd_reset(pulses);
+
+    PWM_DUTY_SET(SVPWM_HALF, SVPWM_HALF, SVPWM_HALF);
+    bsp_pwm_complementary_mode();
+    bsp_adc_inj_seq_set(ipd_adc_seq, 3);
+    bsp_pwm_adc_trig_select(PWM_ADC_TRIG_LOW_SIDE);
+    ADC_INJ_IRQ_ENABLE();
+}
+
+
+/**
+ * @brief abort the test, all phases off
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_ipd_stop(void)
+{
+    ipd.state = IPD_STATE_IDLE;
+    motor_six_step_stop();
+}
+
+
+/**
+ * @brief adc injected end of conversion: rank1 = Iu, rank2 = Iv
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_ipd_adc_isr(void)
+{
+    uint16_t raw_a = ADC_INJ_DAT1();
+    uint16_t raw_b = ADC_INJ_DAT2();
+
+    if(ipd.state == IPD_STATE_OFFSET)
+    {
+        ipd.offset_acc_a += raw_a;
+        ipd.offset_acc_b += raw_b;
+        motor_ipd_step(0, 0);
+        if(ipd.state == IPD_STATE_PULSE)
+        {
+            ipd.offset_a = (uint16_t)(ipd.offset_acc_a >> IPD_OFFSET_SHIFT);
+            ipd.offset_b = (uint16_t)(ipd.offset_acc_b >> IPD_OFFSET_SHIFT);
+            PWM_DUTY_SET(ipd.duty[0], ipd.duty[1], ipd.duty[2]);
+            bsp_pwm_output_enable(ENABLE);
+        }
+        return;
+    }
+    if(ipd.state != IPD_STATE_PULSE)
+    {
+        return;
+    }
+
+    motor_ipd_step(Q15_SAT(((int32_t)ipd.offset_a - raw_a) << FOC_CURRENT_SHIFT),
+                   Q15_SAT(((int32_t)ipd.offset_b - raw_b) << FOC_CURRENT_SHIFT));
+    if(ipd.state == IPD_STATE_DONE)
+    {
+        bsp_pwm_output_enable(DISABLE);
+    }
+    PWM_DUTY_SET(ipd.duty[0], ipd.duty[1], ipd.duty[2]);
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief clear the results and begin with the offset measurement
+ * 
+ * @param[in] pulses: IPD_PULSES_6 or IPD_PULSES_12
+ * @return None
+ */
+static void motor_ipd_reset(ipd_pulses_e pulses)
+{
+    uint8_t i;
+
+    ipd.pulses       = (pulses == IPD_PULSES_6) ? IPD_PULSES_6 : IPD_PULSES_12;
+    ipd.idx          = 0;
+    ipd.step         = 0;
+    ipd.tick         = 0;
+    ipd.offset_acc_a = 0;
+    ipd.offset_acc_b = 0;
+    ipd.margin       = 0;
+    ipd.time_us      = 0;
+    for(i = 0; i < IPD_PULSES_MAX; i++)
+    {
+        ipd.peak[i] = 0;
+    }
+    ipd.duty[0] = SVPWM_HALF;
+    ipd.duty[1] = SVPWM_HALF;
+    ipd.duty[2] = SVPWM_HALF;
+    ipd.state   = IPD_STATE_OFFSET;
+}
+
+
+/**
+ * @brief duties of a voltage vector
+ * 
+ * @param[in] theta: direction
+ * @param[in] v: magnitude, q15, negative for the reversed pulse
+ * @return None
+ */
+static void motor_ipd_vector(uint16_t theta, int32_t v)
+{
+    motor_svpwm_calc((int16_t)((v * motor_math_cos(theta)) >> 15),
+                     (int16_t)((v * motor_math_sin(theta)) >> 15), ipd.duty);
+}
+
+
+/**
+ * @brief one pwm period of the test on the current sampled in it, sets ipd.duty for the next
+ * 
+ * @param[in] ia: phase U current, q15
+ * @param[in] ib: phase V current, q15
+ * @return None
+ */
+static void motor_ipd_step(int16_t ia, int16_t ib)
+{
+    uint16_t theta = (uint16_t)(((uint32_t)ipd.idx << 16) / ipd.pulses);
+    int32_t  beta;
+    int32_t  i_p;
+    int32_t  d;
+    int32_t  x;
+
+    ipd.tick++;
+    if(ipd.state == IPD_STATE_OFFSET)
+    {
+        if(ipd.tick >= IPD_OFFSET_SAMPLES)
+        {
+            ipd.state = IPD_STATE_PULSE;
+            ipd.step  = 0;
+            motor_ipd_vector(theta, IPD_PULSE_V);
+        }
+        return;
+    }
+
+    /*current along the pulse*/
+    beta = (((int32_t)ia + 2 * ib) * IPD_INV_SQRT3) >> 15;
+    i_p  = (ia * motor_math_cos(theta) + beta * motor_math_sin(theta)) >> 15;
+
+    ipd.step++;
+    if(ipd.step == IPD_PULSE_PERIODS)
+    {
+        /*end of the pulse, reverse it*/
+        ipd.peak[ipd.idx] = (int16_t)i_p;
+        ipd.i_last        = (int16_t)i_p;
+        motor_ipd_vector(theta, -IPD_PULSE_V);
+    }
+    else if((ipd.step > IPD_PULSE_PERIODS) && (ipd.step < IPD_STEP_REST))
+    {
+        /*the current falls by d per period, the half period still reversed takes
+          d / 2: once a whole period more would be past zero, the next one only
+          reverses the part that brings the rest to zero. A fixed reverse length
+          leaves current behind once the iron saturated, and what is left biases
+          the next peak by more than the saturation tells*/
+        d = ipd.i_last - i_p;
+        if((2 * i_p <= 3 * d) || (ipd.step == IPD_STEP_REST - 1))
+        {
+            x = (d > 0) ? (((2 * i_p - d) << 14) / d) : 0;
+            x = (x < 0) ? 0 : ((x > 32767) ? 32767 : x);
+            motor_ipd_vector(theta, -((IPD_PULSE_V * x) >> 15));
+            ipd.step = IPD_STEP_REST;
+        }
+        ipd.i_last = (int16_t)i_p;
+    }
+    else if(ipd.step == IPD_STEP_REST + 1)
+    {
+        ipd.duty[0] = SVPWM_HALF;
+        ipd.duty[1] = SVPWM_HALF;
+        ipd.duty[2] = SVPWM_HALF;
+    }
+    else if(ipd.step >= IPD_STEP_REST + IPD_REST_PERIODS)
+    {
+        ipd.step = 0;
+        if(++ipd.idx >= ipd.pulses)
+        {
+            motor_ipd_resolve();
+            ipd.time_us = (uint32_t)ipd.tick * IPD_PERIOD_US;
+            ipd.state   = IPD_STATE_DONE;
+            return;
+        }
+        motor_ipd_vector((uint16_t)(((uint32_t)ipd.idx << 16) / ipd.pulses), IPD_PULSE_V);
+    }
+}
+
+
+/**
+ * @brief largest peak, refined with a parabola through its neighbours
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_ipd_resolve(void)
+{
+    uint8_t  n = (uint8_t)ipd.pulses;
+    uint8_t  k = 0;
+    uint8_t  i;
+    int32_t  p0;
+    int32_t  pm;
+    int32_t  pp;
+    int32_t  den;
+    int32_t  frac = 0;
+
+    for(i = 1; i < n; i++)
+    {
+        if(ipd.peak[i] > ipd.peak[k])
+        {
+            k = i;
+        }
+    }
+    p0  = ipd.peak[k];
+    pm  = ipd.peak[(k + n - 1) % n];
+    pp  = ipd.peak[(k + 1) % n];
+    den = 2 * (pm - 2 * p0 + pp);
+    if(den < 0)
+    {
+        /*vertex offset in q15 of a step, within +-0.5*/
+        frac = ((pm - pp) << 15) / den;
+    }
+
+    ipd.margin = (int16_t)(p0 - ipd.peak[(k + n / 2) % n]);
+    ipd.theta  = (uint16_t)((((int32_t)k << 16) + (frac << 1)) / n);
+}
+
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+/**
+ * @brief begin a test without the hardware set up, for the host model
+ * 
+ * @param[in] pulses: IPD_PULSES_6 or IPD_PULSES_12
+ * @return None
+ */
+void motor_ipd_test_start(ipd_pulses_e pulses)
+{
+    motor_ipd_reset(pulses);
+}
+
+
+/**
+ * @brief one period on a modelled current sample, the next voltage is in ipd.duty
+ * 
+ * @param[in] ia: phase U current, q15
+ * @param[in] ib: phase V current, q15
+ * @return None
+ */
+void motor_ipd_test_step(int16_t ia, int16_t ib)
+{
+    motor_ipd_step(ia, ib);
+}
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
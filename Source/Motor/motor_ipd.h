@@ -0,0 +1,112 @@
+/**
+ * @file motor_ipd.h
+ * @brief Driver motor_ipd Header
+ * 
+ * @details
+ * Initial rotor position detection by inductive saturation pulses, run before a
+ * sensorless start instead of the alignment.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_IPD_H__
+#define __MOTOR_IPD_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+#define IPD_PULSES_MAX                  (12)
+#define IPD_OFFSET_SHIFT                (5)
+#define IPD_OFFSET_SAMPLES              (1 << IPD_OFFSET_SHIFT)
+#define IPD_PULSE_V                     (Q15(0.90f * MOTOR_V_LINEAR))   // pulse vector, q15 of 2/3 Vbus
+#define IPD_PULSE_PERIODS               (4)                 // pulse length
+#define IPD_REVERSE_MAX                 (2 * IPD_PULSE_PERIODS) // reversed pulse, cut at the current zero crossing
+#define IPD_REST_PERIODS                (4)                 // zero vector after each pulse pair
+#define IPD_PERIOD_US                   (1000000 / PWM_FREQ_HZ)
+
+/* ============================ Code Enum Definitions ============================ */
+
+typedef enum
+{
+    IPD_OFF       = 0,
+    IPD_PULSES_6  = 6,
+    IPD_PULSES_12 = 12,
+}ipd_pulses_e;
+
+typedef enum
+{
+    IPD_STATE_IDLE = 0,
+    IPD_STATE_OFFSET,
+    IPD_STATE_PULSE,
+    IPD_STATE_DONE,
+}ipd_state_e;
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    ipd_state_e  state;
+    ipd_pulses_e pulses;
+    uint8_t      idx;                       /*pulse being fired*/
+    uint16_t     step;                      /*period inside the pulse*/
+    uint16_t     tick;                      /*periods since the start*/
+    uint16_t     offset_a;
+    uint16_t     offset_b;
+    uint32_t     offset_acc_a;
+    uint32_t     offset_acc_b;
+    int16_t      peak[IPD_PULSES_MAX];      /*current along each pulse, q15*/
+    int16_t      i_last;                    /*previous sample along the pulse*/
+    int16_t      margin;                    /*peak minus the opposite one, polarity confidence*/
+    uint16_t     theta;                     /*result: electrical angle of the d axis (north)*/
+    uint16_t     duty[3];
+    uint32_t     time_us;                   /*duration of the whole test*/
+}ipd_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern ipd_t ipd;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_ipd_start(ipd_pulses_e pulses);
+void motor_ipd_stop(void);
+void motor_ipd_adc_isr(void);
+
+#ifdef UNIT_TEST
+void motor_ipd_test_start(ipd_pulses_e pulses);
+void motor_ipd_test_step(int16_t ia, int16_t ib);
+#endif /* UNIT_TEST */
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_IPD_H__*/
+
+
+/**
+  * @}
+  */
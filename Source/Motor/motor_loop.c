@@ -0,0 +1,409 @@
+/**
+ * @file motor_loop.c
+ * @brief Cascaded position / speed loops, decimated from the pwm update interrupt
+ * 
+ * @details
+ * The current loop runs every period in the adc interrupt. This module runs in
+ * the update interrupt once the start sequence is done and gives it a torque
+ * request (motor_foc_torque_ref_set, MTPA):
+ *   speed loop    every LOOP_SPEED_DIV periods, phase 0
+ *   position loop every LOOP_POS_DIV periods, phase LOOP_POS_PHASE
+ * A software phase counter and not the TIM1 repetition counter: the update
+ * interrupt has to stay at every period for the start sequence and the six
+ * step modes. The position phase falls between two speed phases, so no period
+ * runs both: worst update interrupt = one slow loop, not the sum.
+ * 
+ * Position: P with speed feedforward, clamped to speed_max. The position is
+ * the electrical angle summed every period, 65536 per electrical turn, in 32
+ * bits: it wraps after 32768 electrical turns (about 33s at 60000 erpm). It
+ * is taken modulo 2^32 throughout (the error, the profile target), so a
+ * wrap is harmless as long as a reference is within 2^31 steps of it.
+ * Speed: PI with torque feedforward. Anti-windup by conditional integration: the
+ * integral stops when the output is at the limit and the error pushes further,
+ * and the integral itself never goes past the limit. With motor_resonant
+ * enabled its torque at the rotation harmonics joins the feedforward.
+ * Mode changes and the first step after a start take the measured speed,
+ * position and torque as references (bumpless).
+ * With traj_on the speed / position references are targets of motor_traj,
+ * stepped in the speed loop period; in position mode its speed is the
+ * position loop feedforward.
+ * Calls from the thread that change several fields the update interrupt
+ * reads (mode, references and integrator, traj_on) mask the interrupts for
+ * the few stores, with the mask state saved so they also work from an
+ * interrupt.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_foc.h"
+#include "motor_traj.h"
+#include "motor_resonant.h"
+#include "motor_loop.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+loop_t loop;
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+static void motor_loop_mode_apply(loop_mode_e mode);
+static int32_t motor_loop_pi(loop_pi_t *pi, int32_t err, int32_t ff);
+static void motor_loop_speed(void);
+static void motor_loop_position(void);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init with the default gains, speed mode
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_loop_init(void)
+{
+    loop.mode             = LOOP_MODE_SPEED;
+    loop.traj_on          = 1;
+    loop.pos_kp_q16       = LOOP_POS_KP;
+    loop.speed_max        = LOOP_SPEED_MAX;
+    loop.speed_pi.kp      = LOOP_SPEED_KP;
+    loop.speed_pi.ki      = LOOP_SPEED_KI;
+    loop.speed_pi.out_max = LOOP_TORQUE_MAX;
+    loop.speed_cycles_max = 0;
+    loop.pos_cycles_max   = 0;
+    motor_traj_init();
+    motor_resonant_init();
+    motor_loop_reset();
+}
+
+
+/**
+ * @brief at every start: the next step takes the references from the motor
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_loop_reset(void)
+{
+    loop.running   = 0;
+    loop.phase     = 0;
+    loop.speed_ff  = 0;
+    loop.torque_ff = 0;
+}
+
+
+/**
+ * @brief change the controlled quantity, bumpless
+ * 
+ * @param[in] mode: torque, speed or position
+ * @return None
+ */
+void motor_loop_mode_set(loop_mode_e mode)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    motor_loop_mode_apply(mode);
+    __set_PRIMASK(primask);
+}
+
+
+/**
+ * @brief torque mode reference
+ * 
+ * @param[in] torque: torque equivalent current, q15
+ * @return None
+ */
+void motor_loop_torque_ref_set(int16_t torque)
+{
+    loop.torque_ref = torque;
+}
+
+
+/**
+ * @brief speed mode reference, the target of the profile with traj_on
+ * 
+ * @param[in] speed: angle step per pwm period, signed
+ * @param[in] torque_ff: torque feedforward (acceleration, known load), q15
+ * @return None
+ */
+void motor_loop_speed_ref_set(int16_t speed, int16_t torque_ff)
+{
+    if(loop.traj_on != 0)
+    {
+        motor_traj_speed_target(speed);
+    }
+    else
+    {
+        loop.speed_ref = speed;
+    }
+    loop.torque_ff = torque_ff;
+}
+
+
+/**
+ * @brief position mode reference, the target of the profile with traj_on
+ * 
+ * @param[in] pos: electrical angle summed over turns, 65536 per electrical turn, modulo 2^32
+ * @param[in] speed_ff: speed feedforward, angle step per pwm period (the profile's with traj_on)
+ * @param[in] torque_ff: torque feedforward, q15
+ * @return None
+ */
+void motor_loop_position_ref_set(int32_t pos, int16_t speed_ff, int16_t torque_ff)
+{
+    uint32_t primask;
+
+    if(loop.traj_on != 0)
+    {
+        motor_traj_position_target(pos);
+    }
+    else
+    {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        loop.pos_ref  = pos;
+        loop.speed_ff = speed_ff;
+        __set_PRIMASK(primask);
+    }
+    loop.torque_ff = torque_ff;
+}
+
+
+/**
+ * @brief speed PI gains, can be changed while running, both at once
+ * 
+ * @param[in] kp: q8 of q15 torque per angle step per period
+ * @param[in] ki: same unit, per speed loop step
+ * @return None
+ */
+void motor_loop_speed_pi_set(int32_t kp, int32_t ki)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    loop.speed_pi.kp = kp;
+    loop.speed_pi.ki = ki;
+    __set_PRIMASK(primask);
+}
+
+
+/**
+ * @brief references through the profile generator or straight, restarts the profile at the motor
+ * 
+ * @param[in] enable: 1 profile, 0 straight
+ * @return None
+ */
+void motor_loop_traj_enable(uint8_t enable)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    loop.traj_on = enable;
+    motor_loop_mode_apply(loop.mode);
+    __set_PRIMASK(primask);
+}
+
+
+/**
+ * @brief TIM1 update interrupt once the motor runs closed loop: at most one slow loop per period
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_loop_pwm_isr(void)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t cycles;
+
+    if(loop.running == 0)
+    {
+        loop.running        = 1;
+        loop.phase          = 0;
+        loop.speed          = motor_foc_speed();
+        loop.theta_prev     = foc.theta;
+        loop.pos            = 0;
+        loop.torque         = foc.iq_ref;
+        loop.speed_pi.integ = (int32_t)foc.iq_ref << LOOP_PI_SHIFT;
+        motor_loop_mode_apply(loop.mode);
+    }
+
+    /*every period: the angle step stays far from +-32768 up to LOOP_SPEED_MAX; modulo 2^32*/
+    loop.pos        = (int32_t)((uint32_t)loop.pos + (uint32_t)(int32_t)(int16_t)(foc.theta - loop.theta_prev));
+    loop.theta_prev = foc.theta;
+
+    if((loop.phase & (LOOP_SPEED_DIV - 1)) == 0)
+    {
+        motor_loop_speed();
+        cycles = DWT->CYCCNT - start;
+        loop.speed_cycles_max = (cycles > loop.speed_cycles_max) ? cycles : loop.speed_cycles_max;
+    }
+    else if(loop.phase == LOOP_POS_PHASE)
+    {
+        motor_loop_position();
+        cycles = DWT->CYCCNT - start;
+        loop.pos_cycles_max = (cycles > loop.pos_cycles_max) ? cycles : loop.pos_cycles_max;
+    }
+    loop.phase = (loop.phase + 1) & (LOOP_POS_DIV - 1);
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief mode change with the references taken from the motor, interrupts masked or from the interrupt
+ * 
+ * @param[in] mode: torque, speed or position
+ * @return None
+ */
+static void motor_loop_mode_apply(loop_mode_e mode)
+{
+    loop.mode       = mode;
+    loop.speed_ref  = loop.speed;
+    loop.speed_cmd  = loop.speed;
+    loop.pos_ref    = loop.pos;
+    loop.torque_ref = loop.torque;
+    loop.speed_ff   = 0;
+    loop.torque_ff  = 0;
+    motor_traj_reset(loop.pos, loop.speed);
+    motor_resonant_reset(foc.theta);
+    if(mode == LOOP_MODE_POSITION)
+    {
+        motor_traj_position_target(loop.pos);
+    }
+}
+
+
+/**
+ * @brief PI step with feedforward and conditional integration
+ * 
+ * @param[in] pi: the controller
+ * @param[in] err: reference - measurement, within +-LOOP_SPEED_ERR_MAX
+ * @param[in] ff: feedforward, output units
+ * @return output, within +-out_max
+ */
+static int32_t motor_loop_pi(loop_pi_t *pi, int32_t err, int32_t ff)
+{
+    int32_t lim = pi->out_max << LOOP_PI_SHIFT;
+    int32_t integ = pi->integ + pi->ki * err;
+    int32_t out;
+
+    integ = (integ > lim) ? lim : ((integ < -lim) ? -lim : integ);
+    out   = ((pi->kp * err + integ) >> LOOP_PI_SHIFT) + ff;
+    if(out > pi->out_max)
+    {
+        out = pi->out_max;
+        integ = (err > 0) ? pi->integ : integ;
+    }
+    else if(out < -pi->out_max)
+    {
+        out = -pi->out_max;
+        integ = (err < 0) ? pi->integ : integ;
+    }
+    pi->integ = integ;
+
+    return out;
+}
+
+
+/**
+ * @brief speed loop step, or the torque reference in torque mode
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_loop_speed(void)
+{
+    int32_t err;
+    int32_t ff;
+
+    loop.speed = motor_foc_speed();
+    if(loop.mode == LOOP_MODE_TORQUE)
+    {
+        loop.torque = Q15_SAT((int32_t)loop.torque_ref + loop.torque_ff);
+    }
+    else
+    {
+        if(loop.traj_on != 0)
+        {
+            motor_traj_step();
+            loop.speed_ref = traj.speed;
+            loop.pos_ref   = traj.pos;
+            loop.speed_ff  = traj.speed;
+        }
+        if(loop.mode == LOOP_MODE_SPEED)
+        {
+            loop.speed_cmd = loop.speed_ref;
+        }
+        err = (int32_t)loop.speed_cmd - loop.speed;
+        err = (err > LOOP_SPEED_ERR_MAX) ? LOOP_SPEED_ERR_MAX : ((err < -LOOP_SPEED_ERR_MAX) ? -LOOP_SPEED_ERR_MAX : err);
+        ff  = loop.torque_ff;
+        if(res.enable != 0)
+        {
+            ff += motor_resonant_step(foc.theta, err);
+        }
+        loop.torque = (int16_t)motor_loop_pi(&loop.speed_pi, err, ff);
+    }
+    motor_foc_torque_ref_set(loop.torque);
+}
+
+
+/**
+ * @brief position loop step: speed command of the next speed loop steps
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_loop_position(void)
+{
+    int32_t err;
+    int32_t speed;
+
+    if(loop.mode != LOOP_MODE_POSITION)
+    {
+        return;
+    }
+
+    /*modulo 2^32: right across a wrap of the counter*/
+    err   = (int32_t)((uint32_t)loop.pos_ref - (uint32_t)loop.pos);
+    err   = (err > LOOP_POS_ERR_MAX) ? LOOP_POS_ERR_MAX : ((err < -LOOP_POS_ERR_MAX) ? -LOOP_POS_ERR_MAX : err);
+    speed = ((err * loop.pos_kp_q16) >> 16) + loop.speed_ff;
+    loop.speed_cmd = (int16_t)((speed > loop.speed_max) ? loop.speed_max : ((speed < -loop.speed_max) ? -loop.speed_max : speed));
+}
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+/**
+ * @brief one step of the slow loop PI, for the host model
+ * 
+ * @param[in,out] pi: controller, e.g. a copy of loop.speed_pi
+ * @param[in] err: reference - measurement, within +-LOOP_SPEED_ERR_MAX
+ * @param[in] ff: feedforward, output units
+ * @return output, within +-out_max
+ */
+int32_t motor_loop_test_pi(loop_pi_t *pi, int32_t err, int32_t ff)
+{
+    return motor_loop_pi(pi, err, ff);
+}
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
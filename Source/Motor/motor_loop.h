@@ -0,0 +1,133 @@
+/**
+ * @file motor_loop.h
+ * @brief Driver motor_loop Header
+ * 
+ * @details
+ * Position and speed loops around the FOC current loop, decimated from the
+ * pwm update interrupt.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_LOOP_H__
+#define __MOTOR_LOOP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+/* rates: speed loop every 2^LOOP_SPEED_SHIFT periods, position loop every 2^LOOP_POS_SHIFT */
+#define LOOP_SPEED_SHIFT                (2)                 // 5kHz
+#define LOOP_POS_SHIFT                  (4)                 // 1.25kHz, >= LOOP_SPEED_SHIFT + 1
+#define LOOP_SPEED_DIV                  (1 << LOOP_SPEED_SHIFT)
+#define LOOP_POS_DIV                    (1 << LOOP_POS_SHIFT)
+#define LOOP_POS_PHASE                  (LOOP_SPEED_DIV / 2)    // between two speed loop periods
+
+/* speed PI: speed in angle steps per period, torque as torque equivalent current q15,
+   gains q8 of q15 per step. 20Hz with J = 1e-4 kgm^2 and kt = 1.5 * p * flux */
+#define LOOP_PI_SHIFT                   (8)
+#define LOOP_SPEED_KP                   (92700)
+#define LOOP_SPEED_KI                   (580)               // per speed loop step, integral corner at 5Hz
+#define LOOP_SPEED_ERR_MAX              (4096)              // keeps kp * err in 32 bits
+#define LOOP_TORQUE_MAX                 (Q15(MOTOR_RATED_CURRENT_A / MOTOR_I_BASE_A))
+
+/* position P: position in electrical angle steps (65536 per electrical turn), speed out,
+   gain q16 of steps per period per step of error, 5Hz */
+#define LOOP_POS_KP                     ((int32_t)(6.2831853f * 5.0f * MOTOR_TS_S * 65536.0f))
+#define LOOP_POS_ERR_MAX                (1L << 23)
+#define LOOP_SPEED_MAX                  ((int16_t)(MOTOR_RATED_INC * 3 / 2))
+
+/* ============================ Code Enum Definitions ============================ */
+
+typedef enum
+{
+    LOOP_MODE_TORQUE = 0,               /*torque reference straight to the current loop*/
+    LOOP_MODE_SPEED,
+    LOOP_MODE_POSITION,
+}loop_mode_e;
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    int32_t kp;                         /*q LOOP_PI_SHIFT*/
+    int32_t ki;
+    int32_t integ;                      /*output units << LOOP_PI_SHIFT*/
+    int32_t out_max;                    /*symmetric limit, output units*/
+}loop_pi_t;
+
+typedef struct
+{
+    loop_mode_e mode;
+    uint8_t     traj_on;                /*speed / position references through motor_traj*/
+    uint8_t     running;                /*0 until the first step after a start: bumpless init*/
+    uint8_t     phase;                  /*period counter, 0 ~ LOOP_POS_DIV - 1*/
+    int32_t     pos_ref;
+    int32_t     pos;                    /*electrical angle summed over turns, wraps modulo 2^32*/
+    uint16_t    theta_prev;
+    int32_t     pos_kp_q16;
+    int16_t     speed_ref;              /*speed mode reference*/
+    int16_t     speed_ff;               /*added to the position loop output*/
+    int16_t     speed_cmd;              /*speed loop reference actually used*/
+    int16_t     speed;                  /*measured, angle steps per period*/
+    int16_t     speed_max;
+    int16_t     torque_ref;             /*torque mode reference*/
+    int16_t     torque_ff;              /*added to the speed loop output*/
+    int16_t     torque;                 /*torque request given to the current loop*/
+    loop_pi_t   speed_pi;
+    uint32_t    speed_cycles_max;       /*worst slow loop cost, cpu cycles*/
+    uint32_t    pos_cycles_max;
+}loop_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern loop_t loop;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_loop_init(void);
+void motor_loop_reset(void);
+void motor_loop_mode_set(loop_mode_e mode);
+void motor_loop_torque_ref_set(int16_t torque);
+void motor_loop_speed_ref_set(int16_t speed, int16_t torque_ff);
+void motor_loop_position_ref_set(int32_t pos, int16_t speed_ff, int16_t torque_ff);
+void motor_loop_speed_pi_set(int32_t kp, int32_t ki);
+void motor_loop_traj_enable(uint8_t enable);
+void motor_loop_pwm_isr(void);
+
+#ifdef UNIT_TEST
+int32_t motor_loop_test_pi(loop_pi_t *pi, int32_t err, int32_t ff);
+#endif /* UNIT_TEST */
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_LOOP_H__*/
+
+
+/**
+  * @}
+  */
@@ -0,0 +1,164 @@
+/**
+ * @file motor_math.c
+ * @brief Fixed point math for the motor control loops
+ * 
+ * @details
+ * No library calls and no division in the per period paths.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_math.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+/* one full period, the extra entry lets the interpolation read [i + 1] without wrapping */
+const int16_t motor_sin_table[MOTOR_SIN_TABLE_SIZE + 1] =
+{
+         0,    804,   1608,   2410,   3212,   4011,   4808,   5602,
+      6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+     12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+     18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+     23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,
+     27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+     30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,
+     32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+     32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,
+     32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,
+     30273,  29956,  29621,  29268,  28898,  28510,  28105,  27683,
+     27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+     23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,
+     18204,  17530,  16846,  16151,  15446,  14732,  14010,  13279,
+     12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,
+      6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,
+         0,   -804,  -1608,  -2410,  -3212,  -4011,  -4808,  -5602,
+     -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+    -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530,
+    -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+    -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+    -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+    -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971,
+    -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+    -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285,
+    -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+    -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+    -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+    -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868,
+    -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+    -12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,
+     -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804,
+         0,
+};
+
+/* ============================ Static Global Variables ============================ */
+
+/* atan(2^-i) in 65536 = 360 degree units, for the CORDIC vectoring */
+static const uint16_t motor_atan_table[14] =
+{
+    8192, 4836, 2555, 1297, 651, 326, 163,
+    81, 41, 20, 10, 5, 3, 1,
+};
+
+/* ============================ Static Function Declarations ============================ */
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief integer square root, bit by bit (16 iterations, no division)
+ * 
+ * @param[in] x: 0 ~ 0xFFFFFFFF
+ * @return floor(sqrt(x))
+ */
+uint16_t motor_math_sqrt(uint32_t x)
+{
+    uint32_t root = 0;
+    uint32_t bit  = 1UL << 30;
+
+    while(bit != 0)
+    {
+        if(x >= root + bit)
+        {
+            x    -= root + bit;
+            root  = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint16_t)root;
+}
+
+
+/**
+ * @brief angle of the vector (x, y), CORDIC vectoring (14 iterations, no division)
+ * 
+ * @param[in] y: q15
+ * @param[in] x: q15
+ * @return 0 ~ 65535 = 0 ~ 360 degree
+ */
+uint16_t motor_math_atan2(int16_t y, int16_t x)
+{
+    int32_t xi = x;
+    int32_t yi = y;
+    int32_t t;
+    uint16_t angle = 0;
+    uint8_t i;
+
+    /*rotate into the right half plane first*/
+    if(xi < 0)
+    {
+        angle = 32768U;
+        xi    = -xi;
+        yi    = -yi;
+    }
+
+    for(i = 0; i < 14; i++)
+    {
+        t = xi;
+        if(yi > 0)
+        {
+            xi    += yi >> i;
+            yi    -= t >> i;
+            angle += motor_atan_table[i];
+        }
+        else
+        {
+            xi    -= yi >> i;
+            yi    += t >> i;
+            angle -= motor_atan_table[i];
+        }
+    }
+
+    return angle;
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,98 @@
+/**
+ * @file motor_math.h
+ * @brief Driver motor_math Header
+ * 
+ * @details
+ * Fixed point helpers shared by the control loops. Angles are uint16_t
+ * electrical angles, 65536 = 360 degree, values are q15 unless stated.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_MATH_H__
+#define __MOTOR_MATH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+
+/* ============================ Public Constants ============================ */
+
+#define Q15_ONE                         (32767)
+#define Q15(x)                          ((int16_t)((x) * 32767.0f))
+#define ANGLE_DEG(x)                    ((uint16_t)((x) * 65536.0f / 360.0f))
+
+#define MOTOR_SIN_TABLE_BITS            (8)
+#define MOTOR_SIN_TABLE_SIZE            (1 << MOTOR_SIN_TABLE_BITS)
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern const int16_t motor_sin_table[MOTOR_SIN_TABLE_SIZE + 1];
+
+/* ============================ Macro Function Declarations ============================ */
+
+#define Q15_MUL(a, b)           ((int16_t)(((int32_t)(a) * (int32_t)(b)) >> 15))
+#define Q15_SAT(x)              ((int16_t)(((x) > 32767) ? 32767 : (((x) < -32768) ? -32768 : (x))))
+
+/* ============================ Function Declarations ============================ */
+
+/**
+ * @brief sine of an electrical angle, 256 entry table with linear interpolation (error < 4 lsb)
+ * 
+ * @param[in] theta: 0 ~ 65535 = 0 ~ 360 degree
+ * @return q15 sine
+ */
+static __INLINE int16_t motor_math_sin(uint16_t theta)
+{
+    uint32_t i    = theta >> (16 - MOTOR_SIN_TABLE_BITS);
+    int32_t  frac = theta & ((1 << (16 - MOTOR_SIN_TABLE_BITS)) - 1);
+    int32_t  s0   = motor_sin_table[i];
+
+    return (int16_t)(s0 + (((motor_sin_table[i + 1] - s0) * frac) >> (16 - MOTOR_SIN_TABLE_BITS)));
+}
+
+
+/**
+ * @brief cosine of an electrical angle
+ * 
+ * @param[in] theta: 0 ~ 65535 = 0 ~ 360 degree
+ * @return q15 cosine
+ */
+static __INLINE int16_t motor_math_cos(uint16_t theta)
+{
+    return motor_math_sin((uint16_t)(theta + 16384U));
+}
+
+uint16_t motor_math_sqrt(uint32_t x);
+uint16_t motor_math_atan2(int16_t y, int16_t x);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_MATH_H__*/
+
+
+/**
+  * @}
+  */
@@ -0,0 +1,77 @@
+/**
+ * @file motor_mtpa.c
+ * @brief MTPA current references by table interpolation
+ * 
+ * @details
+ * The torque request is a torque equivalent current (q15): the q current giving
+ * that torque with id = 0, so a speed loop keeps its gain whether the reluctance
+ * torque is used or not. The table (motor_mtpa_table.h, in flash) is generated
+ * by Tools/motor_mtpa_gen.c from Ld, Lq and the magnet flux and holds id, iq on
+ * 33 evenly spaced requests; between them both are linearly interpolated.
+ * Cost: one index, two multiplies, no division. Rerun the generator when the
+ * motor parameters change.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_mtpa.h"
+#include "motor_mtpa_table.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief id / iq of a torque request, negative torque gives negative iq with the same id
+ * 
+ * @param[in] torque: torque equivalent current, q15
+ * @param[out] id_ref: q15
+ * @param[out] iq_ref: q15
+ * @return None
+ */
+void motor_mtpa_ref(int16_t torque, int16_t *id_ref, int16_t *iq_ref)
+{
+    int32_t t    = (torque < 0) ? -(int32_t)torque : torque;
+    int32_t k;
+    int32_t frac;
+    int32_t iq;
+
+    t    = (t > 32767) ? 32767 : t;
+    k    = t >> MTPA_SEG_SHIFT;
+    frac = t & ((1 << MTPA_SEG_SHIFT) - 1);
+
+    *id_ref = (int16_t)(mtpa_table[k][0] + (((mtpa_table[k + 1][0] - mtpa_table[k][0]) * frac) >> MTPA_SEG_SHIFT));
+    iq      = mtpa_table[k][1] + (((mtpa_table[k + 1][1] - mtpa_table[k][1]) * frac) >> MTPA_SEG_SHIFT);
+    *iq_ref = (int16_t)((torque < 0) ? -iq : iq);
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
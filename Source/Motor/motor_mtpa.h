@@ -0,0 +1,62 @@
+/**
+ * @file motor_mtpa.h
+ * @brief Driver motor_mtpa Header
+ * 
+ * @details
+ * Maximum torque per ampere references of a salient motor from a const table.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_MTPA_H__
+#define __MOTOR_MTPA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+
+/* ============================ Public Constants ============================ */
+
+/* table layout, Tools/motor_mtpa_gen.c uses the same */
+#define MTPA_SEG_SHIFT                  (10)                // 32 segments over q15
+#define MTPA_SEGMENTS                   (32768 >> MTPA_SEG_SHIFT)
+#define MTPA_TABLE_SIZE                 (MTPA_SEGMENTS + 1)
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_mtpa_ref(int16_t torque, int16_t *id_ref, int16_t *iq_ref);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_MTPA_H__*/
+
+
+/**
+  * @}
+  */
@@ -0,0 +1,67 @@
+/**
+ * @file motor_mtpa_table.h
+ * @brief MTPA table, generated by Tools/motor_mtpa_gen.c, do not edit
+ * 
+ * @details
+ * Ld 0.00045 H, Lq 0.0006 H, flux 0.0055 Wb, current base 16.5 A.
+ * Row k: id, iq (q15) of the torque equivalent current k / 32 of the base.
+ * Interpolated: id err 0.0023 A, iq err 0.0016 A, current excess 0.0115%.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_MTPA_TABLE_H__
+#define __MOTOR_MTPA_TABLE_H__
+
+static const int16_t mtpa_table[MTPA_TABLE_SIZE][2] =
+{
+    {     0,      0},                   // torque request 0
+    {   -14,   1024},
+    {   -57,   2046},
+    {  -129,   3066},
+    {  -228,   4083},
+    {  -355,   5095},
+    {  -508,   6101},
+    {  -686,   7101},
+    {  -889,   8093},
+    { -1114,   9077},
+    { -1362,  10052},
+    { -1630,  11017},
+    { -1918,  11972},
+    { -2224,  12917},
+    { -2546,  13851},
+    { -2884,  14774},
+    { -3236,  15686},
+    { -3601,  16587},
+    { -3977,  17477},
+    { -4365,  18355},
+    { -4763,  19222},
+    { -5169,  20078},
+    { -5584,  20923},
+    { -6006,  21757},
+    { -6434,  22580},
+    { -6868,  23393},
+    { -7307,  24195},
+    { -7750,  24988},
+    { -8197,  25770},
+    { -8648,  26543},
+    { -9102,  27306},
+    { -9558,  28060},
+    {-10017,  28805},
+};
+
+#endif /*__MOTOR_MTPA_TABLE_H__*/
+
+
+/**
+  * @}
+  */
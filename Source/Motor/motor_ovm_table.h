@@ -0,0 +1,58 @@
+/**
+ * @file motor_ovm_table.h
+ * @brief Overmodulation gain table, generated by Tools/motor_ovm_gen.c, do not edit
+ * 
+ * @details
+ * Entry k: 1 / gain (q15) at |v|^2 = (24576 + k * 256) / 32768, units of 2/3 Vbus.
+ * Fundamental gain error up to six-step: 0.037%.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_OVM_TABLE_H__
+#define __MOTOR_OVM_TABLE_H__
+
+/* end of mode I: the trajectory on the hexagon, fundamental q15 */
+#define SVPWM_OVM1_V_MAX                (29932)
+
+static const int16_t svpwm_ovm_table[SVPWM_OVM_TABLE_SIZE] =
+{
+     32767,                         // linear circle
+     32741,
+     32682,
+     32596,
+     32481,
+     32334,
+     32148,
+     31915,
+     31619,
+     31231,
+     30682,
+     29681,
+     28273,
+     26752,
+     25099,
+     23284,
+     21267,
+     18983,
+     16320,
+     13049,
+      8493,
+         0,
+};
+
+#endif /*__MOTOR_OVM_TABLE_H__*/
+
+
+/**
+  * @}
+  */
@@ -0,0 +1,79 @@
+/**
+ * @file motor_param.h
+ * @brief Driver motor_param Header
+ * 
+ * @details
+ * Motor nameplate / identified parameters and the per unit bases of the
+ * control loops. Everything here is a compile time constant, the fixed point
+ * gains of the observers and controllers are derived from it.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_PARAM_H__
+#define __MOTOR_PARAM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "bsp_pwm.h"
+
+/* ============================ Public Constants ============================ */
+
+#define MOTOR_POLE_PAIRS                (4)
+#define MOTOR_RS_OHM                    (0.35f)
+#define MOTOR_LD_H                      (0.00045f)
+#define MOTOR_LQ_H                      (0.00060f)
+#define MOTOR_FLUX_WB                   (0.0055f)               // permanent magnet flux linkage
+#define MOTOR_J_KGM2                    (1e-4f)                 // rotor and load, the speed loop gains assume it
+#define MOTOR_RATED_RPM                 (3000)
+#define MOTOR_RATED_CURRENT_A           (8.0f)
+#define MOTOR_VBUS_NOM_V                (24.0f)
+#define MOTOR_VBUS_ADC_FS_V             (69.3f)                 // adc full scale bus voltage, 3.3V * (200k + 10k) / 10k
+
+/* per unit bases: q15 1.0 of a current / voltage */
+#define MOTOR_I_BASE_A                  (16.5f)                 // adc full scale current, 1.65V / (5mOhm * 20)
+#define MOTOR_V_BASE_V                  (MOTOR_VBUS_NOM_V * 0.66666667f)    // 2/3 Vbus: the hexagon vertex, six-step fits
+#define MOTOR_V_LINEAR                  (0.8660254f)            // largest circle of the linear modulation range, of MOTOR_V_BASE_V
+#define MOTOR_TS_S                      (1.0f / PWM_FREQ_HZ)
+
+/* electrical speed as angle step per pwm period (65536 = 360 degree) */
+#define MOTOR_RPM_TO_INC(rpm)           ((rpm) * MOTOR_POLE_PAIRS * 65536.0f / 60.0f / PWM_FREQ_HZ)
+#define MOTOR_RATED_INC                 ((int32_t)MOTOR_RPM_TO_INC(MOTOR_RATED_RPM))
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_PARAM_H__*/
+
+
+/**
+  * @}
+  */
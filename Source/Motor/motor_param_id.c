@@ -0,0 +1,672 @@
+/**
+ * @file motor_param_id.c
+ * @brief Motor parameter identification
+ * 
+ * @details
+ * A fixed sequence of test segments through TIM1, each period one sample of
+ * the two phase shunts (as the position detection), with the motor unloaded:
+ * - alignment: a dc current swept from 90 to 0 degree, the rotor follows it to
+ *   the alpha axis and stays there, d = alpha, q = beta
+ * - dc: the current PI holds two dc levels along d, the voltage over the
+ *   current gives Rs, the intercept (dead time, drops) is left out
+ * - pulse: the PI voltages are frozen on the low dc level and a +V, +V, -V, -V
+ *   square wave is added along d, then along q. Between two samples the
+ *   current steps by Ts / L * (mean of the two voltages written before it - Rs * i),
+ *   the fit of the step over that voltage and the current gives Ld and Lq
+ * - rotating: the current vector turns at a ramped speed (I/f), the rotor
+ *   follows it with the load angle its torque needs. In the holds the current
+ *   is along d and the voltage across it is w * (flux + Ld * i): flux. The
+ *   power into the motor, 1.5 * v . i, is the losses plus J * w * dw/dt of the
+ *   ramps up and down between the same speeds: inertia. The frame of the
+ *   current is damped with the voltage across it, the ramps (0.6s) keep the
+ *   load angle low enough up to about 3x the motor_param.h inertia
+ * 
+ * Every fit is a streaming least squares: the sums of the normal equations of
+ * y = a + b * x1 + c * x2 are accumulated in 64 bits per period and solved once at
+ * the end of the fit, the intercept a is not needed. Two accumulators (the
+ * rotating test fits flux and inertia together), no waveform is kept.
+ * 
+ * Voltages are the commanded ones in volts of the nominal bus (MOTOR_V_BASE_V),
+ * the results scale with Vbus / MOTOR_VBUS_NOM_V.
+ * Timing with the defaults: 3.6s, reported in param_id.time_us.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_pwm.h"
+#include "bsp_adc.h"
+#include "motor_six_step.h"
+#include "motor_svpwm.h"
+#include "motor_foc.h"
+#include "motor_param_id.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define PARAM_ID_INV_SQRT3      (18919)     // 1 / sqrt(3), q15
+#define PARAM_ID_I_TRIP         (4 * PARAM_ID_I_HIGH)
+#define PARAM_ID_W_SHIFT        (10)        // speed regressor: q16 angle steps per period >> 10
+#define PARAM_ID_SPEED_SHIFT    (4)         // frame speed filter, 0.8ms
+
+#define PARAM_ID_TEST_ALIGN     (0)
+#define PARAM_ID_TEST_DC        (1)
+#define PARAM_ID_TEST_PULSE_D   (2)
+#define PARAM_ID_TEST_PULSE_Q   (3)
+#define PARAM_ID_TEST_SPIN      (4)
+
+#define PARAM_ID_FIT_RS         (0x01)
+#define PARAM_ID_FIT_LD         (0x02)
+#define PARAM_ID_FIT_LQ         (0x04)
+#define PARAM_ID_FIT_FLUX       (0x08)
+#define PARAM_ID_FIT_J          (0x10)
+
+/* slopes of the fits to SI */
+#define PARAM_ID_W_RAD_S        (6.2831853f * PWM_FREQ_HZ * (1 << PARAM_ID_W_SHIFT) / 65536.0f / 65536.0f)
+#define PARAM_ID_A_RAD_S2       (6.2831853f * PWM_FREQ_HZ * PWM_FREQ_HZ / 65536.0f / 65536.0f)
+#define PARAM_ID_P_W            (1.5f * MOTOR_V_BASE_V * MOTOR_I_BASE_A / 32768.0f)
+#define PARAM_ID_R_OHM          (MOTOR_V_BASE_V / MOTOR_I_BASE_A)
+#define PARAM_ID_L_H            (MOTOR_TS_S * MOTOR_V_BASE_V / MOTOR_I_BASE_A)
+#define PARAM_ID_FLUX_WB        (MOTOR_V_BASE_V / 32768.0f / PARAM_ID_W_RAD_S)
+#define PARAM_ID_J_KGM2         (PARAM_ID_P_W * MOTOR_POLE_PAIRS * MOTOR_POLE_PAIRS / \
+                                 ((1 << PARAM_ID_J_SHIFT) * PARAM_ID_W_RAD_S * PARAM_ID_A_RAD_S2))
+#define PARAM_ID_I_HIGH_A       (PARAM_ID_I_HIGH * MOTOR_I_BASE_A / 32768.0f)
+
+/* ============================ Module Internal Data Structures ============================ */
+
+typedef struct
+{
+    uint8_t  test;                      /*PARAM_ID_TEST_x*/
+    uint8_t  fit;                       /*PARAM_ID_FIT_x accumulated in the segment*/
+    uint8_t  solve;                     /*PARAM_ID_FIT_x solved at its end*/
+    uint16_t periods;
+    int16_t  i_ref;                     /*current along the frame, q15*/
+    int16_t  inc;                       /*frame speed at the end of the segment, ramped to it*/
+}param_id_seg_t;
+
+/* ============================ Global Variables ============================ */
+
+param_id_t param_id;
+
+/* ============================ Static Global Variables ============================ */
+
+static const uint8_t param_id_adc_seq[3] = {ADC_IU_CH, ADC_IV_CH, ADC_VBUS_CH};
+static const param_id_ls_t param_id_ls_zero = {0};
+
+static const param_id_seg_t param_id_seq[] =
+{
+    {PARAM_ID_TEST_ALIGN,   0,                                   0,                  4000,  PARAM_ID_I_HIGH, 0},
+    {PARAM_ID_TEST_DC,      0,                                   0,                  2000,  PARAM_ID_I_HIGH, 0},
+    {PARAM_ID_TEST_DC,      PARAM_ID_FIT_RS,                     0,                  4096,  PARAM_ID_I_HIGH, 0},
+    {PARAM_ID_TEST_DC,      0,                                   0,                  1000,  PARAM_ID_I_LOW,  0},
+    {PARAM_ID_TEST_DC,      PARAM_ID_FIT_RS,                     PARAM_ID_FIT_RS,    4096,  PARAM_ID_I_LOW,  0},
+    {PARAM_ID_TEST_PULSE_D, 0,                                   0,                  64,    PARAM_ID_I_LOW,  0},
+    {PARAM_ID_TEST_PULSE_D, PARAM_ID_FIT_LD,                     PARAM_ID_FIT_LD,    4096,  PARAM_ID_I_LOW,  0},
+    {PARAM_ID_TEST_PULSE_Q, 0,                                   0,                  64,    PARAM_ID_I_LOW,  0},
+    {PARAM_ID_TEST_PULSE_Q, PARAM_ID_FIT_LQ,                     PARAM_ID_FIT_LQ,    4096,  PARAM_ID_I_LOW,  0},
+    {PARAM_ID_TEST_SPIN,    0,                                   0,                  10000, PARAM_ID_I_HIGH, PARAM_ID_INC_1},
+    {PARAM_ID_TEST_SPIN,    0,                                   0,                  2000,  PARAM_ID_I_HIGH, PARAM_ID_INC_1},
+    {PARAM_ID_TEST_SPIN,    PARAM_ID_FIT_FLUX | PARAM_ID_FIT_J,  0,                  2000,  PARAM_ID_I_HIGH, PARAM_ID_INC_1},
+    {PARAM_ID_TEST_SPIN,    PARAM_ID_FIT_J,                      0,                  12000, PARAM_ID_I_HIGH, PARAM_ID_INC_2},
+    {PARAM_ID_TEST_SPIN,    PARAM_ID_FIT_J,                      0,                  2000,  PARAM_ID_I_HIGH, PARAM_ID_INC_2},
+    {PARAM_ID_TEST_SPIN,    PARAM_ID_FIT_FLUX | PARAM_ID_FIT_J,  PARAM_ID_FIT_FLUX,  2000,  PARAM_ID_I_HIGH, PARAM_ID_INC_2},
+    {PARAM_ID_TEST_SPIN,    PARAM_ID_FIT_J,                      PARAM_ID_FIT_J,     12000, PARAM_ID_I_HIGH, PARAM_ID_INC_1},
+    {PARAM_ID_TEST_SPIN,    0,                                   0,                  6000,  PARAM_ID_I_HIGH, 0},
+};
+
+#define PARAM_ID_SEGS           (sizeof(param_id_seq) / sizeof(param_id_seq[0]))
+
+/* ============================ Static Function Declarations ============================ */
+
+static void motor_param_id_reset(void);
+static void motor_param_id_seg_begin(uint8_t seg);
+static void motor_param_id_ls_add(param_id_ls_t *ls, int32_t x1, int32_t x2, int32_t y);
+static uint8_t motor_param_id_ls_solve(param_id_ls_t *ls, float *b, float *c);
+static uint8_t motor_param_id_solve(uint8_t fit);
+static void motor_param_id_current_pi(int16_t i_x, int16_t i_y, int16_t i_ref);
+static void motor_param_id_frame_update(void);
+static void motor_param_id_output(int32_t v_x, int32_t v_y, int16_t i_ref);
+static void motor_param_id_step(int16_t ia, int16_t ib);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init, the parameter block from motor_param.h
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_param_id_init(void)
+{
+    param_id.state         = PARAM_ID_STATE_IDLE;
+    param_id.block.rs_ohm  = MOTOR_RS_OHM;
+    param_id.block.ld_h    = MOTOR_LD_H;
+    param_id.block.lq_h    = MOTOR_LQ_H;
+    param_id.block.flux_wb = MOTOR_FLUX_WB;
+    param_id.block.j_kgm2  = MOTOR_J_KGM2;
+}
+
+
+/**
+ * @brief start the identification: current offsets with the outputs off, then the test segments
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_param_id_start(void)
+{
+    bsp_pwm_output_enable(DISABLE);
+    motor_param_id_reset();
+
+    PWM_DUTY_SET(SVPWM_HALF, SVPWM_HALF, SVPWM_HALF);
+    bsp_pwm_complementary_mode();
+    bsp_adc_inj_seq_set(param_id_adc_seq, 3);
+    bsp_pwm_adc_trig_select(PWM_ADC_TRIG_LOW_SIDE);
+    ADC_INJ_IRQ_ENABLE();
+}
+
+
+/**
+ * @brief abort the identification, all phases off, the parameter block is kept
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_param_id_stop(void)
+{
+    param_id.state = PARAM_ID_STATE_IDLE;
+    motor_six_step_stop();
+}
+
+
+/**
+ * @brief adc injected end of conversion: rank1 = Iu, rank2 = Iv
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_param_id_adc_isr(void)
+{
+    uint16_t raw_a = ADC_INJ_DAT1();
+    uint16_t raw_b = ADC_INJ_DAT2();
+
+    if(param_id.state == PARAM_ID_STATE_OFFSET)
+    {
+        param_id.offset_acc_a += raw_a;
+        param_id.offset_acc_b += raw_b;
+        motor_param_id_step(0, 0);
+        if(param_id.state == PARAM_ID_STATE_RUN)
+        {
+            param_id.offset_a = (uint16_t)(param_id.offset_acc_a >> PARAM_ID_OFFSET_SHIFT);
+            param_id.offset_b = (uint16_t)(param_id.offset_acc_b >> PARAM_ID_OFFSET_SHIFT);
+            PWM_DUTY_SET(param_id.duty[0], param_id.duty[1], param_id.duty[2]);
+            bsp_pwm_output_enable(ENABLE);
+        }
+        return;
+    }
+    if(param_id.state != PARAM_ID_STATE_RUN)
+    {
+        return;
+    }
+
+    motor_param_id_step(Q15_SAT(((int32_t)param_id.offset_a - raw_a) << FOC_CURRENT_SHIFT),
+                        Q15_SAT(((int32_t)param_id.offset_b - raw_b) << FOC_CURRENT_SHIFT));
+    if(param_id.state != PARAM_ID_STATE_RUN)
+    {
+        bsp_pwm_output_enable(DISABLE);
+    }
+    PWM_DUTY_SET(param_id.duty[0], param_id.duty[1], param_id.duty[2]);
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief clear the test and begin with the offset measurement
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_param_id_reset(void)
+{
+    param_id.seg          = 0;
+    param_id.fail_seg     = 0;
+    param_id.step         = 0;
+    param_id.tick         = 0;
+    param_id.offset_acc_a = 0;
+    param_id.offset_acc_b = 0;
+    param_id.time_us      = 0;
+    param_id.est          = param_id.block;
+    param_id.duty[0]      = SVPWM_HALF;
+    param_id.duty[1]      = SVPWM_HALF;
+    param_id.duty[2]      = SVPWM_HALF;
+    param_id.state        = PARAM_ID_STATE_OFFSET;
+}
+
+
+/**
+ * @brief enter a segment: ramp of the speed, the pi is kept running from the previous one
+ * 
+ * @param[in] seg: index in param_id_seq
+ * @return None
+ */
+static void motor_param_id_seg_begin(uint8_t seg)
+{
+    const param_id_seg_t *s = &param_id_seq[seg];
+    uint8_t i;
+
+    param_id.seg   = seg;
+    param_id.step  = 0;
+    param_id.accel = (((int32_t)s->inc << 16) - param_id.speed) / s->periods;
+    if(seg == 0)
+    {
+        param_id.theta   = (uint32_t)16384 << 16;
+        param_id.frame   = param_id.theta;
+        param_id.speed   = 0;
+        param_id.accel   = 0;
+        param_id.integ_x = 0;
+        param_id.integ_y = 0;
+        param_id.v_x     = 0;
+        param_id.v_y     = 0;
+        param_id.v_pulse[0] = 0;
+        param_id.v_pulse[1] = 0;
+        for(i = 0; i < 2; i++)
+        {
+            param_id.ls[i] = param_id_ls_zero;
+        }
+    }
+}
+
+
+/**
+ * @brief one sample of y = a + b * x1 + c * x2 into the normal equations
+ * 
+ * @details
+ * Regressors and output within +-2^16, at most 2^15 samples: the products of
+ * two sums in motor_param_id_ls_solve() stay in 64 bits.
+ * 
+ * @param[in] ls: the accumulator
+ * @param[in] x1: first regressor
+ * @param[in] x2: second regressor, 0 for a straight line
+ * @param[in] y: output
+ * @return None
+ */
+static void motor_param_id_ls_add(param_id_ls_t *ls, int32_t x1, int32_t x2, int32_t y)
+{
+    ls->n++;
+    ls->s1  += x1;
+    ls->s2  += x2;
+    ls->sy  += y;
+    ls->s11 += (int64_t)x1 * x1;
+    ls->s12 += (int64_t)x1 * x2;
+    ls->s22 += (int64_t)x2 * x2;
+    ls->s1y += (int64_t)x1 * y;
+    ls->s2y += (int64_t)x2 * y;
+}
+
+
+/**
+ * @brief slopes of the fit, the sums are cleared
+ * 
+ * @details
+ * The means are taken out in 64 bits, the small centred sums go to float.
+ * 
+ * @param[in] ls: the accumulator
+ * @param[out] b: slope over x1
+ * @param[out] c: slope over x2, 0 for a straight line
+ * @return 1: solved, 0: too few samples or the regressors do not vary
+ */
+static uint8_t motor_param_id_ls_solve(param_id_ls_t *ls, float *b, float *c)
+{
+    int64_t n = ls->n;
+    float   c11;
+    float   c12;
+    float   c22;
+    float   c1y;
+    float   c2y;
+    float   det;
+
+    *b = 0.0f;
+    *c = 0.0f;
+    if(n < 16)
+    {
+        *ls = param_id_ls_zero;
+        return 0;
+    }
+    c11 = (float)(ls->s11 - ls->s1 * ls->s1 / n);
+    c12 = (float)(ls->s12 - ls->s1 * ls->s2 / n);
+    c22 = (float)(ls->s22 - ls->s2 * ls->s2 / n);
+    c1y = (float)(ls->s1y - ls->s1 * ls->sy / n);
+    c2y = (float)(ls->s2y - ls->s2 * ls->sy / n);
+    *ls = param_id_ls_zero;
+
+    if(c22 <= 0.0f)
+    {
+        if(c11 <= 0.0f)
+        {
+            return 0;
+        }
+        *b = c1y / c11;
+        return 1;
+    }
+    det = c11 * c22 - c12 * c12;
+    if(det <= 1e-6f * c11 * c22)
+    {
+        return 0;
+    }
+    *b = (c1y * c22 - c2y * c12) / det;
+    *c = (c2y * c11 - c1y * c12) / det;
+
+    return 1;
+}
+
+
+/**
+ * @brief solve the fits ending with the segment into param_id.est
+ * 
+ * @param[in] fit: PARAM_ID_FIT_x
+ * @return 1: plausible results, 0: a fit failed
+ */
+static uint8_t motor_param_id_solve(uint8_t fit)
+{
+    float   b;
+    float   c;
+    uint8_t ok = 1;
+
+    if((fit & (PARAM_ID_FIT_RS | PARAM_ID_FIT_LD | PARAM_ID_FIT_LQ | PARAM_ID_FIT_FLUX)) != 0)
+    {
+        ok = motor_param_id_ls_solve(&param_id.ls[0], &b, &c);
+        if(fit & PARAM_ID_FIT_RS)
+        {
+            /*v = v0 + Rs * i*/
+            param_id.est.rs_ohm = b * PARAM_ID_R_OHM;
+            ok &= (b > 0.0f) ? 1 : 0;
+        }
+        else if(fit & (PARAM_ID_FIT_LD | PARAM_ID_FIT_LQ))
+        {
+            /*di = a + Ts / L * v - Ts * Rs / L * i*/
+            ok &= (b > 0.0f) ? 1 : 0;
+            b   = (b > 0.0f) ? (PARAM_ID_L_H / b) : 0.0f;
+            if(fit & PARAM_ID_FIT_LD)
+            {
+                param_id.est.ld_h = b;
+            }
+            else
+            {
+                param_id.est.lq_h = b;
+            }
+        }
+        else
+        {
+            /*v across the current = v0 + w * (flux + Ld * i)*/
+            param_id.est.flux_wb = b * PARAM_ID_FLUX_WB - param_id.est.ld_h * PARAM_ID_I_HIGH_A;
+            ok &= (param_id.est.flux_wb > 0.0f) ? 1 : 0;
+        }
+    }
+    if((fit & PARAM_ID_FIT_J) != 0)
+    {
+        /*p = losses(w) + J * w * dw/dt*/
+        ok &= motor_param_id_ls_solve(&param_id.ls[1], &b, &c);
+        param_id.est.j_kgm2 = c * PARAM_ID_J_KGM2;
+        ok &= (c > 0.0f) ? 1 : 0;
+    }
+
+    return ok;
+}
+
+
+/**
+ * @brief current PI in the test frame, the result in param_id.v_x / v_y
+ * 
+ * @param[in] i_x: current along the frame, q15
+ * @param[in] i_y: current across the frame, q15
+ * @param[in] i_ref: current reference along the frame, q15
+ * @return None
+ */
+static void motor_param_id_current_pi(int16_t i_x, int16_t i_y, int16_t i_ref)
+{
+    const int32_t integ_max = (int32_t)FOC_V_MAX << 15;
+    int32_t err_x = Q15_SAT((int32_t)i_ref - i_x);
+    int32_t err_y = Q15_SAT(-(int32_t)i_y);
+    int32_t vx;
+    int32_t vy;
+    int32_t vy_max;
+
+    param_id.integ_x += err_x * FOC_ID_KI;
+    param_id.integ_y += err_y * FOC_IQ_KI;
+    param_id.integ_x  = (param_id.integ_x > integ_max) ? integ_max : ((param_id.integ_x < -integ_max) ? -integ_max : param_id.integ_x);
+    param_id.integ_y  = (param_id.integ_y > integ_max) ? integ_max : ((param_id.integ_y < -integ_max) ? -integ_max : param_id.integ_y);
+
+    vx = (err_x * FOC_ID_KP + param_id.integ_x) >> 15;
+    vy = (err_y * FOC_IQ_KP + param_id.integ_y) >> 15;
+    vx = (vx > FOC_V_MAX) ? FOC_V_MAX : ((vx < -FOC_V_MAX) ? -FOC_V_MAX : vx);
+    vy_max = motor_math_sqrt((uint32_t)(FOC_V_MAX * FOC_V_MAX) - (uint32_t)(vx * vx));
+    vy = (vy > vy_max) ? vy_max : ((vy < -vy_max) ? -vy_max : vy);
+
+    param_id.v_x = (int16_t)vx;
+    param_id.v_y = (int16_t)vy;
+}
+
+
+/**
+ * @brief frame of the next period: the test angle, pulled back by the voltage across the current
+ * 
+ * @details
+ * The rotor follows the current like a spring with hardly any damping. The
+ * voltage across the current carries its speed (w * flux), taking it off the
+ * frame angle turns that into a damping torque: about 0.7 of critical with the
+ * motor_param.h motor, a speed offset of the frame only while ramping. The
+ * load angle also moves that voltage (w * flux * sin) against the spring, so
+ * the ramps are kept gentle.
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_param_id_frame_update(void)
+{
+    uint32_t frame = param_id.theta - ((uint32_t)(PARAM_ID_DAMP * param_id.v_y) << 16);
+
+    param_id.frame_speed += ((int32_t)(frame - param_id.frame) - param_id.frame_speed) >> PARAM_ID_SPEED_SHIFT;
+    param_id.frame       = frame;
+}
+
+
+/**
+ * @brief duties of a voltage in the test frame, dead time compensated on the test current
+ * 
+ * @details
+ * The fits take the voltage asked for, as the observers of the current loop:
+ * uncompensated the dead time adds a component across a turning current that
+ * reads as flux.
+ * 
+ * @param[in] v_x: along the frame, q15
+ * @param[in] v_y: across the frame, q15
+ * @param[in] i_ref: test current along the frame, q15
+ * @return None
+ */
+static void motor_param_id_output(int32_t v_x, int32_t v_y, int16_t i_ref)
+{
+    uint16_t theta   = (uint16_t)(param_id.frame >> 16);
+    int32_t  sin_val = motor_math_sin(theta);
+    int32_t  cos_val = motor_math_cos(theta);
+    int16_t  v_alpha = Q15_SAT((v_x * cos_val - v_y * sin_val) >> 15);
+    int16_t  v_beta  = Q15_SAT((v_x * sin_val + v_y * cos_val) >> 15);
+
+    if(dtc.enable != 0)
+    {
+        motor_dtc_apply((int16_t)((i_ref * cos_val) >> 15), (int16_t)((i_ref * sin_val) >> 15), &v_alpha, &v_beta);
+    }
+    motor_svpwm_calc(v_alpha, v_beta, param_id.duty);
+}
+
+
+/**
+ * @brief one pwm period of the test on the current sampled in it, sets param_id.duty for the next
+ * 
+ * @details
+ * The voltage written now is on the bridge from the next valley, centred on the
+ * next sample: it is turned to the frame angle of that sample.
+ * 
+ * @param[in] ia: phase U current, q15
+ * @param[in] ib: phase V current, q15
+ * @return None
+ */
+static void motor_param_id_step(int16_t ia, int16_t ib)
+{
+    const param_id_seg_t *s;
+    uint16_t theta;
+    int32_t  beta;
+    int32_t  i_x;
+    int32_t  i_y;
+    int32_t  i_p;
+    int32_t  v_p;
+    int32_t  w;
+
+    param_id.tick++;
+    if(param_id.state == PARAM_ID_STATE_OFFSET)
+    {
+        if(param_id.tick >= PARAM_ID_OFFSET_SAMPLES)
+        {
+            param_id.state = PARAM_ID_STATE_RUN;
+            motor_param_id_seg_begin(0);
+            motor_param_id_output(0, 0, 0);
+        }
+        return;
+    }
+
+    s     = &param_id_seq[param_id.seg];
+    theta = (uint16_t)(param_id.frame >> 16);
+    beta  = (((int32_t)ia + 2 * ib) * PARAM_ID_INV_SQRT3) >> 15;
+    i_x   = (ia * motor_math_cos(theta) + beta * motor_math_sin(theta)) >> 15;
+    i_y   = (beta * motor_math_cos(theta) - ia * motor_math_sin(theta)) >> 15;
+    w     = param_id.frame_speed >> PARAM_ID_W_SHIFT;
+
+    if((i_x > PARAM_ID_I_TRIP) || (i_x < -PARAM_ID_I_TRIP) || (i_y > PARAM_ID_I_TRIP) || (i_y < -PARAM_ID_I_TRIP))
+    {
+        param_id.fail_seg = param_id.seg;
+        param_id.state    = PARAM_ID_STATE_FAIL;
+        return;
+    }
+
+    /*the fits on this sample and the voltage centred on it*/
+    if(s->fit & PARAM_ID_FIT_RS)
+    {
+        motor_param_id_ls_add(&param_id.ls[0], i_x, 0, param_id.v_x);
+    }
+    if(s->fit & PARAM_ID_FIT_FLUX)
+    {
+        motor_param_id_ls_add(&param_id.ls[0], param_id.speed >> PARAM_ID_W_SHIFT, 0, param_id.v_y);
+    }
+    if(s->fit & PARAM_ID_FIT_J)
+    {
+        motor_param_id_ls_add(&param_id.ls[1], w, (w * param_id.accel) >> PARAM_ID_J_SHIFT,
+                              ((int32_t)param_id.v_x * i_x + (int32_t)param_id.v_y * i_y) >> 15);
+    }
+
+    param_id.step++;
+    switch(s->test)
+    {
+        case PARAM_ID_TEST_ALIGN:
+            /*90 to 0 degree, the current ramped up in the first quarter*/
+            param_id.theta = ((uint32_t)16384 * (s->periods - param_id.step) / s->periods) << 16;
+            i_p            = (param_id.step < (s->periods >> 2)) ? (4 * param_id.step) : s->periods;
+            i_p            = s->i_ref * i_p / s->periods;
+            motor_param_id_current_pi((int16_t)i_x, (int16_t)i_y, (int16_t)i_p);
+            motor_param_id_frame_update();
+            motor_param_id_output(param_id.v_x, param_id.v_y, (int16_t)i_p);
+            break;
+
+        case PARAM_ID_TEST_PULSE_D:
+        case PARAM_ID_TEST_PULSE_Q:
+            i_p = (s->test == PARAM_ID_TEST_PULSE_D) ? i_x : i_y;
+            if(s->fit & (PARAM_ID_FIT_LD | PARAM_ID_FIT_LQ))
+            {
+                motor_param_id_ls_add(&param_id.ls[0], (param_id.v_pulse[0] + param_id.v_pulse[1]) >> 1,
+                                      (i_p + param_id.i_last) >> 1, i_p - param_id.i_last);
+            }
+            param_id.i_last     = (int16_t)i_p;
+            v_p                 = ((param_id.step >> 1) & 1) ? PARAM_ID_V_PULSE : -PARAM_ID_V_PULSE;
+            param_id.v_pulse[0] = param_id.v_pulse[1];
+            param_id.v_pulse[1] = (int16_t)v_p;
+            if(s->test == PARAM_ID_TEST_PULSE_D)
+            {
+                motor_param_id_output(param_id.v_x + v_p, param_id.v_y, s->i_ref);
+            }
+            else
+            {
+                motor_param_id_output(param_id.v_x, param_id.v_y + v_p, s->i_ref);
+            }
+            break;
+
+        default:
+            param_id.speed += param_id.accel;
+            param_id.theta += (uint32_t)param_id.speed;
+            motor_param_id_current_pi((int16_t)i_x, (int16_t)i_y, s->i_ref);
+            motor_param_id_frame_update();
+            motor_param_id_output(param_id.v_x, param_id.v_y, s->i_ref);
+            break;
+    }
+
+    if(param_id.step < s->periods)
+    {
+        return;
+    }
+    if((s->solve != 0) && (motor_param_id_solve(s->solve) == 0))
+    {
+        param_id.fail_seg = param_id.seg;
+        param_id.state    = PARAM_ID_STATE_FAIL;
+        return;
+    }
+    if(param_id.seg + 1U < PARAM_ID_SEGS)
+    {
+        motor_param_id_seg_begin(param_id.seg + 1);
+        return;
+    }
+    param_id.block   = param_id.est;
+    param_id.time_us = param_id.tick * PARAM_ID_PERIOD_US;
+    param_id.state   = PARAM_ID_STATE_DONE;
+}
+
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+/**
+ * @brief begin a test without the hardware set up, for the host model
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_param_id_test_start(void)
+{
+    motor_param_id_reset();
+}
+
+
+/**
+ * @brief one period on a modelled current sample, the next voltage is in param_id.duty
+ * 
+ * @param[in] ia: phase U current, q15
+ * @param[in] ib: phase V current, q15
+ * @return None
+ */
+void motor_param_id_test_step(int16_t ia, int16_t ib)
+{
+    motor_param_id_step(ia, ib);
+}
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,141 @@
+/**
+ * @file motor_param_id.h
+ * @brief Driver motor_param_id Header
+ * 
+ * @details
+ * Self-commissioning: Rs, Ld, Lq, flux linkage and inertia of an unloaded motor
+ * from dc, pulse and rotating test signals, results in a parameter block.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_PARAM_ID_H__
+#define __MOTOR_PARAM_ID_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+#define PARAM_ID_OFFSET_SHIFT           (8)
+#define PARAM_ID_OFFSET_SAMPLES         (1 << PARAM_ID_OFFSET_SHIFT)
+#define PARAM_ID_I_HIGH                 (Q15(0.50f * MOTOR_RATED_CURRENT_A / MOTOR_I_BASE_A))  // alignment, Rs, rotating test
+#define PARAM_ID_I_LOW                  (Q15(0.25f * MOTOR_RATED_CURRENT_A / MOTOR_I_BASE_A))  // Rs, bias of the pulse test
+#define PARAM_ID_V_PULSE                (Q15(0.25f))        // pulse test square wave, q15 of 2/3 Vbus
+#define PARAM_ID_INC_1                  ((int16_t)(MOTOR_RATED_INC / 5))    // speeds of the rotating test
+#define PARAM_ID_INC_2                  ((int16_t)(MOTOR_RATED_INC / 2))
+#define PARAM_ID_DAMP                   (2)                 // frame angle steps per q15 of the voltage across the current
+#define PARAM_ID_J_SHIFT                (12)                // speed * acceleration regressor within 16 bits
+#define PARAM_ID_PERIOD_US              (1000000 / PWM_FREQ_HZ)
+
+/* ============================ Code Enum Definitions ============================ */
+
+typedef enum
+{
+    PARAM_ID_STATE_IDLE = 0,
+    PARAM_ID_STATE_OFFSET,
+    PARAM_ID_STATE_RUN,                 /*the test segments*/
+    PARAM_ID_STATE_DONE,                /*param_id.block holds the results*/
+    PARAM_ID_STATE_FAIL,                /*a fit without a plausible result, param_id.block unchanged*/
+}param_id_state_e;
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    float rs_ohm;
+    float ld_h;
+    float lq_h;
+    float flux_wb;
+    float j_kgm2;
+}param_id_block_t;
+
+typedef struct
+{
+    int32_t n;
+    int64_t s1;                         /*sums of the regressors x1, x2 and the output y*/
+    int64_t s2;
+    int64_t sy;
+    int64_t s11;                        /*sums of the products*/
+    int64_t s12;
+    int64_t s22;
+    int64_t s1y;
+    int64_t s2y;
+}param_id_ls_t;
+
+typedef struct
+{
+    param_id_state_e state;
+    uint8_t          seg;               /*test segment being run*/
+    uint8_t          fail_seg;          /*segment whose fit failed*/
+    uint16_t         step;              /*period inside the segment*/
+    uint32_t         tick;              /*periods since the start*/
+    uint16_t         offset_a;
+    uint16_t         offset_b;
+    uint32_t         offset_acc_a;
+    uint32_t         offset_acc_b;
+    uint32_t         theta;             /*test angle, q16 of the electrical angle*/
+    int32_t          speed;             /*test speed, q16 of angle steps per period*/
+    int32_t          accel;             /*speed change per period of the segment*/
+    uint32_t         frame;             /*frame of the test current: the test angle with the damping*/
+    int32_t          frame_speed;       /*frame angle change per period, filtered, q16*/
+    int32_t          integ_x;           /*current PI integrators along / across the frame, q30*/
+    int32_t          integ_y;
+    int16_t          v_x;               /*voltage in the frame, q15 of 2/3 Vbus*/
+    int16_t          v_y;
+    int16_t          v_pulse[2];        /*square wave of the last two periods*/
+    int16_t          i_last;            /*previous sample along the pulse*/
+    param_id_ls_t    ls[2];             /*streaming least squares: [0] Rs, L, flux, [1] inertia*/
+    param_id_block_t est;               /*results of the running test*/
+    param_id_block_t block;             /*motor_param.h values until a test is done*/
+    uint16_t         duty[3];
+    uint32_t         time_us;           /*duration of the whole test*/
+}param_id_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern param_id_t param_id;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_param_id_init(void);
+void motor_param_id_start(void);
+void motor_param_id_stop(void);
+void motor_param_id_adc_isr(void);
+
+#ifdef UNIT_TEST
+void motor_param_id_test_start(void);
+void motor_param_id_test_step(int16_t ia, int16_t ib);
+#endif /* UNIT_TEST */
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_PARAM_ID_H__*/
+
+
+/**
+  * @}
+  */
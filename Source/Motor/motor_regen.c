@@ -0,0 +1,221 @@
+/**
+ * @file motor_regen.c
+ * @brief DC bus overvoltage control during regenerative braking
+ * 
+ * @details
+ * The supply cannot take current back, the braking power goes into the bus
+ * capacitor, which holds a small part of the rotor energy between the nominal
+ * bus and the trip: at full braking the bus rises by volts within
+ * milliseconds. motor_regen_bus_update() runs in the TIM1 update interrupt,
+ * every pwm period in every mode (six-step, BEMF, hall sine, FOC, startup,
+ * IPD, identification, and stopped while the rotor coasts), on the last
+ * bus conversion of the injected group, filtered over 2^REGEN_VBUS_SHIFT
+ * periods:
+ * - chopper (regen.chopper_enable, boards with a brake resistor): on above
+ *   REGEN_V_CHOP_ON, off below REGEN_V_CHOP_OFF, whatever the motor does;
+ *   a stop leaves it to the bus
+ * motor_regen_update() runs in the FOC current loop on that filtered bus:
+ * - while braking (q current against the back emf, vq - Rs * iq, not vq: at
+ *   low speed the drop on Rs of the braking current turns vq over):
+ *   REGEN_V_LOSS ~ REGEN_V_BRAKE: a d current up to REGEN_ID_LOSS_MAX, the
+ *   braking torque is unchanged and the winding burns 1.5 * Rs * id^2 of it
+ *   REGEN_V_BRAKE ~ REGEN_V_MAX: the braking q current is cut linearly to
+ *   none, from what the loss current leaves of REGEN_I_MAX
+ * Both are proportional to the bus within their band: the bus settles where
+ * the braking power left equals the losses, inside the band, and the rotor
+ * slows down as fast as that allows. The currents follow a period later
+ * than the limits, over the current loop time constant: while the bus rises
+ * the bands see it REGEN_LEAD_PERIODS ahead, or it overshoots by volts. The d current is negative, on top of
+ * the weakening current, so it never needs more voltage.
+ * Motoring and the six-step modes only get the chopper.
+ * Cost: the bus update about 15 cycles; the limits one sqrt while over
+ * REGEN_V_LOSS, about 60 cycles, 10 otherwise.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_io.h"
+#include "motor_regen.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define REGEN_CHOP_OFF_COUNTS           REGEN_COUNTS(REGEN_V_CHOP_OFF)
+#define REGEN_CHOP_ON_COUNTS            REGEN_COUNTS(REGEN_V_CHOP_ON)
+#define REGEN_LOSS_COUNTS               REGEN_COUNTS(REGEN_V_LOSS)
+#define REGEN_BRAKE_COUNTS              REGEN_COUNTS(REGEN_V_BRAKE)
+#define REGEN_MAX_COUNTS                REGEN_COUNTS(REGEN_V_MAX)
+#define REGEN_LOSS_BAND                 (REGEN_BRAKE_COUNTS - REGEN_LOSS_COUNTS)
+#define REGEN_BRAKE_BAND                (REGEN_MAX_COUNTS - REGEN_BRAKE_COUNTS)
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+regen_t regen;
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init, enabled: nothing happens under REGEN_V_LOSS; chopper REGEN_CHOPPER_DEFAULT and off,
+ *        the bus filter on the nominal bus
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_regen_init(void)
+{
+    BRAKE_CHOP_OFF();
+    regen.enable         = 1;
+    regen.chopper_enable = REGEN_CHOPPER_DEFAULT;
+    regen.chopper        = 0;
+    regen.vbus           = (int16_t)REGEN_COUNTS(MOTOR_VBUS_NOM_V);
+    regen.vbus_acc       = (int32_t)regen.vbus << REGEN_VBUS_SHIFT;
+    regen.dv             = 0;
+    regen.vbus_peak      = regen.vbus;
+    regen.chop_periods   = 0;
+    motor_regen_reset();
+}
+
+
+/**
+ * @brief full braking allowed; at FOC start and stop, the bus filter and the chopper go on
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_regen_reset(void)
+{
+    regen.braking       = 0;
+    regen.id_loss       = 0;
+    regen.iq_max        = REGEN_I_MAX;
+    regen.limit_periods = 0;
+}
+
+
+/**
+ * @brief enable or disable, can be switched while running
+ * 
+ * @param[in] enable: 1 on, 0 off
+ * @return None
+ */
+void motor_regen_enable(uint8_t enable)
+{
+    regen.enable  = enable;
+    regen.id_loss = 0;
+    regen.iq_max  = REGEN_I_MAX;
+}
+
+
+/**
+ * @brief brake chopper output on BRAKE_CHOP_PIN, only on boards that have one
+ * 
+ * @param[in] enable: 1 on, 0 off (output low)
+ * @return None
+ */
+void motor_regen_chopper_enable(uint8_t enable)
+{
+    regen.chopper_enable = enable;
+    regen.chopper        = 0;
+    BRAKE_CHOP_OFF();
+}
+
+
+/**
+ * @brief one pwm period in every mode: bus filter and chopper, from the TIM1 update interrupt
+ * 
+ * @param[in] vbus_raw: last bus conversion, adc counts
+ * @return None
+ */
+void motor_regen_bus_update(uint16_t vbus_raw)
+{
+    int32_t v;
+
+    regen.vbus_acc += (int32_t)vbus_raw - (regen.vbus_acc >> REGEN_VBUS_SHIFT);
+    v          = regen.vbus_acc >> REGEN_VBUS_SHIFT;
+    regen.dv   = (int16_t)(v - regen.vbus);
+    regen.vbus = (int16_t)v;
+    if(v > regen.vbus_peak)
+    {
+        regen.vbus_peak = (int16_t)v;
+    }
+
+    if(regen.chopper_enable != 0)
+    {
+        if((regen.chopper == 0) && (v >= REGEN_CHOP_ON_COUNTS))
+        {
+            regen.chopper = 1;
+            BRAKE_CHOP_ON();
+        }
+        else if((regen.chopper != 0) && (v <= REGEN_CHOP_OFF_COUNTS))
+        {
+            regen.chopper = 0;
+            BRAKE_CHOP_OFF();
+        }
+        regen.chop_periods += regen.chopper;
+    }
+}
+
+
+/**
+ * @brief one FOC current loop period: loss current and braking limit on the filtered bus
+ * 
+ * @param[in] vq: q voltage of the last period, q15
+ * @param[in] iq: q current of this period, q15
+ * @param[in] iq_ref: q reference of this period, q15
+ * @return None
+ */
+void motor_regen_update(int16_t vq, int16_t iq, int16_t iq_ref)
+{
+    int32_t v = regen.vbus;
+    int32_t x;
+    int32_t emf;
+    int32_t iq_max;
+
+    emf           = (int32_t)vq - (((int32_t)REGEN_RS_Q15 * iq) >> 15);
+    regen.braking = (emf * iq_ref < 0) ? 1 : 0;
+    v            += (regen.dv > 0) ? ((int32_t)regen.dv * REGEN_LEAD_PERIODS) : 0;
+    if((regen.braking == 0) || (v <= REGEN_LOSS_COUNTS))
+    {
+        regen.id_loss = 0;
+        regen.iq_max  = REGEN_I_MAX;
+        return;
+    }
+
+    x             = (v < REGEN_BRAKE_COUNTS) ? (v - REGEN_LOSS_COUNTS) : REGEN_LOSS_BAND;
+    regen.id_loss = (int16_t)(REGEN_ID_LOSS_MAX * x / REGEN_LOSS_BAND);
+    iq_max        = motor_math_sqrt((uint32_t)(REGEN_I_MAX * REGEN_I_MAX) - (uint32_t)(regen.id_loss * regen.id_loss));
+    if(v > REGEN_BRAKE_COUNTS)
+    {
+        x      = (v < REGEN_MAX_COUNTS) ? (REGEN_MAX_COUNTS - v) : 0;
+        iq_max = iq_max * x / REGEN_BRAKE_BAND;
+        regen.limit_periods++;
+    }
+    regen.iq_max = (int16_t)iq_max;
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
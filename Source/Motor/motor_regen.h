@@ -0,0 +1,103 @@
+/**
+ * @file motor_regen.h
+ * @brief Driver motor_regen Header
+ * 
+ * @details
+ * DC bus overvoltage control: bus filter and optional brake chopper every
+ * pwm period in every mode, loss current on d and braking q current cut
+ * while braking in FOC.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_REGEN_H__
+#define __MOTOR_REGEN_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "bsp_adc.h"
+#include "motor_param.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+/* bus voltage in adc counts */
+#define REGEN_COUNTS(v)                 ((int32_t)((v) * ADC_FULL_SCALE / MOTOR_VBUS_ADC_FS_V))
+
+/* thresholds, under 32V (margin to the 35V bus capacitor, board assumption): chopper first (when fitted),
+   then the loss current, then the braking current is cut down to none at REGEN_V_MAX */
+#define REGEN_V_CHOP_OFF                (MOTOR_VBUS_NOM_V * 1.05f)      // 25.2V
+#define REGEN_V_CHOP_ON                 (MOTOR_VBUS_NOM_V * 1.08f)      // 25.9V
+#define REGEN_V_LOSS                    (MOTOR_VBUS_NOM_V * 1.10f)      // 26.4V, loss current from 0
+#define REGEN_V_BRAKE                   (MOTOR_VBUS_NOM_V * 1.15f)      // 27.6V, full loss current, braking current from full
+#define REGEN_V_MAX                     (MOTOR_VBUS_NOM_V * 1.25f)      // 30V, no braking current
+
+#define REGEN_I_MAX                     (Q15(MOTOR_RATED_CURRENT_A / MOTOR_I_BASE_A))           // |i| with the loss current
+#define REGEN_ID_LOSS_MAX               (Q15(0.70f * MOTOR_RATED_CURRENT_A / MOTOR_I_BASE_A))   // copper loss 1.5 * Rs * id^2
+#define REGEN_RS_Q15                    (Q15(MOTOR_RS_OHM * MOTOR_I_BASE_A / MOTOR_V_BASE_V))  // back emf = vq - Rs * iq
+#define REGEN_VBUS_SHIFT                (2)                 // bus filter, 4 periods: the bus moves 0.2V per period at full braking
+#define REGEN_LEAD_PERIODS              (16)                // braking limits on the bus that many periods ahead while it rises, the current loop lag 1 / (2pi * 200Hz)
+#define REGEN_CHOPPER_DEFAULT           (0)                 // 1 on boards with the chopper on BRAKE_CHOP_PIN
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    uint8_t  enable;
+    uint8_t  chopper_enable;
+    uint8_t  chopper;                   /*chopper output on*/
+    uint8_t  braking;                   /*q current against the back emf*/
+    int32_t  vbus_acc;                  /*filtered bus, adc counts << REGEN_VBUS_SHIFT*/
+    int16_t  vbus;                      /*filtered bus, adc counts*/
+    int16_t  dv;                        /*filtered bus change of the last period, adc counts*/
+    int16_t  vbus_peak;
+    int16_t  id_loss;                   /*subtracted from the d reference, q15*/
+    int16_t  iq_max;                    /*braking q reference limit, q15*/
+    uint32_t chop_periods;
+    uint32_t limit_periods;             /*periods with less than the full braking current allowed*/
+}regen_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern regen_t regen;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_regen_init(void);
+void motor_regen_reset(void);
+void motor_regen_enable(uint8_t enable);
+void motor_regen_chopper_enable(uint8_t enable);
+void motor_regen_bus_update(uint16_t vbus_raw);
+void motor_regen_update(int16_t vq, int16_t iq, int16_t iq_ref);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_REGEN_H__*/
+
+
+/**
+  * @}
+  */
@@ -0,0 +1,280 @@
+/**
+ * @file motor_resonant.c
+ * @brief Resonant controllers at harmonics of the rotation, speed loop plug-in
+ * 
+ * @details
+ * Each selected order h (harmonic of the mechanical turn) is an integrator in
+ * the frame turning at h times the mechanical angle: the speed error is
+ * demodulated with cos / sin of h * angle, integrated, and modulated back as
+ * torque added to the speed PI (its feedforward input, so the PI limit and
+ * anti-windup hold for the sum). That is a resonant controller at h times
+ * the speed which follows the speed by construction; the memory is two
+ * integrators and a phase per order, whatever the speed.
+ * 
+ * The output leads by the phase that keeps each order stable: minus the phase
+ * of the speed PI's closed loop from torque to speed at that frequency, plus
+ * the delay of RES_DELAY_PERIODS. With the loop modelled as an integrator
+ * plant and a PI of crossover wc and corner wi:
+ *   phi = atan2(wc * w, wc * wi - w^2) - 90 degree + w * delay
+ * computed for one order per step (one atan2). The adaptation gain is per
+ * mechanical angle, so each order converges in the same number of turns at
+ * any speed and stays slow against the spacing of the harmonics, which
+ * shrinks with the speed. An order holds (integrators kept, output still
+ * applied) under RES_STEP_MIN, where the angle steps are noise, and above
+ * RES_STEP_MAX, where the loop gain is gone.
+ * 
+ * The mechanical angle is the electrical one counted over the pole pairs from
+ * an arbitrary zero at the start; the integrators lock to whatever it is.
+ * Cost per speed loop step: 4 interpolated sines per order and one atan2,
+ * about 80 cycles per order plus 150; RES_ORDERS_MAX orders take under 5% of
+ * the 200us speed loop period.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_loop.h"
+#include "motor_resonant.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define RES_2PI                         (6.2831853f)
+#define RES_POS_TURN                    (65536UL * MOTOR_POLE_PAIRS)
+#define RES_RAD_TO_STEP                 (65536.0f / RES_2PI * MOTOR_TS_S * LOOP_SPEED_DIV)  // rad/s -> angle per speed loop step
+#define RES_LOOP_WC_HZ                  (20.0f)             // the hand tuned LOOP_SPEED_KP / LOOP_SPEED_KI
+#define RES_LOOP_WI_HZ                  (5.0f)
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+res_t res;
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+static void motor_resonant_phase(res_order_t *o, int32_t dmech);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init: no orders, disabled, the loop model of the hand tuned speed PI
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_resonant_init(void)
+{
+    res.enable = 0;
+    res.n      = 0;
+    motor_resonant_loop_set(RES_2PI * RES_LOOP_WC_HZ, RES_2PI * RES_LOOP_WI_HZ);
+    motor_resonant_reset(0);
+}
+
+
+/**
+ * @brief at the first speed loop step: integrators cleared, the mechanical zero at the angle
+ * 
+ * @param[in] theta: electrical angle
+ * @return None
+ */
+void motor_resonant_reset(uint16_t theta)
+{
+    uint8_t k;
+
+    for(k = 0; k < RES_ORDERS_MAX; k++)
+    {
+        res.ord[k].integ_c = 0;
+        res.ord[k].integ_s = 0;
+    }
+    res.next       = 0;
+    res.out        = 0;
+    res.theta_prev = theta;
+    res.pos        = theta;
+    res.mech       = (uint16_t)(res.pos / MOTOR_POLE_PAIRS);
+}
+
+
+/**
+ * @brief enable or disable, can be switched while running; the integrators start from zero
+ * 
+ * @param[in] enable: 1 on, 0 off
+ * @return None
+ */
+void motor_resonant_enable(uint8_t enable)
+{
+    uint8_t k;
+
+    res.enable = 0;
+    for(k = 0; k < RES_ORDERS_MAX; k++)
+    {
+        res.ord[k].integ_c = 0;
+        res.ord[k].integ_s = 0;
+    }
+    res.out    = 0;
+    res.enable = enable;
+}
+
+
+/**
+ * @brief select the harmonic orders, the integrators start from zero
+ * 
+ * @param[in] orders: harmonics of the mechanical turn, 1 ~ 255 (k * MOTOR_POLE_PAIRS for electrical ones)
+ * @param[in] n: count, up to RES_ORDERS_MAX, 0 none
+ * @return 0 ok, 1 too many orders or an order 0, the selection unchanged
+ */
+uint8_t motor_resonant_orders_set(const uint8_t *orders, uint8_t n)
+{
+    uint8_t k;
+
+    if(n > RES_ORDERS_MAX)
+    {
+        return 1;
+    }
+    for(k = 0; k < n; k++)
+    {
+        if(orders[k] == 0)
+        {
+            return 1;
+        }
+    }
+
+    res.n = 0;
+    for(k = 0; k < n; k++)
+    {
+        res.ord[k].order   = orders[k];
+        res.ord[k].phi     = 0;
+        res.ord[k].integ_c = 0;
+        res.ord[k].integ_s = 0;
+    }
+    res.next = 0;
+    res.n    = n;
+
+    return 0;
+}
+
+
+/**
+ * @brief speed loop model for the phase leads, from motor_tune_apply() when the gains change
+ * 
+ * @param[in] wc_rad_s: crossover of the speed PI, rad/s
+ * @param[in] wi_rad_s: integral corner, rad/s
+ * @return None
+ */
+void motor_resonant_loop_set(float wc_rad_s, float wi_rad_s)
+{
+    res.wc = (int32_t)(wc_rad_s * RES_RAD_TO_STEP + 0.5f);
+    res.wi = (int32_t)(wi_rad_s * RES_RAD_TO_STEP + 0.5f);
+}
+
+
+/**
+ * @brief one speed loop step
+ * 
+ * @param[in] theta: electrical angle
+ * @param[in] err: speed error of the step, angle steps per period
+ * @return torque to add to the speed PI output, q15
+ */
+int16_t motor_resonant_step(uint16_t theta, int32_t err)
+{
+    const int32_t lim = (int32_t)RES_OUT_MAX << RES_SHIFT;
+    res_order_t  *o;
+    uint16_t      mech_prev = res.mech;
+    uint16_t      ang;
+    int32_t       dmech;
+    int32_t       d;
+    int32_t       g;
+    int32_t       out = 0;
+    int32_t       v;
+    uint8_t       k;
+
+    /*mechanical angle: the electrical steps since the last step counted over the pole pairs*/
+    res.pos        = (res.pos + RES_POS_TURN + (int16_t)(theta - res.theta_prev)) % RES_POS_TURN;
+    res.theta_prev = theta;
+    res.mech       = (uint16_t)(res.pos / MOTOR_POLE_PAIRS);
+    dmech          = (int16_t)(res.mech - mech_prev);
+    if(res.n == 0)
+    {
+        res.out = 0;
+        return 0;
+    }
+
+    motor_resonant_phase(&res.ord[res.next], dmech);
+    res.next = (res.next + 1 < res.n) ? (res.next + 1) : 0;
+
+    /*adaptation per mechanical angle, not per step: the same per turn at any speed*/
+    g = (RES_GAIN * ((dmech < 0) ? -dmech : dmech)) >> 8;
+    g = (g > RES_GAIN_MAX) ? RES_GAIN_MAX : g;
+
+    for(k = 0; k < res.n; k++)
+    {
+        o   = &res.ord[k];
+        d   = dmech * o->order;
+        ang = (uint16_t)(res.mech * o->order);
+        if(((d > RES_STEP_MIN) || (d < -RES_STEP_MIN)) && (d < RES_STEP_MAX) && (d > -RES_STEP_MAX))
+        {
+            v          = o->integ_c + ((((err * motor_math_cos(ang)) >> 8) * g) >> 7);
+            o->integ_c = (v > lim) ? lim : ((v < -lim) ? -lim : v);
+            v          = o->integ_s + ((((err * motor_math_sin(ang)) >> 8) * g) >> 7);
+            o->integ_s = (v > lim) ? lim : ((v < -lim) ? -lim : v);
+        }
+        ang += o->phi;
+        out += ((o->integ_c >> RES_SHIFT) * motor_math_cos(ang) + (o->integ_s >> RES_SHIFT) * motor_math_sin(ang)) >> 15;
+    }
+    res.out = (int16_t)((out > RES_OUT_MAX) ? RES_OUT_MAX : ((out < -RES_OUT_MAX) ? -RES_OUT_MAX : out));
+
+    return res.out;
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief phase lead of an order at the present speed
+ * 
+ * @param[in] o: the order
+ * @param[in] dmech: mechanical angle of the last speed loop step
+ * @return None
+ */
+static void motor_resonant_phase(res_order_t *o, int32_t dmech)
+{
+    int32_t d = dmech * o->order;
+    int32_t y;
+    int32_t x;
+
+    if((d >= RES_STEP_MAX) || (d <= -RES_STEP_MAX))
+    {
+        return;
+    }
+    y = res.wc * d;
+    x = res.wc * res.wi - d * d;
+
+    /*the atan2 takes q15, only the ratio counts*/
+    while((y > 32767) || (y < -32767) || (x > 32767) || (x < -32767))
+    {
+        x >>= 1;
+        y >>= 1;
+    }
+    o->phi = (uint16_t)(motor_math_atan2((int16_t)y, (int16_t)x) - ((d < 0) ? -16384 : 16384)
+                        + ((d * RES_DELAY_PERIODS) >> LOOP_SPEED_SHIFT));
+}
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
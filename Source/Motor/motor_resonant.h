@@ -0,0 +1,102 @@
+/**
+ * @file motor_resonant.h
+ * @brief Driver motor_resonant Header
+ * 
+ * @details
+ * Resonant controllers at harmonics of the mechanical rotation, plugged into
+ * the speed loop: periodic load torque suppression.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_RESONANT_H__
+#define __MOTOR_RESONANT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+#define RES_ORDERS_MAX                  (6)
+#define RES_SHIFT                       (8)                 // integrators q15 torque << RES_SHIFT
+#ifndef RES_GAIN
+#define RES_GAIN                        (1400)              // q8 per mechanical angle step: adaptation per turn
+#endif
+#define RES_GAIN_MAX                    (2047)              // keeps the adaptation product in 32 bits
+#define RES_OUT_MAX                     (Q15(0.50f * MOTOR_RATED_CURRENT_A / MOTOR_I_BASE_A))  // sum of the orders, and each axis
+#ifndef RES_DELAY_PERIODS
+#define RES_DELAY_PERIODS               (24)                // torque request to measured speed: current loop, speed loop sample, estimator
+#endif
+#define RES_STEP_MIN                    (16)                // harmonic angle per speed loop step under which the order holds: 1.2Hz
+#define RES_STEP_MAX                    (8192)              // harmonic angle per speed loop step, 45 degree: above it the order holds
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    uint8_t  order;                     /*harmonic of the mechanical rotation*/
+    uint16_t phi;                       /*phase lead of the output, 65536 per turn*/
+    int32_t  integ_c;                   /*error harmonic in the rotating frame, q15 torque << RES_SHIFT*/
+    int32_t  integ_s;
+}res_order_t;
+
+typedef struct
+{
+    uint8_t     enable;
+    uint8_t     n;                      /*orders in use*/
+    uint8_t     next;                   /*order whose phase is refreshed in the next step*/
+    uint16_t    theta_prev;
+    uint32_t    pos;                    /*electrical angle over the pole pairs, 65536 * MOTOR_POLE_PAIRS per mechanical turn*/
+    uint16_t    mech;                   /*mechanical angle, 65536 per turn*/
+    int32_t     wc;                     /*speed loop model: crossover and integral corner, angle per speed loop step*/
+    int32_t     wi;
+    int16_t     out;                    /*torque of the last step, q15*/
+    res_order_t ord[RES_ORDERS_MAX];
+}res_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern res_t res;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_resonant_init(void);
+void motor_resonant_reset(uint16_t theta);
+void motor_resonant_enable(uint8_t enable);
+uint8_t motor_resonant_orders_set(const uint8_t *orders, uint8_t n);
+void motor_resonant_loop_set(float wc_rad_s, float wi_rad_s);
+int16_t motor_resonant_step(uint16_t theta, int32_t err);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_RESONANT_H__*/
+
+
+/**
+  * @}
+  */
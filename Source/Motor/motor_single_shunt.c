@@ -0,0 +1,290 @@
+/**
+ * @file motor_single_shunt.c
+ * @brief Single shunt three phase current reconstruction
+ * 
+ * @details
+ * With one shunt in the dc link the bus current is a phase current only while
+ * an active vector is on: with the phases sorted by duty (hi, md, lo), only
+ * hi high gives +i_hi, hi and md high give -i_lo, the third phase follows
+ * from the sum. High side on while CNT < compare, so on the counting down
+ * half hi switches on first, then md, then lo:
+ *   ARR ... cmp_hi: 000 | window 1: +i_hi | cmp_md | window 2: -i_lo | cmp_lo ... 0: 111
+ * A window needs SINGLE_SHUNT_T_MIN: dead time and ringing after the edge
+ * that opens it, then the adc sampling before the edge that closes it. Near
+ * the sector boundaries and at low voltage the duties are too close, so the
+ * compares of the counting down half are shifted apart (md kept where it is
+ * when it can, hi up, lo down) and the counting up half gets 2 * duty - shift:
+ * the duty, the volt seconds and the dead time of the period do not change,
+ * only the current ripple does. Phases on a rail do not move. When md has
+ * no room (two duties at a rail together, deep overmodulation) there is no
+ * window: the currents of the last period are held (single_shunt.hold_cnt).
+ * 
+ * Timing on TIM1 (bsp_pwm_single_shunt_mode()), center aligned mode 1:
+ * - updates at the peak and the valley, the preload of CCDAT1~3 alternates:
+ *   the valley interrupt latches the plan and writes the counting down
+ *   compares (on the bridge from the peak), the peak interrupt writes the
+ *   counting up compares (from the valley), so both halves of a period come
+ *   from the same plan
+ * - the CC4 event is generated counting down only and triggers the injected
+ *   group one rank at a time (discontinuous mode): rank 1 vbus at trig[0],
+ *   rank 2 the bus current at trig[1] (window 1), rank 3 at trig[2] (window 2).
+ *   CCDAT4 is unbuffered, the CC4 interrupt moves it on after each match, the
+ *   valley interrupt sets trig[0] again while counting up (no events then).
+ * The end of conversion comes at least SINGLE_SHUNT_T2_MIN before the valley,
+ * so the current loop runs before the valley interrupt (same priority) and
+ * its plan is latched right after it: the duties reach the bridge at the
+ * next peak, half a period later than with the two phase shunts.
+ * 
+ * The reconstruction is three stores and a sum, the plan a sort and a few
+ * clamps, together under 100 cycles in the adc interrupt; the peak, valley
+ * and CC4 interrupts are register writes.
+ * The samples are taken in the middle of their windows, where the current
+ * ripple crosses the period mean (Tools/motor_single_shunt_sim.c: half the
+ * error of sampling late in the windows).
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_pwm.h"
+#include "bsp_adc.h"
+#include "motor_svpwm.h"
+#include "motor_single_shunt.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+single_shunt_t single_shunt;
+
+/* ============================ Static Global Variables ============================ */
+
+/* rank1 = vbus, rank2 = bus current in window 1, rank3 = bus current in window 2 */
+static const uint8_t single_shunt_adc_seq[SINGLE_SHUNT_TRIGS] = {ADC_VBUS_CH, ADC_IBUS_CH, ADC_IBUS_CH};
+
+/* ============================ Static Function Declarations ============================ */
+
+static __INLINE int32_t motor_single_shunt_max(int32_t a, int32_t b)
+{
+    return (a > b) ? a : b;
+}
+
+
+static __INLINE int32_t motor_single_shunt_min(int32_t a, int32_t b)
+{
+    return (a < b) ? a : b;
+}
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init, currents zero
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_single_shunt_init(void)
+{
+    static const uint16_t half[3] = {SVPWM_HALF, SVPWM_HALF, SVPWM_HALF};
+
+    motor_single_shunt_plan(half);
+    single_shunt.act       = single_shunt.plan;
+    single_shunt.trig_idx  = 0;
+    single_shunt.i[0]      = 0;
+    single_shunt.i[1]      = 0;
+    single_shunt.i[2]      = 0;
+    single_shunt.shift_cnt = 0;
+    single_shunt.hold_cnt  = 0;
+}
+
+
+/**
+ * @brief single shunt timing and adc sequence on, after bsp_pwm_complementary_mode()
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_single_shunt_start(void)
+{
+    motor_single_shunt_init();
+    motor_single_shunt_valley_isr();
+    bsp_adc_inj_seq_set(single_shunt_adc_seq, SINGLE_SHUNT_TRIGS);
+    bsp_adc_inj_trig_select(ADC_INJ_TRIG_SINGLE_SHUNT, ENABLE);
+    bsp_pwm_single_shunt_mode(ENABLE);
+}
+
+
+/**
+ * @brief back to the one trigger per period timing of the other modes
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_single_shunt_stop(void)
+{
+    bsp_pwm_single_shunt_mode(DISABLE);
+    bsp_adc_inj_trig_select(ADC_INJ_TRIG_SRC, DISABLE);
+}
+
+
+/**
+ * @brief compares of both halves and the adc triggers for symmetric duties, into single_shunt.plan
+ * 
+ * @param[in] duty: the three compare values of the modulation
+ * @return None
+ */
+void motor_single_shunt_plan(const uint16_t *duty)
+{
+    single_shunt_plan_t *p = &single_shunt.plan;
+    uint8_t hi = 0;
+    uint8_t lo = 0;
+    uint8_t md;
+    uint8_t i;
+    int32_t md_min;
+    int32_t md_max;
+    int32_t b_hi;
+    int32_t b_md;
+    int32_t b_lo;
+
+    for(i = 1; i < 3; i++)
+    {
+        hi = (duty[i] > duty[hi]) ? i : hi;
+        lo = (duty[i] < duty[lo]) ? i : lo;
+    }
+    lo = (lo == hi) ? (uint8_t)((hi + 1) % 3) : lo;
+    md = (uint8_t)(3 - hi - lo);
+
+    /*a compare can move within 2 * duty - ARR ~ 2 * duty, the other half takes the rest:
+      md needs room for window 1 under the highest hi and window 2 over the lowest lo*/
+    md_min = motor_single_shunt_max(2 * duty[md] - PWM_PERIOD_MAX, SINGLE_SHUNT_T2_MIN + SINGLE_SHUNT_T_RISE);
+    md_min = motor_single_shunt_max(md_min, motor_single_shunt_max(2 * duty[lo] - PWM_PERIOD_MAX, 0) + SINGLE_SHUNT_T_MIN);
+    md_max = motor_single_shunt_min(2 * duty[md], motor_single_shunt_min(2 * duty[hi], PWM_PERIOD_MAX) - SINGLE_SHUNT_T_MIN);
+    if(md_min > md_max)
+    {
+        for(i = 0; i < 3; i++)
+        {
+            p->cmp_up[i]   = duty[i];
+            p->cmp_down[i] = duty[i];
+        }
+        p->trig[2] = SINGLE_SHUNT_T2_MIN;
+        p->trig[1] = SINGLE_SHUNT_T2_MIN + SINGLE_SHUNT_T_CONV;
+        p->trig[0] = SINGLE_SHUNT_T2_MIN + 2 * SINGLE_SHUNT_T_CONV;
+        p->valid   = 0;
+        return;
+    }
+
+    b_md = (duty[md] < md_min) ? md_min : ((duty[md] > md_max) ? md_max : duty[md]);
+    b_hi = motor_single_shunt_max(duty[hi], b_md + SINGLE_SHUNT_T_MIN);
+    b_lo = motor_single_shunt_min(duty[lo], b_md - SINGLE_SHUNT_T_MIN);
+
+    p->cmp_down[hi] = (uint16_t)b_hi;
+    p->cmp_down[md] = (uint16_t)b_md;
+    p->cmp_down[lo] = (uint16_t)b_lo;
+    p->cmp_up[hi]   = (uint16_t)(2 * duty[hi] - b_hi);
+    p->cmp_up[md]   = (uint16_t)(2 * duty[md] - b_md);
+    p->cmp_up[lo]   = (uint16_t)(2 * duty[lo] - b_lo);
+
+    /*middle of the valid trigger range of each window, the ripple crosses its mean mid vector*/
+    p->trig[1] = (uint16_t)((b_hi - SINGLE_SHUNT_T_RISE + b_md + SINGLE_SHUNT_T_SAMPLE) >> 1);
+    p->trig[2] = (uint16_t)motor_single_shunt_max((b_md - SINGLE_SHUNT_T_RISE + b_lo + SINGLE_SHUNT_T_SAMPLE) >> 1, SINGLE_SHUNT_T2_MIN);
+    p->trig[0] = (uint16_t)(p->trig[1] + SINGLE_SHUNT_T_CONV);
+    p->hi      = hi;
+    p->lo      = lo;
+    p->valid   = 1;
+    single_shunt.shift_cnt += ((b_hi != duty[hi]) || (b_md != duty[md]) || (b_lo != duty[lo])) ? 1 : 0;
+}
+
+
+/**
+ * @brief phase currents from the two bus samples of the period, with the plan they were taken with
+ * 
+ * @param[in] i_1: bus current in window 1, q15, positive drawn from the supply
+ * @param[in] i_2: bus current in window 2, q15
+ * @param[out] ia: phase U current, q15
+ * @param[out] ib: phase V current, q15
+ * @return None
+ */
+void motor_single_shunt_currents(int16_t i_1, int16_t i_2, int16_t *ia, int16_t *ib)
+{
+    const single_shunt_plan_t *p = &single_shunt.act;
+
+    if(p->valid != 0)
+    {
+        single_shunt.i[p->hi]              = i_1;
+        single_shunt.i[p->lo]              = Q15_SAT(-(int32_t)i_2);
+        single_shunt.i[3 - p->hi - p->lo]  = Q15_SAT((int32_t)i_2 - i_1);
+    }
+    else
+    {
+        single_shunt.hold_cnt++;
+    }
+    *ia = single_shunt.i[0];
+    *ib = single_shunt.i[1];
+}
+
+
+/**
+ * @brief TIM1 update at the valley: latch the plan, counting down compares and the first trigger
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_single_shunt_valley_isr(void)
+{
+    single_shunt.act      = single_shunt.plan;
+    single_shunt.trig_idx = 0;
+    PWM_DUTY_SET(single_shunt.act.cmp_down[0], single_shunt.act.cmp_down[1], single_shunt.act.cmp_down[2]);
+    PWM_ADC_TRIG_SET(single_shunt.act.trig[0]);
+}
+
+
+/**
+ * @brief TIM1 update at the peak: counting up compares of the same plan
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_single_shunt_peak_isr(void)
+{
+    PWM_DUTY_SET(single_shunt.act.cmp_up[0], single_shunt.act.cmp_up[1], single_shunt.act.cmp_up[2]);
+}
+
+
+/**
+ * @brief TIM1 CC4 match: a conversion was triggered, move the trigger to the next one
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_single_shunt_trig_isr(void)
+{
+    if(single_shunt.trig_idx < (SINGLE_SHUNT_TRIGS - 1))
+    {
+        single_shunt.trig_idx++;
+        PWM_ADC_TRIG_SET(single_shunt.act.trig[single_shunt.trig_idx]);
+    }
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,103 @@
+/**
+ * @file motor_single_shunt.h
+ * @brief Driver motor_single_shunt Header
+ * 
+ * @details
+ * Single shunt current reconstruction: two samples of the dc link current
+ * per pwm period, in the windows of the two active vectors, opened by
+ * shifting the phase edges of the counting down half.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_SINGLE_SHUNT_H__
+#define __MOTOR_SINGLE_SHUNT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "bsp_pwm.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+/* TIM1 counter ticks: dead time and ringing of the bus current after an edge, 2us */
+#define SINGLE_SHUNT_T_RISE             (PWM_DEADTIME + 108)
+/* trigger to the end of the adc sampling (7.5 cycles at 27MHz) with margin, 0.37us */
+#define SINGLE_SHUNT_T_SAMPLE           (40)
+/* shortest window of an active vector that gives a sample */
+#define SINGLE_SHUNT_T_MIN              (SINGLE_SHUNT_T_RISE + SINGLE_SHUNT_T_SAMPLE)
+/* trigger spacing: one conversion (0.74us) plus the CC4 interrupt moving the trigger, 1us */
+#define SINGLE_SHUNT_T_CONV             (108)
+/* the last conversion ends before the valley: the current loop runs before the valley update */
+#define SINGLE_SHUNT_T2_MIN             (SINGLE_SHUNT_T_CONV + 54)
+
+#define SINGLE_SHUNT_TRIGS              (3)     // vbus, bus current in window 1, bus current in window 2
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    uint16_t cmp_up[3];                 /*phase compares of the counting up half*/
+    uint16_t cmp_down[3];               /*phase compares of the counting down half, the samples are in it*/
+    uint16_t trig[SINGLE_SHUNT_TRIGS];  /*CCDAT4 of the conversions, counting down*/
+    uint8_t  hi;                        /*phase of the largest duty: window 1 is +i of it*/
+    uint8_t  lo;                        /*phase of the smallest duty: window 2 is -i of it*/
+    uint8_t  valid;                     /*0: no windows, the currents are held*/
+}single_shunt_plan_t;
+
+typedef struct
+{
+    single_shunt_plan_t plan;           /*from the current loop*/
+    single_shunt_plan_t act;            /*latched at the valley, on the bridge from the next peak*/
+    uint8_t             trig_idx;       /*conversion the CC4 trigger is set for*/
+    int16_t             i[3];           /*phase currents of the last period, q15*/
+    uint32_t            shift_cnt;      /*periods with shifted edges*/
+    uint32_t            hold_cnt;       /*periods without windows*/
+}single_shunt_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern single_shunt_t single_shunt;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_single_shunt_init(void);
+void motor_single_shunt_start(void);
+void motor_single_shunt_stop(void);
+void motor_single_shunt_plan(const uint16_t *duty);
+void motor_single_shunt_currents(int16_t i_1, int16_t i_2, int16_t *ia, int16_t *ib);
+void motor_single_shunt_valley_isr(void);
+void motor_single_shunt_peak_isr(void);
+void motor_single_shunt_trig_isr(void);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_SINGLE_SHUNT_H__*/
+
+
+/**
+  * @}
+  */
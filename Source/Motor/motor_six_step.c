@@ -0,0 +1,304 @@
+/**
+ * @file motor_six_step.c
+ * @brief Hall six-step commutation engine
+ * 
+ * @details
+ * The hall timer fires the TIM1 COM event on every hall edge, so the pattern for the
+ * new sector is already in the preload registers when the edge arrives. The COM
+ * interrupt then only has to preload the pattern of the following sector:
+ * one GPIO read, two table lookups and three register writes, no branches.
+ * 
+ * Phase drive per sector:
+ * - high phase : PWM1 with complementary low side (synchronous rectification)
+ * - low phase  : forced inactive, CCxE + CCxNE on -> low side fully on
+ * - float phase: CCxE + CCxNE off
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "bsp_pwm.h"
+#include "bsp_hall.h"
+#include "motor_six_step.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SS_OCM_PWM      (TIM_OCMODE_PWM1 | TIM_OC_PRE_LOAD_ENABLE)
+#define SS_OCM_LOW      (TIM_FORCED_ACTION_INACTIVE | TIM_OC_PRE_LOAD_ENABLE)
+#define SS_CCEN_PHASE   (TIM_CCEN_CC1EN | TIM_CCEN_CC1NEN)
+
+#define SS_MODE(ph, hi)         (((ph) == (hi)) ? SS_OCM_PWM : SS_OCM_LOW)
+#define SS_EN(ph, hi, lo)       ((((ph) == (hi)) || ((ph) == (lo))) ? (SS_CCEN_PHASE << (4 * (ph))) : 0UL)
+
+/* pattern with phase "hi" chopping and phase "lo" clamped low, the third phase floats */
+#define SIX_STEP_PATTERN(hi, lo)                                                        \
+    {                                                                                   \
+        (uint16_t)(SS_MODE(PHASE_U, hi) | (SS_MODE(PHASE_V, hi) << 8)),                 \
+        (uint16_t)(SS_MODE(PHASE_W, hi) | PWM_CCMOD2_CH4_CFG),                          \
+        (uint32_t)(SS_EN(PHASE_U, hi, lo) | SS_EN(PHASE_V, hi, lo) | SS_EN(PHASE_W, hi, lo) | PWM_CCEN_CH4_CFG | PWM_CCEN_CH5_CFG) \
+    }
+
+#define SIX_STEP_PATTERN_OFF    SIX_STEP_PATTERN(PHASE_NONE, PHASE_NONE)
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+six_step_t six_step;
+
+/* ============================ Static Global Variables ============================ */
+
+/*
+ * pattern applied while the hall state is [hall]
+ * CW  hall sequence: 5 -> 4 -> 6 -> 2 -> 3 -> 1
+ * CCW hall sequence: 5 -> 1 -> 3 -> 2 -> 6 -> 4
+ */
+static const six_step_pattern_t six_step_table[MOTOR_DIR_MAX][SIX_STEP_HALL_STATES] =
+{
+    {
+        SIX_STEP_PATTERN_OFF,                   /*0: invalid*/
+        SIX_STEP_PATTERN(PHASE_W, PHASE_V),     /*1*/
+        SIX_STEP_PATTERN(PHASE_V, PHASE_U),     /*2*/
+        SIX_STEP_PATTERN(PHASE_W, PHASE_U),     /*3*/
+        SIX_STEP_PATTERN(PHASE_U, PHASE_W),     /*4*/
+        SIX_STEP_PATTERN(PHASE_U, PHASE_V),     /*5*/
+        SIX_STEP_PATTERN(PHASE_V, PHASE_W),     /*6*/
+        SIX_STEP_PATTERN_OFF,                   /*7: invalid*/
+    },
+    {
+        SIX_STEP_PATTERN_OFF,                   /*0: invalid*/
+        SIX_STEP_PATTERN(PHASE_V, PHASE_W),     /*1*/
+        SIX_STEP_PATTERN(PHASE_U, PHASE_V),     /*2*/
+        SIX_STEP_PATTERN(PHASE_U, PHASE_W),     /*3*/
+        SIX_STEP_PATTERN(PHASE_W, PHASE_U),     /*4*/
+        SIX_STEP_PATTERN(PHASE_V, PHASE_U),     /*5*/
+        SIX_STEP_PATTERN(PHASE_W, PHASE_V),     /*6*/
+        SIX_STEP_PATTERN_OFF,                   /*7: invalid*/
+    },
+};
+
+/* the hall state expected after [hall], invalid states map to the invalid state 0 */
+static const uint8_t six_step_next_hall[MOTOR_DIR_MAX][SIX_STEP_HALL_STATES] =
+{
+    {0, 5, 3, 1, 6, 4, 2, 0},
+    {0, 3, 6, 2, 5, 1, 4, 0},
+};
+
+static const uint8_t six_step_hall_err[SIX_STEP_HALL_STATES] = {1, 0, 0, 0, 0, 0, 0, 1};
+
+/* the hall state of each sector, used by the sensorless modes to share the pattern table */
+static const uint8_t six_step_sector_hall[MOTOR_DIR_MAX][SIX_STEP_SECTORS] =
+{
+    {5, 4, 6, 2, 3, 1},
+    {5, 1, 3, 2, 6, 4},
+};
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief write a pattern into the TIM1 preload registers
+ * 
+ * @param[in] p: the pattern
+ * @return None
+ */
+static __INLINE void motor_six_step_preload(const six_step_pattern_t *p)
+{
+    PWM_TIM->CCMOD1 = p->ccmod1;
+    PWM_TIM->CCMOD2 = p->ccmod2;
+    PWM_TIM->CCEN   = p->ccen;
+}
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init the six-step engine, all phases off
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_six_step_init(void)
+{
+    six_step.dir          = MOTOR_DIR_CW;
+    six_step.duty         = 0;
+    six_step.hall         = 0;
+    six_step.running      = 0;
+    six_step.com_cnt      = 0;
+    six_step.hall_err_cnt = 0;
+
+    PWM_DUTY_SET(0, 0, 0);
+    motor_six_step_preload(&six_step_table[MOTOR_DIR_CW][0]);
+    PWM_COM_GENERATE();
+}
+
+
+/**
+ * @brief apply the pattern of the current sector, preload the next one and enable the outputs
+ * 
+ * @param[in] dir: rotation direction
+ * @param[in] duty: high side duty, 0 ~ PWM_PERIOD_MAX
+ * @return None
+ */
+void motor_six_step_start(motor_dir_e dir, uint16_t duty)
+{
+    uint8_t hall = HALL_STATE_READ();
+
+    six_step.dir  = dir;
+    motor_six_step_duty_set(duty);
+    PWM_DUTY_SET(six_step.duty, six_step.duty, six_step.duty);
+
+    /*the current sector is applied by a software COM*/
+    motor_six_step_preload(&six_step_table[dir][hall]);
+    PWM_COM_GENERATE();
+
+    /*the next sector is applied by the hall edge*/
+    motor_six_step_commutate(hall);
+    six_step.running = 1;
+    bsp_pwm_output_enable(ENABLE);
+}
+
+
+/**
+ * @brief switch every phase off
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_six_step_stop(void)
+{
+    six_step.running = 0;
+    bsp_pwm_output_enable(DISABLE);
+    motor_six_step_preload(&six_step_table[MOTOR_DIR_CW][0]);
+    PWM_COM_GENERATE();
+    six_step.duty = 0;
+}
+
+
+/**
+ * @brief set the high side duty, it is loaded on the next pwm update
+ * 
+ * @param[in] duty: 0 ~ PWM_PERIOD_MAX
+ * @return None
+ */
+void motor_six_step_duty_set(uint16_t duty)
+{
+    six_step.duty = (duty > PWM_PERIOD_MAX) ? PWM_PERIOD_MAX : duty;
+}
+
+
+/**
+ * @brief commutation, called from the TIM1 COM interrupt after the hall edge
+ * 
+ * The pattern for [hall] was applied by the COM event itself, this only preloads
+ * the pattern for the sector after it (about 20 cycles on the M4, no branches).
+ * 
+ * @param[in] hall: the hall state after the edge
+ * @return None
+ */
+void motor_six_step_commutate(uint8_t hall)
+{
+    hall &= 0x07;
+    motor_six_step_preload(&six_step_table[six_step.dir][six_step_next_hall[six_step.dir][hall]]);
+    six_step.hall          = hall;
+    six_step.hall_err_cnt += six_step_hall_err[hall];
+    six_step.com_cnt++;
+}
+
+
+/**
+ * @brief pwm period update, called from the TIM1 update interrupt
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_six_step_pwm_update(void)
+{
+    PWM_DUTY_SET(six_step.duty, six_step.duty, six_step.duty);
+}
+
+
+/**
+ * @brief preload the pattern of a sector, applied by the next COM event
+ * 
+ * @param[in] dir: rotation direction
+ * @param[in] sector: 0 ~ 5, sector 0 is the hall state 5 sector
+ * @return None
+ */
+void motor_six_step_sector_preload(motor_dir_e dir, uint8_t sector)
+{
+    motor_six_step_preload(&six_step_table[dir][six_step_sector_hall[dir][sector]]);
+}
+
+
+/**
+ * @brief sector to start from at a known rotor angle: its field leads the d axis by 60 ~ 120 degree
+ * 
+ * @details
+ * The angle is the one of the FOC modes: alpha axis on phase U, CW counting up.
+ * CW sector s drives the field to -30 + 60 * s degree, CCW sector s to 150 - 60 * s.
+ * 
+ * @param[in] dir: rotation direction
+ * @param[in] theta: electrical angle of the d axis, 65536 = 360 degree
+ * @return sector 0 ~ 5, as used by motor_six_step_sector_preload()
+ */
+uint8_t motor_six_step_angle_sector(motor_dir_e dir, uint16_t theta)
+{
+    uint16_t a;
+
+    if(dir == MOTOR_DIR_CW)
+    {
+        a = (uint16_t)(theta + 27307);          /*+150 degree*/
+    }
+    else
+    {
+        a = (uint16_t)(49152 - theta);          /*270 degree - theta*/
+    }
+    return (uint8_t)(((uint32_t)a * SIX_STEP_SECTORS) >> 16);
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+/**
+ * @brief get the pattern applied in a hall state, for replaying hall sequences on the host
+ * 
+ * @param[in] dir: rotation direction
+ * @param[in] hall: hall state
+ * @return the pattern
+ */
+const six_step_pattern_t *motor_six_step_pattern_get(motor_dir_e dir, uint8_t hall)
+{
+    return &six_step_table[dir][hall & 0x07];
+}
+
+
+/**
+ * @brief get the expected hall state after [hall]
+ * 
+ * @param[in] dir: rotation direction
+ * @param[in] hall: hall state
+ * @return the next hall state, 0 for invalid input
+ */
+uint8_t motor_six_step_next_hall_get(motor_dir_e dir, uint8_t hall)
+{
+    return six_step_next_hall[dir][hall & 0x07];
+}
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,107 @@
+/**
+ * @file motor_six_step.h
+ * @brief Driver motor_six_step Header
+ * 
+ * @details
+ * Table driven hall six-step commutation. Each hall state indexes a const
+ * CCMOD1/CCMOD2/CCEN pattern which is preloaded into TIM1 and applied by the COM event.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_SIX_STEP_H__
+#define __MOTOR_SIX_STEP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+
+/* ============================ Public Constants ============================ */
+
+#define SIX_STEP_HALL_STATES    (8)     // 3 hall bits, states 0 and 7 are invalid
+#define SIX_STEP_SECTORS        (6)
+
+/* ============================ Code Enum Definitions ============================ */
+
+typedef enum
+{
+    MOTOR_DIR_CW = 0,
+    MOTOR_DIR_CCW,
+    MOTOR_DIR_MAX,
+}motor_dir_e;
+
+typedef enum
+{
+    PHASE_U = 0,
+    PHASE_V,
+    PHASE_W,
+    PHASE_NONE,
+}motor_phase_e;
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    uint16_t ccmod1;    /*OC1/OC2 mode*/
+    uint16_t ccmod2;    /*OC3 mode (+ the fixed OC4 setting)*/
+    uint32_t ccen;      /*CCxE/CCxNE enables*/
+}six_step_pattern_t;
+
+typedef struct
+{
+    motor_dir_e dir;
+    uint16_t    duty;           /*high side duty, 0 ~ PWM_PERIOD_MAX*/
+    uint8_t     hall;           /*hall state seen by the last commutation*/
+    uint8_t     running;
+    uint32_t    com_cnt;        /*number of commutations*/
+    uint32_t    hall_err_cnt;   /*number of invalid hall states seen*/
+}six_step_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern six_step_t six_step;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_six_step_init(void);
+void motor_six_step_start(motor_dir_e dir, uint16_t duty);
+void motor_six_step_stop(void);
+void motor_six_step_duty_set(uint16_t duty);
+void motor_six_step_commutate(uint8_t hall);
+void motor_six_step_pwm_update(void);
+void motor_six_step_sector_preload(motor_dir_e dir, uint8_t sector);
+uint8_t motor_six_step_angle_sector(motor_dir_e dir, uint16_t theta);
+
+#ifdef UNIT_TEST
+const six_step_pattern_t *motor_six_step_pattern_get(motor_dir_e dir, uint8_t hall);
+uint8_t motor_six_step_next_hall_get(motor_dir_e dir, uint8_t hall);
+#endif /* UNIT_TEST */
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_SIX_STEP_H__*/
+
+
+/**
+  * @}
+  */
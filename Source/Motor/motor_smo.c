@@ -0,0 +1,175 @@
+/**
+ * @file motor_smo.c
+ * @brief Sliding mode observer + PLL angle estimator
+ * 
+ * @details
+ * Runs every pwm period after the current loop with the voltage applied during
+ * the past period and the currents measured at its end. No division except one
+ * for the PLL error normalization, no library calls, no loops but the fixed
+ * sqrt and CORDIC ones. Estimated cost about 250 cycles (5% of the period).
+ * 
+ * The PLL error is normalized by the bemf magnitude so its bandwidth does not
+ * move with the speed; the low pass filter lag atan(w / wc) is added back to
+ * the PLL angle.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_smo.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+smo_t smo;
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief boundary layer switching function: slope inside, +-K outside
+ * 
+ * @param[in] err: estimated - measured current, q15
+ * @return q15 voltage
+ */
+static __INLINE int32_t motor_smo_switch(int32_t err)
+{
+    int32_t z = err * SMO_SLOPE;
+
+    if(z > SMO_K)
+    {
+        z = SMO_K;
+    }
+    else if(z < -SMO_K)
+    {
+        z = -SMO_K;
+    }
+    return z;
+}
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init the observer
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_smo_init(void)
+{
+    smo.lpf_k = SMO_LPF_K;
+    motor_smo_reset(0, 0);
+}
+
+
+/**
+ * @brief clear the observer and preset the PLL (handover from an open loop start)
+ * 
+ * @param[in] theta: angle the PLL starts from
+ * @param[in] speed: angle step per period the PLL starts from
+ * @return None
+ */
+void motor_smo_reset(uint16_t theta, int16_t speed)
+{
+    smo.i_alpha     = 0;
+    smo.i_beta      = 0;
+    smo.z_alpha     = 0;
+    smo.z_beta      = 0;
+    smo.e_alpha     = 0;
+    smo.e_beta      = 0;
+    smo.omega_i_q16 = (int32_t)speed << 16;
+    smo.omega_q16   = smo.omega_i_q16;
+    smo.theta_pll   = theta;
+    smo.theta       = theta;
+    smo.speed       = speed;
+    smo.speed_acc   = (int32_t)speed << SMO_SPEED_SHIFT;
+    smo.pll_err     = 0;
+}
+
+
+/**
+ * @brief one observer step
+ * 
+ * @param[in] v_alpha: voltage applied during the past period, q15 of 2/3 Vbus
+ * @param[in] v_beta: voltage applied during the past period
+ * @param[in] i_alpha: current measured at the end of the period, q15
+ * @param[in] i_beta: current measured at the end of the period
+ * @return None
+ */
+void motor_smo_update(int16_t v_alpha, int16_t v_beta, int16_t i_alpha, int16_t i_beta)
+{
+    int32_t s;
+    int32_t c;
+    int32_t err;
+    int32_t mag;
+    int32_t w_q15;
+    uint16_t lag;
+
+    /*current observer and switching signal*/
+    smo.z_alpha = motor_smo_switch(smo.i_alpha - i_alpha);
+    smo.z_beta  = motor_smo_switch(smo.i_beta - i_beta);
+    smo.i_alpha = (SMO_F * smo.i_alpha + SMO_G * (v_alpha - smo.z_alpha)) >> 15;
+    smo.i_beta  = (SMO_F * smo.i_beta  + SMO_G * (v_beta  - smo.z_beta))  >> 15;
+
+    /*bemf = filtered switching signal*/
+    smo.e_alpha += (smo.lpf_k * (smo.z_alpha - smo.e_alpha)) >> 15;
+    smo.e_beta  += (smo.lpf_k * (smo.z_beta  - smo.e_beta))  >> 15;
+
+    /*e = w * psi * (-sin, cos): err = -ea * cos - eb * sin = |e| * sin(theta - theta_pll)*/
+    s   = motor_math_sin(smo.theta_pll);
+    c   = motor_math_cos(smo.theta_pll);
+    err = (-smo.e_alpha * c - smo.e_beta * s) >> 15;
+    mag = motor_math_sqrt((uint32_t)(smo.e_alpha * smo.e_alpha) + (uint32_t)(smo.e_beta * smo.e_beta));
+    if(mag > SMO_E_MIN)
+    {
+        err = (err << 15) / mag;
+        err = (smo.omega_q16 < 0) ? -err : err;
+    }
+    else
+    {
+        err = 0;
+    }
+    smo.pll_err = (int16_t)err;
+
+    /*PI on the angle error*/
+    smo.omega_i_q16 += SMO_PLL_KI * err;
+    smo.omega_q16    = smo.omega_i_q16 + SMO_PLL_KP * err;
+    smo.theta_pll   += (uint16_t)(smo.omega_q16 >> 16);
+
+    smo.speed_acc += (smo.omega_q16 >> 16) - (smo.speed_acc >> SMO_SPEED_SHIFT);
+    smo.speed      = (int16_t)(smo.speed_acc >> SMO_SPEED_SHIFT);
+
+    /*lag of the first order filter: atan(w * Ts / (wc * Ts)), w in rad per period q15 = step * pi*/
+    w_q15 = ((smo.omega_q16 >> 10) * 3217) >> 16;
+    w_q15 = (w_q15 < 0) ? -w_q15 : w_q15;
+    w_q15 = (w_q15 > Q15_ONE) ? Q15_ONE : w_q15;
+    lag   = motor_math_atan2((int16_t)w_q15, (int16_t)smo.lpf_k);
+    smo.theta = (smo.omega_q16 < 0) ? (uint16_t)(smo.theta_pll - lag) : (uint16_t)(smo.theta_pll + lag);
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,99 @@
+/**
+ * @file motor_smo.h
+ * @brief Driver motor_smo Header
+ * 
+ * @details
+ * Sliding mode current observer in the alpha/beta frame, low pass filtered
+ * switching signal as the back EMF, PLL for the angle and the speed.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_SMO_H__
+#define __MOTOR_SMO_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+/* i[k+1] = F * i[k] + G * (v - z), discretized R-L model (Lq) */
+#define SMO_F                           ((int32_t)((1.0f - MOTOR_RS_OHM * MOTOR_TS_S / MOTOR_LQ_H) * 32768.0f))
+#define SMO_G                           ((int32_t)(MOTOR_TS_S / MOTOR_LQ_H * MOTOR_V_BASE_V / MOTOR_I_BASE_A * 32768.0f))
+
+#define SMO_K                           (Q15(0.70f * MOTOR_V_LINEAR))   // switching gain, above the bemf at top speed
+#define SMO_SLOPE                       (12)                // K / boundary layer; SMO_G * SMO_SLOPE must stay < 1 (discrete chattering)
+#define SMO_LPF_HZ                      (400.0f)
+#define SMO_LPF_K                       ((int32_t)(6.2831853f * SMO_LPF_HZ * MOTOR_TS_S * 32768.0f))
+#define SMO_E_MIN                       (Q15(0.01f * MOTOR_V_LINEAR))   // bemf too small to give an angle
+
+/* PLL, error q15 (sin of the angle error), speed in 1/65536 angle step per period */
+#define SMO_PLL_BW_HZ                   (100.0f)
+#define SMO_PLL_WN_TS                   (6.2831853f * SMO_PLL_BW_HZ * MOTOR_TS_S)
+#define SMO_PLL_KP                      ((int32_t)(1.4142136f * SMO_PLL_WN_TS * 20860.76f))
+#define SMO_PLL_KI                      ((int32_t)(SMO_PLL_WN_TS * SMO_PLL_WN_TS * 20860.76f + 0.5f))
+#define SMO_SPEED_SHIFT                 (6)                 // speed output filter, 64 periods
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    int32_t  i_alpha;               /*estimated current, q15*/
+    int32_t  i_beta;
+    int32_t  z_alpha;               /*switching signal, q15 voltage*/
+    int32_t  z_beta;
+    int32_t  e_alpha;               /*filtered bemf, q15 voltage*/
+    int32_t  e_beta;
+    int32_t  omega_q16;             /*pll speed, angle step per period << 16*/
+    int32_t  omega_i_q16;           /*pll integrator*/
+    uint16_t theta_pll;
+    uint16_t theta;                 /*pll angle + filter lag*/
+    int16_t  speed;                 /*filtered angle step per period*/
+    int32_t  speed_acc;
+    int16_t  pll_err;
+    int32_t  lpf_k;
+}smo_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern smo_t smo;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_smo_init(void);
+void motor_smo_reset(uint16_t theta, int16_t speed);
+void motor_smo_update(int16_t v_alpha, int16_t v_beta, int16_t i_alpha, int16_t i_beta);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_SMO_H__*/
+
+
+/**
+  * @}
+  */
@@ -0,0 +1,440 @@
+/**
+ * @file motor_startup.c
+ * @brief Sensorless FOC start sequence
+ * 
+ * @details
+ * Runs from the TIM1 update interrupt, before the current loop of the same period:
+ *   OFFSET: motor_foc_start() measures the current offsets
+ *   ALIGN:  align_current on d at the start angle, ramped up over the first half
+ *           (skipped when the angle is known)
+ *   IF:     the estimators restart at the start angle, if_current on q of an open
+ *           loop angle accelerated up to handover_speed, the rotor lags until its
+ *           torque matches the load. With little load and damping it swings around
+ *           the open loop angle, so the estimator is compared with the ramp on the
+ *           mean over lock_periods, not period by period
+ *   BLEND:  the mean estimated speed agreed: the frame jumps to the estimated
+ *           angle with the current vector kept where it is in the stator
+ *           (id = i * sin(err), iq = i * cos(err)), then id goes back to 0
+ *   RUN:    references belong to the application
+ * No step in the stator current at the handover, so no torque dip.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_math.h"
+#include "motor_smo.h"
+#include "motor_flux_obs.h"
+#include "motor_foc.h"
+#include "motor_startup.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+startup_t startup;
+
+/* ============================ Static Global Variables ============================ */
+
+static const startup_cfg_t startup_cfg_default =
+{
+    STARTUP_ALIGN_PERIODS,
+    STARTUP_ALIGN_CURRENT,
+    STARTUP_IF_CURRENT,
+    STARTUP_HANDOVER_SPEED,
+    STARTUP_ACCEL_Q16,
+    STARTUP_DAMP,
+    STARTUP_LOCK_PERIODS,
+    STARTUP_BLEND_PERIODS,
+    STARTUP_TIMEOUT_PERIODS,
+    FOC_THETA_FLUX,
+};
+
+/* ============================ Static Function Declarations ============================ */
+
+static void motor_startup_state_set(startup_state_e state);
+static void motor_startup_if_begin(void);
+static void motor_startup_if(void);
+static uint16_t motor_startup_est_theta(void);
+static uint8_t motor_startup_est_plausible(void);
+static void motor_startup_handover(void);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init with the default timing
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_startup_init(void)
+{
+    startup.state       = STARTUP_STATE_IDLE;
+    startup.cfg         = startup_cfg_default;
+    startup.angle_known = 0;
+    startup.theta0      = 0;
+}
+
+
+/**
+ * @brief change the timing, ignored while running
+ * 
+ * @param[in] cfg: new settings
+ * @return None
+ */
+void motor_startup_cfg_set(const startup_cfg_t *cfg)
+{
+    if(startup.state != STARTUP_STATE_IDLE)
+    {
+        return;
+    }
+    startup.cfg = *cfg;
+}
+
+
+/**
+ * @brief rotor angle known from a position detection: the next start skips the alignment
+ * 
+ * @param[in] theta: electrical angle of the d axis
+ * @return None
+ */
+void motor_startup_angle_set(uint16_t theta)
+{
+    startup.theta0      = theta;
+    startup.angle_known = 1;
+}
+
+
+/**
+ * @brief start the current loop, the sequence follows from the pwm interrupt
+ * 
+ * @param[in] dir: rotation direction
+ * @return None
+ */
+void motor_startup_start(motor_dir_e dir)
+{
+    startup.dir            = dir;
+    startup.tick           = 0;
+    startup.lock_cnt       = 0;
+    startup.id_ref         = 0;
+    startup.iq_ref         = 0;
+    startup.handover_err   = 0;
+    startup.i_peak         = 0;
+    startup.closed_loop_us = 0;
+    startup.speed_q16      = 0;
+    if(startup.angle_known == 0)
+    {
+        startup.theta0 = 0;
+    }
+    startup.theta_q16 = (uint32_t)startup.theta0 << 16;
+    startup.theta     = startup.theta0;
+
+    motor_foc_theta_src_set(FOC_THETA_OPEN_LOOP);
+    motor_foc_theta_inc_set(0);
+    motor_foc_theta_set(startup.theta0);
+    motor_foc_current_ref_set(0, 0);
+    motor_startup_state_set(STARTUP_STATE_OFFSET);
+    motor_foc_start(dir);
+}
+
+
+/**
+ * @brief stop, all phases off
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_startup_stop(void)
+{
+    motor_startup_state_set(STARTUP_STATE_IDLE);
+    startup.angle_known = 0;
+    motor_foc_stop();
+}
+
+
+/**
+ * @brief TIM1 update interrupt: one step of the sequence
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_startup_pwm_isr(void)
+{
+    int16_t i_mag;
+
+    if((startup.state == STARTUP_STATE_IDLE) || (startup.state == STARTUP_STATE_FAULT))
+    {
+        return;
+    }
+    startup.tick++;
+    startup.state_tick++;
+
+    i_mag = (int16_t)motor_math_sqrt((uint32_t)(foc.i_alpha * foc.i_alpha) + (uint32_t)(foc.i_beta * foc.i_beta));
+    if(i_mag > startup.i_peak)
+    {
+        startup.i_peak = i_mag;
+    }
+
+    switch(startup.state)
+    {
+        case STARTUP_STATE_OFFSET:
+            if(foc.state != FOC_STATE_RUN)
+            {
+                break;
+            }
+            if((startup.angle_known == 0) && (startup.cfg.align_periods != 0))
+            {
+                startup.id_q16      = 0;
+                startup.id_step_q16 = ((int32_t)startup.cfg.align_current << 17) / startup.cfg.align_periods;
+                motor_startup_state_set(STARTUP_STATE_ALIGN);
+            }
+            else
+            {
+                motor_startup_if_begin();
+            }
+            break;
+
+        case STARTUP_STATE_ALIGN:
+            if(startup.state_tick >= startup.cfg.align_periods)
+            {
+                motor_startup_if_begin();
+                break;
+            }
+            startup.id_q16 += startup.id_step_q16;
+            if(startup.id_q16 > ((int32_t)startup.cfg.align_current << 16))
+            {
+                startup.id_q16 = (int32_t)startup.cfg.align_current << 16;
+            }
+            startup.id_ref = (int16_t)(startup.id_q16 >> 16);
+            motor_foc_current_ref_set(startup.id_ref, 0);
+            break;
+
+        case STARTUP_STATE_IF:
+            motor_startup_if();
+            break;
+
+        case STARTUP_STATE_BLEND:
+            startup.id_q16 -= startup.id_step_q16;
+            if(startup.state_tick >= startup.cfg.blend_periods)
+            {
+                startup.id_q16 = 0;
+                motor_startup_state_set(STARTUP_STATE_RUN);
+            }
+            startup.id_ref = (int16_t)(startup.id_q16 >> 16);
+            motor_foc_current_ref_set(startup.id_ref, startup.iq_ref);
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief enter a state
+ * 
+ * @param[in] state: new state
+ * @return None
+ */
+static void motor_startup_state_set(startup_state_e state)
+{
+    startup.state      = state;
+    startup.state_tick = 0;
+}
+
+
+/**
+ * @brief rotor at the start angle: begin the ramp, or hand over right away to the injection
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_startup_if_begin(void)
+{
+    /*the rotor is at the start angle now, the estimators may have followed the alignment with an offset*/
+    motor_smo_reset(startup.theta0, 0);
+    motor_flux_obs_reset(startup.theta0, 0);
+
+    if(startup.cfg.src == FOC_THETA_HFI)
+    {
+        /*works at standstill: the tracker starts at the start angle*/
+        startup.id_ref = 0;
+        startup.iq_ref = 0;
+        motor_foc_current_ref_set(0, 0);
+        motor_foc_theta_src_set(FOC_THETA_HFI);
+        startup.closed_loop_us = startup.tick * STARTUP_PERIOD_US;
+        motor_startup_state_set(STARTUP_STATE_RUN);
+        return;
+    }
+
+    startup.id_ref    = 0;
+    startup.iq_ref    = (startup.dir == MOTOR_DIR_CW) ? startup.cfg.if_current : (int16_t)-startup.cfg.if_current;
+    startup.lock_cnt  = 0;
+    startup.lock_sum  = 0;
+    startup.lock_miss = 0;
+    motor_foc_current_ref_set(0, startup.iq_ref);
+    motor_startup_state_set(STARTUP_STATE_IF);
+}
+
+
+/**
+ * @brief one period of the open loop ramp, hands over once the estimator follows it
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_startup_if(void)
+{
+    int32_t target = (int32_t)startup.cfg.handover_speed << 16;
+    int32_t speed;
+    int32_t est;
+    int32_t corr;
+    int32_t diff;
+
+    if(startup.speed_q16 < target)
+    {
+        startup.speed_q16 += startup.cfg.accel_q16;
+        if(startup.speed_q16 > target)
+        {
+            startup.speed_q16 = target;
+        }
+        startup.state_tick = 0;             /*timeout counts from the end of the ramp*/
+    }
+    speed = (startup.dir == MOTOR_DIR_CW) ? startup.speed_q16 : -startup.speed_q16;
+    startup.theta_q16 += (uint32_t)speed;
+
+    /*bemf too small for the smo in the first half of the ramp: held on the ramp, else its pll may lock 180 degrees off*/
+    if((startup.cfg.src == FOC_THETA_SMO) && (startup.speed_q16 < (target >> 1)))
+    {
+        motor_smo_reset((uint16_t)(startup.theta_q16 >> 16), (int16_t)(speed >> 16));
+    }
+
+    /*damping: a rotor running ahead of the ramp gets the current turned back, less torque. On the speed
+      of the flux observer whatever takes over: it follows from a few percent of the rated speed, the smo
+      is held on the ramp or not locked yet and would leave the rotor swinging freely*/
+    est  = (startup.cfg.src == FOC_THETA_SMO) ? smo.speed : flux_obs.speed;
+    corr = (flux_obs.speed - (speed >> 16)) * startup.cfg.damp;
+    corr = (corr > STARTUP_DAMP_MAX) ? STARTUP_DAMP_MAX : ((corr < -STARTUP_DAMP_MAX) ? -STARTUP_DAMP_MAX : corr);
+    startup.theta = (uint16_t)((startup.theta_q16 >> 16) - corr);
+    motor_foc_theta_set(startup.theta);
+
+    if(startup.speed_q16 < target)
+    {
+        return;
+    }
+
+    /*mean speed difference over the window: |sum| within tolerance * window, the angle plausible all along:
+      a stalled rotor leaves the smo wandering with a speed that may average out right*/
+    startup.lock_sum += est - (speed >> 16);
+    if(motor_startup_est_plausible() == 0)
+    {
+        startup.lock_miss = 1;
+    }
+    if(++startup.lock_cnt >= startup.cfg.lock_periods)
+    {
+        diff = (startup.lock_sum < 0) ? -startup.lock_sum : startup.lock_sum;
+        if((diff <= ((int32_t)(startup.cfg.handover_speed >> STARTUP_SPEED_TOL_SHIFT) * startup.cfg.lock_periods))
+           && (startup.lock_miss == 0))
+        {
+            motor_startup_handover();
+            return;
+        }
+        startup.lock_cnt  = 0;
+        startup.lock_sum  = 0;
+        startup.lock_miss = 0;
+    }
+
+    if(startup.state_tick >= startup.cfg.timeout_periods)
+    {
+        motor_foc_stop();
+        motor_startup_state_set(STARTUP_STATE_FAULT);
+    }
+}
+
+
+/**
+ * @brief estimated angle for the current loop of this period
+ * 
+ * @param[in] None
+ * @return electrical angle, one period ahead of the last estimate
+ */
+static uint16_t motor_startup_est_theta(void)
+{
+    if(startup.cfg.src == FOC_THETA_SMO)
+    {
+        return (uint16_t)(smo.theta + smo.speed);
+    }
+    return (uint16_t)(flux_obs.theta + flux_obs.speed);
+}
+
+
+/**
+ * @brief the open loop current only gives torque with the rotor d axis ahead of the open
+ *        loop one by 0 (pulling out) to 90 degree (no load, the current on its d axis):
+ *        an estimate far from that range has locked wrong even if its speed agrees, one
+ *        180 degree off looks 90 behind without load
+ * 
+ * @param[in] None
+ * @return 1 plausible, 0 not
+ */
+static uint8_t motor_startup_est_plausible(void)
+{
+    int16_t lead = (int16_t)(motor_startup_est_theta() - startup.theta);
+
+    lead = (startup.dir == MOTOR_DIR_CW) ? lead : (int16_t)-lead;
+    lead = (int16_t)(lead - STARTUP_EST_LEAD);
+    return ((lead < STARTUP_EST_LEAD_TOL) && (lead > -STARTUP_EST_LEAD_TOL)) ? 1 : 0;
+}
+
+
+/**
+ * @brief switch the frame to the estimated angle, the current vector stays where it is in the stator
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_startup_handover(void)
+{
+    uint16_t theta_est;
+    int16_t  err;
+
+    theta_est = motor_startup_est_theta();
+    err       = (int16_t)(theta_est - startup.theta);
+
+    /*q current of the open loop frame seen from the estimated one: rotated by -err*/
+    startup.handover_err = err;
+    startup.id_ref       = (int16_t)((startup.iq_ref * motor_math_sin((uint16_t)err)) >> 15);
+    startup.iq_ref       = (int16_t)((startup.iq_ref * motor_math_cos((uint16_t)err)) >> 15);
+    startup.id_q16       = (int32_t)startup.id_ref << 16;
+    startup.id_step_q16  = startup.id_q16 / (int32_t)((startup.cfg.blend_periods != 0) ? startup.cfg.blend_periods : 1);
+
+    motor_foc_frame_shift(theta_est);
+    motor_foc_current_ref_set(startup.id_ref, startup.iq_ref);
+    motor_foc_theta_src_set(startup.cfg.src);
+    startup.closed_loop_us = startup.tick * STARTUP_PERIOD_US;
+    motor_startup_state_set(STARTUP_STATE_BLEND);
+}
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
@@ -0,0 +1,132 @@
+/**
+ * @file motor_startup.h
+ * @brief Driver motor_startup Header
+ * 
+ * @details
+ * Sensorless FOC start sequence: alignment (or a detected angle), I/F ramp,
+ * handover to the angle estimator.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_STARTUP_H__
+#define __MOTOR_STARTUP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_foc.h"
+
+/* ============================ Public Constants ============================ */
+
+/* defaults of startup_cfg_t, periods are pwm periods (50us) */
+#define STARTUP_ALIGN_PERIODS           (2000)                          // 100ms
+#define STARTUP_ALIGN_CURRENT           (Q15(4.0f / MOTOR_I_BASE_A))
+#define STARTUP_IF_CURRENT              (Q15(5.0f / MOTOR_I_BASE_A))
+#define STARTUP_HANDOVER_SPEED          ((int16_t)(MOTOR_RATED_INC / 10))   // 10% of rated speed, the smo needs about 20%
+#define STARTUP_ACCEL_Q16               ((int32_t)(STARTUP_HANDOVER_SPEED * 65536 / 8000))  // 0.4s to the handover speed
+#define STARTUP_DAMP                    (100)                           // 1 step/period faster: current turned back 0.55 degree
+#define STARTUP_DAMP_MAX                ((int32_t)ANGLE_DEG(45))
+#define STARTUP_LOCK_PERIODS            (2000)                          // mean estimated speed over 100ms
+#define STARTUP_SPEED_TOL_SHIFT         (3)                             // agreeing: within 1/8 of the ramp speed
+#define STARTUP_EST_LEAD                ((int16_t)ANGLE_DEG(45))        // rotor ahead of the open loop angle: 0 pulling out, 90 without load
+#define STARTUP_EST_LEAD_TOL            ((int16_t)ANGLE_DEG(90))        // estimate accepted around it, 180 off (wrong lock) is out
+#define STARTUP_BLEND_PERIODS           (2000)                          // id back to 0 within 100ms
+#define STARTUP_TIMEOUT_PERIODS         (20000)                         // no lock 1s after the ramp: fault
+#define STARTUP_PERIOD_US               (1000000 / PWM_FREQ_HZ)
+
+/* ============================ Code Enum Definitions ============================ */
+
+typedef enum
+{
+    STARTUP_STATE_IDLE = 0,
+    STARTUP_STATE_OFFSET,               /*foc measuring the current offsets*/
+    STARTUP_STATE_ALIGN,                /*current on d at the start angle*/
+    STARTUP_STATE_IF,                   /*current controlled open loop ramp*/
+    STARTUP_STATE_BLEND,                /*closed loop, id of the frame change going back to 0*/
+    STARTUP_STATE_RUN,
+    STARTUP_STATE_FAULT,                /*estimator never agreed with the ramp*/
+}startup_state_e;
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    uint16_t        align_periods;      /*0: no alignment even without a known angle*/
+    int16_t         align_current;      /*q15*/
+    int16_t         if_current;         /*q15, magnitude of the open loop current*/
+    int16_t         handover_speed;     /*angle step per period*/
+    int32_t         accel_q16;          /*speed added every period, q16*/
+    int16_t         damp;               /*angle turned back per unit of estimated minus ramp speed*/
+    uint16_t        lock_periods;
+    uint16_t        blend_periods;
+    uint16_t        timeout_periods;
+    foc_theta_src_e src;                /*estimator taking over; FOC_THETA_HFI skips the ramp*/
+}startup_cfg_t;
+
+typedef struct
+{
+    startup_state_e state;
+    startup_cfg_t   cfg;
+    motor_dir_e     dir;
+    uint8_t         angle_known;        /*start angle given (position detection): no alignment*/
+    uint16_t        theta0;
+    uint32_t        theta_q16;          /*open loop angle*/
+    uint16_t        theta;              /*angle applied: open loop angle with the damping*/
+    int32_t         speed_q16;          /*open loop speed, angle step per period q16*/
+    uint32_t        tick;               /*periods since the start*/
+    uint32_t        state_tick;         /*periods in the current state*/
+    uint16_t        lock_cnt;
+    int32_t         lock_sum;           /*estimated minus open loop speed, summed over the window*/
+    uint8_t         lock_miss;          /*estimated angle out of reach of the open loop current in the window*/
+    int16_t         id_ref;
+    int16_t         iq_ref;
+    int32_t         id_q16;             /*id ramp of the alignment and the blend*/
+    int32_t         id_step_q16;
+    int16_t         handover_err;       /*estimated minus open loop angle at the handover*/
+    int16_t         i_peak;             /*largest current vector seen, q15*/
+    uint32_t        closed_loop_us;     /*time from the start to the handover*/
+}startup_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern startup_t startup;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_startup_init(void);
+void motor_startup_cfg_set(const startup_cfg_t *cfg);
+void motor_startup_angle_set(uint16_t theta);
+void motor_startup_start(motor_dir_e dir);
+void motor_startup_stop(void);
+void motor_startup_pwm_isr(void);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_STARTUP_H__*/
+
+
+/**
+  * @}
+  */
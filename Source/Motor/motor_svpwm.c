@@ -0,0 +1,322 @@
+/**
+ * @file motor_svpwm.c
+ * @brief Space vector pwm with overmodulation up to six-step
+ * 
+ * @details
+ * Adding -(max + min) / 2 to the three phase voltages gives the same duties as
+ * the sector based SVPWM without the sector search and without division.
+ * 
+ * Beyond the linear circle (sqrt(3) / 2 of 2/3 Vbus) the three phases with
+ * their zero sequence are multiplied by a gain k and each is clipped at its
+ * rail. Along the circle the phases that hit a rail stay there, the middle
+ * phase keeps moving, so the vector runs on the hexagon where the circle is
+ * outside it:
+ *   mode I:  k * |v| <= 1, arcs and hexagon edges, up to the trajectory on
+ *            the hexagon itself (0.913, 95.7% of six-step)
+ *   mode II: k * |v| > 1, the middle phase reaches its rail too and the
+ *            vector is held at the vertices, the longer the larger k; k = 16
+ *            is six-step within 0.02%
+ * k comes from a table over |v|^2 (Tools/motor_ovm_gen.c) such that the
+ * fundamental of the output is |v|: the gain from the current loop to the
+ * motor stays 1 on to six-step (3 / pi). The table holds 1 / k, smooth where
+ * k runs away; one division per overmodulated period, nothing more in the
+ * linear range.
+ * 
+ * The mode is chosen at runtime; off is the plain SVPWM, clipping above the
+ * circle. svpwm.v_max is the fundamental limit of the mode for the current
+ * loop, svpwm.v_alpha / v_beta the vector after the clipping.
+ * 
+ * Discontinuous pwm replaces the centred zero sequence by one that puts a
+ * phase on a rail, the line voltages and so the current do not change:
+ *   DPWMMIN: lowest phase on the low rail, each phase 120 degree at its minimum
+ *   DPWMMAX: highest phase on the high rail, 120 degree at its maximum
+ *   DPWM1:   the phase of the largest magnitude, 60 degree around each peak
+ * One leg of three does not switch: a third fewer switching events, and the
+ * held legs are the ones carrying the peak current in DPWM1. Below
+ * SVPWM_DPWM_V_OFF the modulation goes back to continuous (hysteresis to
+ * V_ON): the ripple of the held phase would grow, there is little to save.
+ * The phases measured on their low side shunt (svpwm.shunt_phases) are never
+ * held high (no low side on-time, no sample), their high clamp becomes the
+ * low clamp of the lowest phase. Every phase that ends on a rail, whatever the mode,
+ * counts two avoided events per period in svpwm.switch_avoided, against
+ * 6 * svpwm.periods; svpwm.clamp tells motor_dtc which legs have no dead time.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_svpwm.h"
+#include "motor_ovm_table.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SVPWM_OVM_K_ONE                 (1 << SVPWM_OVM_K_SHIFT)
+#define SVPWM_OVM_K_INV_MIN             ((1 << (15 + SVPWM_OVM_K_SHIFT)) / SVPWM_OVM_K_MAX)
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+svpwm_t svpwm;
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief phase voltage to compare value
+ * 
+ * @param[in] v: phase voltage with the zero sequence, q15 of 2/3 Vbus
+ * @return compare value 0 ~ PWM_PERIOD_MAX
+ */
+static __INLINE uint16_t motor_svpwm_duty(int32_t v)
+{
+    int32_t duty = SVPWM_HALF + ((v * SVPWM_GAIN) >> 15);
+
+    if(duty < 0)
+    {
+        duty = 0;
+    }
+    else if(duty > PWM_PERIOD_MAX)
+    {
+        duty = PWM_PERIOD_MAX;
+    }
+    return (uint16_t)duty;
+}
+
+
+/**
+ * @brief phase voltage times the overmodulation gain, clipped at the rails
+ * 
+ * @param[in] v: phase voltage with the zero sequence, q15 of 2/3 Vbus
+ * @param[in] k: gain, q12
+ * @return phase voltage within +-SVPWM_RAIL
+ */
+static __INLINE int32_t motor_svpwm_ovm_phase(int32_t v, int32_t k)
+{
+    v = (v * k) >> SVPWM_OVM_K_SHIFT;
+    return (v > SVPWM_RAIL) ? SVPWM_RAIL : ((v < -SVPWM_RAIL) ? -SVPWM_RAIL : v);
+}
+
+static int32_t motor_svpwm_ovm_gain(int32_t m2);
+static int32_t motor_svpwm_dpwm_zero(const int32_t *v, uint8_t hi, uint8_t lo);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init, continuous, no overmodulation
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_svpwm_init(void)
+{
+    svpwm.k              = SVPWM_OVM_K_ONE;
+    svpwm.v_alpha        = 0;
+    svpwm.v_beta         = 0;
+    svpwm.clamp          = 0;
+    svpwm.periods        = 0;
+    svpwm.switch_avoided = 0;
+    svpwm.shunt_phases   = SVPWM_SHUNT_PHASES;
+    motor_svpwm_ovm_set(SVPWM_OVM_OFF);
+    motor_svpwm_dpwm_set(SVPWM_DPWM_OFF);
+}
+
+
+/**
+ * @brief select the overmodulation mode, can be switched while running
+ * 
+ * @param[in] ovm: SVPWM_OVM_OFF, SVPWM_OVM_I or SVPWM_OVM_II
+ * @return None
+ */
+void motor_svpwm_ovm_set(svpwm_ovm_e ovm)
+{
+    static const int16_t v_max[SVPWM_OVM_MAX] = {SVPWM_V_LINEAR, SVPWM_OVM1_V_MAX, SVPWM_V_SIX_STEP};
+
+    if(ovm < SVPWM_OVM_MAX)
+    {
+        svpwm.v_max  = v_max[ovm];
+        svpwm.m2_max = ((int32_t)v_max[ovm] * v_max[ovm]) >> 15;
+        svpwm.ovm    = ovm;
+    }
+}
+
+
+/**
+ * @brief discontinuous mode, can be switched while running
+ * 
+ * @param[in] dpwm: SVPWM_DPWM_OFF, SVPWM_DPWM_MIN, SVPWM_DPWM_MAX or SVPWM_DPWM_1
+ * @return None
+ */
+void motor_svpwm_dpwm_set(svpwm_dpwm_e dpwm)
+{
+    if(dpwm < SVPWM_DPWM_MODE_MAX)
+    {
+        svpwm.dpwm    = dpwm;
+        svpwm.dpwm_on = 0;
+    }
+}
+
+
+/**
+ * @brief phases that must keep their low side on-time for the current samples
+ * 
+ * @param[in] phases: bit 0 = U, SVPWM_SHUNT_PHASES with the U and V shunts, 0 when the sampling copes with a high clamp
+ * @return None
+ */
+void motor_svpwm_shunt_phases_set(uint8_t phases)
+{
+    svpwm.shunt_phases = phases;
+}
+
+
+/**
+ * @brief alpha/beta voltage to the three compare values (about 40 cycles, 80 overmodulated)
+ * 
+ * @param[in] v_alpha: q15 of 2/3 Vbus
+ * @param[in] v_beta: q15 of 2/3 Vbus
+ * @param[out] duty: compare value of phase U, V, W
+ * @return None
+ */
+void motor_svpwm_calc(int16_t v_alpha, int16_t v_beta, uint16_t *duty)
+{
+    int32_t v[3];
+    uint8_t hi = 0;
+    uint8_t lo = 0;
+    uint8_t i;
+    uint8_t clamp = 0;
+    int32_t v0;
+    int32_t m2 = 0;
+
+    v[0] = v_alpha;
+    v[1] = (-(v[0] << 14) + (int32_t)v_beta * SVPWM_SQRT3_2) >> 15;
+    v[2] = -v[0] - v[1];
+    for(i = 1; i < 3; i++)
+    {
+        hi = (v[i] > v[hi]) ? i : hi;
+        lo = (v[i] < v[lo]) ? i : lo;
+    }
+    if((svpwm.ovm != SVPWM_OVM_OFF) || (svpwm.dpwm != SVPWM_DPWM_OFF))
+    {
+        m2 = (int32_t)(((uint32_t)((int32_t)v_alpha * v_alpha) + (uint32_t)((int32_t)v_beta * v_beta)) >> 15);
+    }
+
+    /*zero sequence: centred, or one phase onto its rail in the linear range*/
+    v0 = -((v[hi] + v[lo]) >> 1);
+    if(svpwm.dpwm != SVPWM_DPWM_OFF)
+    {
+        svpwm.dpwm_on = (m2 > SVPWM_DPWM_M2_ON) ? 1 : ((m2 < SVPWM_DPWM_M2_OFF) ? 0 : svpwm.dpwm_on);
+        if((svpwm.dpwm_on != 0) && (m2 <= SVPWM_OVM_M2_MIN))
+        {
+            v0 = motor_svpwm_dpwm_zero(v, hi, lo);
+        }
+    }
+    v[0] += v0;
+    v[1] += v0;
+    v[2] += v0;
+
+    svpwm.k       = SVPWM_OVM_K_ONE;
+    svpwm.v_alpha = v_alpha;
+    svpwm.v_beta  = v_beta;
+    if((svpwm.ovm != SVPWM_OVM_OFF) && (m2 > SVPWM_OVM_M2_MIN))
+    {
+        svpwm.k       = motor_svpwm_ovm_gain((m2 < svpwm.m2_max) ? m2 : svpwm.m2_max);
+        v[0]          = motor_svpwm_ovm_phase(v[0], svpwm.k);
+        v[1]          = motor_svpwm_ovm_phase(v[1], svpwm.k);
+        v[2]          = motor_svpwm_ovm_phase(v[2], svpwm.k);
+        svpwm.v_alpha = (int16_t)(((2 * v[0] - v[1] - v[2]) * SVPWM_ONE_THIRD) >> 15);
+        svpwm.v_beta  = (int16_t)(((v[1] - v[2]) * SVPWM_INV_SQRT3) >> 15);
+    }
+
+    /*a phase on a rail does not switch in this period*/
+    for(i = 0; i < 3; i++)
+    {
+        duty[i] = motor_svpwm_duty(v[i]);
+        clamp  |= ((duty[i] == 0) || (duty[i] == PWM_PERIOD_MAX)) ? (uint8_t)(1 << i) : 0;
+    }
+    svpwm.clamp           = clamp;
+    svpwm.periods++;
+    svpwm.switch_avoided += (uint32_t)(((clamp & 1) + ((clamp >> 1) & 1) + (clamp >> 2)) << 1);
+}
+
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief overmodulation gain of a magnitude, 1 / k interpolated in the table
+ * 
+ * @param[in] m2: |v|^2, q15, above SVPWM_OVM_M2_MIN
+ * @return k, q12
+ */
+static int32_t motor_svpwm_ovm_gain(int32_t m2)
+{
+    int32_t x   = m2 - SVPWM_OVM_M2_MIN;
+    int32_t seg = x >> SVPWM_OVM_SEG_SHIFT;
+    int32_t frac;
+    int32_t k_inv;
+
+    if(seg >= SVPWM_OVM_SEGMENTS)
+    {
+        return SVPWM_OVM_K_MAX;
+    }
+    frac  = x & ((1 << SVPWM_OVM_SEG_SHIFT) - 1);
+    k_inv = svpwm_ovm_table[seg] + (((svpwm_ovm_table[seg + 1] - svpwm_ovm_table[seg]) * frac) >> SVPWM_OVM_SEG_SHIFT);
+
+    return (k_inv <= SVPWM_OVM_K_INV_MIN) ? SVPWM_OVM_K_MAX : ((1 << (15 + SVPWM_OVM_K_SHIFT)) / k_inv);
+}
+
+
+/**
+ * @brief zero sequence putting one phase on its rail
+ * 
+ * @param[in] v: phase voltages without zero sequence
+ * @param[in] hi: index of the highest phase
+ * @param[in] lo: index of the lowest phase
+ * @return zero sequence
+ */
+static int32_t motor_svpwm_dpwm_zero(const int32_t *v, uint8_t hi, uint8_t lo)
+{
+    uint8_t high;
+
+    switch(svpwm.dpwm)
+    {
+        case SVPWM_DPWM_MAX:
+            high = 1;
+            break;
+
+        case SVPWM_DPWM_1:
+            high = (uint8_t)((v[hi] + v[lo]) >= 0);
+            break;
+
+        default:
+            high = 0;
+            break;
+    }
+
+    /*the shunt phases need their low side on, the lowest phase goes to the low rail instead*/
+    if((high != 0) && ((svpwm.shunt_phases & (1 << hi)) == 0))
+    {
+        return SVPWM_RAIL - v[hi];
+    }
+    return -SVPWM_RAIL - v[lo];
+}
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
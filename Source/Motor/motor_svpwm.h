@@ -0,0 +1,131 @@
+/**
+ * @file motor_svpwm.h
+ * @brief Driver motor_svpwm Header
+ * 
+ * @details
+ * Space vector modulation by min-max zero sequence injection. The voltage is
+ * in q15 of 2/3 Vbus: 1.0 is a hexagon vertex, the linear range ends on the
+ * circle of sqrt(3) / 2, six-step is 3 / pi. Overmodulation (modes I and II)
+ * carries the fundamental from the circle on to six-step, the discontinuous
+ * modes hold one phase on a rail to save its switching.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_SVPWM_H__
+#define __MOTOR_SVPWM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "bsp_pwm.h"
+#include "motor_param.h"
+#include "motor_math.h"
+
+/* ============================ Public Constants ============================ */
+
+#define SVPWM_HALF                      (PWM_PERIOD_MAX / 2)
+#define SVPWM_GAIN                      ((int32_t)(PWM_PERIOD_MAX * 0.66666667f + 0.5f))   // PWM_PERIOD_MAX * 2 / 3
+#define SVPWM_SQRT3_2                   (28378)                                             // sqrt(3) / 2 in q15
+#define SVPWM_ONE_THIRD                 (10923)                                             // 1 / 3 in q15
+#define SVPWM_INV_SQRT3                 (18919)                                             // 1 / sqrt(3) in q15
+#define SVPWM_RAIL                      ((int32_t)SVPWM_HALF * 32768 / SVPWM_GAIN)          // phase voltage of a duty limit, 0.75
+
+/* fundamental limits, q15 */
+#define SVPWM_V_LINEAR                  (Q15(MOTOR_V_LINEAR))
+#define SVPWM_V_SIX_STEP                (Q15(0.95492966f))                                  // 3 / pi
+
+/* overmodulation gain table over |v|^2 from the linear circle (0.75) to six-step, must match Tools/motor_ovm_gen.c */
+#define SVPWM_OVM_M2_MIN                (24576)
+#define SVPWM_OVM_SEG_SHIFT             (8)
+#define SVPWM_OVM_SEGMENTS              (21)
+#define SVPWM_OVM_TABLE_SIZE            (SVPWM_OVM_SEGMENTS + 1)
+#define SVPWM_OVM_K_SHIFT               (12)
+#define SVPWM_OVM_K_MAX                 (16 << SVPWM_OVM_K_SHIFT)                           // six-step within 0.02%, phase * k in 31 bit
+
+/* discontinuous pwm above V_ON, continuous again below V_OFF: the clamped phase has more ripple at low voltage */
+#define SVPWM_DPWM_V_ON                 (0.50f * MOTOR_V_LINEAR)
+#define SVPWM_DPWM_V_OFF                (0.45f * MOTOR_V_LINEAR)
+#define SVPWM_DPWM_M2_ON                ((int32_t)(SVPWM_DPWM_V_ON * SVPWM_DPWM_V_ON * 32768.0f))
+#define SVPWM_DPWM_M2_OFF               ((int32_t)(SVPWM_DPWM_V_OFF * SVPWM_DPWM_V_OFF * 32768.0f))
+
+/* phases measured on their low side shunt with two shunts (U, V): never held on the high rail, the sample would be lost */
+#define SVPWM_SHUNT_PHASES              (0x03)
+
+/* ============================ Code Enum Definitions ============================ */
+
+typedef enum
+{
+    SVPWM_OVM_OFF = 0,                  /*linear, the duties clip above the circle*/
+    SVPWM_OVM_I,                        /*up to the hexagon trajectory*/
+    SVPWM_OVM_II,                       /*on to six-step, held at the vertices*/
+    SVPWM_OVM_MAX,
+}svpwm_ovm_e;
+
+typedef enum
+{
+    SVPWM_DPWM_OFF = 0,                 /*continuous, centred zero sequence*/
+    SVPWM_DPWM_MIN,                     /*lowest phase on the low rail*/
+    SVPWM_DPWM_MAX,                     /*highest phase on the high rail*/
+    SVPWM_DPWM_1,                       /*phase of the largest magnitude on its rail, around its peak*/
+    SVPWM_DPWM_MODE_MAX,
+}svpwm_dpwm_e;
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    svpwm_ovm_e  ovm;
+    int16_t      v_max;                 /*largest fundamental of the mode, q15*/
+    int32_t      m2_max;                /*|v|^2 the gain is looked up at most*/
+    int32_t      k;                     /*phase gain of the last period, q12*/
+    int16_t      v_alpha;               /*vector of the last period after the clipping*/
+    int16_t      v_beta;
+    svpwm_dpwm_e dpwm;
+    uint8_t      dpwm_on;               /*discontinuous right now, above SVPWM_DPWM_V_ON*/
+    uint8_t      clamp;                 /*phases held on a rail in the last period, bit 0 = U*/
+    uint8_t      shunt_phases;          /*phases never held on the high rail, bit 0 = U*/
+    uint32_t     periods;               /*periods modulated*/
+    uint32_t     switch_avoided;        /*switching events saved by the phases on a rail, 2 per phase and period*/
+}svpwm_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern svpwm_t svpwm;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_svpwm_init(void);
+void motor_svpwm_ovm_set(svpwm_ovm_e ovm);
+void motor_svpwm_dpwm_set(svpwm_dpwm_e dpwm);
+void motor_svpwm_shunt_phases_set(uint8_t phases);
+void motor_svpwm_calc(int16_t v_alpha, int16_t v_beta, uint16_t *duty);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_SVPWM_H__*/
+
+
+/**
+  * @}
+  */
@@ -0,0 +1,344 @@
+/**
+ * @file motor_traj.c
+ * @brief Trapezoidal / S-curve profile generator
+ * 
+ * @details
+ * One sample per speed loop step (motor_loop), incremental, no division and no
+ * trig per sample: adds, a few 64 bit multiplies and one ring buffer slot.
+ * 
+ * Trapezoid: speed moves by at most accel per sample.
+ *   speed target: towards the target speed
+ *   position target: the fastest of accelerate / hold / brake that can still stop
+ *   at the target, tested without division on the discrete braking distance
+ *     2 * a * remaining >= v^2 - v * a
+ *   the last sample moves exactly the remainder, so the profile lands on the target
+ * S-curve: the trapezoidal speed through a moving average of 2^jerk_shift samples.
+ *   The acceleration then ramps over 2^jerk_shift samples: jerk accel / 2^n, twice
+ *   that when the trapezoid goes straight from accelerating to braking. The move
+ *   ends at the same position, only 2^(n-1) samples later.
+ * A new target at any time plans from the current state (speed and acceleration
+ * stay continuous, overshoot and come back when it is too close to stop).
+ * 
+ * Targets and limits come from the thread while motor_traj_step() runs in the
+ * speed loop interrupt: they are staged in 32 bit fields behind a request
+ * flag, cleared before the fields are written and set after, and taken at the
+ * next step. The interrupt never sees a half written target, the 64 bit
+ * state is only written by the interrupt (and by motor_traj_reset(), with
+ * the interrupt masked by motor_loop). A restart does not fill the filter:
+ * the slots not written since hold the restart speed, the sum starts there.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_traj.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+traj_t traj;
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+static void motor_traj_restart(int64_t pos_q16, int32_t speed_q16);
+static void motor_traj_request_take(void);
+static int32_t motor_traj_trap_position(void);
+static uint8_t motor_traj_can_stop(int32_t v, int64_t remaining);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init with the default limits, standing at 0
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_traj_init(void)
+{
+    traj.speed_max_q16   = (int32_t)TRAJ_SPEED_MAX << TRAJ_SPEED_SHIFT;
+    traj.accel_q16       = TRAJ_ACCEL_Q16;
+    traj.jerk_shift      = TRAJ_JERK_SHIFT;
+    traj.jerk_shift_next = TRAJ_JERK_SHIFT;
+    traj.req_limits      = 0;
+    motor_traj_reset(0, 0);
+}
+
+
+/**
+ * @brief start from the motor state, holding its speed; a staged target is dropped
+ * 
+ * @param[in] pos: electrical angle steps
+ * @param[in] speed: steps per pwm period
+ * @return None
+ */
+void motor_traj_reset(int32_t pos, int16_t speed)
+{
+    speed                 = (speed > TRAJ_SPEED_LIMIT) ? TRAJ_SPEED_LIMIT : ((speed < -TRAJ_SPEED_LIMIT) ? -TRAJ_SPEED_LIMIT : speed);
+    traj.req              = TRAJ_REQ_NONE;
+    traj.jerk_shift       = traj.jerk_shift_next;
+    traj.target           = TRAJ_TARGET_SPEED;
+    traj.speed_target_q16 = (int32_t)speed << TRAJ_SPEED_SHIFT;
+    traj.pos_target_q16   = (int64_t)pos << 16;
+    motor_traj_restart((int64_t)pos << 16, traj.speed_target_q16);
+}
+
+
+/**
+ * @brief limits, speed and acceleration at once from the next step, the jerk time once the profile is settled
+ * 
+ * @param[in] speed_max: steps per pwm period
+ * @param[in] accel_q16: speed change per sample, steps per sample q16
+ * @param[in] jerk_shift: 0 trapezoidal, n acceleration ramps over 2^n samples
+ * @return None
+ */
+void motor_traj_limits_set(int16_t speed_max, int32_t accel_q16, uint8_t jerk_shift)
+{
+    speed_max               = (speed_max < 0) ? (int16_t)-speed_max : speed_max;
+    speed_max               = (speed_max > TRAJ_SPEED_LIMIT) ? TRAJ_SPEED_LIMIT : speed_max;
+    traj.req_limits         = 0;
+    __DMB();
+    traj.req_speed_max_q16  = (int32_t)speed_max << TRAJ_SPEED_SHIFT;
+    traj.req_accel_q16      = (accel_q16 < 1) ? 1 : ((accel_q16 > TRAJ_ACCEL_MAX_Q16) ? TRAJ_ACCEL_MAX_Q16 : accel_q16);
+    __DMB();
+    traj.req_limits         = 1;
+    traj.jerk_shift_next    = (jerk_shift > TRAJ_JERK_SHIFT_MAX) ? TRAJ_JERK_SHIFT_MAX : jerk_shift;
+}
+
+
+/**
+ * @brief new speed target from the next step, planned from where the profile is
+ * 
+ * @param[in] speed: steps per pwm period, signed
+ * @return None
+ */
+void motor_traj_speed_target(int16_t speed)
+{
+    speed          = (speed > TRAJ_SPEED_LIMIT) ? TRAJ_SPEED_LIMIT : ((speed < -TRAJ_SPEED_LIMIT) ? -TRAJ_SPEED_LIMIT : speed);
+    traj.req       = TRAJ_REQ_NONE;
+    __DMB();
+    traj.req_value = speed;
+    __DMB();
+    traj.req       = TRAJ_REQ_SPEED;
+}
+
+
+/**
+ * @brief new position target from the next step, planned from where the profile is
+ * 
+ * @param[in] pos: electrical angle steps
+ * @return None
+ */
+void motor_traj_position_target(int32_t pos)
+{
+    traj.req       = TRAJ_REQ_NONE;
+    __DMB();
+    traj.req_value = pos;
+    __DMB();
+    traj.req       = TRAJ_REQ_POSITION;
+}
+
+
+/**
+ * @brief one sample: traj.speed / traj.pos for this speed loop step
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_traj_step(void)
+{
+    int32_t v = traj.speed_trap_q16;
+    int32_t goal;
+    int32_t dv;
+    int32_t old;
+    int64_t pos_q16;
+    uint8_t at_target;
+
+    motor_traj_request_take();
+    if(traj.target == TRAJ_TARGET_SPEED)
+    {
+        goal = traj.speed_target_q16;
+        goal = (goal > traj.speed_max_q16) ? traj.speed_max_q16 : ((goal < -traj.speed_max_q16) ? -traj.speed_max_q16 : goal);
+        dv   = goal - v;
+        dv   = (dv > traj.accel_q16) ? traj.accel_q16 : ((dv < -traj.accel_q16) ? -traj.accel_q16 : dv);
+        v   += dv;
+        at_target = (v == goal) ? 1 : 0;
+    }
+    else
+    {
+        v = motor_traj_trap_position();
+        at_target = 0;
+    }
+    traj.speed_trap_q16 = v;
+    traj.pos_trap_q16  += v;
+    if(traj.target == TRAJ_TARGET_POSITION)
+    {
+        /*the last step lands with the remainder as speed: at the target only once stopped there*/
+        at_target = ((traj.pos_trap_q16 == traj.pos_target_q16) && (v == 0)) ? 1 : 0;
+    }
+
+    /*moving average over 2^jerk_shift samples, the position sums it without rounding*/
+    old                          = (traj.filter_fill < (1U << traj.jerk_shift)) ? traj.filter_init : traj.filter[traj.filter_idx];
+    traj.filter[traj.filter_idx] = v;
+    traj.filter_fill            += (traj.filter_fill < (1U << traj.jerk_shift)) ? 1 : 0;
+    traj.filter_idx              = (uint8_t)((traj.filter_idx + 1) & ((1 << traj.jerk_shift) - 1));
+    traj.filter_sum             += (int64_t)v - old;
+    traj.pos_out                += traj.filter_sum;
+
+    traj.speed = (int16_t)((traj.filter_sum < 0) ? -(-traj.filter_sum >> (traj.jerk_shift + TRAJ_SPEED_SHIFT))
+                                                 : (traj.filter_sum >> (traj.jerk_shift + TRAJ_SPEED_SHIFT)));
+    traj.pos   = (int32_t)(traj.pos_out >> (traj.jerk_shift + 16));
+    traj.done  = ((at_target != 0) && (traj.filter_sum == ((int64_t)v << traj.jerk_shift))) ? 1 : 0;
+
+    if((traj.done != 0) && (traj.jerk_shift != traj.jerk_shift_next))
+    {
+        pos_q16         = traj.pos_out >> traj.jerk_shift;
+        traj.jerk_shift = traj.jerk_shift_next;
+        motor_traj_restart(pos_q16, v);
+    }
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief the filter as after a long run at the speed, output at pos: the sum is set, the slots are not
+ * 
+ * @param[in] pos_q16: output position
+ * @param[in] speed_q16: steps per sample q16
+ * @return None
+ */
+static void motor_traj_restart(int64_t pos_q16, int32_t speed_q16)
+{
+    uint16_t n = (uint16_t)(1 << traj.jerk_shift);
+
+    traj.filter_idx     = 0;
+    traj.filter_fill    = 0;
+    traj.filter_init    = speed_q16;
+    traj.filter_sum     = (int64_t)speed_q16 << traj.jerk_shift;
+    traj.speed_trap_q16 = speed_q16;
+    /*the trapezoid runs (n - 1) / 2 samples ahead of the average*/
+    traj.pos_trap_q16   = pos_q16 + (((int64_t)speed_q16 * (n - 1)) >> 1);
+    traj.pos_out        = pos_q16 << traj.jerk_shift;
+    traj.speed          = (int16_t)(speed_q16 >> TRAJ_SPEED_SHIFT);
+    traj.pos            = (int32_t)(pos_q16 >> 16);
+    traj.done           = 0;
+}
+
+
+/**
+ * @brief take the target and the limits staged by the thread
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void motor_traj_request_take(void)
+{
+    int64_t base;
+
+    if(traj.req_limits != 0)
+    {
+        traj.speed_max_q16 = traj.req_speed_max_q16;
+        traj.accel_q16     = traj.req_accel_q16;
+        traj.req_limits    = 0;
+    }
+
+    if(traj.req == TRAJ_REQ_SPEED)
+    {
+        traj.speed_target_q16 = traj.req_value << TRAJ_SPEED_SHIFT;
+        traj.target           = TRAJ_TARGET_SPEED;
+    }
+    else if(traj.req == TRAJ_REQ_POSITION)
+    {
+        /*the target modulo 2^32 nearest to the profile: a wrapped position counter moves the short way*/
+        base                = traj.pos_trap_q16 >> 16;
+        traj.pos_target_q16 = (base + (int32_t)((uint32_t)traj.req_value - (uint32_t)base)) << 16;
+        traj.target         = TRAJ_TARGET_POSITION;
+    }
+    traj.req = TRAJ_REQ_NONE;
+}
+
+
+/**
+ * @brief trapezoidal speed of this sample towards the position target
+ * 
+ * @param[in] None
+ * @return steps per sample q16
+ */
+static int32_t motor_traj_trap_position(void)
+{
+    int64_t d = traj.pos_target_q16 - traj.pos_trap_q16;
+    int32_t s = (d < 0) ? -1 : 1;
+    int32_t a = traj.accel_q16;
+    int32_t v = s * traj.speed_trap_q16;        /*positive: towards the target*/
+    int32_t v_next;
+
+    d = (d < 0) ? -d : d;
+    if((d <= a) && (v <= a) && (v >= -a))
+    {
+        /*last step: exactly the rest*/
+        return s * (int32_t)d;
+    }
+    d = (d > TRAJ_DIST_MAX_Q16) ? TRAJ_DIST_MAX_Q16 : d;
+
+    /*accelerate, else hold, else brake*/
+    v_next = v + a;
+    v_next = (v_next > traj.speed_max_q16) ? traj.speed_max_q16 : v_next;
+    v_next = (v_next < v - a) ? (v - a) : v_next;
+    if(motor_traj_can_stop(v_next, d - v_next) == 0)
+    {
+        v_next = (v > traj.speed_max_q16) ? traj.speed_max_q16 : v;
+        v_next = (v_next < v - a) ? (v - a) : v_next;
+        if(motor_traj_can_stop(v_next, d - v_next) == 0)
+        {
+            v_next = v - a;
+        }
+    }
+
+    return s * v_next;
+}
+
+
+/**
+ * @brief discrete braking distance of v (v - a, v - 2a, ...) within the remaining distance
+ * 
+ * @param[in] v: speed towards the target, q16
+ * @param[in] remaining: distance left after this sample, q16
+ * @return 1 can stop in time
+ */
+static uint8_t motor_traj_can_stop(int32_t v, int64_t remaining)
+{
+    if(v <= 0)
+    {
+        return 1;
+    }
+    if(remaining < 0)
+    {
+        return 0;
+    }
+
+    return ((2 * (int64_t)traj.accel_q16 * remaining) >= ((int64_t)v * v - (int64_t)v * traj.accel_q16)) ? 1 : 0;
+}
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
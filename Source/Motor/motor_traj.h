@@ -0,0 +1,121 @@
+/**
+ * @file motor_traj.h
+ * @brief Driver motor_traj Header
+ * 
+ * @details
+ * Trapezoidal and jerk limited (S-curve) speed / position references, one
+ * sample per speed loop step.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_TRAJ_H__
+#define __MOTOR_TRAJ_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_loop.h"
+
+/* ============================ Public Constants ============================ */
+
+/* internal units: steps per sample (LOOP_SPEED_DIV periods) q16, sample = one speed loop step */
+#define TRAJ_SPEED_SHIFT                (16 + LOOP_SPEED_SHIFT)     // steps per period -> steps per sample q16
+#define TRAJ_SAMPLE_HZ                  (PWM_FREQ_HZ / LOOP_SPEED_DIV)
+
+/* defaults: rated speed, 0 to rated speed in 0.5s, jerk time 2^TRAJ_JERK_SHIFT samples (12.8ms) */
+#define TRAJ_SPEED_MAX                  ((int16_t)MOTOR_RATED_INC)
+#define TRAJ_SPEED_LIMIT                (4095)                      // q18 of it and an acceleration step stay in 32 bits
+#define TRAJ_ACCEL_Q16                  ((int32_t)((float)MOTOR_RATED_INC * LOOP_SPEED_DIV * 65536.0f / (0.5f * TRAJ_SAMPLE_HZ)))
+#define TRAJ_ACCEL_MAX_Q16              (1L << 20)                  // keeps 2 * a * distance in 64 bits
+#define TRAJ_JERK_SHIFT                 (6)
+#define TRAJ_JERK_SHIFT_MAX             (7)
+#define TRAJ_FILTER_LEN                 (1 << TRAJ_JERK_SHIFT_MAX)
+#define TRAJ_DIST_MAX_Q16               (1LL << 41)                 // longer remaining moves are seen as this long
+
+/* ============================ Code Enum Definitions ============================ */
+
+typedef enum
+{
+    TRAJ_TARGET_SPEED = 0,
+    TRAJ_TARGET_POSITION,
+}traj_target_e;
+
+typedef enum
+{
+    TRAJ_REQ_NONE = 0,
+    TRAJ_REQ_SPEED,
+    TRAJ_REQ_POSITION,
+}traj_req_e;
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    volatile uint8_t req;               /*traj_req_e staged by motor_traj_*_target(), taken by motor_traj_step()*/
+    int32_t       req_value;            /*staged speed, steps per period, or position, electrical angle steps*/
+    volatile uint8_t req_limits;        /*1: req_speed_max_q16 / req_accel_q16 staged*/
+    int32_t       req_speed_max_q16;
+    int32_t       req_accel_q16;
+    traj_target_e target;
+    int32_t       speed_max_q16;        /*steps per sample q16*/
+    int32_t       accel_q16;            /*speed change per sample*/
+    uint8_t       jerk_shift;           /*0: trapezoidal, n: acceleration ramps over 2^n samples*/
+    uint8_t       jerk_shift_next;      /*taken over once the profile is settled*/
+    int32_t       speed_target_q16;
+    int64_t       pos_target_q16;
+    int64_t       pos_trap_q16;         /*trapezoidal profile*/
+    int32_t       speed_trap_q16;
+    int32_t       filter[TRAJ_FILTER_LEN];  /*last trapezoidal speeds*/
+    int64_t       filter_sum;
+    uint8_t       filter_idx;
+    uint16_t      filter_fill;          /*slots written since the restart, the others hold filter_init*/
+    int32_t       filter_init;          /*speed of the restart*/
+    int64_t       pos_out;              /*sum of filter_sum: position q(16 + jerk_shift)*/
+    int16_t       speed;                /*reference, steps per period*/
+    int32_t       pos;                  /*reference, electrical angle steps*/
+    uint8_t       done;                 /*profile at the target and the filter drained*/
+}traj_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern traj_t traj;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_traj_init(void);
+void motor_traj_reset(int32_t pos, int16_t speed);
+void motor_traj_limits_set(int16_t speed_max, int32_t accel_q16, uint8_t jerk_shift);
+void motor_traj_speed_target(int16_t speed);
+void motor_traj_position_target(int32_t pos);
+void motor_traj_step(void);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_TRAJ_H__*/
+
+
+/**
+  * @}
+  */
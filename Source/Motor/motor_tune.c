@@ -0,0 +1,197 @@
+/**
+ * @file motor_tune.c
+ * @brief Current and speed PI gains from the motor parameters
+ * 
+ * @details
+ * Current loop, per axis, pole-zero cancellation: the PI zero sits on the
+ * R / L pole of the winding and the loop is a pure integrator crossing at
+ * the target, the closed loop a first order lag of that bandwidth:
+ *   kp = wc * L        ki = wc * R * Ts (per period)
+ * In q15 of MOTOR_V_BASE_V per q15 of MOTOR_I_BASE_A kp stays below 1, i.e.
+ * 0.97 Ohm: a larger kp is clamped with the ratio kp / ki kept, the zero still
+ * cancels the pole, at a lower bandwidth (current_bw_d_hz / current_bw_q_hz).
+ * 
+ * Speed loop: the plant is the integrator kt * p / J from the torque current
+ * to the electrical speed, kt = 1.5 * p * flux. The integral corner at a
+ * TUNE_SPEED_CORNER_DIV-th of the crossover (phase margin about 75 degree)
+ * puts the closed loop -3dB at TUNE_SPEED_BW_RATIO times the crossover, kp
+ * is set for that to be the target. The target is held TUNE_BW_SEPARATION
+ * under the slower current axis.
+ * 
+ * All gains are computed first, then go to the running controllers through
+ * motor_foc_current_pi_set(), motor_loop_speed_pi_set() and (the speed
+ * crossover and corner, for its phase leads) motor_resonant_loop_set() in
+ * one section with the interrupts masked, no restart: no period runs with a
+ * mix of old and new gains. Floating point with divisions: thread context
+ * only, after an identification motor_ctrl_task() calls it.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+/* ============================ Include Headers ============================ */
+
+#include "motor_foc.h"
+#include "motor_loop.h"
+#include "motor_resonant.h"
+#include "motor_tune.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define TUNE_2PI                        (6.2831853f)
+#define TUNE_OHM_TO_Q15                 (32768.0f * MOTOR_I_BASE_A / MOTOR_V_BASE_V)
+#define TUNE_INC_PER_RAD_S              (65536.0f / TUNE_2PI * MOTOR_TS_S)  // angle steps per period of 1 rad/s electrical
+#define TUNE_SPEED_KP_MAX               (0x3FFFFFFF / LOOP_SPEED_ERR_MAX)  // kp * err with room for the integral
+
+/* ============================ Module Internal Data Structures ============================ */
+
+/* ============================ Global Variables ============================ */
+
+tune_t tune;
+
+/* ============================ Static Global Variables ============================ */
+
+/* ============================ Static Function Declarations ============================ */
+
+static float motor_tune_current_axis(float r_ohm, float l_h, int16_t *kp, int16_t *ki);
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief init: default targets, the hand tuned gains of motor_foc.h / motor_loop.h stay applied
+ * 
+ * @param[in] None
+ * @return None
+ */
+void motor_tune_init(void)
+{
+    tune.current_bw_hz       = TUNE_CURRENT_BW_HZ;
+    tune.speed_bw_hz         = TUNE_SPEED_BW_HZ;
+    tune.current_bw_d_hz     = 0.0f;
+    tune.current_bw_q_hz     = 0.0f;
+    tune.speed_applied_bw_hz = 0.0f;
+    tune.kp_d                = FOC_ID_KP;
+    tune.ki_d                = FOC_ID_KI;
+    tune.kp_q                = FOC_IQ_KP;
+    tune.ki_q                = FOC_IQ_KI;
+    tune.speed_kp            = LOOP_SPEED_KP;
+    tune.speed_ki            = LOOP_SPEED_KI;
+}
+
+
+/**
+ * @brief target bandwidths of the next motor_tune_apply()
+ * 
+ * @param[in] current_bw_hz: current loop, > 0
+ * @param[in] speed_bw_hz: speed loop, > 0
+ * @return None
+ */
+void motor_tune_target_set(float current_bw_hz, float speed_bw_hz)
+{
+    if((current_bw_hz <= 0.0f) || (speed_bw_hz <= 0.0f))
+    {
+        return;
+    }
+    tune.current_bw_hz = current_bw_hz;
+    tune.speed_bw_hz   = speed_bw_hz;
+}
+
+
+/**
+ * @brief compute the gains of a parameter block and write them into the running loops, thread context
+ * 
+ * @param[in] block: motor parameters, e.g. param_id.block after an identification
+ * @return None
+ */
+void motor_tune_apply(const param_id_block_t *block)
+{
+    float    kt;
+    float    plant;
+    float    bw;
+    float    wc;
+    float    wi;
+    float    kp;
+    uint32_t primask;
+
+    if((block->rs_ohm <= 0.0f) || (block->ld_h <= 0.0f) || (block->lq_h <= 0.0f)
+       || (block->flux_wb <= 0.0f) || (block->j_kgm2 <= 0.0f))
+    {
+        return;
+    }
+
+    tune.current_bw_d_hz = motor_tune_current_axis(block->rs_ohm, block->ld_h, &tune.kp_d, &tune.ki_d);
+    tune.current_bw_q_hz = motor_tune_current_axis(block->rs_ohm, block->lq_h, &tune.kp_q, &tune.ki_q);
+
+    /*speed steps per period per second, per q15 torque current, output q LOOP_PI_SHIFT*/
+    kt    = 1.5f * MOTOR_POLE_PAIRS * block->flux_wb;
+    plant = (MOTOR_I_BASE_A / 32768.0f) * kt * MOTOR_POLE_PAIRS / block->j_kgm2 * TUNE_INC_PER_RAD_S;
+    bw    = tune.speed_bw_hz;
+    if(bw * TUNE_BW_SEPARATION > tune.current_bw_q_hz)
+    {
+        bw = tune.current_bw_q_hz / TUNE_BW_SEPARATION;
+    }
+    wc = TUNE_2PI * bw / TUNE_SPEED_BW_RATIO;
+    kp = wc / plant * (float)(1 << LOOP_PI_SHIFT);
+    if(kp > (float)TUNE_SPEED_KP_MAX)
+    {
+        kp = (float)TUNE_SPEED_KP_MAX;
+        wc = kp * plant / (float)(1 << LOOP_PI_SHIFT);
+    }
+    tune.speed_kp            = (int32_t)(kp + 0.5f);
+    tune.speed_ki            = (int32_t)(kp * wc / TUNE_SPEED_CORNER_DIV * MOTOR_TS_S * LOOP_SPEED_DIV + 0.5f);
+    tune.speed_applied_bw_hz = wc * TUNE_SPEED_BW_RATIO / TUNE_2PI;
+    wi                       = wc / TUNE_SPEED_CORNER_DIV;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    motor_foc_current_pi_set(tune.kp_d, tune.ki_d, tune.kp_q, tune.ki_q);
+    motor_loop_speed_pi_set(tune.speed_kp, tune.speed_ki);
+    motor_resonant_loop_set(wc, wi);
+    __set_PRIMASK(primask);
+}
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief pole-zero cancelling PI of one current axis at the target bandwidth
+ * 
+ * @param[in] r_ohm: winding resistance
+ * @param[in] l_h: inductance of the axis
+ * @param[out] kp: q15
+ * @param[out] ki: q15, per pwm period
+ * @return bandwidth of the gains, Hz
+ */
+static float motor_tune_current_axis(float r_ohm, float l_h, int16_t *kp, int16_t *ki)
+{
+    float ratio = r_ohm * MOTOR_TS_S / l_h;                 /*ki / kp*/
+    float p     = TUNE_2PI * tune.current_bw_hz * l_h * TUNE_OHM_TO_Q15;
+
+    /*A0 = kp + ki of the arm PI is q15 too*/
+    if(p * (1.0f + ratio) > 32767.0f)
+    {
+        p = 32767.0f / (1.0f + ratio);
+    }
+    *kp = (int16_t)p;
+    *ki = (int16_t)(p * ratio + 0.5f);
+    *ki = (*ki < 1) ? 1 : *ki;
+
+    return (float)*kp / (TUNE_2PI * l_h * TUNE_OHM_TO_Q15);
+}
+
+/* ============================ Unit Test Support ============================ */
+
+#ifdef UNIT_TEST
+
+#endif /* UNIT_TEST */
+
+/**
+  * @}
+  */
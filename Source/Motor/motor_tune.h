@@ -0,0 +1,84 @@
+/**
+ * @file motor_tune.h
+ * @brief Driver motor_tune Header
+ * 
+ * @details
+ * Current and speed PI gains from the motor parameters and target bandwidths.
+ * 
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ * 
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/** @addtogroup MOTOR
+  * @{
+  */
+
+#ifndef __MOTOR_TUNE_H__
+#define __MOTOR_TUNE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/* ============================ Include Headers ============================ */
+
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_param_id.h"
+
+/* ============================ Public Constants ============================ */
+
+#define TUNE_CURRENT_BW_HZ              (200.0f)            // current loop target, kp 0.75 Ohm on q for the motor_param.h motor
+#define TUNE_SPEED_BW_HZ                (25.0f)             // speed loop target, the hand tuned LOOP_SPEED_KP (20Hz crossover) gives 25Hz
+#define TUNE_SPEED_CORNER_DIV           (4.0f)              // integral corner of the speed PI at bandwidth / 4
+#define TUNE_SPEED_BW_RATIO             (1.24f)             // closed loop -3dB / crossover of the speed PI with that corner
+#define TUNE_BW_SEPARATION              (5.0f)              // speed bandwidth kept under the current bandwidth / 5
+
+/* ============================ Code Enum Definitions ============================ */
+
+/* ============================ Data Structure Definitions ============================ */
+
+typedef struct
+{
+    float   current_bw_hz;              /*targets*/
+    float   speed_bw_hz;
+    float   current_bw_d_hz;            /*bandwidths of the applied gains, under the targets when a gain is clamped*/
+    float   current_bw_q_hz;
+    float   speed_applied_bw_hz;
+    int16_t kp_d;                       /*applied gains, units of motor_foc_current_pi_set*/
+    int16_t ki_d;
+    int16_t kp_q;
+    int16_t ki_q;
+    int32_t speed_kp;                   /*units of motor_loop_speed_pi_set*/
+    int32_t speed_ki;
+}tune_t;
+
+/* ============================ Callback Function Type Definitions ============================ */
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern tune_t tune;
+
+/* ============================ Macro Function Declarations ============================ */
+
+/* ============================ Function Declarations ============================ */
+
+void motor_tune_init(void);
+void motor_tune_target_set(float current_bw_hz, float speed_bw_hz);
+void motor_tune_apply(const param_id_block_t *block);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /*__MOTOR_TUNE_H__*/
+
+
+/**
+  * @}
+  */
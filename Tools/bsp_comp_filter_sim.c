@@ -0,0 +1,262 @@
+/**
+ * @file bsp_comp_filter_sim.c
+ * @brief Host tool: zero cross latency of the comparator blanking and filter of bsp_comp.c
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -o bsp_comp_filter_sim bsp_comp_filter_sim.c host/host_mcu.c ../Source/Bsp/bsp_comp.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_comp,n32g43x_exti,n32g43x_gpio,n32g43x_rcc}.c -lm
+ *   ./bsp_comp_filter_sim
+ *
+ * The floating phase is played against the virtual neutral in 1us steps (one
+ * filter clock) and fed through bsp_comp_filter_model(), the host copy of the
+ * COMP1 blanking and digital filter:
+ * - BEMF: a straight crossing from 15 degree before to 45 degree after the
+ *   zero cross, slope from the flux of the fan motor of motor_bemf_sim.c.
+ * - Blanking: TIM1 OC5REF of the center aligned counter against
+ *   BEMF_COMP_WINDOW(duty), the window is the middle of the high side on-time.
+ * - Switching: a ringing of 3V decaying in 1us from every high side edge,
+ *   alternating sign from one filter sample to the next, 10mV rms noise and the
+ *   15mV hysteresis of BEMF_COMP_HYST.
+ *
+ * Each case places the crossing at 200 random points of the pwm period. The
+ * latency runs from the crossing to the filtered edge; motor_bemf_comp_zc_isr()
+ * takes BEMF_COMP_LATENCY_US(duty) of it back, the rest is the commutation
+ * error in degree at that speed. Noise can fire the edge a little before a
+ * slow crossing; an edge more than the filter latency before it is counted as
+ * early. The exit code is 1 on an early edge, a crossing not seen within one
+ * pwm period and the filter latency, or a mean error over 1 degree.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "bsp_pwm.h"
+#include "bsp_comp.h"
+#include "motor_bemf.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_FLUX_WB                     (0.0015)                // as motor_bemf_sim.c
+#define SIM_HYST_V                      (0.015)
+#define SIM_NOISE_V                     (0.010)
+#define SIM_RING_V                      (3.0)
+#define SIM_RING_TAU_US                 (1.0)
+
+#define SIM_TICKS_PER_US                (108)                   // TIM1 clock
+#define SIM_PWM_PERIOD_US               (1000000 / PWM_FREQ_HZ)
+#define SIM_CROSSINGS                   (200)
+#define SIM_BEFORE_DEG                  (15.0)                  // from the end of the demagnetization blanking
+#define SIM_AFTER_DEG                   (45.0)
+#define SIM_ERR_MAX_DEG                 (1.0)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    uint32_t n;
+    uint32_t early;
+    uint32_t missed;
+    double   sum;
+    double   min;
+    double   max;
+}sim_stat_t;
+
+static uint32_t rand_state = 1;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief TIM1 counter of the center aligned pwm at time [t]
+ *
+ * @param[in] t_us: time, the counter is 0 (update, high side center) at t = 0
+ * @return the counter
+ */
+static double pwm_cnt(double t_us)
+{
+    double p = fmod(t_us * SIM_TICKS_PER_US, 2.0 * PWM_PERIOD_MAX);
+
+    return (p < PWM_PERIOD_MAX) ? p : (2.0 * PWM_PERIOD_MAX - p);
+}
+
+
+/**
+ * @brief time since the last high side edge, where the counter crossed [duty]
+ *
+ * @param[in] t_us: time
+ * @param[in] duty: high side duty
+ * @return the time, us
+ */
+static double pwm_edge_age(double t_us, uint16_t duty)
+{
+    double p = fmod(t_us * SIM_TICKS_PER_US, 2.0 * PWM_PERIOD_MAX);
+    double up   = duty;                                     /*turn off, counting up*/
+    double down = 2.0 * PWM_PERIOD_MAX - duty;              /*turn on, counting down*/
+    double age;
+
+    if(p >= down)
+    {
+        age = p - down;
+    }
+    else if(p >= up)
+    {
+        age = p - up;
+    }
+    else
+    {
+        age = p + 2.0 * PWM_PERIOD_MAX - down;
+    }
+    return age / SIM_TICKS_PER_US;
+}
+
+
+/**
+ * @brief one crossing through the blanking and the filter
+ *
+ * @param[in] duty: high side duty
+ * @param[in] erpm: electrical speed
+ * @param[in] t_zc: crossing time against the pwm, us
+ * @param[out] latency: crossing to filtered edge, us
+ * @return 1 when seen, 0 seen more than the filter latency before the crossing, -1 not seen
+ */
+static int crossing_run(uint16_t duty, double erpm, double t_zc, double *latency)
+{
+    double   deg_us = erpm / 60.0 * 360.0 * 1e-6;
+    double   slope  = 6.0 * SIM_FLUX_WB * pow(erpm / 60.0 * 2.0 * M_PI, 2) / M_PI * 1e-6;   /*V per us*/
+    double   t      = ceil(t_zc - SIM_BEFORE_DEG / deg_us);
+    double   t_end  = t_zc + SIM_AFTER_DEG / deg_us;
+    uint16_t window = (uint16_t)BEMF_COMP_WINDOW(duty);
+    uint16_t hist   = 0;
+    uint8_t  raw    = 0;
+
+    for(; t < t_end; t += 1.0)
+    {
+        double age   = pwm_edge_age(t, duty);
+        double ring  = SIM_RING_V * exp(-age / SIM_RING_TAU_US) * ((((long)t & 1) != 0) ? 1.0 : -1.0);
+        double v     = slope * (t - t_zc) + ring + sim_noise(SIM_NOISE_V);
+        uint8_t blank = (pwm_cnt(t) >= window);
+
+        raw = (v > SIM_HYST_V / 2.0) ? 1 : ((v < -SIM_HYST_V / 2.0) ? 0 : raw);
+        if(bsp_comp_filter_model(&hist, raw, blank) != 0)
+        {
+            *latency = t - t_zc;
+            return (t >= (t_zc - BEMF_COMP_FILTER_LATENCY_US)) ? 1 : 0;
+        }
+    }
+    return -1;
+}
+
+
+/**
+ * @brief SIM_CROSSINGS crossings at random points of the pwm period
+ *
+ * @param[in] duty: high side duty
+ * @param[in] erpm: electrical speed
+ * @param[out] stat: latency statistics, us
+ * @return None
+ */
+static void case_run(uint16_t duty, double erpm, sim_stat_t *stat)
+{
+    uint32_t k;
+
+    *stat = (sim_stat_t){0, 0, 0, 0.0, 1e9, -1e9};
+    for(k = 0; k < SIM_CROSSINGS; k++)
+    {
+        double latency = 0.0;
+        int    seen    = crossing_run(duty, erpm, 1000.0 + sim_rand() * SIM_PWM_PERIOD_US, &latency);
+
+        if(seen < 0)
+        {
+            stat->missed++;
+            continue;
+        }
+        if(seen == 0)
+        {
+            stat->early++;
+            continue;
+        }
+        stat->n++;
+        stat->sum += latency;
+        stat->min  = fmin(stat->min, latency);
+        stat->max  = fmax(stat->max, latency);
+    }
+}
+
+
+int main(void)
+{
+    static const uint16_t duty_pct[] = {25, 40, 55, 70, 85, 100};
+    static const double   erpm_run[] = {10000.0, 30000.0, 60000.0};
+    int fail = 0;
+    uint32_t d, s;
+
+    printf("duty  window  comp    eRPM   latency us            early  missed  error degree\n");
+    printf("  %%   us      us             mean   min    max                  mean    spread\n");
+    for(d = 0; d < sizeof(duty_pct) / sizeof(duty_pct[0]); d++)
+    {
+        uint16_t duty = (uint16_t)(duty_pct[d] * PWM_PERIOD_MAX / 100);
+        double   window_us = 2.0 * BEMF_COMP_WINDOW(duty) / SIM_TICKS_PER_US;
+        double   comp_us   = BEMF_COMP_LATENCY_US(duty);
+
+        for(s = 0; s < sizeof(erpm_run) / sizeof(erpm_run[0]); s++)
+        {
+            double     deg_us = erpm_run[s] / 60.0 * 360.0 * 1e-6;
+            sim_stat_t stat;
+            double     mean, err, spread;
+
+            case_run(duty, erpm_run[s], &stat);
+            mean   = (stat.n != 0) ? (stat.sum / stat.n) : 0.0;
+            err    = (mean - comp_us) * deg_us;
+            spread = fmax(stat.max - mean, mean - stat.min) * deg_us;
+            printf("%3d  %6.1f  %5.1f  %6.0f  %5.1f  %5.1f  %5.1f  %6u  %6u  %+6.2f  %6.2f\n",
+                   duty_pct[d], window_us, comp_us, erpm_run[s], mean, stat.min, stat.max,
+                   (unsigned)stat.early, (unsigned)stat.missed, err, spread);
+
+            fail |= (stat.early != 0) || (stat.missed != 0) || (fabs(err) > SIM_ERR_MAX_DEG);
+            fail |= (stat.max > SIM_PWM_PERIOD_US + BEMF_COMP_FILTER_LATENCY_US);
+        }
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
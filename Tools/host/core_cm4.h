@@ -0,0 +1,158 @@
+/**
+ * @file core_cm4.h
+ * @brief Host tool: the Cortex-M4 core header for building firmware modules on the PC
+ *
+ * @details
+ * Found before Libraries/SysCore through -Ihost. cmsis_gcc.h is Arm assembly,
+ * so its guard is taken here and the intrinsics the headers and the modules
+ * use are given in C, then the real core_cm4.h supplies the register layouts.
+ * - PRIMASK is host_primask, __disable_irq() only sets it: there is no
+ *   interrupt on the host, the tools call the handlers themselves.
+ * - The system control space, DWT and CoreDebug move into host_core[].
+ * - DWT->CYCCNT reads the host clock in ns, so the cycle counters of the
+ *   modules compare costs on the PC; they are not Cortex-M4 cycles.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+#ifndef __HOST_CORE_CM4_H__
+#define __HOST_CORE_CM4_H__
+
+/* ============================ Include Headers ============================ */
+
+#include <stdint.h>
+
+/* ============================ Public Constants ============================ */
+
+#define __CMSIS_GCC_H                   /*skip the Arm assembly intrinsics*/
+
+#define __ASM                           __asm__
+#define __INLINE                        inline
+#define __STATIC_INLINE                 static inline
+#define __STATIC_FORCEINLINE            static inline
+#define __NO_RETURN                     __attribute__((__noreturn__))
+#define __USED                          __attribute__((used))
+#define __WEAK                          __attribute__((weak))
+#define __PACKED                        __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT                 struct __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)                    __attribute__((aligned(x)))
+#define __RESTRICT                      __restrict
+#define __COMPILER_BARRIER()            __asm__ volatile("" ::: "memory")
+
+#define HOST_CORE_SIZE                  (0x10000)           // 0xE0000000 ~ 0xE000FFFF
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern uint32_t host_primask;
+extern uint32_t host_core[HOST_CORE_SIZE / 4];
+
+/* ============================ Function Declarations ============================ */
+
+static inline void __NOP(void) {}
+static inline void __DSB(void) { __sync_synchronize(); }
+static inline void __DMB(void) { __sync_synchronize(); }
+static inline void __ISB(void) { __sync_synchronize(); }
+
+static inline uint32_t __get_PRIMASK(void) { return host_primask; }
+static inline void __set_PRIMASK(uint32_t primask) { host_primask = primask; }
+static inline void __disable_irq(void) { host_primask = 1U; }
+static inline void __enable_irq(void) { host_primask = 0U; }
+
+/* the C form cmsis_gcc.h gives for cores without the instruction */
+static inline int32_t __SSAT(int32_t val, uint32_t sat)
+{
+    if((sat >= 1U) && (sat <= 32U))
+    {
+        const int32_t max = (int32_t)((1U << (sat - 1U)) - 1U);
+        const int32_t min = -1 - max;
+
+        if(val > max)
+        {
+            return max;
+        }
+        else if(val < min)
+        {
+            return min;
+        }
+    }
+    return val;
+}
+
+static inline uint32_t __USAT(int32_t val, uint32_t sat)
+{
+    if(sat <= 31U)
+    {
+        const uint32_t max = ((1U << sat) - 1U);
+
+        if(val > (int32_t)max)
+        {
+            return max;
+        }
+        else if(val < 0)
+        {
+            return 0U;
+        }
+    }
+    return (uint32_t)val;
+}
+
+static inline uint8_t __CLZ(uint32_t value)
+{
+    return (value == 0U) ? 32U : (uint8_t)__builtin_clz(value);
+}
+
+/* the DSP instructions arm_math.h uses with ARM_MATH_DSP, as its own C forms for the other cores */
+static inline int32_t __QADD(int32_t x, int32_t y)
+{
+    int64_t sum = (int64_t)x + y;
+
+    return (sum > INT32_MAX) ? INT32_MAX : ((sum < INT32_MIN) ? INT32_MIN : (int32_t)sum);
+}
+
+static inline int32_t __QSUB(int32_t x, int32_t y)
+{
+    int64_t diff = (int64_t)x - y;
+
+    return (diff > INT32_MAX) ? INT32_MAX : ((diff < INT32_MIN) ? INT32_MIN : (int32_t)diff);
+}
+
+static inline uint32_t __SMUAD(uint32_t x, uint32_t y)
+{
+    return (uint32_t)((int32_t)(int16_t)x * (int16_t)y + (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16));
+}
+
+static inline uint64_t __SMLALD(uint32_t x, uint32_t y, uint64_t sum)
+{
+    return (uint64_t)((int64_t)sum + (int32_t)(int16_t)x * (int16_t)y + (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16));
+}
+
+#define __PKHBT(ARG1, ARG2, ARG3)       ((((uint32_t)(ARG1)) & 0x0000FFFFUL) | ((((uint32_t)(ARG2)) << (ARG3)) & 0xFFFF0000UL))
+#define __PKHTB(ARG1, ARG2, ARG3)       ((((uint32_t)(ARG1)) & 0xFFFF0000UL) | ((((uint32_t)(ARG2)) >> (ARG3)) & 0x0000FFFFUL))
+
+/*SCB->VTOR holds a 32 bit address, a pointer on the target*/
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wint-to-pointer-cast"
+#include "../../Libraries/SysCore/core_cm4.h"
+#pragma GCC diagnostic pop
+
+DWT_Type *host_dwt(void);
+
+/* ============================ Macro Function Declarations ============================ */
+
+#define HOST_CORE_ADDR(addr)            ((uintptr_t)host_core + ((addr) - 0xE0000000UL))
+
+#undef  SCS_BASE
+#define SCS_BASE                        HOST_CORE_ADDR(0xE000E000UL)
+#undef  ITM_BASE
+#define ITM_BASE                        HOST_CORE_ADDR(0xE0000000UL)
+#undef  CoreDebug_BASE
+#define CoreDebug_BASE                  HOST_CORE_ADDR(0xE000EDF0UL)
+#undef  DWT
+#define DWT                             (host_dwt())
+
+#endif /*__HOST_CORE_CM4_H__*/
@@ -0,0 +1,85 @@
+/**
+ * @file host_mcu.c
+ * @brief Host tool: the memory behind the registers of host/n32g43x.h and host/core_cm4.h
+ *
+ * @details
+ * Linked into every host tool that builds firmware modules. The registers start
+ * at zero, as after reset; nothing happens behind them, a tool that needs a
+ * flag or a conversion result writes it itself. The flash is mapped at its own
+ * address FLASH_BASE and reads erased (0xFF), so the parameter blocks of
+ * bsp_flash.h load as not programmed.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "n32g43x.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define HOST_FLASH_SIZE                 (0x20000UL)             // 128KB
+
+/* ============================ Global Variables ============================ */
+
+uint32_t host_periph[HOST_PERIPH_SIZE / 4];
+uint32_t host_core[HOST_CORE_SIZE / 4];
+uint32_t host_primask;
+uint32_t SystemCoreClock = 108000000;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief before main: the library truncates register addresses to 32 bit, the
+ *        flash is mapped erased
+ * 
+ * @param[in] None
+ * @return None
+ */
+static void __attribute__((constructor)) host_mcu_check(void)
+{
+    void *flash;
+
+    if(((uintptr_t)host_periph + sizeof(host_periph)) > UINT32_MAX)
+    {
+        printf("host_periph[] above 4GB, link with -no-pie\n");
+        exit(1);
+    }
+
+    flash = mmap((void *)(uintptr_t)FLASH_BASE, HOST_FLASH_SIZE, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if(flash != (void *)(uintptr_t)FLASH_BASE)
+    {
+        printf("flash at 0x%08lX not mapped\n", (unsigned long)FLASH_BASE);
+        exit(1);
+    }
+    memset(flash, 0xFF, HOST_FLASH_SIZE);
+}
+
+/* ============================ Public Function Implementations ============================ */
+
+/**
+ * @brief the DWT, CYCCNT refreshed from the host clock in ns
+ * 
+ * @param[in] None
+ * @return the DWT registers
+ */
+DWT_Type *host_dwt(void)
+{
+    DWT_Type *dwt = (DWT_Type *)HOST_CORE_ADDR(0xE0001000UL);
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    dwt->CYCCNT = (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+    return dwt;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file n32g43x.h
+ * @brief Host tool: the device header for building firmware modules on the PC
+ *
+ * @details
+ * Found before Libraries/SysConfig through -Ihost. It includes the real device
+ * header, so every register layout, bit definition and library prototype is the
+ * one the firmware is built with, then moves the peripheral window into
+ * host_periph[] of host_mcu.c: TIM1, ADC, COMP... point into host memory and
+ * the modules and the vendor library read and write them as plain RAM. The
+ * library keeps register addresses in uint32_t, so the tools are linked with
+ * -no-pie to keep host_periph[] below 4GB (host_mcu.c checks it). The
+ * Cortex-M4 core part comes from host/core_cm4.h, arm_math.h is the vendored
+ * one on top of it.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+#ifndef __HOST_N32G43X_H__
+#define __HOST_N32G43X_H__
+
+/* ============================ Include Headers ============================ */
+
+#include <stdint.h>
+
+/*as the project defines them*/
+#ifndef USE_STDPERIPH_DRIVER
+#define USE_STDPERIPH_DRIVER
+#endif
+#ifndef ARM_MATH_CM4
+#define ARM_MATH_CM4
+#endif
+#include "../../Libraries/SysConfig/n32g43x.h"
+
+/*the vendored arm_math.h keeps pointers in 32 bit integers in its circular buffer helpers*/
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpointer-to-int-cast"
+#pragma GCC diagnostic ignored "-Wint-to-pointer-cast"
+#include "arm_math.h"
+#pragma GCC diagnostic pop
+
+/* ============================ Public Constants ============================ */
+
+#define HOST_PERIPH_SIZE                (0x28000)           // APB1, APB2 and AHB up to MMU_BASE
+
+/* ============================ Global Variable Declarations ============================ */
+
+extern uint32_t host_periph[HOST_PERIPH_SIZE / 4];
+
+/* ============================ Macro Function Declarations ============================ */
+
+#undef  PERIPH_BASE
+#define PERIPH_BASE                     ((uintptr_t)host_periph)
+
+#endif /*__HOST_N32G43X_H__*/
@@ -0,0 +1,535 @@
+/**
+ * @file motor_bemf_sim.c
+ * @brief Host tool: motor_bemf.c against a trapezoidal-BEMF fan motor model
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_bemf_sim motor_bemf_sim.c host/host_mcu.c \
+ *       ../Source/Motor/{motor_bemf,motor_six_step}.c ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_bemf_sim
+ *
+ * The firmware module runs unchanged on host registers, the tool plays the
+ * hardware around it in 1us steps:
+ * - TIM1: the CCMOD1/CCMOD2/CCEN preload goes to the outputs on the COM
+ *   event, fired by software (PWM_COM_GENERATE) or by the TIM2 update when
+ *   TIM1 takes ITR1 as trigger. The high phase is the duty times Vbus on
+ *   average, the low phase 0V, a floating phase that still carries current
+ *   is clamped by the body diodes (demagnetization) until it reaches zero.
+ * - ADC: the injected sequence in JSEQ is converted at the centre of the on
+ *   time (TIM1 update, the high phase on Vbus), motor_bemf_adc_isr() runs
+ *   BEMF_ISR_LATENCY_US later while JENDCIEN is set.
+ * - TIM2: one pulse, 1us tick, the update after AR + 1 ticks.
+ * - Motor: 4 pole pairs, 120 degree flat top trapezoidal BEMF, fan load
+ *   torque k * w^2 and friction on the rotor inertia, so the speed follows
+ *   the duty.
+ *
+ * Each run starts from standstill at a random rotor angle (align, forced ramp,
+ * closed loop), then the duty is ramped to the operating point and held.
+ * At every closed loop commutation the rotor angle is compared with the ideal
+ * one: the field of the new pattern leading the rotor by 120 degree, 30
+ * degree after the zero cross. The table gives the mean error (late
+ * positive), the spread around it and the worst spread in us next to one pwm
+ * period. The exit code is 1 when a run does not reach the closed loop, loses
+ * zero crosses in steady state or spreads over one pwm period at the top
+ * speed (about 50k eRPM, 15 degree per pwm period: near the end of the per
+ * period adc detection, the comparator takes the speeds above).
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "bsp_pwm.h"
+#include "bsp_adc.h"
+#include "bsp_com_tim.h"
+#include "motor_param.h"
+#include "motor_bemf.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_VBUS_V                      (24.0)
+#define SIM_ADC_FS_V                    (MOTOR_VBUS_ADC_FS_V)   // bus and phase dividers are the same
+#define SIM_ADC_NOISE_LSB               (2)
+
+#define SIM_POLE_PAIRS                  (4)
+#define SIM_RS_OHM                      (1.0)
+#define SIM_LS_H                        (400e-6)
+#define SIM_FLUX_WB                     (0.0015)                // phase BEMF flat top / electrical speed
+#define SIM_J_KGM2                      (5e-6)
+#define SIM_FAN_K                       (1.3e-8)                // Nm / (rad/s)^2
+#define SIM_FRICTION_NM                 (0.002)
+
+#define SIM_DT                          (1e-6)
+#define SIM_PWM_PERIOD_US               (1000000 / PWM_FREQ_HZ)
+#define SIM_START_US                    (1500000)               // standstill -> closed loop
+#define SIM_DUTY_RAMP_US                (1500000)
+#define SIM_HOLD_US                     (500000)
+#define SIM_RUNS                        (6)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef enum
+{
+    OUT_FLOAT = 0,
+    OUT_LOW,
+    OUT_PWM,
+}out_e;
+
+typedef struct
+{
+    double theta;                       /*electrical angle, degree, d axis against phase U*/
+    double w;                           /*mechanical speed, rad/s*/
+    double i[3];
+    uint8_t diode[3];                   /*floating phase still conducting*/
+}sim_motor_t;
+
+typedef struct
+{
+    uint32_t n;
+    double   sum;
+    double   sum2;
+    double   min;
+    double   max;
+}sim_stat_t;
+
+static const double phase_axis[3] = {0.0, 120.0, 240.0};
+
+static sim_motor_t motor;
+static out_e       out[3];
+static uint32_t    t_us;
+static double      adc_sample[2];
+static sim_stat_t  com_err;
+static uint32_t    com_trig_err;
+static uint32_t    case_us;             /*start of the run*/
+static uint32_t    run_us;              /*time the closed loop was entered, 0: not yet*/
+static uint32_t    rand_state = 12345;
+
+/* ============================ Static Function Declarations ============================ */
+
+static void sim_irq_none(void)
+{
+}
+
+
+static int sim_rand(int range)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (int)((rand_state >> 16) % (uint32_t)(2 * range + 1)) - range;
+}
+
+
+static double wrap180(double deg)
+{
+    deg = fmod(deg + 180.0, 360.0);
+    return (deg < 0.0) ? deg + 180.0 : deg - 180.0;
+}
+
+
+/**
+ * @brief trapezoidal BEMF shape of a phase, 1 on the 120 degree flat top
+ *
+ * @param[in] ph: phase
+ * @param[in] theta: rotor electrical angle, degree
+ * @return -1 ~ 1
+ */
+static double bemf_shape(int ph, double theta)
+{
+    /*peak 90 degree behind the phase axis: the field leading the d axis by 90 degree gives the most torque*/
+    double x = fabs(wrap180(theta - phase_axis[ph] + 90.0));
+
+    if(x <= 60.0)
+    {
+        return 1.0;
+    }
+    return (x >= 120.0) ? -1.0 : 1.0 - (x - 60.0) / 30.0;
+}
+
+
+/**
+ * @brief phase outputs of the pattern on the outputs
+ *
+ * @param[in] ccmod1, ccmod2, ccen: the applied registers
+ * @return None
+ */
+static void outputs_decode(uint16_t ccmod1, uint16_t ccmod2, uint32_t ccen)
+{
+    int ph;
+
+    for(ph = 0; ph < 3; ph++)
+    {
+        uint16_t mode = ((ph == 2) ? ccmod2 : (uint16_t)(ccmod1 >> (8 * ph))) & TIM_CCMOD1_OC1M;
+
+        if(((ccen >> (4 * ph)) & (TIM_CCEN_CC1EN | TIM_CCEN_CC1NEN)) == 0)
+        {
+            out[ph] = OUT_FLOAT;
+        }
+        else
+        {
+            out[ph] = (mode == TIM_OCMODE_PWM1) ? OUT_PWM : OUT_LOW;
+        }
+    }
+}
+
+
+/**
+ * @brief terminal voltage of a phase, NAN for an open phase
+ *
+ * @param[in] ph: phase
+ * @param[in] v_pwm: voltage of the chopping phase (average or instant)
+ * @return V
+ */
+static double terminal_v(int ph, double v_pwm)
+{
+    if(!PWM_OUTPUT_ENABLED() || (out[ph] == OUT_FLOAT))
+    {
+        return (motor.diode[ph] != 0) ? ((motor.i[ph] > 0.0) ? 0.0 : SIM_VBUS_V) : NAN;
+    }
+    return (out[ph] == OUT_PWM) ? v_pwm : 0.0;
+}
+
+
+/**
+ * @brief star point and open phase voltages at a chopping phase voltage
+ *
+ * @param[in] v_pwm: voltage of the chopping phase
+ * @param[out] v: terminal voltages, open phases get the star point plus their BEMF
+ * @param[out] vn: star point
+ * @return number of conducting phases
+ */
+static int motor_voltages(double v_pwm, double v[3], double *vn)
+{
+    double e_w = SIM_POLE_PAIRS * motor.w * SIM_FLUX_WB;
+    double sum = 0.0;
+    int    n   = 0;
+    int    ph;
+
+    for(ph = 0; ph < 3; ph++)
+    {
+        v[ph] = terminal_v(ph, v_pwm);
+        if(!isnan(v[ph]))
+        {
+            sum += v[ph] - SIM_RS_OHM * motor.i[ph] - e_w * bemf_shape(ph, motor.theta);
+            n++;
+        }
+    }
+    *vn = (n >= 2) ? sum / n : 0.0;
+    for(ph = 0; ph < 3; ph++)
+    {
+        if(isnan(v[ph]))
+        {
+            v[ph] = *vn + e_w * bemf_shape(ph, motor.theta);
+        }
+    }
+    return n;
+}
+
+
+/**
+ * @brief one 1us step of the motor
+ *
+ * @param[in] None
+ * @return None
+ */
+static void motor_step(void)
+{
+    double duty = (double)PWM_TIM->CCDAT1 / PWM_PERIOD_MAX;
+    double e_w  = SIM_POLE_PAIRS * motor.w * SIM_FLUX_WB;
+    double v[3], vn, torque = 0.0, load;
+    int    n, ph;
+
+    duty = (duty > 1.0) ? 1.0 : duty;
+    n    = motor_voltages(duty * SIM_VBUS_V, v, &vn);
+    for(ph = 0; ph < 3; ph++)
+    {
+        if((n < 2) || isnan(terminal_v(ph, 0.0)))
+        {
+            motor.i[ph]     = 0.0;
+            motor.diode[ph] = 0;
+            continue;
+        }
+        {
+            double i_old = motor.i[ph];
+
+            motor.i[ph] += (v[ph] - vn - SIM_RS_OHM * motor.i[ph] - e_w * bemf_shape(ph, motor.theta)) / SIM_LS_H * SIM_DT;
+            if((motor.diode[ph] != 0) && ((i_old > 0.0) != (motor.i[ph] > 0.0)))
+            {
+                motor.i[ph]     = 0.0;
+                motor.diode[ph] = 0;
+            }
+        }
+    }
+    /*a diode phase stopping inside the step: the others take its rest*/
+    for(ph = 0, n = 0, vn = 0.0; ph < 3; ph++)
+    {
+        vn += motor.i[ph];
+        n  += (motor.i[ph] != 0.0);
+    }
+    for(ph = 0; ph < 3; ph++)
+    {
+        motor.i[ph] -= ((n != 0) && (motor.i[ph] != 0.0)) ? vn / n : 0.0;
+        torque      += SIM_POLE_PAIRS * SIM_FLUX_WB * bemf_shape(ph, motor.theta) * motor.i[ph];
+    }
+
+    load = SIM_FAN_K * motor.w * fabs(motor.w);
+    if(fabs(motor.w) > 1e-3)
+    {
+        load += (motor.w > 0.0) ? SIM_FRICTION_NM : -SIM_FRICTION_NM;
+    }
+    else if(fabs(torque) < SIM_FRICTION_NM)
+    {
+        load = torque;
+    }
+    motor.w     += (torque - load) / SIM_J_KGM2 * SIM_DT;
+    motor.theta  = fmod(motor.theta + SIM_POLE_PAIRS * motor.w * SIM_DT * 180.0 / M_PI + 360.0, 360.0);
+}
+
+
+static void stat_add(sim_stat_t *s, double x)
+{
+    s->min   = (s->n == 0 || x < s->min) ? x : s->min;
+    s->max   = (s->n == 0 || x > s->max) ? x : s->max;
+    s->sum  += x;
+    s->sum2 += x * x;
+    s->n++;
+}
+
+
+/**
+ * @brief TIM1 COM event: the preload goes to the outputs, then the COM interrupt
+ *
+ * @param[in] None
+ * @return None
+ */
+static void com_event(void)
+{
+    int ph, hi = -1, lo = -1;
+
+    for(ph = 0; ph < 3; ph++)
+    {
+        /*a phase switched off keeps its current through the diodes*/
+        if(out[ph] != OUT_FLOAT)
+        {
+            motor.diode[ph] = (motor.i[ph] != 0.0);
+        }
+    }
+    outputs_decode((uint16_t)PWM_TIM->CCMOD1, (uint16_t)PWM_TIM->CCMOD2, PWM_TIM->CCEN);
+    for(ph = 0; ph < 3; ph++)
+    {
+        hi = (out[ph] == OUT_PWM) ? ph : hi;
+        lo = (out[ph] == OUT_LOW) ? ph : lo;
+        motor.diode[ph] = (out[ph] == OUT_FLOAT) ? motor.diode[ph] : 0;
+    }
+
+    if((bemf.state == BEMF_STATE_RUN) && (hi >= 0) && (lo >= 0))
+    {
+        double field = atan2(sin(phase_axis[hi] * M_PI / 180.0) - sin(phase_axis[lo] * M_PI / 180.0),
+                             cos(phase_axis[hi] * M_PI / 180.0) - cos(phase_axis[lo] * M_PI / 180.0)) * 180.0 / M_PI;
+        double err   = wrap180(motor.theta - (field - 120.0));
+
+        if(run_us == 0)
+        {
+            run_us = t_us;
+        }
+        stat_add(&com_err, err);
+    }
+    motor_bemf_com_isr();
+}
+
+
+/**
+ * @brief injected conversion at the TIM1 update, the high side is on
+ *
+ * @param[in] None
+ * @return None
+ */
+static void adc_convert(void)
+{
+    uint32_t jseq = ADC->JSEQ;
+    uint32_t len  = ((jseq >> 20) & 0x03) + 1;
+    double   v[3], vn;
+    uint32_t rank;
+
+    motor_voltages(SIM_VBUS_V, v, &vn);
+    for(rank = 1; (rank <= 2) && (rank <= len); rank++)
+    {
+        uint32_t ch = (jseq >> (5 * (rank + 3 - len))) & 0x1F;
+        double   volt;
+
+        switch(ch)
+        {
+            case ADC_BEMF_U_CH: volt = v[0];       break;
+            case ADC_BEMF_V_CH: volt = v[1];       break;
+            case ADC_BEMF_W_CH: volt = v[2];       break;
+            case ADC_VBUS_CH:   volt = SIM_VBUS_V; break;
+            default:            volt = 0.0;        break;
+        }
+        adc_sample[rank - 1] = volt;
+    }
+    ADC->JDAT1 = (uint32_t)lround(fmin(fmax(adc_sample[0] / SIM_ADC_FS_V * ADC_FULL_SCALE + sim_rand(SIM_ADC_NOISE_LSB), 0), ADC_FULL_SCALE - 1));
+    ADC->JDAT2 = (uint32_t)lround(fmin(fmax(adc_sample[1] / SIM_ADC_FS_V * ADC_FULL_SCALE + sim_rand(SIM_ADC_NOISE_LSB), 0), ADC_FULL_SCALE - 1));
+}
+
+
+/**
+ * @brief run the hardware for [us] microseconds
+ *
+ * @param[in] us: time
+ * @return None
+ */
+static void sim_run(uint32_t us)
+{
+    uint32_t end = t_us + us;
+
+    while(t_us != end)
+    {
+        t_us++;
+        motor_step();
+
+        /*TIM2, one pulse: update after AR + 1 ticks, TRGO -> TIM1 COM through ITR1*/
+        if((COM_TIM->CTRL1 & TIM_CTRL1_CNTEN) != 0)
+        {
+            if(COM_TIM->CNT >= COM_TIM->AR)
+            {
+                COM_TIM->CNT    = 0;
+                COM_TIM->CTRL1 &= ~TIM_CTRL1_CNTEN;
+                if((PWM_TIM->SMCTRL & TIM_SMCTRL_TSEL) == PWM_COM_TRIG_TIMER)
+                {
+                    com_event();
+                }
+                else
+                {
+                    com_trig_err++;
+                }
+            }
+            else
+            {
+                COM_TIM->CNT++;
+            }
+        }
+
+        if((t_us % SIM_PWM_PERIOD_US) == 0)
+        {
+            adc_convert();
+        }
+        if(((t_us % SIM_PWM_PERIOD_US) == BEMF_ISR_LATENCY_US) && ((ADC->CTRL1 & ADC_CTRL1_JENDCIEN) != 0))
+        {
+            motor_bemf_adc_isr();
+        }
+        if(PWM_TIM->EVTGEN & TIM_EVTGEN_CCUDGN)
+        {
+            PWM_TIM->EVTGEN = 0;
+            com_event();
+        }
+    }
+}
+
+
+/**
+ * @brief start from standstill, ramp the duty to [duty] and hold it
+ *
+ * @param[in] duty: 0 ~ PWM_PERIOD_MAX
+ * @param[out] erpm: electrical speed at the end, eRPM
+ * @param[out] lost: zero crosses missed while held
+ * @return 1 when the closed loop was reached
+ */
+static int sim_case(uint16_t duty, double *erpm, uint32_t *lost)
+{
+    uint32_t lost_start;
+    uint32_t k;
+
+    motor.theta = (double)(sim_rand(180) + 180);
+    motor.w     = 0.0;
+    motor.i[0]  = motor.i[1] = motor.i[2] = 0.0;
+    motor.diode[0] = motor.diode[1] = motor.diode[2] = 0;
+    out[0] = out[1] = out[2] = OUT_FLOAT;
+    run_us  = 0;
+    case_us = t_us;
+
+    motor_bemf_init();
+    motor_bemf_duty_set(BEMF_RAMP_DUTY_MAX);
+    bsp_pwm_output_enable(DISABLE);
+    motor_bemf_start(MOTOR_DIR_CW);
+    sim_run(SIM_START_US);
+    if(bemf.state != BEMF_STATE_RUN)
+    {
+        motor_bemf_stop();
+        return 0;
+    }
+
+    for(k = 1; k <= 100; k++)
+    {
+        motor_bemf_duty_set((uint16_t)(BEMF_RAMP_DUTY_MAX + ((int32_t)duty - BEMF_RAMP_DUTY_MAX) * (int32_t)k / 100));
+        sim_run(SIM_DUTY_RAMP_US / 100);
+    }
+    sim_run(SIM_HOLD_US / 2);
+
+    com_err    = (sim_stat_t){0};
+    lost_start = bemf.lost_cnt;
+    sim_run(SIM_HOLD_US / 2);
+    *lost = bemf.lost_cnt - lost_start;
+    *erpm = SIM_POLE_PAIRS * motor.w * 60.0 / (2.0 * M_PI);
+    motor_bemf_stop();
+    return bemf.state != BEMF_STATE_FAULT;
+}
+
+
+int main(void)
+{
+    static const uint16_t duty_pct[SIM_RUNS] = {25, 40, 55, 70, 85, 100};
+    int fail = 0;
+    int r;
+
+    /*the sim calls the handlers itself; the adc needs no setup on the host (bsp_adc_init() waits for its ready flag)*/
+    bsp_pwm_init(sim_irq_none, sim_irq_none, sim_irq_none);
+
+    printf("duty   eRPM    start ms  com    err mean  spread rms  spread max   pwm period  lost\n");
+    printf("  %%                       n      degree    degree      us          degree\n");
+    for(r = 0; r < SIM_RUNS; r++)
+    {
+        uint16_t duty = (uint16_t)(duty_pct[r] * PWM_PERIOD_MAX / 100);
+        double   erpm = 0.0;
+        uint32_t lost = 0;
+        double   mean, rms, spread_us, period_deg;
+        int      ok;
+
+        ok = sim_case(duty, &erpm, &lost);
+        if((ok == 0) || (com_err.n == 0))
+        {
+            printf("%3d    no closed loop, state %d\n", duty_pct[r], (int)bemf.state);
+            fail = 1;
+            continue;
+        }
+        mean       = com_err.sum / com_err.n;
+        rms        = sqrt(fmax(com_err.sum2 / com_err.n - mean * mean, 0.0));
+        period_deg = erpm / 60.0 * 360.0 * SIM_PWM_PERIOD_US * 1e-6;
+        spread_us  = fmax(com_err.max - mean, mean - com_err.min) / period_deg * SIM_PWM_PERIOD_US;
+        printf("%3d  %7.0f  %7.1f  %5u  %+8.2f  %9.2f  %10.1f  %11.1f  %5u\n",
+               duty_pct[r], erpm, (run_us - case_us) / 1000.0, (unsigned)com_err.n, mean, rms, spread_us, period_deg, (unsigned)lost);
+        fail |= (lost != 0);
+        if(r == SIM_RUNS - 1)
+        {
+            fail |= (spread_us >= SIM_PWM_PERIOD_US) || (erpm < 45000.0);
+        }
+    }
+    if(com_trig_err != 0)
+    {
+        printf("%u TIM2 updates without TIM1 on ITR1\n", (unsigned)com_trig_err);
+        fail = 1;
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
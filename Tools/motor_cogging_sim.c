@@ -0,0 +1,427 @@
+/**
+ * @file motor_cogging_sim.c
+ * @brief Host tool: motor_cogging.c learning its table on the whole FOC chain, and the speed ripple it takes out
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_cogging_sim motor_cogging_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_cogging_sim
+ *
+ * The chain of motor_loop_sim.c (J 1e-4, 24V, two shunts, the update
+ * interrupt then the current loop), references straight, with a cogging
+ * torque of 6th and 12th electrical harmonics, SIM_COG_6 and SIM_COG_12 of
+ * the rated torque. The motor starts on the flux observer; then a sensor
+ * takes over, as the learning needs the angle at low speed: after every
+ * current loop foc.theta is set to the true angle of the next sample and
+ * the speed the loops read (flux_obs.speed) to its change, both in whole
+ * angle steps.
+ *
+ * - speed ripple (peak to peak of the true speed over SIM_RIPPLE_S, after
+ *   SIM_SETTLE_S) at SIM_RPM_LIST without the table
+ * - motor_cogging_learn_start() until done, its time
+ * - the table against the q current of the cogging torque, mean removed:
+ *   rms error of the rms
+ * - the ripple again with the table
+ * The exit code is 1 when the learning fails or takes over
+ * SIM_LEARN_MAX_S, the table error is over SIM_TABLE_ERR_MAX or the ripple
+ * with the table is not under SIM_RIPPLE_RATIO of the one without.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_foc.h"
+#include "motor_flux_obs.h"
+#include "motor_startup.h"
+#include "motor_loop.h"
+#include "motor_cogging.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_VBUS_V                      (24.0)
+#define SIM_ADC_MID                     (2048)
+#define SIM_NOISE_RAW                   (1.0)                   // adc counts rms
+#define SIM_SUBSTEPS                    (20)
+#define SIM_START_MAX_S                 (3.0)
+
+#define SIM_KT                          (1.5 * MOTOR_POLE_PAIRS * MOTOR_FLUX_WB)    // Nm / A
+#define SIM_T_RATED                     (SIM_KT * MOTOR_RATED_CURRENT_A)
+#define SIM_COG_6                       (0.075)                 // of the rated torque
+#define SIM_COG_12                      (0.0375)
+
+#define SIM_SPEED_START                 (75)                    // steps per period, 343rpm
+#define SIM_HOLD_S                      (0.5)
+#define SIM_SETTLE_S                    (1.0)
+#define SIM_RIPPLE_S                    (1.2)                   // two electrical turns at 27rpm
+#define SIM_LEARN_MAX_S                 (30.0)
+
+#define SIM_TABLE_ERR_MAX               (0.25)                  // rms of the rms
+#define SIM_RIPPLE_RATIO                (0.5)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad, not wrapped*/
+    double wm;                          /*mechanical, rad/s*/
+    double v_alpha;                     /*applied, V*/
+    double v_beta;
+    double t_load;                      /*Nm, against the rotation*/
+    uint16_t duty[3];
+}sim_pmsm_t;
+
+static uint32_t rand_state = 1;
+static uint8_t  sensor_on;              /*the angle and speed of the sensor in place of the observer's*/
+static uint16_t sensor_theta;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief cogging torque at a rotor angle
+ *
+ * @param[in] theta: electrical, rad
+ * @return Nm, against the rotation where positive
+ */
+static double sim_cogging(double theta)
+{
+    return SIM_COG_6 * SIM_T_RATED * sin(6.0 * theta + 0.4) + SIM_COG_12 * SIM_T_RATED * sin(12.0 * theta - 1.1);
+}
+
+
+/**
+ * @brief PMSM and the load over half a pwm period, the voltage is constant in the stator frame
+ *
+ * @param[in,out] m: motor
+ * @param[in] on: main output enabled, else the bridge is open and no current flows
+ * @return None
+ */
+static void pmsm_half_period(sim_pmsm_t *m, int on)
+{
+    double dt = MOTOR_TS_S / SIM_SUBSTEPS;
+    int k;
+
+    for(k = 0; k < SIM_SUBSTEPS / 2; k++)
+    {
+        double s  = sin(m->theta);
+        double co = cos(m->theta);
+        double we = m->wm * MOTOR_POLE_PAIRS;
+        double vd = m->v_alpha * co + m->v_beta * s;
+        double vq = -m->v_alpha * s + m->v_beta * co;
+        double te, tl;
+
+        if(on != 0)
+        {
+            double did = (vd - MOTOR_RS_OHM * m->id + we * MOTOR_LQ_H * m->iq) / MOTOR_LD_H;
+            double diq = (vq - MOTOR_RS_OHM * m->iq - we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB)) / MOTOR_LQ_H;
+
+            m->id += did * dt;
+            m->iq += diq * dt;
+        }
+        else
+        {
+            m->id = 0.0;
+            m->iq = 0.0;
+        }
+        te = 1.5 * MOTOR_POLE_PAIRS * (MOTOR_FLUX_WB * m->iq + (MOTOR_LD_H - MOTOR_LQ_H) * m->id * m->iq);
+        te -= sim_cogging(m->theta);
+        tl = (m->wm > 0.0) ? m->t_load : ((m->wm < 0.0) ? -m->t_load : 0.0);
+        if((m->wm == 0.0) && (fabs(te) <= m->t_load))
+        {
+            tl = te;
+        }
+        m->wm    += (te - tl) / MOTOR_J_KGM2 * dt;
+        m->theta += m->wm * MOTOR_POLE_PAIRS * dt;
+    }
+}
+
+
+/**
+ * @brief the stator voltage of the three duties
+ *
+ * @param[in,out] m: motor, applied voltage
+ * @return None
+ */
+static void pmsm_apply(sim_pmsm_t *m)
+{
+    double v[3];
+    int i;
+
+    for(i = 0; i < 3; i++)
+    {
+        v[i] = ((double)m->duty[i] / PWM_PERIOD_MAX - 0.5) * SIM_VBUS_V;
+    }
+    m->v_alpha = (2.0 * v[0] - v[1] - v[2]) / 3.0;
+    m->v_beta  = (v[1] - v[2]) / sqrt(3.0);
+}
+
+
+/**
+ * @brief the two shunt conversions at the counter peak into the injected data registers
+ *
+ * @param[in] m: motor
+ * @return None
+ */
+static void adc_sample(const sim_pmsm_t *m)
+{
+    double alpha = m->id * cos(m->theta) - m->iq * sin(m->theta);
+    double beta  = m->id * sin(m->theta) + m->iq * cos(m->theta);
+    double iu    = alpha;
+    double iv    = -0.5 * alpha + sqrt(3.0) / 2.0 * beta;
+
+    /*the amplifier output falls for a positive phase current, 16 q15 per count*/
+    ADC->JDAT1 = (uint32_t)lround(SIM_ADC_MID - iu / MOTOR_I_BASE_A * 2048.0 + sim_noise(SIM_NOISE_RAW));
+    ADC->JDAT2 = (uint32_t)lround(SIM_ADC_MID - iv / MOTOR_I_BASE_A * 2048.0 + sim_noise(SIM_NOISE_RAW));
+    ADC->JDAT3 = (uint32_t)lround(SIM_VBUS_V / MOTOR_VBUS_ADC_FS_V * 4096.0);
+}
+
+
+/**
+ * @brief one pwm period: update interrupt of the FOC mode at the underflow, current loop at the peak
+ *
+ * @param[in,out] m: motor
+ * @return None
+ */
+static void sim_period(sim_pmsm_t *m)
+{
+    int on = ((PWM_TIM->BKDT & TIM_BKDT_MOEN) != 0);
+
+    if(on != 0)
+    {
+        pmsm_apply(m);
+    }
+    motor_startup_pwm_isr();
+    if(startup.state == STARTUP_STATE_RUN)
+    {
+        motor_loop_pwm_isr();
+    }
+    pmsm_half_period(m, on);
+
+    adc_sample(m);
+    motor_foc_adc_isr();
+    m->duty[0] = foc.duty[0];
+    m->duty[1] = foc.duty[1];
+    m->duty[2] = foc.duty[2];
+    if(sensor_on != 0)
+    {
+        /*the sensor angle for the next period and the speed the loop reads, in whole angle steps*/
+        uint16_t theta = (uint16_t)((uint32_t)llround((m->theta + m->wm * MOTOR_POLE_PAIRS * MOTOR_TS_S) * 65536.0 / (2.0 * M_PI)));
+
+        flux_obs.speed = (int16_t)(theta - sensor_theta);
+        sensor_theta   = theta;
+        motor_foc_theta_set(theta);
+    }
+    pmsm_half_period(m, on);
+}
+
+
+/**
+ * @brief start from a random rotor angle and run until the loops have the motor
+ *
+ * @param[in,out] m: motor
+ * @return 0 the start sequence reached RUN
+ */
+static int sim_start(sim_pmsm_t *m)
+{
+    uint32_t n;
+
+    *m = (sim_pmsm_t){0};
+    m->theta   = sim_rand() * 2.0 * M_PI;
+    m->duty[0] = PWM_PERIOD_MAX / 2;
+    m->duty[1] = PWM_PERIOD_MAX / 2;
+    m->duty[2] = PWM_PERIOD_MAX / 2;
+
+    motor_foc_init();
+    motor_startup_init();
+    motor_loop_init();
+    motor_loop_traj_enable(0);
+    motor_fw_enable(0);
+    motor_cogging_enable(0);
+    sensor_on = 0;
+    motor_loop_reset();
+    motor_startup_start(MOTOR_DIR_CW);
+
+    for(n = 0; n < (uint32_t)(SIM_START_MAX_S * PWM_FREQ_HZ); n++)
+    {
+        sim_period(m);
+        if((startup.state == STARTUP_STATE_RUN) && (loop.running != 0))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+/**
+ * @brief run for a time
+ *
+ * @param[in,out] m: motor
+ * @param[in] t: s
+ * @return None
+ */
+static void sim_run(sim_pmsm_t *m, double t)
+{
+    uint32_t n;
+
+    for(n = 0; n < (uint32_t)(t * PWM_FREQ_HZ); n++)
+    {
+        sim_period(m);
+    }
+}
+
+
+/**
+ * @brief peak to peak of the true speed at a reference
+ *
+ * @param[in,out] m: motor
+ * @param[in] rpm: reference
+ * @return rpm
+ */
+static double sim_ripple(sim_pmsm_t *m, double rpm)
+{
+    double lo = 1e9, hi = -1e9;
+    uint32_t n;
+
+    motor_loop_speed_ref_set((int16_t)lround(MOTOR_RPM_TO_INC(rpm)), 0);
+    sim_run(m, SIM_SETTLE_S);
+    for(n = 0; n < (uint32_t)(SIM_RIPPLE_S * PWM_FREQ_HZ); n++)
+    {
+        double w = m->wm * 60.0 / (2.0 * M_PI);
+
+        sim_period(m);
+        lo = fmin(lo, w);
+        hi = fmax(hi, w);
+    }
+    return hi - lo;
+}
+
+
+/**
+ * @brief rms error of the table against the q current of the cogging torque, both without their mean
+ *
+ * @param[in] None
+ * @return of the rms of the cogging current
+ */
+static double table_error(void)
+{
+    double ideal[COGGING_BINS];
+    double mean_i = 0.0, mean_t = 0.0, err = 0.0, rms = 0.0;
+    int k;
+
+    for(k = 0; k < COGGING_BINS; k++)
+    {
+        ideal[k] = sim_cogging(2.0 * M_PI * k / COGGING_BINS) / SIM_KT / MOTOR_I_BASE_A * 32768.0;
+        mean_i  += ideal[k] / COGGING_BINS;
+        mean_t  += (double)cogging.table[k] / COGGING_BINS;
+    }
+    for(k = 0; k < COGGING_BINS; k++)
+    {
+        double e = (cogging.table[k] - mean_t) - (ideal[k] - mean_i);
+
+        err += e * e;
+        rms += (ideal[k] - mean_i) * (ideal[k] - mean_i);
+    }
+    return sqrt(err / rms);
+}
+
+
+int main(void)
+{
+    static const double rpm_list[] = {27.0, 55.0, 110.0};
+    double ripple[sizeof(rpm_list) / sizeof(rpm_list[0])];
+    double err, learn_s;
+    sim_pmsm_t m;
+    uint32_t n, k;
+    int fail = 0;
+
+    if(sim_start(&m) != 0)
+    {
+        printf("start sequence did not reach RUN\n\nFAIL\n");
+        return 1;
+    }
+    motor_loop_speed_ref_set(SIM_SPEED_START, 0);
+    sim_run(&m, SIM_HOLD_S);
+    sensor_theta = foc.theta;
+    sensor_on    = 1;
+
+    printf("cogging %.1f%% + %.2f%% of the rated torque, 6th + 12th\n", SIM_COG_6 * 100.0, SIM_COG_12 * 100.0);
+    for(k = 0; k < sizeof(rpm_list) / sizeof(rpm_list[0]); k++)
+    {
+        ripple[k] = sim_ripple(&m, rpm_list[k]);
+    }
+
+    if(motor_cogging_learn_start() != 0)
+    {
+        printf("learning did not start\n\nFAIL\n");
+        return 1;
+    }
+    for(n = 0; (n < (uint32_t)(SIM_LEARN_MAX_S * PWM_FREQ_HZ)) && (cogging.learn < COGGING_LEARN_DONE); n++)
+    {
+        sim_period(&m);
+    }
+    learn_s = (double)n / PWM_FREQ_HZ;
+    err     = table_error();
+    printf("learning: %s after %.1f s, %u passes, table error %.1f%% rms\n",
+           (cogging.learn == COGGING_LEARN_DONE) ? "done" : "not done", learn_s, cogging.pass, err * 100.0);
+    fail |= (cogging.learn != COGGING_LEARN_DONE) || (err > SIM_TABLE_ERR_MAX);
+
+    printf("speed ripple, rpm p-p:\n");
+    for(k = 0; k < sizeof(rpm_list) / sizeof(rpm_list[0]); k++)
+    {
+        double with = sim_ripple(&m, rpm_list[k]);
+
+        printf("  %5.0f rpm:  %5.1f without the table, %5.1f with\n", rpm_list[k], ripple[k], with);
+        fail |= (with > SIM_RIPPLE_RATIO * ripple[k]);
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,378 @@
+/**
+ * @file motor_dpwm_sim.c
+ * @brief Host tool: switching events and current of the discontinuous pwm modes of motor_svpwm.c
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_dpwm_sim motor_dpwm_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_dpwm_sim
+ *
+ * The current loop and the switch level bridge with dead time of
+ * motor_dtc_sim.c, 24V, the dead time compensation on: a leg on a rail does
+ * not switch and has no dead time. 4A is asked for at the speeds where the
+ * steady state voltage is 0.30, 0.63 and 0.90 of the linear circle, with
+ * each discontinuous mode and with the centred SVPWM.
+ *
+ * Each case settles for 0.2s, then over two electrical periods:
+ * - the switching events avoided, counted from the duties (a leg at 0 or
+ *   PWM_PERIOD_MAX saves two of six per period), and from
+ *   svpwm.switch_avoided against 6 * svpwm.periods
+ * - the fundamental of the phase A current (DFT) and the THD of harmonics 2
+ *   to 50
+ * The exit code is 1 when the two counts differ, a discontinuous mode saves
+ * anything below SVPWM_DPWM_V_OFF or not a third above SVPWM_DPWM_V_ON, the
+ * centred one saves anything, phase U or V is held on the high rail, or the
+ * fundamental differs from the one of the centred SVPWM by more than
+ * SIM_FUND_TOL.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "bsp_pwm.h"
+#include "motor_param.h"
+#include "motor_foc.h"
+#include "motor_dtc.h"
+#include "motor_svpwm.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_VBUS_V                      (24.0)
+#define SIM_IQ_A                        (4.0)
+#define SIM_NOISE_LSB                   (3.0)
+#define SIM_SLICE_TICKS                 (27)                    // PWM_PERIOD_MAX / 100
+#define SIM_SETTLE_S                    (0.2)
+#define SIM_CYCLES                      (2)                     // electrical periods in the DFT
+#define SIM_HARMONICS                   (50)
+
+#define SIM_FUND_TOL                    (0.01)                  // of the centred one
+#define SIM_SAVED_TOL                   (0.005)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad*/
+    double we;                          /*electrical, rad/s*/
+}sim_pmsm_t;
+
+typedef struct
+{
+    double   v;                         /*mean |v| of the current loop, of the linear circle*/
+    double   saved;                     /*switching events avoided, counted from the duties*/
+    double   saved_fw;                  /*the same from svpwm.switch_avoided*/
+    double   fund;                      /*A, phase A current amplitude*/
+    double   thd;                       /*percent*/
+    uint32_t high_uv;                   /*periods with phase U or V on the high rail*/
+}sim_result_t;
+
+static uint32_t rand_state = 1;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief length of the overlap of two tick intervals
+ *
+ * @param[in] a0: start of the first
+ * @param[in] a1: end of the first
+ * @param[in] b0: start of the second
+ * @param[in] b1: end of the second
+ * @return overlap, ticks
+ */
+static double sim_overlap(double a0, double a1, double b0, double b1)
+{
+    double d = fmin(a1, b1) - fmax(a0, b0);
+
+    return (d > 0.0) ? d : 0.0;
+}
+
+
+/**
+ * @brief mean leg voltage over a slice of a half period
+ *
+ * @param[in] duty: compare value
+ * @param[in] up: 1 counting up from the underflow, 0 down to it
+ * @param[in] k0: start of the slice, ticks from the start of the half period
+ * @param[in] k1: end of the slice
+ * @param[in] i: phase current into the motor, A
+ * @return voltage to the negative rail, V
+ */
+static double leg_voltage(uint16_t duty, uint8_t up, double k0, double k1, double i)
+{
+    double td = PWM_DEADTIME;
+    double high, dead;
+
+    if(duty == 0)
+    {
+        return 0.0;
+    }
+    if(duty >= PWM_PERIOD_MAX)
+    {
+        return SIM_VBUS_V;
+    }
+
+    if(up != 0)
+    {
+        /*high side off at the compare, low side on one dead time later*/
+        high = sim_overlap(k0, k1, 0.0, duty);
+        dead = sim_overlap(k0, k1, duty, duty + td);
+    }
+    else
+    {
+        /*low side off at the compare, high side on one dead time later*/
+        high = sim_overlap(k0, k1, PWM_PERIOD_MAX - duty + td, PWM_PERIOD_MAX);
+        dead = sim_overlap(k0, k1, PWM_PERIOD_MAX - duty, PWM_PERIOD_MAX - duty + td);
+    }
+    if(i < 0.0)
+    {
+        high += dead;
+    }
+    return SIM_VBUS_V * high / (k1 - k0);
+}
+
+
+/**
+ * @brief PMSM and bridge over half a pwm period
+ *
+ * @param[in,out] m: motor
+ * @param[in] duty: compare values
+ * @param[in] up: 1 counting up from the underflow, 0 down to it
+ * @return None
+ */
+static void pmsm_half_period(sim_pmsm_t *m, const uint16_t *duty, uint8_t up)
+{
+    double dt = MOTOR_TS_S * SIM_SLICE_TICKS / (2.0 * PWM_PERIOD_MAX);
+    double k;
+
+    for(k = 0.0; k < PWM_PERIOD_MAX; k += SIM_SLICE_TICKS)
+    {
+        double s  = sin(m->theta);
+        double c  = cos(m->theta);
+        double ia = m->id * c - m->iq * s;
+        double ibeta = m->id * s + m->iq * c;
+        double ib = -0.5 * ia + sqrt(3.0) / 2.0 * ibeta;
+        double va = leg_voltage(duty[0], up, k, k + SIM_SLICE_TICKS, ia);
+        double vb = leg_voltage(duty[1], up, k, k + SIM_SLICE_TICKS, ib);
+        double vc = leg_voltage(duty[2], up, k, k + SIM_SLICE_TICKS, -ia - ib);
+        double v_alpha = (2.0 * va - vb - vc) / 3.0;
+        double v_beta  = (vb - vc) / sqrt(3.0);
+        double vd = v_alpha * c + v_beta * s;
+        double vq = -v_alpha * s + v_beta * c;
+        double did = (vd - MOTOR_RS_OHM * m->id + m->we * MOTOR_LQ_H * m->iq) / MOTOR_LD_H;
+        double diq = (vq - MOTOR_RS_OHM * m->iq - m->we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB)) / MOTOR_LQ_H;
+
+        m->id    += did * dt;
+        m->iq    += diq * dt;
+        m->theta += m->we * dt;
+    }
+}
+
+
+/**
+ * @brief speed where the steady state voltage at SIM_IQ_A and id = 0 is a share of the linear circle
+ *
+ * @param[in] ratio: of the linear circle
+ * @return electrical speed, rad/s
+ */
+static double speed_of(double ratio)
+{
+    double v_ref = ratio * SIM_VBUS_V / sqrt(3.0);
+    double lo = 0.0, hi = 1e5;
+    int k;
+
+    for(k = 0; k < 60; k++)
+    {
+        double we = 0.5 * (lo + hi);
+        double vd = -we * MOTOR_LQ_H * SIM_IQ_A;
+        double vq = MOTOR_RS_OHM * SIM_IQ_A + we * MOTOR_FLUX_WB;
+
+        if(sqrt(vd * vd + vq * vq) > v_ref)
+        {
+            hi = we;
+        }
+        else
+        {
+            lo = we;
+        }
+    }
+    return lo;
+}
+
+
+/**
+ * @brief one case
+ *
+ * @param[in] we: electrical speed, rad/s
+ * @param[in] dpwm: discontinuous mode
+ * @param[out] r: result
+ * @return None
+ */
+static void case_run(double we, svpwm_dpwm_e dpwm, sim_result_t *r)
+{
+    sim_pmsm_t m = {0};
+    uint16_t   duty[3] = {PWM_PERIOD_MAX / 2, PWM_PERIOD_MAX / 2, PWM_PERIOD_MAX / 2};
+    uint16_t   duty_next[3];
+    double     f_e = we / (2.0 * M_PI);
+    uint32_t   n_settle = (uint32_t)(SIM_SETTLE_S * PWM_FREQ_HZ);
+    uint32_t   n_dft = (uint32_t)lround(SIM_CYCLES / f_e * PWM_FREQ_HZ);
+    double     re[SIM_HARMONICS + 1] = {0.0}, im[SIM_HARMONICS + 1] = {0.0};
+    double     h_sum = 0.0;
+    uint32_t   held = 0, periods = 0, avoided = 0;
+    uint32_t   n;
+    int        h, i;
+
+    *r      = (sim_result_t){0.0, 0.0, 0.0, 0.0, 0.0, 0};
+    m.we    = we;
+    m.theta = sim_rand() * 2.0 * M_PI;
+
+    PWM_TIM->BKDT = PWM_DEADTIME;
+    motor_foc_init();
+    motor_foc_start(MOTOR_DIR_CW);
+    motor_svpwm_dpwm_set(dpwm);
+    motor_fw_enable(0);
+    motor_dtc_enable(1);
+    motor_regen_enable(0);
+    motor_cogging_enable(0);
+    foc.id_ref = 0;
+    foc.iq_ref = (int16_t)lround(SIM_IQ_A / MOTOR_I_BASE_A * 32768.0);
+
+    pmsm_half_period(&m, duty, 1);
+    for(n = 0; n < n_settle + n_dft; n++)
+    {
+        double alpha = m.id * cos(m.theta) - m.iq * sin(m.theta);
+        double beta  = m.id * sin(m.theta) + m.iq * cos(m.theta);
+        double ia    = alpha / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+        double ib    = (-0.5 * alpha + sqrt(3.0) / 2.0 * beta) / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+
+        if(n >= n_settle)
+        {
+            double t = (n - n_settle) * MOTOR_TS_S;
+
+            for(h = 1; h <= SIM_HARMONICS; h++)
+            {
+                re[h] += alpha * cos(2.0 * M_PI * f_e * h * t);
+                im[h] += alpha * sin(2.0 * M_PI * f_e * h * t);
+            }
+        }
+
+        /*the angle of the rotor at the sample*/
+        motor_foc_theta_set((uint16_t)lround(fmod(m.theta, 2.0 * M_PI) * 65536.0 / (2.0 * M_PI)));
+        if(n == n_settle)
+        {
+            periods = svpwm.periods;
+            avoided = svpwm.switch_avoided;
+        }
+        motor_foc_step((int16_t)lround(ia), (int16_t)lround(ib));
+        for(i = 0; i < 3; i++)
+        {
+            duty_next[i] = foc.duty[i];
+        }
+        if(n >= n_settle)
+        {
+            for(i = 0; i < 3; i++)
+            {
+                held += ((duty_next[i] == 0) || (duty_next[i] >= PWM_PERIOD_MAX)) ? 1 : 0;
+            }
+            r->high_uv += ((duty_next[0] >= PWM_PERIOD_MAX) || (duty_next[1] >= PWM_PERIOD_MAX)) ? 1 : 0;
+            r->v       += sqrt((double)foc.v_alpha * foc.v_alpha + (double)foc.v_beta * foc.v_beta) / SVPWM_V_LINEAR / n_dft;
+        }
+
+        /*sampled at the counter peak, the new duties load at the following underflow*/
+        pmsm_half_period(&m, duty, 0);
+        for(i = 0; i < 3; i++)
+        {
+            duty[i] = duty_next[i];
+        }
+        pmsm_half_period(&m, duty, 1);
+    }
+
+    for(h = 2; h <= SIM_HARMONICS; h++)
+    {
+        h_sum += re[h] * re[h] + im[h] * im[h];
+    }
+    r->saved    = (double)held / (3.0 * n_dft);
+    r->saved_fw = (double)(svpwm.switch_avoided - avoided) / (6.0 * (svpwm.periods - periods));
+    r->fund     = 2.0 * sqrt(re[1] * re[1] + im[1] * im[1]) / n_dft;
+    r->thd      = 100.0 * sqrt(h_sum / (re[1] * re[1] + im[1] * im[1]));
+}
+
+
+int main(void)
+{
+    static const double ratio_list[] = {0.30, 0.63, 0.90};
+    static const char *mode_name[SVPWM_DPWM_MODE_MAX] = {"centred", "DPWMMIN", "DPWMMAX", "DPWM1"};
+    int fail = 0;
+    uint32_t k;
+    int d;
+
+    printf("4A at 24V, dead time compensation on\n");
+    printf("|v| of the    mode      avoided %%          |i1| A   THD %%\n");
+    printf("linear circle           duties  counter\n");
+    for(k = 0; k < sizeof(ratio_list) / sizeof(ratio_list[0]); k++)
+    {
+        double we = speed_of(ratio_list[k]);
+        sim_result_t res[SVPWM_DPWM_MODE_MAX];
+
+        for(d = 0; d < SVPWM_DPWM_MODE_MAX; d++)
+        {
+            sim_result_t *r = &res[d];
+            double share;
+
+            case_run(we, (svpwm_dpwm_e)d, r);
+            printf("%4.2f          %-8s  %6.2f  %6.2f     %5.3f    %5.2f\n", r->v, mode_name[d], 100.0 * r->saved,
+                   100.0 * r->saved_fw, r->fund, r->thd);
+            share = ((d == SVPWM_DPWM_OFF) || (r->v < SVPWM_DPWM_V_OFF / MOTOR_V_LINEAR)) ? 0.0 : (1.0 / 3.0);
+            fail |= (fabs(r->saved - r->saved_fw) > 1e-9) || (fabs(r->saved - share) > SIM_SAVED_TOL) || (r->high_uv != 0);
+            fail |= fabs(r->fund - res[SVPWM_DPWM_OFF].fund) > SIM_FUND_TOL * res[SVPWM_DPWM_OFF].fund;
+        }
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,320 @@
+/**
+ * @file motor_dtc_sim.c
+ * @brief Host tool: phase current distortion of the dead time, motor_dtc.c off and on
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_dtc_sim motor_dtc_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_dtc_sim
+ *
+ * The current loop of the firmware runs through motor_foc_step() on the dq
+ * model of motor_param.h held at speed by a dyno, 24V, with the timing of
+ * bsp_pwm.c (currents at the counter peak with 3 LSB rms of noise, the duties
+ * loaded at the next underflow) and the angle of the rotor at the sample.
+ * The dead time is PWM_DEADTIME, written to the TIM1 register before the init
+ * so motor_dtc reads it back as on the target.
+ *
+ * The bridge is switch level, centre aligned: a phase is high while the
+ * counter is under its compare value, each leg turns on one dead time after
+ * the other one turned off. In the dead time the diodes set the phase by the
+ * sign of the model current at that instant, low for a current into the
+ * motor, high for one out of it: the pwm ripple around a zero crossing is in.
+ * Every half period is cut in slices of 27 ticks, the voltage of a slice is
+ * its mean over the exact switching instants.
+ *
+ * Each case settles for 0.2s, then the phase A current at the samples over
+ * two electrical periods goes through a DFT: THD is the rms of harmonics 2 to
+ * 50 over the fundamental. The exit code is 1 when with the compensation the
+ * THD is over the limit of the case or not under the one without. At 0.5A
+ * and 1000rpm or more the ripple is as large as the current, the polarity
+ * of the reference says little there and the limits are wider.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "bsp_pwm.h"
+#include "motor_param.h"
+#include "motor_foc.h"
+#include "motor_dtc.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_VBUS_V                      (24.0)
+#define SIM_NOISE_LSB                   (3.0)
+#define SIM_SLICE_TICKS                 (27)                    // PWM_PERIOD_MAX / 100
+#define SIM_SETTLE_S                    (0.2)
+#define SIM_CYCLES                      (2)                     // electrical periods in the DFT
+#define SIM_HARMONICS                   (50)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    double rpm;                         /*mechanical*/
+    double iq;                          /*A*/
+    double thd_max;                     /*percent, with the compensation*/
+}sim_case_t;
+
+typedef struct
+{
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad*/
+    double we;                          /*electrical, rad/s*/
+}sim_pmsm_t;
+
+static uint32_t rand_state = 1;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief length of the overlap of two tick intervals
+ *
+ * @param[in] a0: start of the first
+ * @param[in] a1: end of the first
+ * @param[in] b0: start of the second
+ * @param[in] b1: end of the second
+ * @return overlap, ticks
+ */
+static double sim_overlap(double a0, double a1, double b0, double b1)
+{
+    double d = fmin(a1, b1) - fmax(a0, b0);
+
+    return (d > 0.0) ? d : 0.0;
+}
+
+
+/**
+ * @brief mean leg voltage over a slice of a half period
+ *
+ * @param[in] duty: compare value
+ * @param[in] up: 1 counting up from the underflow, 0 down to it
+ * @param[in] k0: start of the slice, ticks from the start of the half period
+ * @param[in] k1: end of the slice
+ * @param[in] i: phase current into the motor, A
+ * @return voltage to the negative rail, V
+ */
+static double leg_voltage(uint16_t duty, uint8_t up, double k0, double k1, double i)
+{
+    double td = PWM_DEADTIME;
+    double high, dead;
+
+    if(duty == 0)
+    {
+        return 0.0;
+    }
+    if(duty >= PWM_PERIOD_MAX)
+    {
+        return SIM_VBUS_V;
+    }
+
+    if(up != 0)
+    {
+        /*high side off at the compare, low side on one dead time later*/
+        high = sim_overlap(k0, k1, 0.0, duty);
+        dead = sim_overlap(k0, k1, duty, duty + td);
+    }
+    else
+    {
+        /*low side off at the compare, high side on one dead time later*/
+        high = sim_overlap(k0, k1, PWM_PERIOD_MAX - duty + td, PWM_PERIOD_MAX);
+        dead = sim_overlap(k0, k1, PWM_PERIOD_MAX - duty, PWM_PERIOD_MAX - duty + td);
+    }
+    if(i < 0.0)
+    {
+        high += dead;
+    }
+    return SIM_VBUS_V * high / (k1 - k0);
+}
+
+
+/**
+ * @brief PMSM and bridge over half a pwm period
+ *
+ * @param[in,out] m: motor
+ * @param[in] duty: compare values
+ * @param[in] up: 1 counting up from the underflow, 0 down to it
+ * @return None
+ */
+static void pmsm_half_period(sim_pmsm_t *m, const uint16_t *duty, uint8_t up)
+{
+    double dt = MOTOR_TS_S * SIM_SLICE_TICKS / (2.0 * PWM_PERIOD_MAX);
+    double k;
+
+    for(k = 0.0; k < PWM_PERIOD_MAX; k += SIM_SLICE_TICKS)
+    {
+        double s  = sin(m->theta);
+        double c  = cos(m->theta);
+        double ia = m->id * c - m->iq * s;
+        double ibeta = m->id * s + m->iq * c;
+        double ib = -0.5 * ia + sqrt(3.0) / 2.0 * ibeta;
+        double va = leg_voltage(duty[0], up, k, k + SIM_SLICE_TICKS, ia);
+        double vb = leg_voltage(duty[1], up, k, k + SIM_SLICE_TICKS, ib);
+        double vc = leg_voltage(duty[2], up, k, k + SIM_SLICE_TICKS, -ia - ib);
+        double v_alpha = (2.0 * va - vb - vc) / 3.0;
+        double v_beta  = (vb - vc) / sqrt(3.0);
+        double vd = v_alpha * c + v_beta * s;
+        double vq = -v_alpha * s + v_beta * c;
+        double did = (vd - MOTOR_RS_OHM * m->id + m->we * MOTOR_LQ_H * m->iq) / MOTOR_LD_H;
+        double diq = (vq - MOTOR_RS_OHM * m->iq - m->we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB)) / MOTOR_LQ_H;
+
+        m->id    += did * dt;
+        m->iq    += diq * dt;
+        m->theta += m->we * dt;
+    }
+}
+
+
+/**
+ * @brief one case
+ *
+ * @param[in] rpm: mechanical speed
+ * @param[in] iq_a: q current reference
+ * @param[in] dtc_on: compensation enabled
+ * @return THD of the phase A current, percent
+ */
+static double case_run(double rpm, double iq_a, uint8_t dtc_on)
+{
+    sim_pmsm_t m = {0};
+    uint16_t   duty[3] = {PWM_PERIOD_MAX / 2, PWM_PERIOD_MAX / 2, PWM_PERIOD_MAX / 2};
+    uint16_t   duty_next[3];
+    double     f_e = rpm / 60.0 * MOTOR_POLE_PAIRS;
+    uint32_t   n_settle = (uint32_t)(SIM_SETTLE_S * PWM_FREQ_HZ);
+    uint32_t   n_dft = (uint32_t)lround(SIM_CYCLES / f_e * PWM_FREQ_HZ);
+    double     re[SIM_HARMONICS + 1] = {0.0}, im[SIM_HARMONICS + 1] = {0.0};
+    double     h_sum = 0.0;
+    uint32_t   n;
+    int        h, i;
+
+    m.we    = 2.0 * M_PI * f_e;
+    m.theta = sim_rand() * 2.0 * M_PI;
+
+    PWM_TIM->BKDT = PWM_DEADTIME;
+    motor_foc_init();
+    motor_foc_start(MOTOR_DIR_CW);
+    motor_fw_enable(0);
+    motor_dtc_enable(dtc_on);
+    motor_regen_enable(0);
+    motor_cogging_enable(0);
+    foc.id_ref = 0;
+    foc.iq_ref = (int16_t)lround(iq_a / MOTOR_I_BASE_A * 32768.0);
+
+    pmsm_half_period(&m, duty, 1);
+    for(n = 0; n < n_settle + n_dft; n++)
+    {
+        double alpha = m.id * cos(m.theta) - m.iq * sin(m.theta);
+        double beta  = m.id * sin(m.theta) + m.iq * cos(m.theta);
+        double ia    = alpha / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+        double ib    = (-0.5 * alpha + sqrt(3.0) / 2.0 * beta) / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+
+        if(n >= n_settle)
+        {
+            double t = (n - n_settle) * MOTOR_TS_S;
+
+            for(h = 1; h <= SIM_HARMONICS; h++)
+            {
+                re[h] += alpha * cos(2.0 * M_PI * f_e * h * t);
+                im[h] += alpha * sin(2.0 * M_PI * f_e * h * t);
+            }
+        }
+
+        /*the angle of the rotor at the sample*/
+        motor_foc_theta_set((uint16_t)lround(fmod(m.theta, 2.0 * M_PI) * 65536.0 / (2.0 * M_PI)));
+        motor_foc_step((int16_t)lround(ia), (int16_t)lround(ib));
+        for(i = 0; i < 3; i++)
+        {
+            duty_next[i] = foc.duty[i];
+        }
+
+        /*sampled at the counter peak, the new duties load at the following underflow*/
+        pmsm_half_period(&m, duty, 0);
+        for(i = 0; i < 3; i++)
+        {
+            duty[i] = duty_next[i];
+        }
+        pmsm_half_period(&m, duty, 1);
+    }
+
+    for(h = 2; h <= SIM_HARMONICS; h++)
+    {
+        h_sum += re[h] * re[h] + im[h] * im[h];
+    }
+    return 100.0 * sqrt(h_sum / (re[1] * re[1] + im[1] * im[1]));
+}
+
+
+int main(void)
+{
+    static const sim_case_t case_list[] =
+    {
+        {30.0, 2.0, 1.0},
+        {100.0, 2.0, 1.0},
+        {300.0, 2.0, 1.0},
+        {1000.0, 2.0, 1.5},
+        {3000.0, 2.0, 1.5},
+        {100.0, 0.5, 2.0},
+        {1000.0, 0.5, 5.0},
+        {3000.0, 0.5, 4.0},
+    };
+    int fail = 0;
+    uint32_t k;
+
+    printf("rpm    iq A   THD %% dtc off   on\n");
+    for(k = 0; k < sizeof(case_list) / sizeof(case_list[0]); k++)
+    {
+        const sim_case_t *c = &case_list[k];
+        double off = case_run(c->rpm, c->iq, 0);
+        double on  = case_run(c->rpm, c->iq, 1);
+
+        printf("%5.0f  %4.1f   %6.2f       %6.2f\n", c->rpm, c->iq, off, on);
+        fail |= (on > c->thd_max) || (on >= off);
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,341 @@
+/**
+ * @file motor_flux_obs_sim.c
+ * @brief Host tool: motor_flux_obs.c and motor_smo.c side by side on a PMSM model, cold and after a handover
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -o motor_flux_obs_sim motor_flux_obs_sim.c host/host_mcu.c \
+ *       ../Source/Motor/{motor_flux_obs,motor_smo,motor_math}.c -lm
+ *   ./motor_flux_obs_sim
+ *
+ * The motor and its current loop are the ones of motor_smo_sim.c: motor_param.h
+ * at a constant speed, 3A on q from a double precision dq PI on the true angle,
+ * the q15 voltage of the past period and the q15 currents at its end with 3
+ * LSB rms of noise. Both observers get the same samples, as in
+ * motor_foc_theta_update().
+ *
+ * Each speed runs twice: cold, both observers from init (angle 0, speed 0)
+ * with the rotor at a random angle, and from a handover, both preset to the
+ * rotor angle and speed as the handover of motor_startup.c does. After
+ * 500ms or 20 electrical turns, whichever is longer, 200ms are measured: the
+ * rms error of flux_obs.theta and smo.theta against the rotor angle at the
+ * sample. The host time of one update of each only ranks the two, the target
+ * figures are the DWT counts in foc.smo_cycles and foc.flux_cycles. The exit
+ * code is 1 when the flux observer is over 1 degree rms from SIM_RPM_MIN (2%
+ * of the rated speed) up, cold or not.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "motor_param.h"
+#include "motor_smo.h"
+#include "motor_flux_obs.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_VBUS_V                      (24.0)
+#define SIM_IQ_A                        (3.0)
+#define SIM_NOISE_LSB                   (3.0)
+#define SIM_CUR_BW_HZ                   (1000.0)
+#define SIM_SUBSTEPS                    (10)
+#define SIM_SETTLE_PERIODS              (10000)                 // 500ms, at least
+#define SIM_SETTLE_REVS                 (20.0)                  // electrical, at least
+#define SIM_TIME_CALLS                  (1000000)
+#define SIM_MEASURE_PERIODS             (4000)                  // 200ms
+
+#define SIM_ERR_RMS_MAX_DEG             (1.0)
+#define SIM_RPM_MIN                     (0.02 * MOTOR_RATED_RPM)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad*/
+    double we;                          /*electrical, rad/s*/
+    double v_alpha;                     /*applied this period, V*/
+    double v_beta;
+    double int_d;                       /*current PI integrators, V*/
+    double int_q;
+}sim_pmsm_t;
+
+static uint32_t rand_state = 1;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief angle difference folded to [-180, 180) degree
+ *
+ * @param[in] a: angle, rad
+ * @param[in] b: angle, rad
+ * @return a - b, degree
+ */
+static double sim_angle_diff(double a, double b)
+{
+    double d = fmod(a - b, 2.0 * M_PI);
+
+    d = (d < -M_PI) ? (d + 2.0 * M_PI) : ((d >= M_PI) ? (d - 2.0 * M_PI) : d);
+    return d * 180.0 / M_PI;
+}
+
+
+/**
+ * @brief PMSM over one pwm period at constant speed
+ *
+ * @param[in,out] m: motor
+ * @return None
+ */
+static void pmsm_period(sim_pmsm_t *m)
+{
+    double dt = MOTOR_TS_S / SIM_SUBSTEPS;
+    int k;
+
+    for(k = 0; k < SIM_SUBSTEPS; k++)
+    {
+        double s  = sin(m->theta);
+        double c  = cos(m->theta);
+        double vd = m->v_alpha * c + m->v_beta * s;
+        double vq = -m->v_alpha * s + m->v_beta * c;
+        double did = (vd - MOTOR_RS_OHM * m->id + m->we * MOTOR_LQ_H * m->iq) / MOTOR_LD_H;
+        double diq = (vq - MOTOR_RS_OHM * m->iq - m->we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB)) / MOTOR_LQ_H;
+
+        m->id    += did * dt;
+        m->iq    += diq * dt;
+        m->theta += m->we * dt;
+    }
+}
+
+
+/**
+ * @brief the current loop on the true angle, the voltage of the next period
+ *
+ * @param[in,out] m: motor
+ * @param[out] v_alpha: the voltage, V
+ * @param[out] v_beta: the voltage, V
+ * @return None
+ */
+static void pmsm_control(sim_pmsm_t *m, double *v_alpha, double *v_beta)
+{
+    double wc    = 2.0 * M_PI * SIM_CUR_BW_HZ;
+    double v_max = SIM_VBUS_V / sqrt(3.0);
+    double ed    = 0.0 - m->id;
+    double eq    = SIM_IQ_A - m->iq;
+    double vd, vq, mag;
+
+    m->int_d += MOTOR_RS_OHM * wc * MOTOR_TS_S * ed;
+    m->int_q += MOTOR_RS_OHM * wc * MOTOR_TS_S * eq;
+    vd  = m->int_d + MOTOR_LD_H * wc * ed - m->we * MOTOR_LQ_H * m->iq;
+    vq  = m->int_q + MOTOR_LQ_H * wc * eq + m->we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB);
+    mag = sqrt(vd * vd + vq * vq);
+    if(mag > v_max)
+    {
+        vd *= v_max / mag;
+        vq *= v_max / mag;
+    }
+    *v_alpha = vd * cos(m->theta) - vq * sin(m->theta);
+    *v_beta  = vd * sin(m->theta) + vq * cos(m->theta);
+}
+
+
+/**
+ * @brief volts or amps to q15, saturated
+ *
+ * @param[in] x: value
+ * @param[in] base: q15 full scale
+ * @return q15
+ */
+static int16_t sim_q15(double x, double base)
+{
+    double q = floor(x / base * 32768.0 + 0.5);
+
+    return (int16_t)fmin(fmax(q, -32768.0), 32767.0);
+}
+
+
+/**
+ * @brief host time in ns
+ *
+ * @param[in] None
+ * @return the time
+ */
+static double sim_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+/**
+ * @brief one speed
+ *
+ * @param[in] rpm: mechanical speed
+ * @param[in] cold: 1 both observers from init, 0 preset to the rotor angle and speed
+ * @param[out] flux: rms angle error of the flux observer, degree
+ * @param[out] sm: rms angle error of the SMO, degree
+ * @return None
+ */
+static void speed_run(double rpm, int cold, double *flux, double *sm)
+{
+    sim_pmsm_t m = {0};
+    double     inc    = MOTOR_RPM_TO_INC(rpm);
+    uint32_t   settle = (uint32_t)(SIM_SETTLE_REVS * 65536.0 / inc);
+    double     sum_flux = 0.0, sum_smo = 0.0;
+    int16_t    v_alpha = 0, v_beta = 0;
+    uint32_t   n;
+
+    settle  = (settle > SIM_SETTLE_PERIODS) ? settle : SIM_SETTLE_PERIODS;
+    m.we    = rpm / 60.0 * 2.0 * M_PI * MOTOR_POLE_PAIRS;
+    m.theta = sim_rand() * 2.0 * M_PI;
+    m.iq    = SIM_IQ_A;
+    m.int_q = MOTOR_RS_OHM * SIM_IQ_A;
+    motor_smo_init();
+    motor_flux_obs_init();
+    if(cold == 0)
+    {
+        motor_smo_reset((uint16_t)(m.theta * 65536.0 / (2.0 * M_PI)), (int16_t)lround(inc));
+        motor_flux_obs_reset((uint16_t)(m.theta * 65536.0 / (2.0 * M_PI)), (int16_t)lround(inc));
+    }
+
+    for(n = 0; n < settle + SIM_MEASURE_PERIODS; n++)
+    {
+        double  alpha, beta, ia, ib, va, vb;
+        int16_t i_alpha, i_beta;
+
+        pmsm_period(&m);
+
+        /*sample at the end of the period, both observers on it as in motor_foc_theta_update()*/
+        alpha   = m.id * cos(m.theta) - m.iq * sin(m.theta);
+        beta    = m.id * sin(m.theta) + m.iq * cos(m.theta);
+        ia      = alpha / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+        ib      = (-0.5 * alpha + sqrt(3.0) / 2.0 * beta) / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+        i_alpha = (int16_t)lround(ia);
+        i_beta  = (int16_t)lround((ia + 2.0 * ib) / sqrt(3.0));
+        motor_smo_update(v_alpha, v_beta, i_alpha, i_beta);
+        motor_flux_obs_update(v_alpha, v_beta, i_alpha, i_beta);
+
+        /*the voltage of the next period*/
+        pmsm_control(&m, &va, &vb);
+        m.v_alpha = va;
+        m.v_beta  = vb;
+        v_alpha   = sim_q15(va, MOTOR_V_BASE_V * SIM_VBUS_V / MOTOR_VBUS_NOM_V);
+        v_beta    = sim_q15(vb, MOTOR_V_BASE_V * SIM_VBUS_V / MOTOR_VBUS_NOM_V);
+
+        if(n >= settle)
+        {
+            double e_flux = sim_angle_diff(flux_obs.theta * 2.0 * M_PI / 65536.0, m.theta);
+            double e_smo  = sim_angle_diff(smo.theta * 2.0 * M_PI / 65536.0, m.theta);
+
+            sum_flux += e_flux * e_flux;
+            sum_smo  += e_smo * e_smo;
+        }
+    }
+    *flux = sqrt(sum_flux / SIM_MEASURE_PERIODS);
+    *sm   = sqrt(sum_smo / SIM_MEASURE_PERIODS);
+}
+
+
+/**
+ * @brief host time of one update of each, over SIM_TIME_CALLS calls on a turning input
+ *
+ * @param[out] flux: ns per motor_flux_obs_update()
+ * @param[out] sm: ns per motor_smo_update()
+ * @return None
+ */
+static void update_time(double *flux, double *sm)
+{
+    volatile int16_t i_alpha, i_beta;
+    double   t;
+    uint32_t n;
+
+    t = sim_ns();
+    for(n = 0; n < SIM_TIME_CALLS; n++)
+    {
+        i_alpha = motor_math_cos((uint16_t)(n * 64)) >> 3;
+        i_beta  = motor_math_sin((uint16_t)(n * 64)) >> 3;
+        motor_smo_update(i_alpha, i_beta, i_alpha, i_beta);
+    }
+    *sm = (sim_ns() - t) / SIM_TIME_CALLS;
+
+    t = sim_ns();
+    for(n = 0; n < SIM_TIME_CALLS; n++)
+    {
+        i_alpha = motor_math_cos((uint16_t)(n * 64)) >> 3;
+        i_beta  = motor_math_sin((uint16_t)(n * 64)) >> 3;
+        motor_flux_obs_update(i_alpha, i_beta, i_alpha, i_beta);
+    }
+    *flux = (sim_ns() - t) / SIM_TIME_CALLS;
+}
+
+
+int main(void)
+{
+    static const double rpm_run[] = {30.0, 60.0, 100.0, 300.0, 1000.0, 2000.0, 3000.0};
+    double t_flux, t_smo;
+    int    fail = 0;
+    uint32_t s;
+
+    printf(" rpm   %% rated   rms angle error degree\n");
+    printf("                 cold             handover\n");
+    printf("                 flux     smo     flux     smo\n");
+    for(s = 0; s < sizeof(rpm_run) / sizeof(rpm_run[0]); s++)
+    {
+        double flux_cold, smo_cold, flux_hand, smo_hand;
+
+        speed_run(rpm_run[s], 1, &flux_cold, &smo_cold);
+        speed_run(rpm_run[s], 0, &flux_hand, &smo_hand);
+        printf("%5.0f  %5.1f   %7.2f %7.2f  %7.2f %7.2f\n", rpm_run[s], rpm_run[s] * 100.0 / MOTOR_RATED_RPM,
+               flux_cold, smo_cold, flux_hand, smo_hand);
+        fail |= (rpm_run[s] >= SIM_RPM_MIN) && ((flux_cold > SIM_ERR_RMS_MAX_DEG) || (flux_hand > SIM_ERR_RMS_MAX_DEG));
+    }
+
+    update_time(&t_flux, &t_smo);
+    printf("\nhost ns per update: flux %.1f, smo %.1f\n", t_flux, t_smo);
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,428 @@
+/**
+ * @file motor_foc_ref.c
+ * @brief Host tool: the q15 current loop of motor_foc.c against a double precision reference
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_foc_ref motor_foc_ref.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_foc_ref
+ *
+ * The loop is the one of the firmware (Clarke, Park, d / q PI, voltage circle,
+ * inverse Park, SVPWM) through motor_foc_step(), with the weakening, the dead
+ * time compensation, the regeneration limits and the cogging table off. The
+ * reference does the same steps in double: exact sine and square root, the PI
+ * as y += (Kp + Ki) * e - Kp * e_prev with the same gains.
+ * - Step: 200000 random angles, currents, references and PI histories. The
+ *   reference starts every step from the PI history of the firmware, so the
+ *   errors are those of one step and do not add up. Errors in q15 LSB for
+ *   the currents and voltages, in compare counts for the duties.
+ * - Loop: both loops drive their own copy of a PMSM (motor_param.h: Rs, Ld,
+ *   Lq, flux; 24V, 1000 rpm, the duty applied one period later) through a
+ *   q current step of 5A and a d current step of -2A. The currents of the two
+ *   are compared every period.
+ * arm_pid_q15() truncates its sum, the integral stands still while Ki * e is
+ * under one LSB: the firmware loop settles anywhere up to 32768 / Ki LSB
+ * (29mA) short of the reference, the double one right on it.
+ * The exit code is 1 when the worst step error is over 4 LSB on a current, 8
+ * LSB on a voltage or 2 counts on a duty, or the two loops differ by more than
+ * that dead band.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "motor_param.h"
+#include "motor_foc.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_STEPS                       (200000)
+#define SIM_CUR_ERR_MAX                 (4.0)                   // q15 LSB
+#define SIM_VOLT_ERR_MAX                (8.0)                   // q15 LSB
+#define SIM_DUTY_ERR_MAX                (2.0)                   // compare counts
+#define SIM_LOOP_ERR_MAX_A              (MOTOR_I_BASE_A / FOC_IQ_KI)   // integral dead band of arm_pid_q15, see above
+
+#define SIM_VBUS_V                      (24.0)
+#define SIM_RPM                         (1000.0)
+#define SIM_SUBSTEPS                    (20)
+#define SIM_LOOP_PERIODS                (2000)                  // 100ms
+#define SIM_IQ_STEP_A                   (5.0)
+#define SIM_ID_STEP_A                   (-2.0)
+#define SIM_IQ_STEP_PERIOD              (100)
+#define SIM_ID_STEP_PERIOD              (1000)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    double kp;
+    double ki;
+    double e_prev;
+    double y;
+}ref_pi_t;
+
+typedef struct
+{
+    double id;
+    double iq;
+    double vd;
+    double vq;
+    double duty[3];
+}ref_out_t;
+
+typedef struct
+{
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad*/
+    double v_alpha;                     /*applied this period, V*/
+    double v_beta;
+}sim_pmsm_t;
+
+typedef struct
+{
+    double max;
+    double sum2;
+    uint32_t n;
+}sim_err_t;
+
+static uint32_t rand_state = 1;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [-1, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 8388608.0 - 1.0;
+}
+
+
+/**
+ * @brief add one error
+ *
+ * @param[in,out] err: statistics
+ * @param[in] e: error
+ * @return None
+ */
+static void err_add(sim_err_t *err, double e)
+{
+    err->max   = fmax(err->max, fabs(e));
+    err->sum2 += e * e;
+    err->n++;
+}
+
+
+/**
+ * @brief the reference PI with the gains and the history of an arm_pid_q15
+ *
+ * @param[out] pi: reference
+ * @param[in] pid: firmware controller
+ * @return None
+ */
+static void ref_pi_load(ref_pi_t *pi, const arm_pid_instance_q15 *pid)
+{
+    pi->kp     = pid->Kp / 32768.0;
+    pi->ki     = pid->Ki / 32768.0;
+    pi->e_prev = pid->state[0] / 32768.0;
+    pi->y      = pid->state[2] / 32768.0;
+}
+
+
+/**
+ * @brief saturate to the q15 range
+ *
+ * @param[in] x: per unit
+ * @return [-1, 32767 / 32768]
+ */
+static double ref_sat(double x)
+{
+    return fmin(fmax(x, -1.0), 32767.0 / 32768.0);
+}
+
+
+/**
+ * @brief the current loop in double, per unit (1.0 = q15 full scale)
+ *
+ * @param[in] theta: electrical angle, 65536 = 360 degree
+ * @param[in] ia: phase U current
+ * @param[in] ib: phase V current
+ * @param[in] id_ref: d reference
+ * @param[in] iq_ref: q reference
+ * @param[in,out] pi_d: d controller
+ * @param[in,out] pi_q: q controller
+ * @param[out] out: currents, voltages and duties
+ * @return None
+ */
+static void ref_step(uint16_t theta, double ia, double ib, double id_ref, double iq_ref,
+                     ref_pi_t *pi_d, ref_pi_t *pi_q, ref_out_t *out)
+{
+    double th    = theta * 2.0 * M_PI / 65536.0;
+    double s     = sin(th);
+    double c     = cos(th);
+    double alpha = ia;
+    double beta  = (ia + 2.0 * ib) / sqrt(3.0);
+    double v_max = FOC_V_MAX / 32768.0;
+    double e, vd, vq, vq_max, va, vb, v[3], v0;
+    int i;
+
+    out->id = alpha * c + beta * s;
+    out->iq = -alpha * s + beta * c;
+
+    /*the error and the output saturate at q15 full scale as in arm_pid_q15()*/
+    e          = ref_sat(id_ref - out->id);
+    vd         = ref_sat(pi_d->y + (pi_d->kp + pi_d->ki) * e - pi_d->kp * pi_d->e_prev);
+    pi_d->e_prev = e;
+    e          = ref_sat(iq_ref - out->iq);
+    vq         = ref_sat(pi_q->y + (pi_q->kp + pi_q->ki) * e - pi_q->kp * pi_q->e_prev);
+    pi_q->e_prev = e;
+
+    vd     = fmin(fmax(vd, -v_max), v_max);
+    vq_max = sqrt(v_max * v_max - vd * vd);
+    vq     = fmin(fmax(vq, -vq_max), vq_max);
+    pi_d->y = vd;
+    pi_q->y = vq;
+    out->vd = vd;
+    out->vq = vq;
+
+    va   = vd * c - vq * s;
+    vb   = vd * s + vq * c;
+    v[0] = va;
+    v[1] = -0.5 * va + sqrt(3.0) / 2.0 * vb;
+    v[2] = -v[0] - v[1];
+    v0   = -(fmax(v[0], fmax(v[1], v[2])) + fmin(v[0], fmin(v[1], v[2]))) / 2.0;
+    for(i = 0; i < 3; i++)
+    {
+        out->duty[i] = fmin(fmax(PWM_PERIOD_MAX / 2.0 + (v[i] + v0) * PWM_PERIOD_MAX * 2.0 / 3.0, 0.0), PWM_PERIOD_MAX);
+    }
+}
+
+
+/**
+ * @brief one step of both on the same random input
+ *
+ * @param[in,out] e_i: current errors, LSB
+ * @param[in,out] e_v: voltage errors, LSB
+ * @param[in,out] e_duty: duty errors, counts
+ * @return None
+ */
+static void step_compare(sim_err_t *e_i, sim_err_t *e_v, sim_err_t *e_duty)
+{
+    uint16_t  theta = (uint16_t)(rand_state >> 16);
+    double    i_amp = fabs(sim_rand()) * 0.6;
+    double    i_ang = sim_rand() * M_PI;
+    int16_t   ia    = (int16_t)(i_amp * cos(i_ang) * 32767);
+    int16_t   ib    = (int16_t)(i_amp * cos(i_ang - 2.0 * M_PI / 3.0) * 32767);
+    int16_t   v_pre = (int16_t)(sim_rand() * 0.6 * FOC_V_MAX);
+    ref_pi_t  pi_d, pi_q;
+    ref_out_t ref;
+    int i;
+
+    foc.theta  = theta;
+    foc.id_ref = (int16_t)(sim_rand() * 0.5 * 32767);
+    foc.iq_ref = (int16_t)(sim_rand() * 0.5 * 32767);
+    foc.pid_d.state[0] = (q15_t)(sim_rand() * 0.1 * 32767);
+    foc.pid_d.state[1] = 0;
+    foc.pid_d.state[2] = v_pre;
+    foc.pid_q.state[0] = (q15_t)(sim_rand() * 0.1 * 32767);
+    foc.pid_q.state[1] = 0;
+    foc.pid_q.state[2] = (q15_t)(sim_rand() * 0.6 * FOC_V_MAX);
+    ref_pi_load(&pi_d, &foc.pid_d);
+    ref_pi_load(&pi_q, &foc.pid_q);
+
+    motor_foc_step(ia, ib);
+    ref_step(theta, ia / 32768.0, ib / 32768.0, foc.id_ref / 32768.0, foc.iq_ref / 32768.0, &pi_d, &pi_q, &ref);
+
+    err_add(e_i, foc.id - ref.id * 32768.0);
+    err_add(e_i, foc.iq - ref.iq * 32768.0);
+    err_add(e_v, foc.vd - ref.vd * 32768.0);
+    err_add(e_v, foc.vq - ref.vq * 32768.0);
+    for(i = 0; i < 3; i++)
+    {
+        err_add(e_duty, foc.duty[i] - ref.duty[i]);
+    }
+}
+
+
+/**
+ * @brief PMSM over one pwm period, the voltage is constant in the stator frame
+ *
+ * @param[in,out] m: motor
+ * @return None
+ */
+static void pmsm_period(sim_pmsm_t *m)
+{
+    double we = SIM_RPM / 60.0 * 2.0 * M_PI * MOTOR_POLE_PAIRS;
+    double dt = MOTOR_TS_S / SIM_SUBSTEPS;
+    int k;
+
+    for(k = 0; k < SIM_SUBSTEPS; k++)
+    {
+        double s  = sin(m->theta);
+        double c  = cos(m->theta);
+        double vd = m->v_alpha * c + m->v_beta * s;
+        double vq = -m->v_alpha * s + m->v_beta * c;
+        double did = (vd - MOTOR_RS_OHM * m->id + we * MOTOR_LQ_H * m->iq) / MOTOR_LD_H;
+        double diq = (vq - MOTOR_RS_OHM * m->iq - we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB)) / MOTOR_LQ_H;
+
+        m->id    += did * dt;
+        m->iq    += diq * dt;
+        m->theta += we * dt;
+    }
+}
+
+
+/**
+ * @brief the stator voltage of three duties
+ *
+ * @param[out] m: motor, applied voltage
+ * @param[in] duty: compare values, fractional for the reference
+ * @return None
+ */
+static void pmsm_apply(sim_pmsm_t *m, const double *duty)
+{
+    double v[3];
+    int i;
+
+    for(i = 0; i < 3; i++)
+    {
+        v[i] = (duty[i] / PWM_PERIOD_MAX - 0.5) * SIM_VBUS_V;
+    }
+    m->v_alpha = (2.0 * v[0] - v[1] - v[2]) / 3.0;
+    m->v_beta  = (v[1] - v[2]) / sqrt(3.0);
+}
+
+
+/**
+ * @brief phase currents of the motor
+ *
+ * @param[in] m: motor
+ * @param[out] ia: phase U, A
+ * @param[out] ib: phase V, A
+ * @return None
+ */
+static void pmsm_currents(const sim_pmsm_t *m, double *ia, double *ib)
+{
+    double alpha = m->id * cos(m->theta) - m->iq * sin(m->theta);
+    double beta  = m->id * sin(m->theta) + m->iq * cos(m->theta);
+
+    *ia = alpha;
+    *ib = -0.5 * alpha + sqrt(3.0) / 2.0 * beta;
+}
+
+
+/**
+ * @brief both loops on their own motor through the reference steps
+ *
+ * @param[out] err: difference of the d and q currents, A
+ * @param[out] iq_end: q current of the firmware loop at the end, A
+ * @param[out] id_end: d current of the firmware loop at the end, A
+ * @return None
+ */
+static void loop_compare(sim_err_t *err, double *iq_end, double *id_end)
+{
+    sim_pmsm_t fw  = {0};
+    sim_pmsm_t ref = {0};
+    ref_pi_t   pi_d, pi_q;
+    ref_out_t  out;
+    double     duty[3];
+    double     id_ref = 0.0;
+    double     iq_ref = 0.0;
+    uint32_t   n;
+    int        i;
+
+    foc.pid_d.state[0] = foc.pid_d.state[1] = foc.pid_d.state[2] = 0;
+    foc.pid_q.state[0] = foc.pid_q.state[1] = foc.pid_q.state[2] = 0;
+    ref_pi_load(&pi_d, &foc.pid_d);
+    ref_pi_load(&pi_q, &foc.pid_q);
+
+    for(n = 0; n < SIM_LOOP_PERIODS; n++)
+    {
+        double ia, ib;
+
+        iq_ref = (n >= SIM_IQ_STEP_PERIOD) ? SIM_IQ_STEP_A : 0.0;
+        id_ref = (n >= SIM_ID_STEP_PERIOD) ? SIM_ID_STEP_A : 0.0;
+
+        /*firmware: q15 currents, angle at the sample*/
+        pmsm_currents(&fw, &ia, &ib);
+        foc.theta  = (uint16_t)lround(fmod(fw.theta, 2.0 * M_PI) * 65536.0 / (2.0 * M_PI));
+        foc.id_ref = (int16_t)lround(id_ref / MOTOR_I_BASE_A * 32768.0);
+        foc.iq_ref = (int16_t)lround(iq_ref / MOTOR_I_BASE_A * 32768.0);
+        motor_foc_step((int16_t)lround(ia / MOTOR_I_BASE_A * 32768.0), (int16_t)lround(ib / MOTOR_I_BASE_A * 32768.0));
+        for(i = 0; i < 3; i++)
+        {
+            duty[i] = foc.duty[i];
+        }
+
+        /*reference: the same in double*/
+        pmsm_currents(&ref, &ia, &ib);
+        ref_step((uint16_t)lround(fmod(ref.theta, 2.0 * M_PI) * 65536.0 / (2.0 * M_PI)) , ia / MOTOR_I_BASE_A, ib / MOTOR_I_BASE_A,
+                 id_ref / MOTOR_I_BASE_A, iq_ref / MOTOR_I_BASE_A, &pi_d, &pi_q, &out);
+
+        /*the duties of this period are applied in the next one*/
+        pmsm_period(&fw);
+        pmsm_period(&ref);
+        pmsm_apply(&fw, duty);
+        pmsm_apply(&ref, out.duty);
+
+        err_add(err, fw.id - ref.id);
+        err_add(err, fw.iq - ref.iq);
+    }
+    *iq_end = fw.iq;
+    *id_end = fw.id;
+}
+
+
+int main(void)
+{
+    sim_err_t e_i = {0}, e_v = {0}, e_duty = {0}, e_loop = {0};
+    double    iq_end, id_end;
+    uint32_t  k;
+    int       fail;
+
+    motor_foc_init();
+    motor_fw_enable(0);
+    motor_dtc_enable(0);
+    motor_regen_enable(0);
+    motor_cogging_enable(0);
+
+    for(k = 0; k < SIM_STEPS; k++)
+    {
+        step_compare(&e_i, &e_v, &e_duty);
+    }
+    loop_compare(&e_loop, &iq_end, &id_end);
+
+    printf("step errors, %u random steps    max      rms\n", (unsigned)SIM_STEPS);
+    printf("  id, iq  (q15 LSB)         %8.2f  %7.3f\n", e_i.max, sqrt(e_i.sum2 / e_i.n));
+    printf("  vd, vq  (q15 LSB)         %8.2f  %7.3f\n", e_v.max, sqrt(e_v.sum2 / e_v.n));
+    printf("  duty    (counts of %d)  %8.2f  %7.3f\n", PWM_PERIOD_MAX, e_duty.max, sqrt(e_duty.sum2 / e_duty.n));
+    printf("closed loop, %.0f rpm, iq %.1fA, id %.1fA: difference max %.2f mA, rms %.2f mA (end iq %.3fA id %.3fA)\n",
+           SIM_RPM, SIM_IQ_STEP_A, SIM_ID_STEP_A, e_loop.max * 1000.0, sqrt(e_loop.sum2 / e_loop.n) * 1000.0, iq_end, id_end);
+    printf("  integral dead band of the q15 PI %.2f mA\n", SIM_LOOP_ERR_MAX_A * 1000.0);
+
+    fail  = (e_i.max > SIM_CUR_ERR_MAX) || (e_v.max > SIM_VOLT_ERR_MAX) || (e_duty.max > SIM_DUTY_ERR_MAX);
+    fail |= (e_loop.max > SIM_LOOP_ERR_MAX_A);
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,373 @@
+/**
+ * @file motor_fw_sim.c
+ * @brief Host tool: speed sweep of motor_fw.c past base speed, with a bus sag
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_fw_sim motor_fw_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_fw_sim
+ *
+ * The current loop of the firmware runs through motor_foc_step() on the dq
+ * model of motor_param.h held at speed by a dyno, with the timing of bsp_pwm.c
+ * (currents at the counter peak with 3 LSB rms of noise, the duties loaded
+ * at the next underflow) and the angle of the rotor at the sample. The duties
+ * are fractions of the actual bus, so a sag takes voltage away at once.
+ *
+ * Base speed is where the q current of the case at id = 0 needs FW_V_REF at
+ * the start bus voltage. At the top speed after the sag the q current the
+ * limits leave (|v| at FW_V_REF, |i| at FW_I_MAX) can be under the reference,
+ * the reachable one is the q current of the steady state model there. The speed ramps from standstill to the top speed of
+ * the case within 2s and stays there, the bus steps down at 2.5s, the run ends
+ * at 3.5s. Each case runs with the weakening off and on:
+ * - off: the q current left at the end
+ * - on: the speed where id first goes under -0.1A (onset), the q current at
+ *   the end, the deepest id, the largest current vector, the time id needs
+ *   after the sag to settle within 0.1A of its end value, and its peak to peak
+ *   over the last 0.5s (a limit cycle)
+ * The currents at the end are means over the last 10ms. The exit code is 1
+ * when with the weakening on the q current at the end is under 90% of the
+ * reachable one, the current vector goes more than 5% over FW_I_MAX, id takes
+ * longer than 150ms to settle or swings by more than 0.2A.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "motor_param.h"
+#include "motor_foc.h"
+#include "motor_fw.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_NOISE_LSB                   (3.0)
+#define SIM_SUBSTEPS                    (20)
+#define SIM_RAMP_S                      (2.0)
+#define SIM_SAG_S                       (2.5)
+#define SIM_END_S                       (3.5)
+#define SIM_TAIL_S                      (0.5)                   // limit cycle window
+#define SIM_ONSET_A                     (-0.1)
+#define SIM_SETTLE_A                    (0.1)
+
+#define SIM_IQ_MIN                      (0.9)                   // of the reachable one
+#define SIM_I_OVER                      (1.05)                  // of FW_I_MAX
+#define SIM_SETTLE_MAX_MS               (150.0)
+#define SIM_PP_MAX_A                    (0.2)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    double vbus;                        /*V, before the sag*/
+    double vbus_sag;                    /*V, after*/
+    double top;                         /*top speed, of the base speed*/
+    double iq;                          /*A*/
+}sim_case_t;
+
+typedef struct
+{
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad*/
+    double we;                          /*electrical, rad/s*/
+    double v_alpha;                     /*applied this period, V*/
+    double v_beta;
+}sim_pmsm_t;
+
+typedef struct
+{
+    double onset;                       /*of the base speed, 0 never*/
+    double iq_end;                      /*A, mean of the last 10ms*/
+    double id_min;
+    double i_max;
+    double settle_ms;
+    double id_pp;
+}sim_result_t;
+
+static uint32_t rand_state = 1;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief PMSM over half a pwm period, the voltage is constant in the stator frame
+ *
+ * @param[in,out] m: motor
+ * @return None
+ */
+static void pmsm_half_period(sim_pmsm_t *m)
+{
+    double dt = MOTOR_TS_S / SIM_SUBSTEPS;
+    int k;
+
+    for(k = 0; k < SIM_SUBSTEPS / 2; k++)
+    {
+        double s  = sin(m->theta);
+        double c  = cos(m->theta);
+        double vd = m->v_alpha * c + m->v_beta * s;
+        double vq = -m->v_alpha * s + m->v_beta * c;
+        double did = (vd - MOTOR_RS_OHM * m->id + m->we * MOTOR_LQ_H * m->iq) / MOTOR_LD_H;
+        double diq = (vq - MOTOR_RS_OHM * m->iq - m->we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB)) / MOTOR_LQ_H;
+
+        m->id    += did * dt;
+        m->iq    += diq * dt;
+        m->theta += m->we * dt;
+    }
+}
+
+
+/**
+ * @brief the stator voltage of the three duties
+ *
+ * @param[out] m: motor, applied voltage
+ * @param[in] duty: compare values
+ * @param[in] vbus: bus voltage
+ * @return None
+ */
+static void pmsm_apply(sim_pmsm_t *m, const uint16_t *duty, double vbus)
+{
+    double v[3];
+    int i;
+
+    for(i = 0; i < 3; i++)
+    {
+        v[i] = ((double)duty[i] / PWM_PERIOD_MAX - 0.5) * vbus;
+    }
+    m->v_alpha = (2.0 * v[0] - v[1] - v[2]) / 3.0;
+    m->v_beta  = (v[1] - v[2]) / sqrt(3.0);
+}
+
+
+/**
+ * @brief base speed: the q current at id = 0 needs FW_V_REF
+ *
+ * @param[in] vbus: bus voltage
+ * @param[in] iq: q current, A
+ * @return electrical speed, rad/s
+ */
+static double base_speed(double vbus, double iq)
+{
+    double v_ref = FW_V_REF / 32768.0 * vbus * 2.0 / 3.0;
+    double lo = 0.0, hi = 1e5;
+    int k;
+
+    for(k = 0; k < 60; k++)
+    {
+        double we = 0.5 * (lo + hi);
+        double vd = -we * MOTOR_LQ_H * iq;
+        double vq = MOTOR_RS_OHM * iq + we * MOTOR_FLUX_WB;
+
+        if(sqrt(vd * vd + vq * vq) > v_ref)
+        {
+            hi = we;
+        }
+        else
+        {
+            lo = we;
+        }
+    }
+    return lo;
+}
+
+
+/**
+ * @brief q current the limits leave in the steady state, the d current as deep as needed
+ *
+ * @param[in] vbus: bus voltage
+ * @param[in] we: electrical speed, rad/s
+ * @param[in] iq: q current reference, A
+ * @return reachable q current, A
+ */
+static double iq_reachable(double vbus, double we, double iq)
+{
+    double v_ref = FW_V_REF / 32768.0 * vbus * 2.0 / 3.0;
+    double i_max = FW_I_MAX * MOTOR_I_BASE_A / 32768.0;
+    double id;
+
+    for(id = 0.0; id > -i_max; id -= 0.001)
+    {
+        double iq_lim = fmin(iq, sqrt(i_max * i_max - id * id));
+        double vd = MOTOR_RS_OHM * id - we * MOTOR_LQ_H * iq_lim;
+        double vq = MOTOR_RS_OHM * iq_lim + we * (MOTOR_LD_H * id + MOTOR_FLUX_WB);
+
+        if(sqrt(vd * vd + vq * vq) <= v_ref)
+        {
+            return iq_lim;
+        }
+    }
+    return 0.0;
+}
+
+
+/**
+ * @brief one sweep
+ *
+ * @param[in] c: case
+ * @param[in] fw_on: weakening enabled
+ * @param[out] r: result
+ * @return None
+ */
+static void case_run(const sim_case_t *c, uint8_t fw_on, sim_result_t *r)
+{
+    sim_pmsm_t m = {0};
+    uint16_t   duty[3];
+    double     w_base = base_speed(c->vbus, c->iq);
+    double     id_hist_min = 1e9, id_hist_max = -1e9;
+    double     id_end;
+    double    *id_log;
+    double    *iq_log;
+    uint32_t   n, n_end = (uint32_t)(SIM_END_S * PWM_FREQ_HZ), n_sag = (uint32_t)(SIM_SAG_S * PWM_FREQ_HZ);
+    uint32_t   n_tail = n_end - (uint32_t)(SIM_TAIL_S * PWM_FREQ_HZ), n_settle;
+    int        i;
+
+    id_log = malloc(n_end * sizeof(double));
+    iq_log = malloc(n_end * sizeof(double));
+    *r     = (sim_result_t){0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    m.theta = sim_rand() * 2.0 * M_PI;
+    pmsm_apply(&m, (const uint16_t[3]){PWM_PERIOD_MAX / 2, PWM_PERIOD_MAX / 2, PWM_PERIOD_MAX / 2}, c->vbus);
+
+    motor_foc_init();
+    motor_foc_start(MOTOR_DIR_CW);
+    motor_fw_enable(fw_on);
+    motor_dtc_enable(0);
+    motor_regen_enable(0);
+    motor_cogging_enable(0);
+    foc.id_ref = 0;
+    foc.iq_ref = (int16_t)lround(c->iq / MOTOR_I_BASE_A * 32768.0);
+
+    for(n = 0; n < n_end; n++)
+    {
+        double t     = n * MOTOR_TS_S;
+        double vbus  = (n < n_sag) ? c->vbus : c->vbus_sag;
+        double ratio = (t < SIM_RAMP_S) ? (c->top * t / SIM_RAMP_S) : c->top;
+        double alpha = m.id * cos(m.theta) - m.iq * sin(m.theta);
+        double beta  = m.id * sin(m.theta) + m.iq * cos(m.theta);
+        double ia    = alpha / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+        double ib    = (-0.5 * alpha + sqrt(3.0) / 2.0 * beta) / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+
+        m.we = ratio * w_base;
+
+        /*the angle of the rotor at the sample*/
+        motor_foc_theta_set((uint16_t)lround(fmod(m.theta, 2.0 * M_PI) * 65536.0 / (2.0 * M_PI)));
+        motor_foc_step((int16_t)lround(ia), (int16_t)lround(ib));
+        for(i = 0; i < 3; i++)
+        {
+            duty[i] = foc.duty[i];
+        }
+
+        /*sampled at the counter peak, the new duties load at the following underflow*/
+        pmsm_half_period(&m);
+        pmsm_apply(&m, duty, vbus);
+        pmsm_half_period(&m);
+
+        id_log[n] = m.id;
+        iq_log[n] = m.iq;
+        r->i_max  = fmax(r->i_max, sqrt(m.id * m.id + m.iq * m.iq));
+        r->id_min = fmin(r->id_min, m.id);
+        if((r->onset == 0.0) && (fw.id * MOTOR_I_BASE_A / 32768.0 < SIM_ONSET_A))
+        {
+            r->onset = ratio;
+        }
+        if(n >= n_tail)
+        {
+            id_hist_min = fmin(id_hist_min, m.id);
+            id_hist_max = fmax(id_hist_max, m.id);
+        }
+    }
+
+    /*the q current and id at the end, averaged over the last 10ms against the noise and the ripple*/
+    id_end = 0.0;
+    for(n = n_end - 200; n < n_end; n++)
+    {
+        id_end    += id_log[n] / 200.0;
+        r->iq_end += iq_log[n] / 200.0;
+    }
+    r->id_pp  = id_hist_max - id_hist_min;
+    for(n_settle = n_end; n_settle > n_sag; n_settle--)
+    {
+        if(fabs(id_log[n_settle - 1] - id_end) > SIM_SETTLE_A)
+        {
+            break;
+        }
+    }
+    r->settle_ms = (n_settle - n_sag) * MOTOR_TS_S * 1000.0;
+    free(id_log);
+    free(iq_log);
+}
+
+
+int main(void)
+{
+    static const sim_case_t case_list[] =
+    {
+        {20.0, 20.0, 1.4, 4.0},
+        {20.0, 17.0, 1.4, 4.0},
+        {24.0, 20.0, 1.6, 4.0},
+        {20.0, 17.0, 1.4, 2.0},
+    };
+    double i_lim = FW_I_MAX * MOTOR_I_BASE_A / 32768.0;
+    int fail = 0;
+    uint32_t k;
+
+    printf("bus V    top   iq             fw off   fw on\n");
+    printf("               ref A  reach A iq A     onset  iq A   id min A  |i| max A  settle ms  id p-p A\n");
+    for(k = 0; k < sizeof(case_list) / sizeof(case_list[0]); k++)
+    {
+        const sim_case_t *c = &case_list[k];
+        sim_result_t off, on;
+        double reach = iq_reachable(c->vbus_sag, c->top * base_speed(c->vbus, c->iq), c->iq);
+
+        case_run(c, 0, &off);
+        case_run(c, 1, &on);
+        printf("%2.0f->%2.0f  %.1fx  %4.1f   %5.2f   %+6.2f   %.2fx  %5.2f  %+7.2f   %7.2f    %7.1f    %6.3f\n",
+               c->vbus, c->vbus_sag, c->top, c->iq, reach, off.iq_end, on.onset, on.iq_end, on.id_min, on.i_max,
+               on.settle_ms, on.id_pp);
+        fail |= (on.iq_end < SIM_IQ_MIN * reach) || (on.i_max > SIM_I_OVER * i_lim)
+              || (on.settle_ms > SIM_SETTLE_MAX_MS) || (on.id_pp > SIM_PP_MAX_A);
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
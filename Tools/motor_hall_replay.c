@@ -0,0 +1,445 @@
+/**
+ * @file motor_hall_replay.c
+ * @brief Host tool: hall sequence replay through the six-step commutation of motor_six_step.c
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -o motor_hall_replay motor_hall_replay.c host/host_mcu.c ../Source/Motor/motor_six_step.c \
+ *       ../Source/Bsp/bsp_pwm.c ../Libraries/Lib/src/{misc,n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_hall_replay
+ *
+ * The firmware module runs unchanged on host registers. A hall edge is
+ * replayed as the hardware does it: the COM event moves the preloaded
+ * CCMOD1/CCMOD2/CCEN to the outputs (here: a copy of the registers), then the
+ * COM interrupt calls motor_six_step_commutate(HALL_STATE_READ()) as
+ * motor_ctrl does, which preloads the next sector.
+ *
+ * Every applied pattern is decoded per phase (PWM / low / floating) and
+ * checked against the rotor: the hall sensors give the rotor sector in the
+ * frame of motor_six_step_angle_sector() (CW hall 5 for -150 ~ -90 degree,
+ * 60 degree per state), and the field of the driven pair (in at the PWM
+ * phase, out at the low phase) has to lead the rotor by 60 ~ 120 degree in
+ * the direction of rotation. Sequences: both directions from every start
+ * state, a contact bounce, a missed edge and the invalid states 0 / 7
+ * (counted in hall_err_cnt, the outputs go off from the edge after). The
+ * exit code is 1 on any wrong pattern, on a sequence that does not recover
+ * or on a wrong count.
+ *
+ * The cost of one commutation is measured with DWT->CYCCNT around the call,
+ * which reads the host clock here (host/core_cm4.h): the numbers compare
+ * hall states with each other, they are not Cortex-M4 cycles.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "bsp_pwm.h"
+#include "bsp_hall.h"
+#include "motor_six_step.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_DUTY                        (PWM_PERIOD_MAX / 2)
+#define SIM_TIMING_CALLS                (200000)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef enum
+{
+    OUT_FLOAT = 0,
+    OUT_LOW,
+    OUT_PWM,
+    OUT_BAD,
+}out_e;
+
+typedef struct
+{
+    uint16_t ccmod1;
+    uint16_t ccmod2;
+    uint32_t ccen;
+}applied_t;
+
+/* CW hall sequence from -150 degree, 60 degree per state, as motor_six_step_angle_sector() */
+static const uint8_t hall_of_sector[SIX_STEP_SECTORS] = {5, 4, 6, 2, 3, 1};
+static const char *out_name[] = {"float", "low", "pwm", "bad"};
+
+static applied_t applied;
+static int       fail;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief the hall lines as the sensors see them at a rotor sector
+ *
+ * @param[in] hall: hall state, bit0 = A (PB6)
+ * @return None
+ */
+static void hall_set(uint8_t hall)
+{
+    HALL_A_GPIO->PID = (HALL_A_GPIO->PID & ~(0x07UL << 6)) | ((uint32_t)hall << 6);
+}
+
+
+/**
+ * @brief COM event: the preloaded pattern goes to the outputs
+ *
+ * @param[in] None
+ * @return None
+ */
+static void com_event(void)
+{
+    applied.ccmod1 = (uint16_t)PWM_TIM->CCMOD1;
+    applied.ccmod2 = (uint16_t)PWM_TIM->CCMOD2;
+    applied.ccen   = PWM_TIM->CCEN;
+}
+
+
+/**
+ * @brief the software COM of motor_six_step_start(): the start sector, preloaded before the next one
+ *
+ * @param[in] dir: rotation direction
+ * @param[in] sector: start sector
+ * @return None
+ */
+static void start_applied(motor_dir_e dir, int sector)
+{
+    const six_step_pattern_t *p = motor_six_step_pattern_get(dir, hall_of_sector[sector]);
+
+    applied.ccmod1 = p->ccmod1;
+    applied.ccmod2 = p->ccmod2;
+    applied.ccen   = p->ccen;
+}
+
+
+/**
+ * @brief hall edge: COM event, then the COM interrupt as motor_ctrl_hall_com_isr()
+ *
+ * @param[in] hall: the new hall state
+ * @return None
+ */
+static void hall_edge(uint8_t hall)
+{
+    hall_set(hall);
+    com_event();
+    motor_six_step_commutate(HALL_STATE_READ());
+}
+
+
+/**
+ * @brief output of one phase in the applied pattern
+ *
+ * @param[in] ph: PHASE_U / PHASE_V / PHASE_W
+ * @return out_e
+ */
+static out_e phase_out(int ph)
+{
+    uint32_t en   = (applied.ccen >> (4 * ph)) & (TIM_CCEN_CC1EN | TIM_CCEN_CC1NEN);
+    uint16_t mode = (ph == PHASE_W) ? applied.ccmod2 : (uint16_t)(applied.ccmod1 >> (8 * ph));
+
+    mode &= TIM_CCMOD1_OC1M;
+    if(en == 0)
+    {
+        return OUT_FLOAT;
+    }
+    if(en != (TIM_CCEN_CC1EN | TIM_CCEN_CC1NEN))
+    {
+        return OUT_BAD;
+    }
+    if(mode == TIM_OCMODE_PWM1)
+    {
+        return OUT_PWM;
+    }
+    return (mode == TIM_FORCED_ACTION_INACTIVE) ? OUT_LOW : OUT_BAD;
+}
+
+
+/**
+ * @brief field angle of the applied pattern, current in at the pwm phase and out at the low phase
+ *
+ * @param[out] deg: field angle, degree, alpha axis on phase U
+ * @return 0: all off, 1: one pwm, one low and one floating phase, -1: anything else
+ */
+static int pattern_field(int *deg)
+{
+    int hi = -1, lo = -1, off = 0, ph;
+    double x, y;
+
+    for(ph = PHASE_U; ph <= PHASE_W; ph++)
+    {
+        switch(phase_out(ph))
+        {
+            case OUT_PWM:   hi = (hi < 0) ? ph : 9; break;
+            case OUT_LOW:   lo = (lo < 0) ? ph : 9; break;
+            case OUT_FLOAT: off++;                  break;
+            default:        return -1;
+        }
+    }
+    if(off == 3)
+    {
+        return 0;
+    }
+    if((hi < 0) || (lo < 0) || (hi > 2) || (lo > 2) || (off != 1))
+    {
+        return -1;
+    }
+    /*unit vector of the hi phase axis minus the one of the lo phase axis*/
+    x = cos(hi * 2.0 * M_PI / 3.0) - cos(lo * 2.0 * M_PI / 3.0);
+    y = sin(hi * 2.0 * M_PI / 3.0) - sin(lo * 2.0 * M_PI / 3.0);
+    *deg = ((int)lround(atan2(y, x) * 180.0 / M_PI) + 360) % 360;
+    return 1;
+}
+
+
+/**
+ * @brief check the applied pattern against the rotor sector
+ *
+ * @param[in] what: sequence name for the report
+ * @param[in] dir: rotation direction
+ * @param[in] sector: rotor sector 0 ~ 5, -1 for an invalid hall state (all off expected)
+ * @return 1 when the pattern is right
+ */
+static int pattern_check(const char *what, motor_dir_e dir, int sector)
+{
+    int field = 0;
+    int r     = pattern_field(&field);
+    int lead;
+
+    if(sector < 0)
+    {
+        if(r == 0)
+        {
+            return 1;
+        }
+        printf("  %s: invalid hall state, outputs not off\n", what);
+        return 0;
+    }
+    if(r != 1)
+    {
+        printf("  %s: sector %d, U %s V %s W %s\n", what, sector, out_name[phase_out(PHASE_U)],
+               out_name[phase_out(PHASE_V)], out_name[phase_out(PHASE_W)]);
+        return 0;
+    }
+    /*lead over the sector centre (-120 + 60 * sector), positive in the direction of rotation*/
+    lead = field - (-120 + 60 * sector);
+    lead = (dir == MOTOR_DIR_CW) ? lead : -lead;
+    lead = ((lead % 360) + 540) % 360 - 180;
+    if((lead < 60) || (lead > 120))
+    {
+        printf("  %s: sector %d, field %d degree, lead %d degree\n", what, sector, field, lead);
+        return 0;
+    }
+    return 1;
+}
+
+
+/**
+ * @brief start in a sector and turn through [edges] hall edges
+ *
+ * @param[in] dir: rotation direction
+ * @param[in] start: start sector
+ * @param[in] edges: number of edges
+ * @return number of wrong patterns
+ */
+static int replay_turn(motor_dir_e dir, int start, int edges)
+{
+    int step   = (dir == MOTOR_DIR_CW) ? 1 : SIX_STEP_SECTORS - 1;
+    int sector = start;
+    int errors = 0;
+    int k;
+    char what[48];
+
+    motor_six_step_init();
+    hall_set(hall_of_sector[sector]);
+    motor_six_step_start(dir, SIM_DUTY);
+    start_applied(dir, sector);
+    snprintf(what, sizeof(what), "%s start %d", (dir == MOTOR_DIR_CW) ? "CW" : "CCW", start);
+    errors += !pattern_check(what, dir, sector);
+
+    for(k = 0; k < edges; k++)
+    {
+        sector = (sector + step) % SIX_STEP_SECTORS;
+        hall_edge(hall_of_sector[sector]);
+        snprintf(what, sizeof(what), "%s start %d edge %d", (dir == MOTOR_DIR_CW) ? "CW" : "CCW", start, k);
+        errors += !pattern_check(what, dir, sector);
+    }
+    if(six_step.com_cnt != (uint32_t)(edges + 1) || (six_step.hall_err_cnt != 0))
+    {
+        printf("  %s: com_cnt %u hall_err_cnt %u\n", what, (unsigned)six_step.com_cnt, (unsigned)six_step.hall_err_cnt);
+        errors++;
+    }
+    return errors;
+}
+
+
+/**
+ * @brief a disturbed sequence: the patterns applied on each edge, with the lead they give
+ *
+ * @param[in] name: report name
+ * @param[in] seq: rotor sectors after each edge, -1: invalid hall state 0, -2: invalid hall state 7
+ *                 (reported as on / off, the rotor angle is unknown there)
+ * @param[in] n: number of edges
+ * @param[out] worst: largest lead error against the 60 ~ 120 degree window, degree
+ * @return sector count after which the patterns are right again, -1 if never
+ */
+static int replay_disturbed(const char *name, const int *seq, int n, int *worst)
+{
+    int sector = seq[0];
+    int good   = -1;
+    int k;
+
+    *worst = 0;
+    motor_six_step_init();
+    hall_set(hall_of_sector[sector]);
+    motor_six_step_start(MOTOR_DIR_CW, SIM_DUTY);
+    start_applied(MOTOR_DIR_CW, sector);
+
+    printf("%-10s", name);
+    for(k = 1; k < n; k++)
+    {
+        int field = 0;
+        int r;
+
+        hall_edge((seq[k] >= 0) ? hall_of_sector[seq[k]] : ((seq[k] == -1) ? 0 : 7));
+        r = pattern_field(&field);
+        if(seq[k] < 0)
+        {
+            /*the pattern preloaded on the edge before goes on, the state only stops the next one*/
+            printf("  [%d]%s", (seq[k] == -1) ? 0 : 7, (r == 0) ? "off" : "on");
+            good = -1;
+            continue;
+        }
+        if(r == 1)
+        {
+            int lead = ((field - (-120 + 60 * seq[k])) % 360 + 540) % 360 - 180;
+            int err  = (lead < 60) ? 60 - lead : ((lead > 120) ? lead - 120 : 0);
+
+            printf("  %d:%+d", seq[k], lead);
+            *worst = (err > *worst) ? err : *worst;
+            good   = (err == 0) ? ((good < 0) ? k : good) : -1;
+        }
+        else
+        {
+            printf("  %d:off", seq[k]);
+            good = -1;
+        }
+    }
+    printf("\n");
+    return good;
+}
+
+
+/**
+ * @brief cost of one commutation per hall state, DWT->CYCCNT (host clock) around a batch
+ *
+ * @param[out] ns: per hall state, ns per commutation
+ * @return None
+ */
+static void commutate_timing(double ns[SIX_STEP_HALL_STATES])
+{
+    int h;
+
+    six_step.dir = MOTOR_DIR_CW;
+    for(h = 0; h < SIX_STEP_HALL_STATES; h++)
+    {
+        double best = 1e9;
+        int    rep;
+
+        for(rep = 0; rep < 5; rep++)
+        {
+            uint32_t start = DWT->CYCCNT;
+            int      i;
+
+            for(i = 0; i < SIM_TIMING_CALLS; i++)
+            {
+                motor_six_step_commutate((uint8_t)h);
+            }
+            best = ((double)(DWT->CYCCNT - start) < best) ? (double)(DWT->CYCCNT - start) : best;
+        }
+        ns[h] = best / SIM_TIMING_CALLS;
+    }
+}
+
+
+int main(void)
+{
+    static const int bounce[]  = {0, 1, 2, 1, 2, 3, 4};
+    static const int missed[]  = {0, 1, 3, 4, 5, 0};
+    static const int invalid[] = {0, 1, -1, 2, -2, 2, 3, 4};
+    double ns[SIX_STEP_HALL_STATES];
+    int    errors = 0;
+    int    worst;
+    int    good;
+    int    s;
+    int    h;
+
+    /*both directions, every start sector, two turns*/
+    for(s = 0; s < SIX_STEP_SECTORS; s++)
+    {
+        errors += replay_turn(MOTOR_DIR_CW, s, 2 * SIX_STEP_SECTORS);
+        errors += replay_turn(MOTOR_DIR_CCW, s, 2 * SIX_STEP_SECTORS);
+    }
+    printf("clean sequences: 2 directions x 6 start sectors x 12 edges, %d wrong patterns\n", errors);
+    fail |= (errors != 0);
+
+    /*the table itself: every valid hall state of each direction, any order*/
+    for(h = 0; h < SIX_STEP_HALL_STATES; h++)
+    {
+        motor_dir_e dir;
+
+        for(dir = MOTOR_DIR_CW; dir < MOTOR_DIR_MAX; dir++)
+        {
+            const six_step_pattern_t *p = motor_six_step_pattern_get(dir, (uint8_t)h);
+            char what[32];
+
+            applied.ccmod1 = p->ccmod1;
+            applied.ccmod2 = p->ccmod2;
+            applied.ccen   = p->ccen;
+            for(s = 0; (s < SIX_STEP_SECTORS) && (hall_of_sector[s] != h); s++);
+            snprintf(what, sizeof(what), "table %s hall %d", (dir == MOTOR_DIR_CW) ? "CW" : "CCW", h);
+            fail |= !pattern_check(what, dir, (s < SIX_STEP_SECTORS) ? s : -1);
+            if((applied.ccmod2 & 0xFF00) != (PWM_CCMOD2_CH4_CFG & 0xFF00)
+               || (applied.ccen & (TIM_CCEN_CC4EN | TIM_CCEN_CC5EN)) != (PWM_CCEN_CH4_CFG | PWM_CCEN_CH5_CFG))
+            {
+                printf("  %s: channel 4/5 setting changed\n", what);
+                fail = 1;
+            }
+        }
+    }
+
+    /*disturbed CW sequences, rotor sector after each edge and the lead over its centre*/
+    printf("\ndisturbed CW sequences, sector:lead degree (60 ~ 120 is right)\n");
+    good = replay_disturbed("bounce", bounce, sizeof(bounce) / sizeof(bounce[0]), &worst);
+    printf("          worst %d degree off, right again from edge %d\n", worst, good);
+    fail |= (good < 0);
+    good = replay_disturbed("missed", missed, sizeof(missed) / sizeof(missed[0]), &worst);
+    printf("          worst %d degree off, right again from edge %d\n", worst, good);
+    fail |= (good < 0);
+    good = replay_disturbed("invalid", invalid, sizeof(invalid) / sizeof(invalid[0]), &worst);
+    printf("          worst %d degree off, right again from edge %d, hall_err_cnt %u\n",
+           worst, good, (unsigned)six_step.hall_err_cnt);
+    fail |= (good < 0) || (six_step.hall_err_cnt != 2);
+
+    /*cost per commutation*/
+    commutate_timing(ns);
+    printf("\nmotor_six_step_commutate(), host ns per call:");
+    for(h = 0; h < SIX_STEP_HALL_STATES; h++)
+    {
+        printf(" [%d] %.2f", h, ns[h]);
+    }
+    printf("\n");
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,419 @@
+/**
+ * @file motor_hall_sim.c
+ * @brief Host tool: motor_hall_sin.c on hall edges of a rotor run through a speed profile
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_hall_sim motor_hall_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_hall_sim
+ *
+ * Kinematic: the rotor follows the speed profile, no motor model. It goes
+ * from standstill to SIM_RPM_MAX and back to standstill at SIM_ACCEL_RPM_S,
+ * with SIM_HOLD_S at the top. The hall timer is emulated tick by tick (1MHz):
+ * every change of the hall state captures the counter and restarts it, the
+ * capture interrupt hands the interval to motor_hall_speed_edge_isr() and the
+ * COM interrupt that follows calls motor_hall_sin_com_isr(), as on the
+ * target. A counter overflow calls motor_hall_speed_timeout_isr(). Every pwm
+ * period motor_hall_sin_pwm_isr() reads the counter.
+ *
+ * The hall states change at -30 + 60 * k degree of the rotor d axis, as
+ * motor_hall_sin.c expects. While the drive is sinusoidal the error of
+ * hall_sin.theta against the rotor angle is taken at every pwm period. The
+ * speeds where the drive switches to sinusoidal and back are given. Both
+ * directions, with ideal halls and again with the edges off by sim_place
+ * (+-4 degree) and every SIM_BOUNCE_EVERY th edge bouncing: the line goes
+ * back to the old state SIM_BOUNCE_AT ticks after the edge for
+ * SIM_BOUNCE_WIDTH ticks, two more edges for both interrupts.
+ *
+ * Then motor_hall_speed alone at constant speeds, with the placement errors,
+ * without and with bounces: the published speed against the true one over
+ * SIM_MEASURE_S, after SIM_SETTLE_S and two mechanical turns.
+ *
+ * The exit code is 1 when:
+ * - the angle error is over SIM_ERR_MAX_DEG (4 degree more with the
+ *   placement errors)
+ * - the drive switches to sinusoidal below HALL_SIN_ENTER_RPM or 30% above
+ *   it (six edges have to pass), back below 30% under HALL_SIN_EXIT_RPM or
+ *   above it, or more than once each way; SIM_PLACE_TOL more on both sides
+ *   with the placement errors, the period method reads them
+ * - a bounce is not rejected as two glitches, or changes the speed read
+ * - the count method is off by more than SIM_COUNT_ERR_MAX from 1000rpm
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "n32g43x.h"
+#include "bsp_pwm.h"
+#include "bsp_hall.h"
+#include "motor_param.h"
+#include "motor_six_step.h"
+#include "motor_hall_speed.h"
+#include "motor_hall_sin.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_RPM_MAX                     (1500.0)
+#define SIM_ACCEL_RPM_S                 (1450.0)
+#define SIM_HOLD_S                      (0.2)
+#define SIM_TICKS_PER_PERIOD            (HALL_TIM_FREQ_HZ / PWM_FREQ_HZ)
+#define SIM_V_REF                       (Q15(0.3f))
+
+#define SIM_BOUNCE_EVERY                (3)
+#define SIM_BOUNCE_AT                   (10)                    // ticks after the edge
+#define SIM_BOUNCE_WIDTH                (3)                     // ticks
+
+#define SIM_SETTLE_S                    (0.2)                   // and two mechanical turns
+#define SIM_MEASURE_S                   (0.5)
+#define SIM_COUNT_ERR_MAX               (0.5)                   // %, count method
+
+#define SIM_ERR_MAX_DEG                 (10.0)
+#define SIM_SWITCH_TOL                  (0.3)
+#define SIM_PLACE_TOL                   (0.15)                  // period method speed error from the placement
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    double   theta;                     /*rotor d axis, electrical, degree, not wrapped*/
+    double   rpm;                       /*signed*/
+    uint8_t  hall;                      /*state of the rotor angle*/
+    uint8_t  line;                      /*state on the hall lines, differs during a bounce*/
+    uint32_t cnt;                       /*hall timer counter*/
+    uint32_t edges;
+    uint32_t bounce_tick;               /*ticks since the edge that bounces, 0: none*/
+    uint8_t  bounce_hall;               /*state before that edge*/
+    const double *place;                /*hall edge placement errors, degree, NULL: none*/
+    uint8_t  bounce;                    /*1: every SIM_BOUNCE_EVERY th edge bounces*/
+    uint32_t bounces;
+}sim_rotor_t;
+
+typedef struct
+{
+    double   err_max;                   /*degree, while sinusoidal*/
+    double   err_rms;
+    double   enter_rpm;                 /*first switch to sinusoidal*/
+    double   exit_rpm;                  /*last switch back to six-step*/
+    uint32_t sine_cnt;
+    uint32_t fallback_cnt;
+}sim_result_t;
+
+typedef struct
+{
+    double   truth;                     /*angle steps per pwm period*/
+    double   mean;                      /*of the published speed*/
+    double   err_mean;                  /*mean of |error|, %*/
+    double   err_max;
+    uint8_t  count;                     /*count method at the end*/
+    uint32_t bounces;
+    uint32_t glitches;
+}sim_speed_t;
+
+/* hall state of sector k, -30 + 60 * k degree, as motor_hall_sin.c */
+static const uint8_t sim_hall_of_sector[SIX_STEP_SECTORS] = {6, 2, 3, 1, 5, 4};
+
+/* error of the edge into sector k, degree: +-4, nothing on average (that is the calibration offset) */
+static const double sim_place[SIX_STEP_SECTORS] = {4.0, -2.5, 1.0, -4.0, 3.0, -1.5};
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief the hall state at a rotor angle
+ *
+ * @param[in] theta: rotor d axis, electrical, degree
+ * @param[in] place: edge placement errors, degree, NULL: none
+ * @return hall state, bit0 = A
+ */
+static uint8_t sim_hall_of(double theta, const double *place)
+{
+    double a = fmod(theta + 30.0, 360.0);
+    int k, i;
+
+    a = (a < 0.0) ? (a + 360.0) : a;
+    k = (int)(a / 60.0) % SIX_STEP_SECTORS;
+    if(place != NULL)
+    {
+        /*the last edge passed, before the first one still in the sector of the turn before*/
+        k = SIX_STEP_SECTORS - 1;
+        for(i = 0; i < SIX_STEP_SECTORS; i++)
+        {
+            k = (a >= 60.0 * i + place[i]) ? i : k;
+        }
+        k = (a >= 360.0 + place[0]) ? 0 : k;
+    }
+    return sim_hall_of_sector[k];
+}
+
+
+/**
+ * @brief the hall lines as the sensors see them
+ *
+ * @param[in] hall: hall state, bit0 = A (PB6)
+ * @return None
+ */
+static void sim_hall_set(uint8_t hall)
+{
+    HALL_A_GPIO->PID = (HALL_A_GPIO->PID & ~(0x07UL << 6)) | ((uint32_t)hall << 6);
+}
+
+
+/**
+ * @brief one hall timer tick: the rotor moves, an edge on the lines captures and restarts the counter
+ *
+ * @param[in,out] r: rotor
+ * @return None
+ */
+static void sim_tick(sim_rotor_t *r)
+{
+    uint8_t hall;
+    uint8_t line;
+
+    r->theta += r->rpm * MOTOR_POLE_PAIRS * 360.0 / 60.0 / HALL_TIM_FREQ_HZ;
+    hall      = sim_hall_of(r->theta, r->place);
+    if(hall != r->hall)
+    {
+        r->edges++;
+        r->bounce_hall = r->hall;
+        r->bounce_tick = ((r->bounce != 0) && ((r->edges % SIM_BOUNCE_EVERY) == 0)) ? 1 : 0;
+        r->bounces    += r->bounce_tick;
+        r->hall        = hall;
+    }
+
+    /*a bounce: back to the state before for a few ticks, shortly after the edge*/
+    line = r->hall;
+    if(r->bounce_tick != 0)
+    {
+        line = ((r->bounce_tick >= SIM_BOUNCE_AT) && (r->bounce_tick < SIM_BOUNCE_AT + SIM_BOUNCE_WIDTH)) ? r->bounce_hall : line;
+        r->bounce_tick = (r->bounce_tick < SIM_BOUNCE_AT + SIM_BOUNCE_WIDTH) ? (r->bounce_tick + 1) : 0;
+    }
+
+    r->cnt++;
+    if(r->cnt > 0xFFFF)
+    {
+        r->cnt = 0;
+        motor_hall_speed_timeout_isr();
+    }
+    if(line != r->line)
+    {
+        r->line = line;
+        sim_hall_set(line);
+        motor_hall_speed_edge_isr(line, (uint16_t)r->cnt);
+        r->cnt = 0;
+        motor_hall_sin_com_isr();
+    }
+    HALL_TIM->CNT = r->cnt;
+}
+
+
+/**
+ * @brief rotor at standstill, the hall interface, the speed measurement and the drive started
+ *
+ * @param[out] r: rotor
+ * @param[in] dir: rotation direction
+ * @param[in] place: hall edge placement errors, degree, NULL: none
+ * @param[in] bounce: 1: every SIM_BOUNCE_EVERY th edge bounces
+ * @return None
+ */
+static void sim_start(sim_rotor_t *r, motor_dir_e dir, const double *place, uint8_t bounce)
+{
+    r->theta       = 15.0 + 360.0 * ((dir == MOTOR_DIR_CW) ? 0.37 : 0.81);
+    r->rpm         = 0.0;
+    r->place       = place;
+    r->bounce      = bounce;
+    r->hall        = sim_hall_of(r->theta, place);
+    r->line        = r->hall;
+    r->cnt         = 0;
+    r->edges       = 0;
+    r->bounces     = 0;
+    r->bounce_tick = 0;
+    sim_hall_set(r->hall);
+
+    motor_six_step_init();
+    motor_hall_speed_init();
+    motor_hall_sin_init();
+    motor_hall_sin_voltage_set(SIM_V_REF);
+    motor_hall_sin_start(dir);
+}
+
+
+/**
+ * @brief the profile in one direction
+ *
+ * @param[in] dir: rotation direction
+ * @param[in] place: hall edge placement errors, degree, NULL: none
+ * @param[in] bounce: 1: every SIM_BOUNCE_EVERY th edge bounces
+ * @param[out] res: result
+ * @return None
+ */
+static void sim_run(motor_dir_e dir, const double *place, uint8_t bounce, sim_result_t *res)
+{
+    double sign   = (dir == MOTOR_DIR_CW) ? 1.0 : -1.0;
+    double t_ramp = SIM_RPM_MAX / SIM_ACCEL_RPM_S;
+    double t_end  = 2.0 * t_ramp + SIM_HOLD_S;
+    double err_sum = 0.0;
+    uint32_t n, k, n_err = 0;
+    sim_rotor_t r;
+    hall_sin_state_e state;
+
+    *res = (sim_result_t){0.0, 0.0, -1.0, -1.0, 0, 0};
+    sim_start(&r, dir, place, bounce);
+
+    for(n = 0; n < (uint32_t)(t_end * PWM_FREQ_HZ); n++)
+    {
+        double t = (double)n / PWM_FREQ_HZ;
+
+        r.rpm = sign * SIM_ACCEL_RPM_S * fmin(fmin(t, t_ramp), t_end - t);
+        state = hall_sin.state;
+        for(k = 0; k < SIM_TICKS_PER_PERIOD; k++)
+        {
+            sim_tick(&r);
+        }
+        motor_hall_sin_pwm_isr();
+
+        if((state != HALL_SIN_STATE_SINE) && (hall_sin.state == HALL_SIN_STATE_SINE) && (res->enter_rpm < 0.0))
+        {
+            res->enter_rpm = fabs(r.rpm);
+        }
+        if((state == HALL_SIN_STATE_SINE) && (hall_sin.state != HALL_SIN_STATE_SINE))
+        {
+            res->exit_rpm = fabs(r.rpm);
+        }
+        if(hall_sin.state == HALL_SIN_STATE_SINE)
+        {
+            double e = fmod(hall_sin.theta * 360.0 / 65536.0 - r.theta, 360.0);
+
+            e = (e < -180.0) ? (e + 360.0) : ((e >= 180.0) ? (e - 360.0) : e);
+            res->err_max = fmax(res->err_max, fabs(e));
+            err_sum     += e * e;
+            n_err++;
+        }
+    }
+    res->err_rms      = sqrt(err_sum / ((n_err != 0) ? n_err : 1));
+    res->sine_cnt     = hall_sin.sine_cnt;
+    res->fallback_cnt = hall_sin.fallback_cnt;
+    motor_hall_sin_stop();
+}
+
+
+/**
+ * @brief constant speed: the published speed against the true one at every pwm period
+ *
+ * @param[in] rpm: speed, CW
+ * @param[in] place: hall edge placement errors, degree, NULL: none
+ * @param[in] bounce: 1: every SIM_BOUNCE_EVERY th edge bounces
+ * @param[out] res: result
+ * @return None
+ */
+static void sim_speed(double rpm, const double *place, uint8_t bounce, sim_speed_t *res)
+{
+    double truth = rpm * MOTOR_POLE_PAIRS * 65536.0 / 60.0 / PWM_FREQ_HZ;
+    double sum = 0.0, err_sum = 0.0;
+    uint32_t n, k, n_settle, n_measure;
+    sim_rotor_t r;
+
+    sim_start(&r, MOTOR_DIR_CW, place, bounce);
+    r.rpm     = rpm;
+    n_settle  = (uint32_t)((SIM_SETTLE_S + 2.0 * 60.0 / rpm) * PWM_FREQ_HZ);
+    n_measure = (uint32_t)(SIM_MEASURE_S * PWM_FREQ_HZ);
+    res->err_max = 0.0;
+
+    for(n = 0; n < n_settle + n_measure; n++)
+    {
+        double v, e;
+
+        for(k = 0; k < SIM_TICKS_PER_PERIOD; k++)
+        {
+            sim_tick(&r);
+        }
+        if(n < n_settle)
+        {
+            continue;
+        }
+        v             = motor_hall_speed_snap()->speed_q8 / 256.0;
+        e             = fabs(v - truth) / truth * 100.0;
+        sum          += v;
+        err_sum      += e;
+        res->err_max  = fmax(res->err_max, e);
+    }
+    res->truth    = truth;
+    res->mean     = sum / n_measure;
+    res->err_mean = err_sum / n_measure;
+    res->count    = hall_speed.count_mode;
+    res->bounces  = r.bounces;
+    res->glitches = hall_speed.glitch_cnt;
+    motor_hall_sin_stop();
+}
+
+
+int main(void)
+{
+    static const char *dir_name[MOTOR_DIR_MAX] = {"CW", "CCW"};
+    static const double rpm_list[] = {100.0, 200.0, 300.0, 500.0, 700.0, 800.0, 1000.0, 1500.0, 3000.0};
+    double mean_sum = 0.0;
+    uint32_t mean_n = 0;
+    int fail = 0;
+    int d, b;
+    uint32_t k;
+
+    printf("0 -> %.0f -> 0 rpm at %.0f rpm/s\n", SIM_RPM_MAX, SIM_ACCEL_RPM_S);
+    printf("halls                  dir   angle error deg    sine at   six-step at   switches\n");
+    printf("                             max     rms        rpm       rpm           sine / back\n");
+    for(b = 0; b < 2; b++)
+    {
+        for(d = 0; d < MOTOR_DIR_MAX; d++)
+        {
+            sim_result_t res;
+            double tol;
+
+            sim_run((motor_dir_e)d, (b == 0) ? NULL : sim_place, (uint8_t)b, &res);
+            printf("%-22s %-4s  %5.2f   %5.2f      %5.0f     %5.0f         %u / %u\n",
+                   (b == 0) ? "ideal" : "+-4 deg, bouncing", dir_name[d], res.err_max, res.err_rms,
+                   res.enter_rpm, res.exit_rpm, res.sine_cnt, res.fallback_cnt);
+            tol   = (b == 0) ? 0.0 : SIM_PLACE_TOL;
+            fail |= (res.err_max > SIM_ERR_MAX_DEG + ((b == 0) ? 0.0 : 4.0)) || (res.sine_cnt != 1) || (res.fallback_cnt != 1);
+            fail |= (res.enter_rpm < (1.0 - tol) * HALL_SIN_ENTER_RPM);
+            fail |= (res.enter_rpm > (1.0 + SIM_SWITCH_TOL + tol) * HALL_SIN_ENTER_RPM);
+            fail |= (res.exit_rpm > (1.0 + tol) * HALL_SIN_EXIT_RPM);
+            fail |= (res.exit_rpm < (1.0 - SIM_SWITCH_TOL - tol) * HALL_SIN_EXIT_RPM);
+        }
+    }
+
+    printf("\nspeed, +-4 deg placement, %%: clean / bouncing\n");
+    printf("rpm     true steps   read steps        mean error      worst error     method   bounces / glitches\n");
+    for(k = 0; k < sizeof(rpm_list) / sizeof(rpm_list[0]); k++)
+    {
+        sim_speed_t c, g;
+
+        sim_speed(rpm_list[k], sim_place, 0, &c);
+        sim_speed(rpm_list[k], sim_place, 1, &g);
+        printf("%5.0f   %8.2f     %8.2f %8.2f   %5.2f / %5.2f   %5.2f / %5.2f   %s    %u / %u\n", rpm_list[k], c.truth,
+               c.mean, g.mean, c.err_mean, g.err_mean, c.err_max, g.err_max, c.count ? "count " : "period", g.bounces, g.glitches);
+        fail |= (g.glitches != 2 * g.bounces) || (fabs(g.mean - c.mean) > 1e-3 * c.truth) || (fabs(g.err_max - c.err_max) > 0.01);
+        fail |= (rpm_list[k] >= 1000.0) && (c.err_max > SIM_COUNT_ERR_MAX);
+        if(rpm_list[k] >= HALL_SIN_ENTER_RPM)
+        {
+            mean_sum += c.err_mean;
+            mean_n++;
+        }
+    }
+    printf("mean error from %d rpm up: %.2f%%\n", HALL_SIN_ENTER_RPM, mean_sum / mean_n);
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,285 @@
+/**
+ * @file motor_hfi_sim.c
+ * @brief Host tool: convergence of the injection tracker of motor_hfi.c on a salient PMSM model
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_hfi_sim motor_hfi_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_hfi_sim
+ *
+ * The current loop of the firmware runs through motor_foc_step() with
+ * FOC_THETA_HFI: the carrier on vd, the demodulation on the raw samples, the
+ * PI on the carrier free current. After every step the angle of the next
+ * period is taken from the tracker, as motor_foc_theta_update() does. The
+ * motor is the dq model of motor_param.h (Ld 0.45mH, Lq 0.6mH) turned at a
+ * constant speed by the load, 24V. The timing is the one of bsp_pwm.c: the
+ * currents sampled at the counter peak with 3 LSB rms of noise, the duties
+ * computed on them loaded at the next underflow, half a period later.
+ *
+ * Every case starts the tracker off the rotor d axis, both signs, with a q
+ * current reference and a speed. It converges when the error stays under 5
+ * degree, the time of the last sample over it is given. The error over the
+ * last 100ms of the 300ms run is the steady state one. A start close to 90
+ * degree is on the edge of the opposite axis (the saliency repeats every 180
+ * degree). The tracker starts at zero speed, so a rotor turning away from it
+ * adds to a negative start error, 300rpm is 36 degree in 5ms. Starts past
+ * SIM_ERR0_SURE_DEG() are listed but not checked. The exit code is 1 when a
+ * checked case does not converge within 25ms, locks on the opposite axis or
+ * goes over 2 degree from its mean in the steady state.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "motor_param.h"
+#include "motor_foc.h"
+#include "motor_hfi.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_VBUS_V                      (24.0)
+#define SIM_NOISE_LSB                   (3.0)
+#define SIM_SUBSTEPS                    (20)
+#define SIM_PERIODS                     (6000)                  // 300ms
+#define SIM_STEADY_PERIODS              (2000)                  // the last 100ms
+
+#define SIM_CONV_DEG                    (5.0)
+#define SIM_CONV_MAX_MS                 (25.0)
+#define SIM_STEADY_MAX_DEG              (2.0)                   // around the mean
+#define SIM_ERR0_SURE_DEG(rpm)          (((rpm) > 100.0) ? 45.0 : 60.0)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad*/
+    double we;                          /*electrical, rad/s*/
+    double v_alpha;                     /*applied this period, V*/
+    double v_beta;
+}sim_pmsm_t;
+
+static uint32_t rand_state = 1;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief angle difference folded to [-180, 180) degree
+ *
+ * @param[in] a: angle, rad
+ * @param[in] b: angle, rad
+ * @return a - b, degree
+ */
+static double sim_angle_diff(double a, double b)
+{
+    double d = fmod(a - b, 2.0 * M_PI);
+
+    d = (d < -M_PI) ? (d + 2.0 * M_PI) : ((d >= M_PI) ? (d - 2.0 * M_PI) : d);
+    return d * 180.0 / M_PI;
+}
+
+
+/**
+ * @brief PMSM over half a pwm period, the voltage is constant in the stator frame
+ *
+ * @param[in,out] m: motor
+ * @return None
+ */
+static void pmsm_half_period(sim_pmsm_t *m)
+{
+    double dt = MOTOR_TS_S / SIM_SUBSTEPS;
+    int k;
+
+    for(k = 0; k < SIM_SUBSTEPS / 2; k++)
+    {
+        double s  = sin(m->theta);
+        double c  = cos(m->theta);
+        double vd = m->v_alpha * c + m->v_beta * s;
+        double vq = -m->v_alpha * s + m->v_beta * c;
+        double did = (vd - MOTOR_RS_OHM * m->id + m->we * MOTOR_LQ_H * m->iq) / MOTOR_LD_H;
+        double diq = (vq - MOTOR_RS_OHM * m->iq - m->we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB)) / MOTOR_LQ_H;
+
+        m->id    += did * dt;
+        m->iq    += diq * dt;
+        m->theta += m->we * dt;
+    }
+}
+
+
+/**
+ * @brief the stator voltage of the three duties
+ *
+ * @param[out] m: motor, applied voltage
+ * @param[in] duty: compare values
+ * @return None
+ */
+static void pmsm_apply(sim_pmsm_t *m, const uint16_t *duty)
+{
+    double v[3];
+    int i;
+
+    for(i = 0; i < 3; i++)
+    {
+        v[i] = ((double)duty[i] / PWM_PERIOD_MAX - 0.5) * SIM_VBUS_V;
+    }
+    m->v_alpha = (2.0 * v[0] - v[1] - v[2]) / 3.0;
+    m->v_beta  = (v[1] - v[2]) / sqrt(3.0);
+}
+
+
+/**
+ * @brief one case from the start of the tracker
+ *
+ * @param[in] err0: start error of the tracker, degree
+ * @param[in] iq_a: q current reference
+ * @param[in] rpm: mechanical speed
+ * @param[out] conv_ms: time of the last error over SIM_CONV_DEG, -1 when still over at the end
+ * @param[out] mean: steady state mean error, degree
+ * @param[out] dev: steady state largest deviation from the mean, degree
+ * @return None
+ */
+static void case_run(double err0, double iq_a, double rpm, double *conv_ms, double *mean, double *dev)
+{
+    sim_pmsm_t m = {0};
+    uint16_t   duty[3];
+    double     e_min = 1e9, e_max = -1e9, e_sum = 0.0;
+    uint32_t   n, last_out = 0;
+    int        i;
+
+    m.we    = rpm / 60.0 * 2.0 * M_PI * MOTOR_POLE_PAIRS;
+    m.theta = sim_rand() * 2.0 * M_PI;
+    m.iq    = 0.0;
+    pmsm_apply(&m, (const uint16_t[3]){PWM_PERIOD_MAX / 2, PWM_PERIOD_MAX / 2, PWM_PERIOD_MAX / 2});
+
+    motor_foc_init();
+    motor_foc_start(MOTOR_DIR_CW);
+    motor_fw_enable(0);
+    motor_dtc_enable(0);
+    motor_regen_enable(0);
+    motor_cogging_enable(0);
+    foc.id_ref = 0;
+    foc.iq_ref = (int16_t)lround(iq_a / MOTOR_I_BASE_A * 32768.0);
+    motor_foc_theta_set((uint16_t)lround(fmod(m.theta + err0 * M_PI / 180.0 + 2.0 * M_PI, 2.0 * M_PI) * 65536.0 / (2.0 * M_PI)));
+    motor_foc_theta_src_set(FOC_THETA_HFI);
+
+    for(n = 0; n < SIM_PERIODS; n++)
+    {
+        double alpha = m.id * cos(m.theta) - m.iq * sin(m.theta);
+        double beta  = m.id * sin(m.theta) + m.iq * cos(m.theta);
+        double ia    = alpha / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+        double ib    = (-0.5 * alpha + sqrt(3.0) / 2.0 * beta) / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+        double e;
+
+        /*the step runs on the angle of this period, the tracker sets the next one*/
+        e = sim_angle_diff(foc.theta * 2.0 * M_PI / 65536.0, m.theta);
+        motor_foc_step((int16_t)lround(ia), (int16_t)lround(ib));
+        motor_foc_theta_set(hfi.theta);
+        for(i = 0; i < 3; i++)
+        {
+            duty[i] = foc.duty[i];
+        }
+
+        /*sampled at the counter peak, the new duties load at the following underflow*/
+        pmsm_half_period(&m);
+        pmsm_apply(&m, duty);
+        pmsm_half_period(&m);
+
+        if(fabs(e) > SIM_CONV_DEG)
+        {
+            last_out = n + 1;
+        }
+        if(n >= SIM_PERIODS - SIM_STEADY_PERIODS)
+        {
+            e_min  = fmin(e_min, e);
+            e_max  = fmax(e_max, e);
+            e_sum += e;
+        }
+    }
+    *conv_ms = (last_out >= SIM_PERIODS) ? -1.0 : (last_out * MOTOR_TS_S * 1000.0);
+    *mean    = e_sum / SIM_STEADY_PERIODS;
+    *dev     = fmax(e_max - *mean, *mean - e_min);
+}
+
+
+int main(void)
+{
+    static const double err0_run[] = {30.0, 45.0, 60.0, 80.0};
+    static const double iq_run[]   = {0.0, 4.0, 8.0};
+    static const double rpm_run[]  = {0.0, 100.0, 300.0};
+    int fail = 0;
+    uint32_t e, l, r;
+    int sign;
+
+    printf("start    iq    rpm   converged   steady state degree\n");
+    printf("degree   A           ms          mean    deviation\n");
+    for(e = 0; e < sizeof(err0_run) / sizeof(err0_run[0]); e++)
+    {
+        for(sign = -1; sign <= 1; sign += 2)
+        {
+            for(l = 0; l < sizeof(iq_run) / sizeof(iq_run[0]); l++)
+            {
+                for(r = 0; r < sizeof(rpm_run) / sizeof(rpm_run[0]); r++)
+                {
+                    double conv_ms, mean, dev;
+
+                    case_run(sign * err0_run[e], iq_run[l], rpm_run[r], &conv_ms, &mean, &dev);
+                    printf("%+5.0f  %5.1f  %5.0f   %6.2f      %+7.2f  %6.2f  %s\n",
+                           sign * err0_run[e], iq_run[l], rpm_run[r], conv_ms, mean, dev,
+                           (fabs(mean) > 90.0) ? "opposite axis" : "");
+                    if(err0_run[e] <= SIM_ERR0_SURE_DEG(rpm_run[r]))
+                    {
+                        fail |= (conv_ms < 0.0) || (conv_ms > SIM_CONV_MAX_MS) || (dev > SIM_STEADY_MAX_DEG);
+                    }
+                }
+            }
+        }
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,244 @@
+/**
+ * @file motor_ipd_sim.c
+ * @brief Host tool: motor_ipd.c on a standing motor with a saturating d axis, swept over the rotor angle
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_ipd_sim motor_ipd_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_ipd_sim
+ *
+ * The test runs through motor_ipd_test_start() / motor_ipd_test_step() on the
+ * dq model of motor_param.h at standstill, 24V. The d axis saturates where
+ * its current adds to the magnet flux: the incremental inductance is
+ * Ld / (1 + (id / SIM_I_SAT)^2) for id > 0, Ld below; q stays at Lq. The
+ * currents are sampled at the counter peak with SIM_NOISE_LSB rms of noise,
+ * the duties of a step are applied from the next period, as motor_ipd_adc_isr()
+ * runs on the target.
+ *
+ * The rotor angle is swept over 360 degree in SIM_ANGLE_STEP_DEG, with 6
+ * and 12 pulses: the largest angle error, the polarity (an error under 90
+ * degree), the smallest margin and the time of the test. The current left
+ * after each pulse pair (at the end of its zero vector) is given too. The
+ * exit code is 1 on a wrong polarity or an error over the limit of the
+ * pulse count.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "bsp_pwm.h"
+#include "motor_param.h"
+#include "motor_svpwm.h"
+#include "motor_ipd.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_VBUS_V                      (24.0)
+#define SIM_NOISE_LSB                   (3.0)
+#define SIM_SUBSTEPS                    (20)
+#define SIM_I_SAT                       (10.0)                  // A, d axis saturation
+#define SIM_ANGLE_STEP_DEG              (1.0)
+#define SIM_PERIODS_MAX                 (1000)
+
+#define SIM_ERR_MAX_6                   (15.0)                  // degree
+#define SIM_ERR_MAX_12                  (8.0)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad, the rotor stands*/
+    double v_alpha;                     /*applied, V*/
+    double v_beta;
+}sim_pmsm_t;
+
+typedef struct
+{
+    double   err_max;                   /*degree*/
+    double   err_rms;
+    uint32_t polarity_wrong;
+    int16_t  margin_min;                /*q15*/
+    uint32_t time_us;                   /*longest*/
+    double   i_left_max;                /*A, after a pulse pair*/
+}sim_result_t;
+
+static uint32_t rand_state = 1;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief standing PMSM over half a pwm period, the d axis saturating
+ *
+ * @param[in,out] m: motor
+ * @return None
+ */
+static void pmsm_half_period(sim_pmsm_t *m)
+{
+    double dt = MOTOR_TS_S / SIM_SUBSTEPS;
+    double s  = sin(m->theta);
+    double c  = cos(m->theta);
+    double vd = m->v_alpha * c + m->v_beta * s;
+    double vq = -m->v_alpha * s + m->v_beta * c;
+    int k;
+
+    for(k = 0; k < SIM_SUBSTEPS / 2; k++)
+    {
+        double x  = (m->id > 0.0) ? (m->id / SIM_I_SAT) : 0.0;
+        double ld = MOTOR_LD_H / (1.0 + x * x);
+
+        m->id += (vd - MOTOR_RS_OHM * m->id) / ld * dt;
+        m->iq += (vq - MOTOR_RS_OHM * m->iq) / MOTOR_LQ_H * dt;
+    }
+}
+
+
+/**
+ * @brief the stator voltage of the three duties
+ *
+ * @param[out] m: motor, applied voltage
+ * @param[in] duty: compare values
+ * @return None
+ */
+static void pmsm_apply(sim_pmsm_t *m, const uint16_t *duty)
+{
+    double v[3];
+    int i;
+
+    for(i = 0; i < 3; i++)
+    {
+        v[i] = ((double)duty[i] / PWM_PERIOD_MAX - 0.5) * SIM_VBUS_V;
+    }
+    m->v_alpha = (2.0 * v[0] - v[1] - v[2]) / 3.0;
+    m->v_beta  = (v[1] - v[2]) / sqrt(3.0);
+}
+
+
+/**
+ * @brief one test at a rotor angle
+ *
+ * @param[in] pulses: IPD_PULSES_6 or IPD_PULSES_12
+ * @param[in] theta_deg: rotor angle, electrical
+ * @param[in,out] r: result, accumulated
+ * @return angle error, degree
+ */
+static double sim_test(ipd_pulses_e pulses, double theta_deg, sim_result_t *r)
+{
+    sim_pmsm_t m = {0};
+    uint16_t   duty[3];
+    uint32_t   n;
+    double     err;
+    int        i;
+
+    m.theta = theta_deg * M_PI / 180.0;
+    motor_ipd_test_start(pulses);
+    for(n = 0; (n < SIM_PERIODS_MAX) && (ipd.state != IPD_STATE_DONE); n++)
+    {
+        double  alpha, beta, ia, ib;
+        uint8_t idx = ipd.idx;
+
+        for(i = 0; i < 3; i++)
+        {
+            duty[i] = ipd.duty[i];
+        }
+        pmsm_apply(&m, duty);
+        pmsm_half_period(&m);
+
+        /*sampled at the counter peak, the next duties apply from the following period*/
+        alpha = m.id * cos(m.theta) - m.iq * sin(m.theta);
+        beta  = m.id * sin(m.theta) + m.iq * cos(m.theta);
+        ia    = alpha / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+        ib    = (-0.5 * alpha + sqrt(3.0) / 2.0 * beta) / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+        motor_ipd_test_step((int16_t)lround(ia), (int16_t)lround(ib));
+        pmsm_half_period(&m);
+        if((ipd.idx != idx) || (ipd.state == IPD_STATE_DONE))
+        {
+            r->i_left_max = fmax(r->i_left_max, sqrt(m.id * m.id + m.iq * m.iq));
+        }
+    }
+
+    err = fmod(ipd.theta * 360.0 / 65536.0 - theta_deg + 540.0, 360.0) - 180.0;
+    r->err_max         = fmax(r->err_max, fabs(err));
+    r->err_rms        += err * err;
+    r->polarity_wrong += (fabs(err) >= 90.0) || (ipd.state != IPD_STATE_DONE);
+    r->margin_min      = (ipd.margin < r->margin_min) ? ipd.margin : r->margin_min;
+    r->time_us         = (ipd.time_us > r->time_us) ? ipd.time_us : r->time_us;
+    return err;
+}
+
+
+int main(void)
+{
+    static const ipd_pulses_e pulse_list[] = {IPD_PULSES_6, IPD_PULSES_12};
+    static const double err_lim[] = {SIM_ERR_MAX_6, SIM_ERR_MAX_12};
+    uint32_t k, n;
+    int fail = 0;
+
+    motor_svpwm_init();
+    printf("saturation %.0fA, %.0f degree steps\n", SIM_I_SAT, SIM_ANGLE_STEP_DEG);
+    printf("pulses   error max   rms    polarity wrong   margin min A   time ms   left after a pulse A\n");
+    for(k = 0; k < sizeof(pulse_list) / sizeof(pulse_list[0]); k++)
+    {
+        sim_result_t r = {0.0, 0.0, 0, INT16_MAX, 0, 0.0};
+        double theta;
+
+        n = 0;
+        for(theta = 0.0; theta < 360.0; theta += SIM_ANGLE_STEP_DEG)
+        {
+            sim_test(pulse_list[k], theta, &r);
+            n++;
+        }
+        r.err_rms = sqrt(r.err_rms / n);
+        printf("%3d      %6.2f     %5.2f   %3u / %u        %6.3f        %5.2f      %5.3f\n", pulse_list[k], r.err_max,
+               r.err_rms, r.polarity_wrong, n, r.margin_min * MOTOR_I_BASE_A / 32768.0, r.time_us / 1000.0, r.i_left_max);
+        fail |= (r.polarity_wrong != 0) || (r.err_max > err_lim[k]);
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
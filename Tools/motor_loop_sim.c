@@ -0,0 +1,448 @@
+/**
+ * @file motor_loop_sim.c
+ * @brief Host tool: speed step, load step and position move of motor_loop.c on the whole FOC chain
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_loop_sim motor_loop_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_loop_sim
+ *
+ * The chain of motor_startup_sim.c: the motor of motor_param.h (J 1e-4, 24V)
+ * on the two shunt conversions at the counter peak, 1 LSB rms of noise, the
+ * duties applied from the next underflow. At the underflow the update
+ * interrupt of the FOC mode runs as motor_ctrl does: motor_startup_pwm_isr(),
+ * then motor_loop_pwm_isr() once the start sequence is in RUN. The motor
+ * starts with the flux observer and the loops take over bumpless after the
+ * blend. Speeds are the true rotor speed in angle steps per period, positions
+ * the true electrical angle summed over turns.
+ *
+ * Twice, with the references straight (traj_on 0) and through the profile of
+ * motor_traj (the default), after SIM_HOLD_S at SIM_SPEED_LOW:
+ * - speed step to SIM_SPEED_HIGH: overshoot and the time to within 2%
+ * - SIM_LOAD_NM load step at that speed: the largest drop and the time back
+ *   within 2%
+ * - position mode, a move of SIM_MOVE_TURNS electrical turns: the time to stay
+ *   within 1% of the move, and the overshoot. Straight, the P law asks for
+ *   more braking than the rated current gives from LOOP_SPEED_MAX, so the
+ *   move overshoots; the profile of motor_traj is the way to move that far.
+ * Each slow loop period is counted from loop.phase as motor_loop_pwm_isr()
+ * dispatches it. The exit code is 1 when the speed overshoot is over 5%, the
+ * load step is not recovered within 200ms, the move does not settle within
+ * 0.5s or overshoots by more than 1% through the profile, or a period ran
+ * both slow loops.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_foc.h"
+#include "motor_startup.h"
+#include "motor_loop.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_VBUS_V                      (24.0)
+#define SIM_ADC_MID                     (2048)
+#define SIM_NOISE_RAW                   (1.0)                   // adc counts rms
+#define SIM_SUBSTEPS                    (20)
+#define SIM_START_MAX_S                 (3.0)
+
+#define SIM_SPEED_LOW                   (75)                    // steps per period, 343rpm
+#define SIM_SPEED_HIGH                  (327)                   // 1497rpm
+#define SIM_LOAD_NM                     (0.06)
+#define SIM_MOVE_TURNS                  (10)                    // electrical
+#define SIM_HOLD_S                      (0.5)
+#define SIM_STEP_S                      (1.0)
+
+#define SIM_OVERSHOOT_MAX               (0.05)
+#define SIM_LOAD_RECOVER_MAX_S          (0.2)
+#define SIM_MOVE_SETTLE_MAX_S           (0.5)
+#define SIM_TRAJ_MOVE_OVER_MAX          (1.0)                   // %
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad, not wrapped*/
+    double wm;                          /*mechanical, rad/s*/
+    double v_alpha;                     /*applied, V*/
+    double v_beta;
+    double t_load;                      /*Nm, against the rotation*/
+    uint16_t duty[3];
+}sim_pmsm_t;
+
+static uint32_t rand_state = 1;
+static uint32_t slow_both;              /*periods that ran both slow loops*/
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief PMSM and the load over half a pwm period, the voltage is constant in the stator frame
+ *
+ * @param[in,out] m: motor
+ * @param[in] on: main output enabled, else the bridge is open and no current flows
+ * @return None
+ */
+static void pmsm_half_period(sim_pmsm_t *m, int on)
+{
+    double dt = MOTOR_TS_S / SIM_SUBSTEPS;
+    int k;
+
+    for(k = 0; k < SIM_SUBSTEPS / 2; k++)
+    {
+        double s  = sin(m->theta);
+        double co = cos(m->theta);
+        double we = m->wm * MOTOR_POLE_PAIRS;
+        double vd = m->v_alpha * co + m->v_beta * s;
+        double vq = -m->v_alpha * s + m->v_beta * co;
+        double te, tl;
+
+        if(on != 0)
+        {
+            double did = (vd - MOTOR_RS_OHM * m->id + we * MOTOR_LQ_H * m->iq) / MOTOR_LD_H;
+            double diq = (vq - MOTOR_RS_OHM * m->iq - we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB)) / MOTOR_LQ_H;
+
+            m->id += did * dt;
+            m->iq += diq * dt;
+        }
+        else
+        {
+            m->id = 0.0;
+            m->iq = 0.0;
+        }
+        te = 1.5 * MOTOR_POLE_PAIRS * (MOTOR_FLUX_WB * m->iq + (MOTOR_LD_H - MOTOR_LQ_H) * m->id * m->iq);
+        tl = (m->wm > 0.0) ? m->t_load : ((m->wm < 0.0) ? -m->t_load : 0.0);
+        if((m->wm == 0.0) && (fabs(te) <= m->t_load))
+        {
+            tl = te;
+        }
+        m->wm    += (te - tl) / MOTOR_J_KGM2 * dt;
+        m->theta += m->wm * MOTOR_POLE_PAIRS * dt;
+    }
+}
+
+
+/**
+ * @brief the stator voltage of the three duties
+ *
+ * @param[in,out] m: motor, applied voltage
+ * @return None
+ */
+static void pmsm_apply(sim_pmsm_t *m)
+{
+    double v[3];
+    int i;
+
+    for(i = 0; i < 3; i++)
+    {
+        v[i] = ((double)m->duty[i] / PWM_PERIOD_MAX - 0.5) * SIM_VBUS_V;
+    }
+    m->v_alpha = (2.0 * v[0] - v[1] - v[2]) / 3.0;
+    m->v_beta  = (v[1] - v[2]) / sqrt(3.0);
+}
+
+
+/**
+ * @brief the two shunt conversions at the counter peak into the injected data registers
+ *
+ * @param[in] m: motor
+ * @return None
+ */
+static void adc_sample(const sim_pmsm_t *m)
+{
+    double alpha = m->id * cos(m->theta) - m->iq * sin(m->theta);
+    double beta  = m->id * sin(m->theta) + m->iq * cos(m->theta);
+    double iu    = alpha;
+    double iv    = -0.5 * alpha + sqrt(3.0) / 2.0 * beta;
+
+    /*the amplifier output falls for a positive phase current, 16 q15 per count*/
+    ADC->JDAT1 = (uint32_t)lround(SIM_ADC_MID - iu / MOTOR_I_BASE_A * 2048.0 + sim_noise(SIM_NOISE_RAW));
+    ADC->JDAT2 = (uint32_t)lround(SIM_ADC_MID - iv / MOTOR_I_BASE_A * 2048.0 + sim_noise(SIM_NOISE_RAW));
+    ADC->JDAT3 = (uint32_t)lround(SIM_VBUS_V / MOTOR_VBUS_ADC_FS_V * 4096.0);
+}
+
+
+/**
+ * @brief one pwm period: update interrupt of the FOC mode at the underflow, current loop at the peak
+ *
+ * @param[in,out] m: motor
+ * @return None
+ */
+static void sim_period(sim_pmsm_t *m)
+{
+    int on = ((PWM_TIM->BKDT & TIM_BKDT_MOEN) != 0);
+    uint8_t phase = loop.phase;
+
+    if(on != 0)
+    {
+        pmsm_apply(m);
+    }
+    motor_startup_pwm_isr();
+    if(startup.state == STARTUP_STATE_RUN)
+    {
+        slow_both += (((phase & (LOOP_SPEED_DIV - 1)) == 0) && (phase == LOOP_POS_PHASE)) ? 1 : 0;
+        motor_loop_pwm_isr();
+    }
+    pmsm_half_period(m, on);
+
+    adc_sample(m);
+    motor_foc_adc_isr();
+    m->duty[0] = foc.duty[0];
+    m->duty[1] = foc.duty[1];
+    m->duty[2] = foc.duty[2];
+    pmsm_half_period(m, on);
+}
+
+
+/**
+ * @brief true speed
+ *
+ * @param[in] m: motor
+ * @return angle steps per pwm period
+ */
+static double sim_speed(const sim_pmsm_t *m)
+{
+    return m->wm * MOTOR_POLE_PAIRS * 65536.0 / (2.0 * M_PI) / PWM_FREQ_HZ;
+}
+
+
+/**
+ * @brief true position
+ *
+ * @param[in] m: motor
+ * @return electrical angle steps, summed over turns
+ */
+static double sim_pos(const sim_pmsm_t *m)
+{
+    return m->theta * 65536.0 / (2.0 * M_PI);
+}
+
+
+/**
+ * @brief start from a random rotor angle and run until the loops have the motor
+ *
+ * @param[in,out] m: motor
+ * @param[in] traj_on: references through the profile generator
+ * @return 0 the start sequence reached RUN
+ */
+static int sim_start(sim_pmsm_t *m, uint8_t traj_on)
+{
+    uint32_t n;
+
+    *m = (sim_pmsm_t){0};
+    m->theta   = sim_rand() * 2.0 * M_PI;
+    m->duty[0] = PWM_PERIOD_MAX / 2;
+    m->duty[1] = PWM_PERIOD_MAX / 2;
+    m->duty[2] = PWM_PERIOD_MAX / 2;
+
+    motor_foc_init();
+    motor_startup_init();
+    motor_loop_init();
+    motor_loop_traj_enable(traj_on);
+    motor_loop_reset();
+    motor_startup_start(MOTOR_DIR_CW);
+
+    for(n = 0; n < (uint32_t)(SIM_START_MAX_S * PWM_FREQ_HZ); n++)
+    {
+        sim_period(m);
+        if((startup.state == STARTUP_STATE_RUN) && (loop.running != 0))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+/**
+ * @brief run for a time
+ *
+ * @param[in,out] m: motor
+ * @param[in] t: s
+ * @return None
+ */
+static void sim_run(sim_pmsm_t *m, double t)
+{
+    uint32_t n;
+
+    for(n = 0; n < (uint32_t)(t * PWM_FREQ_HZ); n++)
+    {
+        sim_period(m);
+    }
+}
+
+
+/**
+ * @brief speed from its value now to a new reference: overshoot past it and the time to stay within 2%
+ *
+ * @param[in,out] m: motor
+ * @param[in] speed: reference, steps per period
+ * @param[out] settle_ms: time to stay within 2% of the reference
+ * @return overshoot, steps per period
+ */
+static double sim_speed_step(sim_pmsm_t *m, int16_t speed, double *settle_ms)
+{
+    double peak = 0.0;
+    uint32_t n, n_out = 0;
+
+    motor_loop_speed_ref_set(speed, 0);
+    for(n = 0; n < (uint32_t)(SIM_STEP_S * PWM_FREQ_HZ); n++)
+    {
+        double w = sim_speed(m);
+
+        sim_period(m);
+        peak  = fmax(peak, w);
+        n_out = (fabs(w - speed) > 0.02 * speed) ? n : n_out;
+    }
+    *settle_ms = n_out * 1000.0 / PWM_FREQ_HZ;
+    return peak - speed;
+}
+
+
+/**
+ * @brief load step at the speed reference: the largest drop and the time back within 2%
+ *
+ * @param[in,out] m: motor
+ * @param[in] speed: the reference, steps per period
+ * @param[out] recover_ms: time to stay within 2% of the reference
+ * @return drop, steps per period
+ */
+static double sim_load_step(sim_pmsm_t *m, int16_t speed, double *recover_ms)
+{
+    double low = speed;
+    uint32_t n, n_out = 0;
+
+    m->t_load = SIM_LOAD_NM;
+    for(n = 0; n < (uint32_t)(SIM_STEP_S * PWM_FREQ_HZ); n++)
+    {
+        double w = sim_speed(m);
+
+        sim_period(m);
+        low   = fmin(low, w);
+        n_out = (fabs(w - speed) > 0.02 * speed) ? n : n_out;
+    }
+    *recover_ms = n_out * 1000.0 / PWM_FREQ_HZ;
+    return speed - low;
+}
+
+
+/**
+ * @brief position move from standstill: the time to stay within 1% of the move and the overshoot
+ *
+ * @param[in,out] m: motor
+ * @param[in] turns: electrical turns
+ * @param[out] overshoot: past the target, % of the move
+ * @return settling time, ms
+ */
+static double sim_move(sim_pmsm_t *m, int32_t turns, double *overshoot)
+{
+    double move   = turns * 65536.0;
+    double target = sim_pos(m) + move;
+    double peak   = 0.0;
+    uint32_t n, n_out = 0;
+
+    motor_loop_position_ref_set((int32_t)((uint32_t)loop.pos + (uint32_t)(turns * 65536)), 0, 0);
+    for(n = 0; n < (uint32_t)(SIM_STEP_S * PWM_FREQ_HZ); n++)
+    {
+        double p = sim_pos(m);
+
+        sim_period(m);
+        peak  = fmax(peak, p - target);
+        n_out = (fabs(p - target) > 0.01 * move) ? n : n_out;
+    }
+    *overshoot = peak / move * 100.0;
+    return n_out * 1000.0 / PWM_FREQ_HZ;
+}
+
+
+int main(void)
+{
+    sim_pmsm_t m;
+    double over, settle_ms, drop, recover_ms, move_ms, move_over;
+    int fail = 0;
+    uint8_t traj_on;
+
+    for(traj_on = 0; traj_on < 2; traj_on++)
+    {
+        printf("%s:\n", (traj_on == 0) ? "references straight" : "references through motor_traj");
+        if(sim_start(&m, traj_on) != 0)
+        {
+            printf("start sequence did not reach RUN\n\nFAIL\n");
+            return 1;
+        }
+        motor_loop_speed_ref_set(SIM_SPEED_LOW, 0);
+        sim_run(&m, SIM_HOLD_S);
+
+        over = sim_speed_step(&m, SIM_SPEED_HIGH, &settle_ms);
+        printf("  speed step %d -> %d steps:  overshoot %.1f steps (%.2f%%), within 2%% after %.1f ms\n",
+               SIM_SPEED_LOW, SIM_SPEED_HIGH, over, over / SIM_SPEED_HIGH * 100.0, settle_ms);
+        fail |= (over > SIM_OVERSHOOT_MAX * SIM_SPEED_HIGH);
+
+        drop = sim_load_step(&m, SIM_SPEED_HIGH, &recover_ms);
+        printf("  load step %.2f Nm:          drop %.1f steps, within 2%% after %.1f ms\n", SIM_LOAD_NM, drop, recover_ms);
+        fail |= (recover_ms > SIM_LOAD_RECOVER_MAX_S * 1000.0);
+
+        m.t_load = 0.0;
+        motor_loop_speed_ref_set(0, 0);
+        sim_run(&m, SIM_HOLD_S);
+        motor_loop_mode_set(LOOP_MODE_POSITION);
+        move_ms = sim_move(&m, SIM_MOVE_TURNS, &move_over);
+        printf("  move %d electrical turns:   within 1%% after %.1f ms, overshoot %.2f%%\n", SIM_MOVE_TURNS, move_ms, move_over);
+        fail |= (move_ms > SIM_MOVE_SETTLE_MAX_S * 1000.0);
+        fail |= (traj_on != 0) && (move_over > SIM_TRAJ_MOVE_OVER_MAX);
+    }
+
+    printf("periods with both slow loops: %u\n", slow_both);
+    fail |= (slow_both != 0);
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file motor_mtpa_gen.c
+ * @brief Host tool: MTPA table of motor_mtpa.c from the motor parameters
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware:
+ *   gcc -O2 -o motor_mtpa_gen motor_mtpa_gen.c -lm
+ *   ./motor_mtpa_gen [Ld_H Lq_H flux_Wb i_base_A] > ../Source/Motor/motor_mtpa_table.h
+ * The defaults are the ones of motor_param.h.
+ *
+ * The torque request is a torque equivalent current i_t (q15 of i_base): the
+ * current giving that torque on q alone through the magnet flux,
+ *   T = 1.5 * p * psi * i_t = 1.5 * p * iq * (psi + (Ld - Lq) * id)
+ * so a speed loop built for id = 0 keeps its gain. For every grid point the
+ * current magnitude of the MTPA curve
+ *   id = (psi - sqrt(psi^2 + 8 (Lq - Ld)^2 is^2)) / (4 (Lq - Ld))
+ * giving that torque is found by bisection.
+ *
+ * The table is then checked the way the firmware uses it (same integer
+ * interpolation) against the analytic solution on a fine grid; the errors go
+ * to stderr and the exit code is 1 when they are over the limits.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+/* ============================ Module Internal Constants ============================ */
+
+/* must match motor_mtpa.h */
+#define MTPA_SEG_SHIFT                  (10)                // 32 segments over q15
+#define MTPA_SEGMENTS                   (32768 >> MTPA_SEG_SHIFT)
+#define MTPA_TABLE_SIZE                 (MTPA_SEGMENTS + 1)
+
+#define CHECK_POINTS                    (32768)
+#define CHECK_CURRENT_MAX_A             (0.05)              // id / iq error limit
+#define CHECK_EXCESS_MAX                (0.002)             // current above the optimum for the torque
+
+/* ============================ Static Global Variables ============================ */
+
+static double ld    = 0.00045;
+static double lq    = 0.00060;
+static double psi   = 0.0055;
+static double ibase = 16.5;
+
+static int16_t table[MTPA_TABLE_SIZE][2];
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief MTPA point of a current magnitude
+ *
+ * @param[in] is: current magnitude, A
+ * @param[out] id: A
+ * @param[out] iq: A
+ * @return torque equivalent current, A
+ */
+static double mtpa_point(double is, double *id, double *iq)
+{
+    double dl = lq - ld;
+
+    *id = (fabs(dl) < 1e-12) ? 0.0 : (psi - sqrt(psi * psi + 8.0 * dl * dl * is * is)) / (4.0 * dl);
+    *iq = sqrt(fmax(is * is - *id * *id, 0.0));
+    return *iq * (psi + (ld - lq) * *id) / psi;
+}
+
+
+/**
+ * @brief analytic MTPA currents of a torque request
+ *
+ * @param[in] it: torque equivalent current, A
+ * @param[out] id: A
+ * @param[out] iq: A
+ * @return None
+ */
+static void mtpa_solve(double it, double *id, double *iq)
+{
+    double lo = 0.0;
+    double hi = it * 2.0 + 1.0;
+    int    i;
+
+    for(i = 0; i < 100; i++)
+    {
+        double mid = 0.5 * (lo + hi);
+
+        if(mtpa_point(mid, id, iq) < it)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    mtpa_point(0.5 * (lo + hi), id, iq);
+}
+
+
+/**
+ * @brief q15 of a current, saturated
+ */
+static int16_t q15_of(double a)
+{
+    double v = floor(a / ibase * 32767.0 + 0.5);
+
+    return (int16_t)((v > 32767.0) ? 32767.0 : ((v < -32768.0) ? -32768.0 : v));
+}
+
+
+/**
+ * @brief the firmware lookup, motor_mtpa_ref() for a positive request
+ */
+static void table_ref(int32_t t, int16_t *id, int16_t *iq)
+{
+    int32_t k    = t >> MTPA_SEG_SHIFT;
+    int32_t frac = t & ((1 << MTPA_SEG_SHIFT) - 1);
+
+    *id = (int16_t)(table[k][0] + (((table[k + 1][0] - table[k][0]) * frac) >> MTPA_SEG_SHIFT));
+    *iq = (int16_t)(table[k][1] + (((table[k + 1][1] - table[k][1]) * frac) >> MTPA_SEG_SHIFT));
+}
+
+
+int main(int argc, char **argv)
+{
+    double id;
+    double iq;
+    double err_id     = 0.0;
+    double err_iq     = 0.0;
+    double err_torque = 0.0;
+    double excess     = 0.0;
+    int    k;
+
+    if(argc == 5)
+    {
+        ld    = atof(argv[1]);
+        lq    = atof(argv[2]);
+        psi   = atof(argv[3]);
+        ibase = atof(argv[4]);
+    }
+    else if(argc != 1)
+    {
+        fprintf(stderr, "usage: %s [Ld_H Lq_H flux_Wb i_base_A]\n", argv[0]);
+        return 2;
+    }
+
+    for(k = 0; k < MTPA_TABLE_SIZE; k++)
+    {
+        mtpa_solve(ibase * k / MTPA_SEGMENTS, &id, &iq);
+        table[k][0] = q15_of(id);
+        table[k][1] = q15_of(iq);
+    }
+
+    /*check: interpolated table against the analytic solution*/
+    for(k = 0; k < CHECK_POINTS; k++)
+    {
+        int16_t tid;
+        int16_t tiq;
+        double  aid;
+        double  aiq;
+        double  it = ibase * k / 32767.0;
+        double  ti;
+
+        table_ref(k, &tid, &tiq);
+        mtpa_solve(it, &aid, &aiq);
+        aid = tid * ibase / 32767.0 - aid;
+        aiq = tiq * ibase / 32767.0 - aiq;
+        err_id = fmax(err_id, fabs(aid));
+        err_iq = fmax(err_iq, fabs(aiq));
+
+        /*the table point: its torque and how much more current than the optimum for that torque*/
+        id = tid * ibase / 32767.0;
+        iq = tiq * ibase / 32767.0;
+        ti = iq * (psi + (ld - lq) * id) / psi;
+        err_torque = fmax(err_torque, fabs(ti - it));
+        mtpa_solve(ti, &aid, &aiq);
+        if(ti > 0.1)
+        {
+            excess = fmax(excess, hypot(id, iq) / hypot(aid, aiq) - 1.0);
+        }
+    }
+    fprintf(stderr, "mtpa check over %d points: id err %.4f A, iq err %.4f A, torque err %.4f A, current excess %.4f%%\n",
+            CHECK_POINTS, err_id, err_iq, err_torque, excess * 100.0);
+
+    printf("/**\n");
+    printf(" * @file motor_mtpa_table.h\n");
+    printf(" * @brief MTPA table, generated by Tools/motor_mtpa_gen.c, do not edit\n");
+    printf(" * \n");
+    printf(" * @details\n");
+    printf(" * Ld %.6g H, Lq %.6g H, flux %.6g Wb, current base %.6g A.\n", ld, lq, psi, ibase);
+    printf(" * Row k: id, iq (q15) of the torque equivalent current k / %d of the base.\n", MTPA_SEGMENTS);
+    printf(" * Interpolated: id err %.4f A, iq err %.4f A, current excess %.4f%%.\n", err_id, err_iq, excess * 100.0);
+    printf(" * \n");
+    printf(" * @author  SamuelYang\n");
+    printf(" * @email samuelyang615@163.com\n");
+    printf(" * @date 2026-10-16\n");
+    printf(" * @version 0.1.0\n");
+    printf(" * \n");
+    printf(" * @copyright Copyright (c) 2024 Company Name. All rights reserved.\n");
+    printf(" */\n\n");
+    printf("/** @addtogroup MOTOR\n  * @{\n  */\n\n");
+    printf("#ifndef __MOTOR_MTPA_TABLE_H__\n#define __MOTOR_MTPA_TABLE_H__\n\n");
+    printf("static const int16_t mtpa_table[MTPA_TABLE_SIZE][2] =\n{\n");
+    for(k = 0; k < MTPA_TABLE_SIZE; k++)
+    {
+        printf("    {%6d, %6d},%s\n", table[k][0], table[k][1], (k == 0) ? "                   // torque request 0" : "");
+    }
+    printf("};\n\n#endif /*__MOTOR_MTPA_TABLE_H__*/\n\n\n");
+    printf("/**\n  * @}\n  */\n");
+
+    return ((err_id > CHECK_CURRENT_MAX_A) || (err_iq > CHECK_CURRENT_MAX_A) || (excess > CHECK_EXCESS_MAX)) ? 1 : 0;
+}
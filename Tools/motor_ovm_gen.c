@@ -0,0 +1,300 @@
+/**
+ * @file motor_ovm_gen.c
+ * @brief Host tool: overmodulation gain table of motor_svpwm.c
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware:
+ *   gcc -O2 -o motor_ovm_gen motor_ovm_gen.c -lm
+ *   ./motor_ovm_gen > ../Source/Motor/motor_ovm_table.h
+ *
+ * Voltages in units of 2/3 Vbus: the linear range ends on the circle of
+ * sqrt(3) / 2, six-step has the fundamental 3 / pi (2 / pi Vbus). Above the
+ * circle the firmware multiplies the phases with their min-max zero sequence
+ * by k and clips them at +-0.75 (the rails). The fundamental of that over a
+ * turn, F(k, m), is integrated numerically and for every table point
+ * (|v|^2 = m^2 on a grid) the k with F(k, m) = m is found by bisection on
+ * 1 / k, which is what the table holds. The end of mode I, where the circle
+ * k * m reaches the vertices, is found the same way.
+ *
+ * The table is then checked the way the firmware uses it (q15 inputs, the
+ * same integer interpolation, the division, the clipping and the duty
+ * quantisation): the fundamental of the duties over a turn against the
+ * demand, which is the gain curve the current loop sees, 1 up to six-step,
+ * and the six-step end against 2 / pi Vbus. The curve goes to stderr next to
+ * the one without overmodulation; the exit code is 1 when the gain error is
+ * over the limit.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+/* ============================ Module Internal Constants ============================ */
+
+/* must match motor_svpwm.h / bsp_pwm.h */
+#define PWM_PERIOD_MAX                  (2700)
+#define SVPWM_HALF                      (PWM_PERIOD_MAX / 2)
+#define SVPWM_GAIN                      ((int32_t)(PWM_PERIOD_MAX * 0.66666667f + 0.5f))
+#define SVPWM_SQRT3_2                   (28378)
+#define SVPWM_RAIL                      ((int32_t)SVPWM_HALF * 32768 / SVPWM_GAIN)
+#define SVPWM_OVM_M2_MIN                (24576)
+#define SVPWM_OVM_SEG_SHIFT             (8)
+#define SVPWM_OVM_SEGMENTS              (21)
+#define SVPWM_OVM_TABLE_SIZE            (SVPWM_OVM_SEGMENTS + 1)
+#define SVPWM_OVM_K_SHIFT               (12)
+#define SVPWM_OVM_K_MAX                 (16 << SVPWM_OVM_K_SHIFT)
+
+#define V_LINEAR                        (0.8660254)
+#define V_SIX_STEP                      (3.0 / M_PI)
+
+#define TURN_POINTS                     (3600)
+#define CHECK_POINTS                    (400)
+#define CHECK_GAIN_MAX                  (0.005)             // |fundamental / demand - 1|
+
+/* ============================ Static Global Variables ============================ */
+
+static int16_t table[SVPWM_OVM_TABLE_SIZE];
+static int16_t ovm1_v_max;
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief fundamental over a turn of the clipped phases, continuous
+ *
+ * @param[in] k_inv: 1 / gain, 0 for six-step
+ * @param[in] m: demanded magnitude
+ * @return fundamental
+ */
+static double fundamental(double k_inv, double m)
+{
+    double sum = 0.0;
+    int    n;
+    int    j;
+
+    for(n = 0; n < TURN_POINTS; n++)
+    {
+        double th  = 2.0 * M_PI * n / TURN_POINTS;
+        double p[3];
+        double mx;
+        double mn;
+
+        p[0] = m * cos(th);
+        p[1] = m * cos(th - 2.0 * M_PI / 3.0);
+        p[2] = m * cos(th + 2.0 * M_PI / 3.0);
+        mx   = fmax(p[0], fmax(p[1], p[2]));
+        mn   = fmin(p[0], fmin(p[1], p[2]));
+        for(j = 0; j < 3; j++)
+        {
+            p[j] -= 0.5 * (mx + mn);
+            p[j]  = (k_inv > 0.0) ? p[j] / k_inv : ((p[j] > 0.0) ? 1.0 : ((p[j] < 0.0) ? -1.0 : 0.0));
+            p[j]  = fmax(fmin(p[j], 0.75), -0.75);
+        }
+        sum += (2.0 * p[0] - p[1] - p[2]) / 3.0 * cos(th) + (p[1] - p[2]) / sqrt(3.0) * sin(th);
+    }
+    return sum / TURN_POINTS;
+}
+
+
+/**
+ * @brief 1 / k giving the fundamental m
+ */
+static double solve_k_inv(double m)
+{
+    double lo = 0.0;
+    double hi = 1.0;
+    int    i;
+
+    for(i = 0; i < 50; i++)
+    {
+        double mid = 0.5 * (lo + hi);
+
+        if(fundamental(mid, m) > m)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return 0.5 * (lo + hi);
+}
+
+
+/**
+ * @brief the firmware: motor_svpwm_calc() with an overmodulation mode, on the duties
+ *
+ * @param[in] v_alpha: q15
+ * @param[in] v_beta: q15
+ * @param[in] m2_max: |v|^2 limit of the mode, 0 for no overmodulation
+ * @param[out] duty: compare values
+ */
+static void firmware_calc(int16_t v_alpha, int16_t v_beta, int32_t m2_max, int32_t *duty)
+{
+    int32_t v[3];
+    int32_t vmax;
+    int32_t vmin;
+    int32_t v0;
+    int32_t m2;
+    int32_t k = 1 << SVPWM_OVM_K_SHIFT;
+    int     j;
+
+    v[0] = v_alpha;
+    v[1] = (-(v[0] << 14) + (int32_t)v_beta * SVPWM_SQRT3_2) >> 15;
+    v[2] = -v[0] - v[1];
+    vmax = (v[1] > v[0]) ? v[1] : v[0];
+    vmax = (v[2] > vmax) ? v[2] : vmax;
+    vmin = (v[1] < v[0]) ? v[1] : v[0];
+    vmin = (v[2] < vmin) ? v[2] : vmin;
+    v0   = -((vmax + vmin) >> 1);
+    m2   = (int32_t)(((uint32_t)((int32_t)v_alpha * v_alpha) + (uint32_t)((int32_t)v_beta * v_beta)) >> 15);
+
+    if((m2_max != 0) && (m2 > SVPWM_OVM_M2_MIN))
+    {
+        int32_t x   = ((m2 < m2_max) ? m2 : m2_max) - SVPWM_OVM_M2_MIN;
+        int32_t seg = x >> SVPWM_OVM_SEG_SHIFT;
+
+        if(seg >= SVPWM_OVM_SEGMENTS)
+        {
+            k = SVPWM_OVM_K_MAX;
+        }
+        else
+        {
+            int32_t frac  = x & ((1 << SVPWM_OVM_SEG_SHIFT) - 1);
+            int32_t k_inv = table[seg] + (((table[seg + 1] - table[seg]) * frac) >> SVPWM_OVM_SEG_SHIFT);
+
+            k = (k_inv <= (1 << (15 + SVPWM_OVM_K_SHIFT)) / SVPWM_OVM_K_MAX) ? SVPWM_OVM_K_MAX : ((1 << (15 + SVPWM_OVM_K_SHIFT)) / k_inv);
+        }
+    }
+
+    for(j = 0; j < 3; j++)
+    {
+        int32_t p = ((v[j] + v0) * k) >> SVPWM_OVM_K_SHIFT;
+
+        p       = (p > SVPWM_RAIL) ? SVPWM_RAIL : ((p < -SVPWM_RAIL) ? -SVPWM_RAIL : p);
+        duty[j] = SVPWM_HALF + ((p * SVPWM_GAIN) >> 15);
+        duty[j] = (duty[j] < 0) ? 0 : ((duty[j] > PWM_PERIOD_MAX) ? PWM_PERIOD_MAX : duty[j]);
+    }
+}
+
+
+/**
+ * @brief fundamental of the firmware duties over a turn, units of 2/3 Vbus
+ */
+static double firmware_fundamental(double m, int32_t m2_max)
+{
+    double sum = 0.0;
+    int    n;
+
+    for(n = 0; n < TURN_POINTS; n++)
+    {
+        double  th = 2.0 * M_PI * (n + 0.5) / TURN_POINTS;
+        int32_t d[3];
+        double  p[3];
+        int     j;
+
+        firmware_calc((int16_t)floor(m * cos(th) * 32767.0 + 0.5), (int16_t)floor(m * sin(th) * 32767.0 + 0.5), m2_max, d);
+        for(j = 0; j < 3; j++)
+        {
+            p[j] = (double)(d[j] - SVPWM_HALF) / SVPWM_GAIN;
+        }
+        sum += (2.0 * p[0] - p[1] - p[2]) / 3.0 * cos(th) + (p[1] - p[2]) / sqrt(3.0) * sin(th);
+    }
+    return sum / TURN_POINTS;
+}
+
+
+int main(void)
+{
+    double  lo = V_LINEAR;
+    double  hi = V_SIX_STEP;
+    double  err = 0.0;
+    double  six;
+    int32_t m2_ovm1;
+    int32_t m2_six = (int32_t)(floor(V_SIX_STEP * 32767.0) * floor(V_SIX_STEP * 32767.0)) >> 15;
+    int     k;
+
+    for(k = 0; k < SVPWM_OVM_TABLE_SIZE; k++)
+    {
+        double m = sqrt((double)(SVPWM_OVM_M2_MIN + (k << SVPWM_OVM_SEG_SHIFT)) / 32768.0);
+        double v = (m >= V_SIX_STEP) ? 0.0 : floor(solve_k_inv(m) * 32768.0 + 0.5);
+
+        table[k] = (int16_t)((v > 32767.0) ? 32767.0 : v);
+    }
+
+    /*end of mode I: k * m = 1*/
+    for(k = 0; k < 50; k++)
+    {
+        double mid = 0.5 * (lo + hi);
+
+        if(fundamental(mid, mid) > mid)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    ovm1_v_max = (int16_t)floor(lo * 32767.0);
+    m2_ovm1    = ((int32_t)ovm1_v_max * ovm1_v_max) >> 15;
+
+    /*check: the gain curve of the firmware from the linear circle to six-step*/
+    fprintf(stderr, "   |v|    off      mode I   mode II  (fundamental / |v|)\n");
+    for(k = 0; k <= CHECK_POINTS; k++)
+    {
+        double m   = V_LINEAR * 0.99 + (V_SIX_STEP - V_LINEAR * 0.99) * k / CHECK_POINTS;
+        double g2  = firmware_fundamental(m, m2_six + 1) / m;
+        double g1  = (m <= ovm1_v_max / 32767.0) ? firmware_fundamental(m, m2_ovm1) / m : 0.0;
+
+        err = fmax(err, fabs(g2 - 1.0));
+        err = (g1 != 0.0) ? fmax(err, fabs(g1 - 1.0)) : err;
+        if((k % (CHECK_POINTS / 10)) == 0)
+        {
+            fprintf(stderr, (g1 != 0.0) ? "  %.4f  %.4f   %.4f   %.4f\n" : "  %.4f  %.4f   -        %.4f\n",
+                    m, firmware_fundamental(m, 0) / m, (g1 != 0.0) ? g1 : g2, g2);
+        }
+    }
+    six = firmware_fundamental(V_SIX_STEP, m2_six + 1);
+    fprintf(stderr, "mode I up to %.4f (%.2f%% of six-step), six-step fundamental %.5f of 2/pi Vbus, gain error max %.3f%%\n",
+            ovm1_v_max / 32767.0, ovm1_v_max / 32767.0 / V_SIX_STEP * 100.0, six / V_SIX_STEP, err * 100.0);
+
+    printf("/**\n");
+    printf(" * @file motor_ovm_table.h\n");
+    printf(" * @brief Overmodulation gain table, generated by Tools/motor_ovm_gen.c, do not edit\n");
+    printf(" * \n");
+    printf(" * @details\n");
+    printf(" * Entry k: 1 / gain (q15) at |v|^2 = (%d + k * %d) / 32768, units of 2/3 Vbus.\n", SVPWM_OVM_M2_MIN, 1 << SVPWM_OVM_SEG_SHIFT);
+    printf(" * Fundamental gain error up to six-step: %.3f%%.\n", err * 100.0);
+    printf(" * \n");
+    printf(" * @author  SamuelYang\n");
+    printf(" * @email samuelyang615@163.com\n");
+    printf(" * @date 2026-10-16\n");
+    printf(" * @version 0.1.0\n");
+    printf(" * \n");
+    printf(" * @copyright Copyright (c) 2024 Company Name. All rights reserved.\n");
+    printf(" */\n\n");
+    printf("/** @addtogroup MOTOR\n  * @{\n  */\n\n");
+    printf("#ifndef __MOTOR_OVM_TABLE_H__\n#define __MOTOR_OVM_TABLE_H__\n\n");
+    printf("/* end of mode I: the trajectory on the hexagon, fundamental q15 */\n");
+    printf("#define SVPWM_OVM1_V_MAX                (%d)\n\n", ovm1_v_max);
+    printf("static const int16_t svpwm_ovm_table[SVPWM_OVM_TABLE_SIZE] =\n{\n");
+    for(k = 0; k < SVPWM_OVM_TABLE_SIZE; k++)
+    {
+        printf("    %6d,%s\n", table[k], (k == 0) ? "                         // linear circle" : "");
+    }
+    printf("};\n\n#endif /*__MOTOR_OVM_TABLE_H__*/\n\n\n");
+    printf("/**\n  * @}\n  */\n");
+
+    return (err > CHECK_GAIN_MAX) ? 1 : 0;
+}
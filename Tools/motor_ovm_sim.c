@@ -0,0 +1,350 @@
+/**
+ * @file motor_ovm_sim.c
+ * @brief Host tool: the current loop past the linear range with each overmodulation mode of motor_svpwm.c
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_ovm_sim motor_ovm_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_ovm_sim
+ *
+ * The current loop of the firmware runs through motor_foc_step() on the dq
+ * model of motor_param.h held at speed by a dyno, with the timing of
+ * motor_fw_sim.c: currents at the counter peak with 3 LSB rms of noise, the
+ * duties loaded at the next underflow, a fraction of the actual bus. The
+ * speed ramps from standstill to the one of the case within SIM_RAMP_S and
+ * stays there, the bus steps down at SIM_SAG_S, the run ends at SIM_END_S.
+ * Every case runs with overmodulation off, mode I and mode II.
+ *
+ * Cases:
+ * - 24V, 4A asked for, no weakening, 5400 and 6000rpm: the q current at the
+ *   end and the THD of the phase current (all harmonics against the
+ *   fundamental over whole electrical turns of the last SIM_THD_S)
+ * - 20V sagging to 17V at 1.4 times base speed, 4A asked for, weakening on:
+ *   the d current it needs at the end
+ * The currents at the end are means over the last 10ms. The exit code is 1
+ * when a mode reaches less q current than the one before it (by more than
+ * SIM_IQ_SLACK_A), mode II reaches under SIM_IQ_MIN of the reference at
+ * 5400rpm, or needs a deeper d current than off after the sag.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "motor_param.h"
+#include "motor_foc.h"
+#include "motor_fw.h"
+#include "motor_svpwm.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_NOISE_LSB                   (3.0)
+#define SIM_SUBSTEPS                    (20)
+#define SIM_RAMP_S                      (2.0)
+#define SIM_SAG_S                       (2.5)
+#define SIM_END_S                       (3.5)
+#define SIM_MEAN_PERIODS                (200)                   // 10ms
+#define SIM_THD_S                       (0.1)
+
+#define SIM_IQ_MIN                      (0.95)                  // of the reference
+#define SIM_IQ_SLACK_A                  (0.05)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    double  vbus;                       /*V, before the sag*/
+    double  vbus_sag;                   /*V, after*/
+    double  rpm;                        /*0: top times the base speed*/
+    double  top;
+    double  iq;                         /*A*/
+    uint8_t fw_on;
+}sim_case_t;
+
+typedef struct
+{
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad*/
+    double we;                          /*electrical, rad/s*/
+    double v_alpha;                     /*applied this period, V*/
+    double v_beta;
+}sim_pmsm_t;
+
+typedef struct
+{
+    double id_end;                      /*A, mean of the last 10ms*/
+    double iq_end;
+    double thd;                         /*%, phase current*/
+}sim_result_t;
+
+static uint32_t rand_state = 1;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief PMSM over half a pwm period, the voltage is constant in the stator frame
+ *
+ * @param[in,out] m: motor
+ * @return None
+ */
+static void pmsm_half_period(sim_pmsm_t *m)
+{
+    double dt = MOTOR_TS_S / SIM_SUBSTEPS;
+    int k;
+
+    for(k = 0; k < SIM_SUBSTEPS / 2; k++)
+    {
+        double s  = sin(m->theta);
+        double c  = cos(m->theta);
+        double vd = m->v_alpha * c + m->v_beta * s;
+        double vq = -m->v_alpha * s + m->v_beta * c;
+        double did = (vd - MOTOR_RS_OHM * m->id + m->we * MOTOR_LQ_H * m->iq) / MOTOR_LD_H;
+        double diq = (vq - MOTOR_RS_OHM * m->iq - m->we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB)) / MOTOR_LQ_H;
+
+        m->id    += did * dt;
+        m->iq    += diq * dt;
+        m->theta += m->we * dt;
+    }
+}
+
+
+/**
+ * @brief the stator voltage of the three duties
+ *
+ * @param[out] m: motor, applied voltage
+ * @param[in] duty: compare values
+ * @param[in] vbus: bus voltage
+ * @return None
+ */
+static void pmsm_apply(sim_pmsm_t *m, const uint16_t *duty, double vbus)
+{
+    double v[3];
+    int i;
+
+    for(i = 0; i < 3; i++)
+    {
+        v[i] = ((double)duty[i] / PWM_PERIOD_MAX - 0.5) * vbus;
+    }
+    m->v_alpha = (2.0 * v[0] - v[1] - v[2]) / 3.0;
+    m->v_beta  = (v[1] - v[2]) / sqrt(3.0);
+}
+
+
+/**
+ * @brief base speed: the q current at id = 0 needs FW_V_REF
+ *
+ * @param[in] vbus: bus voltage
+ * @param[in] iq: q current, A
+ * @return electrical speed, rad/s
+ */
+static double base_speed(double vbus, double iq)
+{
+    double v_ref = FW_V_REF / 32768.0 * vbus * 2.0 / 3.0;
+    double lo = 0.0, hi = 1e5;
+    int k;
+
+    for(k = 0; k < 60; k++)
+    {
+        double we = 0.5 * (lo + hi);
+        double vd = -we * MOTOR_LQ_H * iq;
+        double vq = MOTOR_RS_OHM * iq + we * MOTOR_FLUX_WB;
+
+        if(sqrt(vd * vd + vq * vq) > v_ref)
+        {
+            hi = we;
+        }
+        else
+        {
+            lo = we;
+        }
+    }
+    return lo;
+}
+
+
+/**
+ * @brief THD of the phase current over whole electrical turns at the end of the log
+ *
+ * @param[in] ia: phase current log, A
+ * @param[in] n_end: log length
+ * @param[in] we: electrical speed, rad/s
+ * @return THD, %
+ */
+static double phase_thd(const double *ia, uint32_t n_end, double we)
+{
+    double   turn  = 2.0 * M_PI / (we * MOTOR_TS_S);              /*periods per electrical turn*/
+    uint32_t n_win = (uint32_t)lround(floor(SIM_THD_S / MOTOR_TS_S / turn) * turn);
+    double   mean = 0.0, re = 0.0, im = 0.0, sq = 0.0, fund;
+    uint32_t n;
+
+    for(n = n_end - n_win; n < n_end; n++)
+    {
+        mean += ia[n] / n_win;
+    }
+    for(n = n_end - n_win; n < n_end; n++)
+    {
+        double x = ia[n] - mean;
+        double a = 2.0 * M_PI * (double)n / turn;
+
+        re += 2.0 * x * cos(a) / n_win;
+        im += 2.0 * x * sin(a) / n_win;
+        sq += x * x / n_win;
+    }
+    fund = (re * re + im * im) / 2.0;                             /*mean square of the fundamental*/
+    return 100.0 * sqrt(fmax(sq - fund, 0.0) / fund);
+}
+
+
+/**
+ * @brief one run
+ *
+ * @param[in] c: case
+ * @param[in] ovm: overmodulation mode
+ * @param[out] r: result
+ * @return None
+ */
+static void case_run(const sim_case_t *c, svpwm_ovm_e ovm, sim_result_t *r)
+{
+    sim_pmsm_t m = {0};
+    uint16_t   duty[3];
+    double     we_top = (c->rpm > 0.0) ? (c->rpm * MOTOR_POLE_PAIRS * 2.0 * M_PI / 60.0) : (c->top * base_speed(c->vbus, c->iq));
+    double    *ia_log;
+    uint32_t   n, n_end = (uint32_t)(SIM_END_S * PWM_FREQ_HZ), n_sag = (uint32_t)(SIM_SAG_S * PWM_FREQ_HZ);
+    int        i;
+
+    ia_log = malloc(n_end * sizeof(double));
+    *r     = (sim_result_t){0.0, 0.0, 0.0};
+    m.theta = sim_rand() * 2.0 * M_PI;
+    pmsm_apply(&m, (const uint16_t[3]){PWM_PERIOD_MAX / 2, PWM_PERIOD_MAX / 2, PWM_PERIOD_MAX / 2}, c->vbus);
+
+    motor_foc_init();
+    motor_foc_start(MOTOR_DIR_CW);
+    motor_foc_ovm_set(ovm);
+    motor_fw_enable(c->fw_on);
+    motor_dtc_enable(0);
+    motor_regen_enable(0);
+    motor_cogging_enable(0);
+    foc.id_ref = 0;
+    foc.iq_ref = (int16_t)lround(c->iq / MOTOR_I_BASE_A * 32768.0);
+
+    for(n = 0; n < n_end; n++)
+    {
+        double t     = n * MOTOR_TS_S;
+        double vbus  = (n < n_sag) ? c->vbus : c->vbus_sag;
+        double alpha = m.id * cos(m.theta) - m.iq * sin(m.theta);
+        double beta  = m.id * sin(m.theta) + m.iq * cos(m.theta);
+        double ia    = alpha / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+        double ib    = (-0.5 * alpha + sqrt(3.0) / 2.0 * beta) / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+
+        m.we = (t < SIM_RAMP_S) ? (we_top * t / SIM_RAMP_S) : we_top;
+
+        /*the angle of the rotor at the sample*/
+        motor_foc_theta_set((uint16_t)lround(fmod(m.theta, 2.0 * M_PI) * 65536.0 / (2.0 * M_PI)));
+        motor_foc_step((int16_t)lround(ia), (int16_t)lround(ib));
+        for(i = 0; i < 3; i++)
+        {
+            duty[i] = foc.duty[i];
+        }
+
+        /*sampled at the counter peak, the new duties load at the following underflow*/
+        pmsm_half_period(&m);
+        pmsm_apply(&m, duty, vbus);
+        pmsm_half_period(&m);
+
+        ia_log[n] = m.id * cos(m.theta) - m.iq * sin(m.theta);
+        if(n >= n_end - SIM_MEAN_PERIODS)
+        {
+            r->id_end += m.id / SIM_MEAN_PERIODS;
+            r->iq_end += m.iq / SIM_MEAN_PERIODS;
+        }
+    }
+    r->thd = phase_thd(ia_log, n_end, we_top);
+    free(ia_log);
+}
+
+
+int main(void)
+{
+    static const sim_case_t case_list[] =
+    {
+        {24.0, 24.0, 5400.0, 0.0, 4.0, 0},
+        {24.0, 24.0, 6000.0, 0.0, 4.0, 0},
+        {20.0, 17.0,    0.0, 1.4, 4.0, 1},
+    };
+    static const char *ovm_name[SVPWM_OVM_MAX] = {"off", "I", "II"};
+    int fail = 0;
+    uint32_t k;
+    int o;
+
+    printf("bus V   speed     fw   iq ref A   ovm   iq A    id A     THD %%\n");
+    for(k = 0; k < sizeof(case_list) / sizeof(case_list[0]); k++)
+    {
+        const sim_case_t *c = &case_list[k];
+        sim_result_t res[SVPWM_OVM_MAX];
+
+        for(o = 0; o < SVPWM_OVM_MAX; o++)
+        {
+            case_run(c, (svpwm_ovm_e)o, &res[o]);
+            if(c->rpm > 0.0)
+            {
+                printf("%2.0f->%2.0f  %4.0frpm   %-3s  %4.1f       %-3s  %5.2f   %+6.2f   %6.1f\n", c->vbus, c->vbus_sag,
+                       c->rpm, c->fw_on ? "on" : "off", c->iq, ovm_name[o], res[o].iq_end, res[o].id_end, res[o].thd);
+            }
+            else
+            {
+                printf("%2.0f->%2.0f  %.1fx      %-3s  %4.1f       %-3s  %5.2f   %+6.2f   %6.1f\n", c->vbus, c->vbus_sag,
+                       c->top, c->fw_on ? "on" : "off", c->iq, ovm_name[o], res[o].iq_end, res[o].id_end, res[o].thd);
+            }
+            fail |= (o > 0) && (res[o].iq_end < res[o - 1].iq_end - SIM_IQ_SLACK_A);
+        }
+        fail |= (c->rpm == 5400.0) && (res[SVPWM_OVM_II].iq_end < SIM_IQ_MIN * c->iq);
+        fail |= c->fw_on && (res[SVPWM_OVM_II].id_end < res[SVPWM_OVM_OFF].id_end);
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,330 @@
+/**
+ * @file motor_param_id_sim.c
+ * @brief Host tool: errors of the parameters motor_param_id.c identifies, on three motors
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_param_id_sim motor_param_id_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_param_id_sim
+ *
+ * The whole test sequence runs through motor_param_id_test_step(), from the
+ * offsets to DONE, on a salient dq motor with its rotor free: inertia,
+ * viscous and coulomb friction, no load. The timing is the one of bsp_pwm.c
+ * (currents at the counter peak, the duties loaded at the next underflow),
+ * the currents go through the 12 bit adc with 1 count rms of noise. The
+ * bridge is switch level with the dead time of bsp_pwm.h and the diodes on
+ * the sign of the instantaneous current, as in motor_dtc_sim.c, at 24V.
+ *
+ * Three motors: the one of motor_param.h the firmware is tuned for, a slower
+ * one (0.8 ohm, 1.2 / 1.6mH, 3x the inertia) and a faster one (0.15 ohm,
+ * 0.2 / 0.28mH), each from four rotor angles. The errors are in percent of
+ * the motor value. The exit code is 1 when a run does not reach DONE or an
+ * error is over SIM_ERR_MAX_PCT.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "bsp_pwm.h"
+#include "motor_param.h"
+#include "motor_foc.h"
+#include "motor_param_id.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_VBUS_V                      (24.0)
+#define SIM_NOISE_COUNTS                (1.0)
+#define SIM_SLICE_TICKS                 (54)                    // PWM_PERIOD_MAX / 50
+#define SIM_MAX_PERIODS                 (100000)                // 5s
+#define SIM_ERR_MAX_PCT                 (3.0)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    const char *name;
+    double rs;                          /*ohm*/
+    double ld;                          /*H*/
+    double lq;
+    double flux;                        /*Wb*/
+    double j;                           /*kgm2*/
+    double b;                           /*Nm / (rad/s)*/
+    double tc;                          /*Nm*/
+}sim_motor_t;
+
+typedef struct
+{
+    const sim_motor_t *p;
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad*/
+    double we;                          /*electrical, rad/s*/
+}sim_pmsm_t;
+
+static uint32_t rand_state = 1;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief length of the overlap of two tick intervals
+ *
+ * @param[in] a0: start of the first
+ * @param[in] a1: end of the first
+ * @param[in] b0: start of the second
+ * @param[in] b1: end of the second
+ * @return overlap, ticks
+ */
+static double sim_overlap(double a0, double a1, double b0, double b1)
+{
+    double d = fmin(a1, b1) - fmax(a0, b0);
+
+    return (d > 0.0) ? d : 0.0;
+}
+
+
+/**
+ * @brief mean leg voltage over a slice of a half period
+ *
+ * @param[in] duty: compare value
+ * @param[in] up: 1 counting up from the underflow, 0 down to it
+ * @param[in] k0: start of the slice, ticks from the start of the half period
+ * @param[in] k1: end of the slice
+ * @param[in] i: phase current into the motor, A
+ * @return voltage to the negative rail, V
+ */
+static double leg_voltage(uint16_t duty, uint8_t up, double k0, double k1, double i)
+{
+    double td = PWM_DEADTIME;
+    double high, dead;
+
+    if(duty == 0)
+    {
+        return 0.0;
+    }
+    if(duty >= PWM_PERIOD_MAX)
+    {
+        return SIM_VBUS_V;
+    }
+
+    if(up != 0)
+    {
+        /*high side off at the compare, low side on one dead time later*/
+        high = sim_overlap(k0, k1, 0.0, duty);
+        dead = sim_overlap(k0, k1, duty, duty + td);
+    }
+    else
+    {
+        /*low side off at the compare, high side on one dead time later*/
+        high = sim_overlap(k0, k1, PWM_PERIOD_MAX - duty + td, PWM_PERIOD_MAX);
+        dead = sim_overlap(k0, k1, PWM_PERIOD_MAX - duty, PWM_PERIOD_MAX - duty + td);
+    }
+    if(i < 0.0)
+    {
+        high += dead;
+    }
+    return SIM_VBUS_V * high / (k1 - k0);
+}
+
+
+/**
+ * @brief PMSM, rotor and bridge over half a pwm period
+ *
+ * @param[in,out] m: motor
+ * @param[in] duty: compare values, NULL with the outputs off
+ * @param[in] up: 1 counting up from the underflow, 0 down to it
+ * @return None
+ */
+static void pmsm_half_period(sim_pmsm_t *m, const uint16_t *duty, uint8_t up)
+{
+    const sim_motor_t *p = m->p;
+    double dt = MOTOR_TS_S * SIM_SLICE_TICKS / (2.0 * PWM_PERIOD_MAX);
+    double k;
+
+    if(duty == NULL)
+    {
+        return;                         /*standing still, no current*/
+    }
+    for(k = 0.0; k < PWM_PERIOD_MAX; k += SIM_SLICE_TICKS)
+    {
+        double s  = sin(m->theta);
+        double c  = cos(m->theta);
+        double ia = m->id * c - m->iq * s;
+        double ibeta = m->id * s + m->iq * c;
+        double ib = -0.5 * ia + sqrt(3.0) / 2.0 * ibeta;
+        double va = leg_voltage(duty[0], up, k, k + SIM_SLICE_TICKS, ia);
+        double vb = leg_voltage(duty[1], up, k, k + SIM_SLICE_TICKS, ib);
+        double vc = leg_voltage(duty[2], up, k, k + SIM_SLICE_TICKS, -ia - ib);
+        double v_alpha = (2.0 * va - vb - vc) / 3.0;
+        double v_beta  = (vb - vc) / sqrt(3.0);
+        double vd = v_alpha * c + v_beta * s;
+        double vq = -v_alpha * s + v_beta * c;
+        double did = (vd - p->rs * m->id + m->we * p->lq * m->iq) / p->ld;
+        double diq = (vq - p->rs * m->iq - m->we * (p->ld * m->id + p->flux)) / p->lq;
+        double wm  = m->we / MOTOR_POLE_PAIRS;
+        double te  = 1.5 * MOTOR_POLE_PAIRS * (p->flux * m->iq + (p->ld - p->lq) * m->id * m->iq);
+        double tf  = p->b * wm + p->tc * tanh(wm / 0.5);
+
+        m->id    += did * dt;
+        m->iq    += diq * dt;
+        m->theta += m->we * dt;
+        m->we    += MOTOR_POLE_PAIRS * (te - tf) / p->j * dt;
+    }
+}
+
+
+/**
+ * @brief a phase current through the adc, as the isr hands it over
+ *
+ * @param[in] i: current, A
+ * @return q15
+ */
+static int16_t adc_current(double i)
+{
+    double raw = floor(2048.0 - i / MOTOR_I_BASE_A * 2048.0 + sim_noise(SIM_NOISE_COUNTS) + 0.5);
+
+    raw = (raw < 0.0) ? 0.0 : ((raw > 4095.0) ? 4095.0 : raw);
+    return (int16_t)((2048 - (int32_t)raw) << FOC_CURRENT_SHIFT);
+}
+
+
+/**
+ * @brief one identification from a rotor angle
+ *
+ * @param[in] p: motor
+ * @param[in] theta0: electrical rotor angle, degree
+ * @param[out] err: errors of Rs, Ld, Lq, flux, J, percent
+ * @return final state
+ */
+static param_id_state_e case_run(const sim_motor_t *p, double theta0, double *err)
+{
+    sim_pmsm_t m = {0};
+    uint16_t   duty[3];
+    uint32_t   n;
+    int        i;
+
+    m.p     = p;
+    m.theta = theta0 * M_PI / 180.0;
+
+    PWM_TIM->BKDT = PWM_DEADTIME;
+    motor_foc_init();
+    motor_param_id_init();
+    motor_param_id_test_start();
+
+    for(n = 0; n < SIM_MAX_PERIODS; n++)
+    {
+        double alpha = m.id * cos(m.theta) - m.iq * sin(m.theta);
+        double beta  = m.id * sin(m.theta) + m.iq * cos(m.theta);
+        uint8_t on   = (param_id.state == PARAM_ID_STATE_RUN);
+
+        if(param_id.state == PARAM_ID_STATE_OFFSET)
+        {
+            motor_param_id_test_step(0, 0);
+        }
+        else if(param_id.state == PARAM_ID_STATE_RUN)
+        {
+            motor_param_id_test_step(adc_current(alpha), adc_current(-0.5 * alpha + sqrt(3.0) / 2.0 * beta));
+        }
+        else
+        {
+            break;
+        }
+
+        /*sampled at the counter peak, the new duties load at the following underflow*/
+        pmsm_half_period(&m, on ? duty : NULL, 0);
+        for(i = 0; i < 3; i++)
+        {
+            duty[i] = param_id.duty[i];
+        }
+        pmsm_half_period(&m, (param_id.state == PARAM_ID_STATE_RUN) ? duty : NULL, 1);
+    }
+
+    err[0] = 100.0 * (param_id.block.rs_ohm / p->rs - 1.0);
+    err[1] = 100.0 * (param_id.block.ld_h / p->ld - 1.0);
+    err[2] = 100.0 * (param_id.block.lq_h / p->lq - 1.0);
+    err[3] = 100.0 * (param_id.block.flux_wb / p->flux - 1.0);
+    err[4] = 100.0 * (param_id.block.j_kgm2 / p->j - 1.0);
+    return param_id.state;
+}
+
+
+int main(void)
+{
+    static const sim_motor_t motor_list[] =
+    {
+        {"motor_param.h", MOTOR_RS_OHM, MOTOR_LD_H, MOTOR_LQ_H, MOTOR_FLUX_WB, MOTOR_J_KGM2, 1e-5, 0.002},
+        {"slow",          0.80,         1.2e-3,     1.6e-3,     0.0080,        3.0 * MOTOR_J_KGM2, 1e-5, 0.002},
+        {"fast",          0.15,         0.2e-3,     0.28e-3,    0.0040,        MOTOR_J_KGM2, 1e-5, 0.002},
+    };
+    static const double theta_list[] = {0.0, 100.0, 190.0, 280.0};
+    int fail = 0;
+    uint32_t k, a;
+    int e;
+
+    printf("motor          rotor   state  error %%\n");
+    printf("               degree         Rs      Ld      Lq      flux    J\n");
+    for(k = 0; k < sizeof(motor_list) / sizeof(motor_list[0]); k++)
+    {
+        for(a = 0; a < sizeof(theta_list) / sizeof(theta_list[0]); a++)
+        {
+            double err[5];
+            param_id_state_e state = case_run(&motor_list[k], theta_list[a], err);
+
+            printf("%-13s  %5.0f   %-5s ", motor_list[k].name, theta_list[a],
+                   (state == PARAM_ID_STATE_DONE) ? "done" : "fail");
+            for(e = 0; e < 5; e++)
+            {
+                printf("  %+6.2f", err[e]);
+                fail |= (fabs(err[e]) > SIM_ERR_MAX_PCT);
+            }
+            printf("\n");
+            fail |= (state != PARAM_ID_STATE_DONE);
+        }
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,287 @@
+/**
+ * @file motor_regen_sim.c
+ * @brief Host tool: bus voltage during full braking with the control of motor_regen.c
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_regen_sim motor_regen_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_regen_sim [J_kgm2]
+ *
+ * The motor of motor_param.h spins at SIM_RPM and is braked with the rated
+ * current, the q reference held at -rated until the rotor is below
+ * SIM_RPM_STOP. Plant, solved SIM_SUB times per pwm period:
+ * - the d and q currents follow the references of the period as first order
+ *   lags of the current loop bandwidth (TUNE_CURRENT_BW_HZ), the voltages are
+ *   those of the dq model of the winding with the back emf
+ * - the bridge takes 1.5 * (vd * id + vq * iq) from the bus capacitor
+ *   SIM_C_F, the supply feeds it through a diode and SIM_R_SUPPLY_OHM and
+ *   cannot take current back, the chopper (regen.chopper on)
+ *   SIM_R_CHOP_OHM
+ * - rotor: J and the torque 1.5 * p * flux * iq, no friction
+ * Once per period the bus is sampled to adc counts (+-3 counts of noise),
+ * motor_regen_bus_update() takes the sample of the period before (the TIM1
+ * update reads the last conversion) and, while regen.enable is set,
+ * motor_regen_update() sets the loss current and the braking limit, applied
+ * to the references as motor_foc_current_loop() does.
+ * Three runs of the shipped regen state after motor_regen_init(): no control
+ * (motor_regen_enable(0)), control, control with the chopper
+ * (motor_regen_chopper_enable(1)). The bus of each is printed every
+ * SIM_PRINT_MS, then the peak and the braking time. The exit code is 1 when
+ * a controlled peak reaches SIM_V_TRIP.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "bsp_pwm.h"
+#include "bsp_adc.h"
+#include "motor_param.h"
+#include "motor_tune.h"
+#include "motor_regen.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_RPM                         (3000.0)            // start speed
+#define SIM_RPM_STOP                    (30.0)              // braking current off under it
+#define SIM_C_F                         (470e-6)            // bus capacitor
+#define SIM_R_SUPPLY_OHM                (0.1)               // supply and diode, forward only
+#define SIM_R_CHOP_OHM                  (10.0)              // brake resistor
+#define SIM_V_TRIP                      (32.0)              // controlled peak must stay under it
+#define SIM_SUB                         (10)                // plant steps per pwm period
+#define SIM_T_MAX_MS                    (5000)
+#define SIM_PRINT_MS                    (10)
+#define SIM_ROWS                        (SIM_T_MAX_MS / SIM_PRINT_MS + 1)
+
+#define SIM_RUNS                        (3)
+
+/* ============================ Module Internal Data Structures ============================ */
+
+typedef struct
+{
+    double   w;                         /*mechanical speed, rad/s*/
+    double   id;                        /*A*/
+    double   iq;
+    double   vbus;                      /*V*/
+    double   vq;                        /*V, last period*/
+    uint16_t raw;                       /*bus sample of the last period, adc counts*/
+    double   peak;
+    double   t_stop;                    /*braking time, s; 0 while turning*/
+    double   e_chop;                    /*J into the brake resistor*/
+    double   e_cu;                      /*J in the winding*/
+    uint32_t limit_periods;             /*of regen, at the end of the run*/
+    uint32_t chop_periods;
+}sim_t;
+
+/* ============================ Static Global Variables ============================ */
+
+static double sim_vbus_trace[SIM_RUNS][SIM_ROWS];
+static double sim_rpm_trace[SIM_ROWS];             /*controlled run*/
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief start of a run: the motor at SIM_RPM, regen initialized and set for the run
+ *
+ * @param[out] s: run
+ * @param[in] run: 0 no control, 1 control, 2 control and chopper
+ * @return None
+ */
+static void sim_init(sim_t *s, int run)
+{
+    motor_regen_init();
+    motor_regen_enable((run > 0) ? 1 : 0);
+    motor_regen_chopper_enable((run > 1) ? 1 : 0);
+    s->w      = SIM_RPM * 2.0 * M_PI / 60.0;
+    s->id     = 0.0;
+    s->iq     = 0.0;
+    s->vbus   = MOTOR_VBUS_NOM_V;
+    s->vq     = s->w * MOTOR_POLE_PAIRS * MOTOR_FLUX_WB;
+    s->raw    = (uint16_t)REGEN_COUNTS(MOTOR_VBUS_NOM_V);
+    s->peak   = s->vbus;
+    s->t_stop = 0.0;
+    s->e_chop = 0.0;
+    s->e_cu   = 0.0;
+}
+
+
+/**
+ * @brief one pwm period: the references as motor_foc_current_loop() makes them, then the plant
+ *
+ * @param[in,out] s: run
+ * @param[in] t: time of the period, s
+ * @param[in] j: inertia, kgm2
+ * @return None
+ */
+static void sim_period(sim_t *s, double t, double j)
+{
+    const double dt   = MOTOR_TS_S / SIM_SUB;
+    const double tau  = 1.0 / (2.0 * M_PI * TUNE_CURRENT_BW_HZ);
+    const double kt   = 1.5 * MOTOR_POLE_PAIRS * MOTOR_FLUX_WB;
+    int32_t id_ref    = 0;
+    int32_t iq_ref    = 0;
+    double vq_sum     = 0.0;
+    int k;
+
+    if(s->t_stop == 0.0)
+    {
+        if(s->w * 60.0 / (2.0 * M_PI) > SIM_RPM_STOP)
+        {
+            iq_ref = -REGEN_I_MAX;
+        }
+        else
+        {
+            s->t_stop = t;
+        }
+    }
+
+    /*TIM1 update: the conversion of the last period; then this period's*/
+    motor_regen_bus_update(s->raw);
+    s->raw = (uint16_t)(s->vbus * ADC_FULL_SCALE / MOTOR_VBUS_ADC_FS_V + (rand() % 7) - 3);
+
+    if(regen.enable != 0)
+    {
+        int16_t vq = (int16_t)(s->vq / MOTOR_V_BASE_V * 32768.0);
+        int16_t iq = (int16_t)(s->iq / MOTOR_I_BASE_A * 32768.0);
+
+        motor_regen_update(vq, iq, (int16_t)iq_ref);
+        if(regen.braking != 0)
+        {
+            id_ref -= regen.id_loss;
+            id_ref  = (id_ref < -REGEN_I_MAX) ? -REGEN_I_MAX : id_ref;
+            iq_ref  = (iq_ref > regen.iq_max) ? regen.iq_max : ((iq_ref < -regen.iq_max) ? -regen.iq_max : iq_ref);
+        }
+    }
+
+    for(k = 0; k < SIM_SUB; k++)
+    {
+        double we  = s->w * MOTOR_POLE_PAIRS;
+        double did = ((double)id_ref * MOTOR_I_BASE_A / 32768.0 - s->id) / tau;
+        double diq = ((double)iq_ref * MOTOR_I_BASE_A / 32768.0 - s->iq) / tau;
+        double vd  = MOTOR_RS_OHM * s->id + MOTOR_LD_H * did - we * MOTOR_LQ_H * s->iq;
+        double vq  = MOTOR_RS_OHM * s->iq + MOTOR_LQ_H * diq + we * (MOTOR_LD_H * s->id + MOTOR_FLUX_WB);
+        double p   = 1.5 * (vd * s->id + vq * s->iq);
+        double i_c = -p / s->vbus;
+
+        if(s->vbus < MOTOR_VBUS_NOM_V)
+        {
+            i_c += (MOTOR_VBUS_NOM_V - s->vbus) / SIM_R_SUPPLY_OHM;
+        }
+        if(regen.chopper != 0)
+        {
+            i_c       -= s->vbus / SIM_R_CHOP_OHM;
+            s->e_chop += s->vbus * s->vbus / SIM_R_CHOP_OHM * dt;
+        }
+        s->e_cu += 1.5 * MOTOR_RS_OHM * (s->id * s->id + s->iq * s->iq) * dt;
+        s->vbus += i_c / SIM_C_F * dt;
+        s->w    += kt * s->iq / j * dt;
+        s->w     = (s->w < 0.0) ? 0.0 : s->w;
+        s->id   += did * dt;
+        s->iq   += diq * dt;
+        vq_sum  += vq;
+        s->peak  = (s->vbus > s->peak) ? s->vbus : s->peak;
+    }
+    s->vq = vq_sum / SIM_SUB;
+}
+
+
+int main(int argc, char **argv)
+{
+    static const char *name[SIM_RUNS] = {"no control", "control", "control+chopper"};
+    sim_t  sim[SIM_RUNS];
+    double j     = MOTOR_J_KGM2;
+    long   n     = (long)SIM_T_MAX_MS * PWM_FREQ_HZ / 1000;
+    long   print = (long)SIM_PRINT_MS * PWM_FREQ_HZ / 1000;
+    int    rows  = 0;
+    int    fail  = 0;
+    long   k;
+    int    r, i;
+
+    if(argc == 2)
+    {
+        j = atof(argv[1]);
+    }
+    if((argc > 2) || (j <= 0.0))
+    {
+        fprintf(stderr, "usage: %s [J_kgm2]\n", argv[0]);
+        return 2;
+    }
+
+    /*one run after the other on the one regen state, the bus kept every SIM_PRINT_MS*/
+    for(r = 0; r < SIM_RUNS; r++)
+    {
+        sim_init(&sim[r], r);
+        for(k = 0; k < n; k++)
+        {
+            sim_period(&sim[r], k * (double)MOTOR_TS_S, j);
+            if((k % print) == 0)
+            {
+                sim_vbus_trace[r][k / print] = sim[r].vbus;
+                if(r == 1)
+                {
+                    sim_rpm_trace[k / print] = sim[r].w * 60.0 / (2.0 * M_PI);
+                }
+            }
+            if(sim[r].t_stop != 0.0)
+            {
+                break;
+            }
+        }
+        i    = (k < n) ? (int)(k / print) + 1 : SIM_ROWS;
+        rows = (i > rows) ? i : rows;
+        for(; i < SIM_ROWS; i++)
+        {
+            sim_vbus_trace[r][i] = sim[r].vbus;
+        }
+        sim[r].limit_periods = regen.limit_periods;
+        sim[r].chop_periods  = regen.chop_periods;
+    }
+
+    printf("full braking from %.0f rpm, J %.2g kgm2, C %.0f uF; bands: chopper %.1f/%.1fV, loss %.1fV, brake %.1f..%.1fV\n",
+           SIM_RPM, j, SIM_C_F * 1e6, REGEN_V_CHOP_OFF, REGEN_V_CHOP_ON, REGEN_V_LOSS, REGEN_V_BRAKE, REGEN_V_MAX);
+    printf("  t ms   rpm    ");
+    for(r = 0; r < SIM_RUNS; r++)
+    {
+        printf(" %15s", name[r]);
+    }
+    printf("   (bus V, rpm of the controlled run)\n");
+    for(i = 0; i < rows; i++)
+    {
+        printf("%6ld %6.0f    ", (long)i * SIM_PRINT_MS, sim_rpm_trace[i]);
+        for(r = 0; r < SIM_RUNS; r++)
+        {
+            printf(" %15.2f", sim_vbus_trace[r][i]);
+        }
+        printf("\n");
+    }
+
+    printf("\nrun               peak V  braking s  limited ms  chopper ms  copper J  chopper J\n");
+    for(r = 0; r < SIM_RUNS; r++)
+    {
+        printf("%-16s %7.2f  %9.3f  %10.1f  %10.1f  %8.2f  %9.2f\n", name[r], sim[r].peak, sim[r].t_stop,
+               sim[r].limit_periods * 1000.0 / PWM_FREQ_HZ, sim[r].chop_periods * 1000.0 / PWM_FREQ_HZ,
+               sim[r].e_cu, sim[r].e_chop);
+        if((r > 0) && ((sim[r].peak >= SIM_V_TRIP) || (sim[r].t_stop == 0.0)))
+        {
+            fail = 1;
+        }
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
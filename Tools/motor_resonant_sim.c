@@ -0,0 +1,305 @@
+/**
+ * @file motor_resonant_sim.c
+ * @brief Host tool: periodic load torque through the speed loop, with and without motor_resonant.c
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_resonant_sim motor_resonant_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_resonant_sim
+ * The adaptation gain and the delay are swept by rebuilding with the header
+ * constants overridden, e.g. -DRES_GAIN=700 -DRES_DELAY_PERIODS=16.
+ *
+ * The motor of motor_param.h runs in speed mode against a load torque of
+ * SIM_LOAD_NM plus harmonics of the mechanical turn (orders SIM_ORDERS,
+ * amplitudes SIM_AMP_NM). Plant, solved SIM_SUB times per pwm period:
+ * - the q current follows the reference of the period as a first order lag
+ *   of the current loop bandwidth (TUNE_CURRENT_BW_HZ)
+ * - rotor: J and the torque 1.5 * p * flux * iq against the load
+ * Every LOOP_SPEED_DIV periods the speed loop runs as motor_loop_speed()
+ * does: the speed measured as the angle steps of the last speed loop step
+ * over LOOP_SPEED_DIV, motor_resonant_step() on the shipped res state adds
+ * its torque to the feedforward, and the PI of motor_loop.c
+ * (motor_loop_test_pi() on a copy of loop.speed_pi) gives the q reference.
+ * For each of SIM_RPM: SIM_SETTLE_S to settle, the speed ripple measured
+ * over SIM_MEASURE_S, then the controller on (motor_resonant_orders_set(),
+ * motor_resonant_reset(), motor_resonant_enable()) for SIM_CONVERGE_S and
+ * the ripple measured again; per order the amplitude of the true speed at
+ * that harmonic, and the peak to peak. Then a ramp from the first to the
+ * last speed over SIM_RAMP_S, with and without the controller converged at
+ * the first. The exit code is 1 when an order above SIM_FLOOR_RPM is not
+ * reduced by SIM_REDUCTION or the ramp has a larger speed error with the
+ * controller.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "bsp_pwm.h"
+#include "motor_param.h"
+#include "motor_tune.h"
+#include "motor_loop.h"
+#include "motor_resonant.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_LOAD_NM                     (0.01)              // mean load
+#define SIM_NORDERS                     (3)
+#define SIM_ORDERS                      {1, 2, 4}           // harmonics of the mechanical turn
+#define SIM_AMP_NM                      {0.03, 0.02, 0.01}  // 0.03 Nm is a third of the rated torque
+#define SIM_SPEEDS                      (4)
+#define SIM_RPM                         {150.0, 300.0, 1000.0, 2000.0}
+#define SIM_SUB                         (10)                // plant steps per pwm period
+#define SIM_SETTLE_S                    (2.0)
+#define SIM_CONVERGE_S                  (3.0)
+#define SIM_MEASURE_S                   (2.4)               // whole turns at each SIM_RPM
+#define SIM_RAMP_S                      (4.0)
+#define SIM_FLOOR_RPM                   (3.0)               // speed measurement step: 4.58 rpm
+#define SIM_REDUCTION                   (3.0)
+
+/* ============================ Module Internal Data Structures ============================ */
+
+typedef struct
+{
+    uint8_t   res_on;                   /*this run steps the res state*/
+    loop_pi_t pi;                       /*speed PI, a copy of loop.speed_pi*/
+    int16_t  iq_ref;                    /*q15*/
+    uint16_t theta;                     /*electrical angle of the firmware*/
+    uint16_t theta_step;                /*at the last speed loop step*/
+    uint32_t periods;
+    double   th;                        /*mechanical angle, rad*/
+    double   w;                         /*mechanical speed, rad/s*/
+    double   iq;                        /*A*/
+}sim_t;
+
+/* ============================ Static Global Variables ============================ */
+
+static const uint8_t sim_order[SIM_NORDERS] = SIM_ORDERS;
+static const double  sim_amp[SIM_NORDERS]   = SIM_AMP_NM;
+
+/* ============================ Static Function Implementations ============================ */
+
+static double sim_rpm_to_inc(double rpm)
+{
+    return rpm * MOTOR_POLE_PAIRS * 65536.0 / 60.0 / PWM_FREQ_HZ;
+}
+
+
+static double sim_load(double th)
+{
+    double t = SIM_LOAD_NM;
+    int    k;
+
+    for(k = 0; k < SIM_NORDERS; k++)
+    {
+        t += sim_amp[k] * sin(sim_order[k] * th + 0.7 * k);
+    }
+
+    return t;
+}
+
+
+static void sim_init(sim_t *s, double rpm)
+{
+    memset(s, 0, sizeof(*s));
+    s->w        = rpm * 2.0 * M_PI / 60.0;
+    s->iq       = SIM_LOAD_NM / (1.5 * MOTOR_POLE_PAIRS * MOTOR_FLUX_WB);
+    s->pi       = loop.speed_pi;
+    s->pi.integ = (int32_t)(s->iq / MOTOR_I_BASE_A * 32768.0) << LOOP_PI_SHIFT;
+}
+
+
+/**
+ * @brief one pwm period: the speed loop every LOOP_SPEED_DIV periods, then the plant
+ */
+static void sim_period(sim_t *s, double rpm_ref)
+{
+    const double dt  = MOTOR_TS_S / SIM_SUB;
+    const double tau = 1.0 / (2.0 * M_PI * TUNE_CURRENT_BW_HZ);
+    const double kt  = 1.5 * MOTOR_POLE_PAIRS * MOTOR_FLUX_WB;
+    int k;
+
+    if((s->periods & (LOOP_SPEED_DIV - 1)) == 0)
+    {
+        int32_t speed = ((int16_t)(s->theta - s->theta_step) + LOOP_SPEED_DIV / 2) >> LOOP_SPEED_SHIFT;
+        int32_t err   = (int32_t)lrint(sim_rpm_to_inc(rpm_ref)) - speed;
+        int32_t ff    = 0;
+
+        s->theta_step = s->theta;
+        err = (err > LOOP_SPEED_ERR_MAX) ? LOOP_SPEED_ERR_MAX : ((err < -LOOP_SPEED_ERR_MAX) ? -LOOP_SPEED_ERR_MAX : err);
+        if((s->res_on != 0) && (res.enable != 0))
+        {
+            ff += motor_resonant_step(s->theta, err);
+        }
+        s->iq_ref = (int16_t)motor_loop_test_pi(&s->pi, err, ff);
+    }
+    s->periods++;
+
+    for(k = 0; k < SIM_SUB; k++)
+    {
+        s->iq += ((double)s->iq_ref * MOTOR_I_BASE_A / 32768.0 - s->iq) / tau * dt;
+        s->w  += (kt * s->iq - sim_load(s->th)) / MOTOR_J_KGM2 * dt;
+        s->th += s->w * dt;
+    }
+    s->theta = (uint16_t)((uint32_t)llrint(s->th * MOTOR_POLE_PAIRS * 65536.0 / (2.0 * M_PI)) & 0xFFFF);
+}
+
+
+/**
+ * @brief run at rpm for t seconds: per order the amplitude of the true speed at that harmonic, and the peak to peak, rpm
+ */
+static double sim_measure(sim_t *s, double rpm, double t, double *amp)
+{
+    double c[SIM_NORDERS] = {0};
+    double q[SIM_NORDERS] = {0};
+    double lo = 1e9;
+    double hi = -1e9;
+    long   n  = (long)(t * PWM_FREQ_HZ);
+    long   i;
+    int    k;
+
+    for(i = 0; i < n; i++)
+    {
+        double r;
+
+        sim_period(s, rpm);
+        r  = s->w * 60.0 / (2.0 * M_PI) - rpm;
+        lo = (r < lo) ? r : lo;
+        hi = (r > hi) ? r : hi;
+        for(k = 0; k < SIM_NORDERS; k++)
+        {
+            c[k] += r * cos(sim_order[k] * s->th);
+            q[k] += r * sin(sim_order[k] * s->th);
+        }
+    }
+    for(k = 0; k < SIM_NORDERS; k++)
+    {
+        amp[k] = 2.0 * sqrt(c[k] * c[k] + q[k] * q[k]) / n;
+    }
+
+    return hi - lo;
+}
+
+
+static void sim_run(sim_t *s, double rpm, double t)
+{
+    long n = (long)(t * PWM_FREQ_HZ);
+    long i;
+
+    for(i = 0; i < n; i++)
+    {
+        sim_period(s, rpm);
+    }
+}
+
+
+static void sim_res_on(sim_t *s)
+{
+    motor_resonant_orders_set(sim_order, SIM_NORDERS);
+    motor_resonant_reset(s->theta);
+    motor_resonant_enable(1);
+    s->res_on = 1;
+}
+
+
+int main(void)
+{
+    static const double rpm[SIM_SPEEDS] = SIM_RPM;
+    double a0[SIM_NORDERS];
+    double a1[SIM_NORDERS];
+    double pp0;
+    double pp1;
+    sim_t  sim;
+    sim_t  ref;
+    long   n;
+    long   i;
+    int    fail = 0;
+    int    r;
+    int    k;
+
+    motor_loop_init();
+
+    printf("load %.3f Nm +", SIM_LOAD_NM);
+    for(k = 0; k < SIM_NORDERS; k++)
+    {
+        printf(" %.3f Nm order %d", sim_amp[k], sim_order[k]);
+    }
+    printf("; RES_GAIN %d, RES_DELAY_PERIODS %d\n", RES_GAIN, RES_DELAY_PERIODS);
+    printf("\n  rpm   ripple rpm, off -> on:");
+    for(k = 0; k < SIM_NORDERS; k++)
+    {
+        printf("      order %d", sim_order[k]);
+    }
+    printf("      peak-peak\n");
+
+    for(r = 0; r < SIM_SPEEDS; r++)
+    {
+        sim_init(&sim, rpm[r]);
+        sim_run(&sim, rpm[r], SIM_SETTLE_S);
+        pp0 = sim_measure(&sim, rpm[r], SIM_MEASURE_S, a0);
+        sim_res_on(&sim);
+        sim_run(&sim, rpm[r], SIM_CONVERGE_S);
+        pp1 = sim_measure(&sim, rpm[r], SIM_MEASURE_S, a1);
+
+        printf("%5.0f                         ", rpm[r]);
+        for(k = 0; k < SIM_NORDERS; k++)
+        {
+            printf(" %5.2f->%5.2f", a0[k], a1[k]);
+            if((a0[k] > SIM_FLOOR_RPM) && (a1[k] * SIM_REDUCTION > a0[k]))
+            {
+                fail = 1;
+            }
+        }
+        printf("  %5.2f->%5.2f\n", pp0, pp1);
+    }
+
+    /*ramp: the same speeds with and without the controller, compared at the end*/
+    sim_init(&sim, rpm[0]);
+    sim_init(&ref, rpm[0]);
+    sim_run(&sim, rpm[0], SIM_SETTLE_S);
+    sim_run(&ref, rpm[0], SIM_SETTLE_S);
+    sim_res_on(&sim);
+    sim_run(&sim, rpm[0], SIM_CONVERGE_S);
+    sim_run(&ref, rpm[0], SIM_CONVERGE_S);
+    n   = (long)(SIM_RAMP_S * PWM_FREQ_HZ);
+    pp0 = 0.0;
+    pp1 = 0.0;
+    for(i = 0; i < n; i++)
+    {
+        double rr = rpm[0] + (rpm[SIM_SPEEDS - 1] - rpm[0]) * i / n;
+        double e0;
+        double e1;
+
+        sim_period(&sim, rr);
+        sim_period(&ref, rr);
+        e0  = fabs(ref.w * 60.0 / (2.0 * M_PI) - rr);
+        e1  = fabs(sim.w * 60.0 / (2.0 * M_PI) - rr);
+        pp0 = (e0 > pp0) ? e0 : pp0;
+        pp1 = (e1 > pp1) ? e1 : pp1;
+    }
+    printf("\nramp %.0f -> %.0f rpm in %.1f s, largest speed error: %.2f rpm off, %.2f rpm on\n",
+           rpm[0], rpm[SIM_SPEEDS - 1], SIM_RAMP_S, pp0, pp1);
+    if(pp1 > pp0)
+    {
+        fail = 1;
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,494 @@
+/**
+ * @file motor_single_shunt_sim.c
+ * @brief Host tool: single shunt reconstruction error of motor_single_shunt.c
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_single_shunt_sim motor_single_shunt_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_single_shunt_sim [Vbus_V]
+ * The motor is the one of motor_param.h.
+ *
+ * motor_single_shunt_start() sets up TIM1 and the adc on the host registers;
+ * checked once: rank 1 vbus, rank 2 and 3 the bus current in JSEQ, the
+ * injected group in discontinuous mode on TIM1 CC4, CCDAT4 unbuffered with
+ * the CC4 interrupt, no repetition (an update at the peak and the valley).
+ *
+ * The motor (R, L, back emf) is driven open loop by the steady state voltage
+ * of id = 0 at a set of speeds, through motor_svpwm_calc() and
+ * motor_single_shunt_plan(). TIM1 is emulated at counter tick resolution:
+ * CCDAT1~3 are loaded at the valley and the peak updates, each followed by
+ * motor_single_shunt_valley_isr() / motor_single_shunt_peak_isr(); counting
+ * down, CNT == CCDAT4 starts the conversion of the next rank of JSEQ and
+ * calls motor_single_shunt_trig_isr(). The bridge has the dead time (diode
+ * conduction by the current polarity); the bus current is sampled half way
+ * into the adc sampling time and converted to counts. After the last rank
+ * the adc interrupt runs as motor_foc_adc_isr() does in single shunt mode:
+ * motor_single_shunt_currents() on JDAT2 / JDAT3, then the plan of the next
+ * voltage. Every reconstructed period is compared with the mean phase
+ * current over one period centred on its sample (ripple and reconstruction,
+ * not the sample delay, the loop sees that in both modes), the error is
+ * split into periods within 5 degree of a sector boundary of the voltage
+ * vector and the rest; the two shunt sampling (both phases at the counter
+ * peak) is reported on the same data for reference.
+ *
+ * Also checked every period: the three conversions come in order on the
+ * counting down half, SINGLE_SHUNT_T_CONV apart and the last one
+ * SINGLE_SHUNT_T2_MIN before the valley; at a bus current sample the bridge
+ * is in the vector of its window (hi on for window 1, hi and md for
+ * window 2) and no edge falls within SINGLE_SHUNT_T_RISE before it or the
+ * sampling time after it; rank 1 reads the bus voltage. The exit code is 1
+ * on any violation or when an error is over the limits.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "n32g43x.h"
+#include "bsp_pwm.h"
+#include "bsp_adc.h"
+#include "motor_param.h"
+#include "motor_svpwm.h"
+#include "motor_foc.h"
+#include "motor_single_shunt.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define TICK_S                          (1.0 / (2.0 * PWM_PERIOD_MAX * PWM_FREQ_HZ))
+#define ADC_SAMPLE_TICKS                (30)                // 7.5 adc cycles at 27MHz
+#define TWO_SHUNT_TRIG                  (PWM_PERIOD_MAX - PWM_ADC_TRIG_ADVANCE)
+#define SIM_LS_H                        ((MOTOR_LD_H + MOTOR_LQ_H) / 2.0)
+#define SIM_ADC_MID                     (2048)              // bus amplifier output at zero current
+
+#define SIM_CURRENT_A                   (4.0)
+#define SIM_CYCLES                      (3)                 // electrical turns per speed
+#define SIM_BOUNDARY_DEG                (5.0)
+#define SIM_RING                        (8 * PWM_PERIOD_MAX)
+#define CHECK_ERR_MAX_A                 (0.15)              // any period, any phase
+#define CHECK_ERR_RMS_A                 (0.08)
+#define CHECK_HOLD_MAX                  (0.02)              // periods without windows, linear range
+
+/* ============================ Static Global Variables ============================ */
+
+static double vbus = 24.0;
+
+typedef struct
+{
+    double   err_max;
+    double   err_sq;
+    double   two_max;
+    double   two_sq;
+    long     n;
+}stat_t;
+
+typedef struct
+{
+    stat_t  *s;                         /*NULL: nothing to check*/
+    double   rec[3];
+    double   two[3];
+    long     tc[2];                     /*ticks of the two bus samples*/
+    long     tc_two;
+    uint8_t  hi;
+    uint8_t  lo;
+}pend_t;
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief the rank of JSEQ, decoded the way the library builds it (the rank position depends on the length)
+ *
+ * @param[in] rank: 1 ~ 4
+ * @return channel, 0xFF past the length
+ */
+static uint8_t adc_rank_ch(uint32_t rank)
+{
+    uint32_t jseq = ADC->JSEQ;
+    uint32_t len  = ((jseq >> 20) & 0x3) + 1;
+
+    return (rank > len) ? 0xFF : (uint8_t)((jseq >> (5 * (rank + 3 - len))) & 0x1F);
+}
+
+
+/**
+ * @brief counts of a conversion of channel ch
+ *
+ * @param[in] ch: channel of the rank
+ * @param[in] bus: dc link current drawn from the supply, A
+ * @return adc counts
+ */
+static uint16_t adc_counts(uint8_t ch, double bus)
+{
+    double c = 0.0;
+
+    c = (ch == ADC_IBUS_CH) ? (SIM_ADC_MID + bus / MOTOR_I_BASE_A * 2048.0) : c;
+    c = (ch == ADC_VBUS_CH) ? (vbus / MOTOR_VBUS_ADC_FS_V * 4096.0) : c;
+
+    return (uint16_t)lround(fmin(fmax(c, 0.0), 4095.0));
+}
+
+
+/**
+ * @brief what motor_single_shunt_start() left in TIM1 and the adc
+ *
+ * @param[in] None
+ * @return 1 on a miss
+ */
+static int setup_check(void)
+{
+    int miss = 0;
+
+    miss |= (adc_rank_ch(1) != ADC_VBUS_CH) || (adc_rank_ch(2) != ADC_IBUS_CH) || (adc_rank_ch(3) != ADC_IBUS_CH)
+            || (adc_rank_ch(4) != 0xFF);
+    miss |= ((ADC->CTRL1 & ADC_CTRL1_DJCH) == 0);
+    miss |= ((ADC->CTRL2 & ADC_CTRL2_EXTJSEL) != ADC_INJ_TRIG_SINGLE_SHUNT);
+    miss |= ((PWM_TIM->CCMOD2 & TIM_CCMOD2_OC4PEN) != 0) || ((PWM_TIM->DINTEN & TIM_DINTEN_CC4IEN) == 0);
+    miss |= (PWM_TIM->REPCNT != PWM_REPET_CNT_SINGLE_SHUNT);
+    printf("JSEQ 0x%06lx: rank 1 ch %u, rank 2 ch %u, rank 3 ch %u; CC4 trigger, discontinuous: %s\n",
+           (unsigned long)ADC->JSEQ, adc_rank_ch(1), adc_rank_ch(2), adc_rank_ch(3), miss ? "FAIL" : "pass");
+
+    return miss;
+}
+
+
+/**
+ * @brief the three compares of the voltage vector, motor_svpwm_calc()
+ *
+ * @param[in] va: alpha voltage, V
+ * @param[in] vb: beta voltage, V
+ * @param[out] duty: compare values
+ * @return None
+ */
+static void svpwm_calc(double va, double vb, uint16_t *duty)
+{
+    double base = vbus * 2.0 / 3.0;
+    double a    = fmin(fmax(va / base * 32768.0, -32768.0), 32767.0);
+    double b    = fmin(fmax(vb / base * 32768.0, -32768.0), 32767.0);
+
+    motor_svpwm_calc((int16_t)lround(a), (int16_t)lround(b), duty);
+}
+
+
+/**
+ * @brief the steady state voltage at the electrical angle th through motor_svpwm_calc() into motor_single_shunt_plan()
+ *
+ * @param[in] ud: d voltage, V
+ * @param[in] uq: q voltage, V
+ * @param[in] th: electrical angle, rad
+ * @param[out] ang: angle of the vector within its sector, degree
+ * @return None
+ */
+static void vector_plan(double ud, double uq, double th, double *ang)
+{
+    double   va = ud * cos(th) - uq * sin(th);
+    double   vb = ud * sin(th) + uq * cos(th);
+    uint16_t duty[3];
+
+    *ang = fmod(atan2(vb, va) * 180.0 / M_PI + 360.0, 60.0);
+    svpwm_calc(va, vb, duty);
+    motor_single_shunt_plan(duty);
+}
+
+
+/**
+ * @brief leg state at tick t of the period (valley to valley), with the dead time
+ *
+ * @param[in] cmp: compare loaded for the half of t
+ * @param[in] t: tick
+ * @param[in] i: phase current, A
+ * @return 1: phase on the positive rail
+ */
+static int leg_high(int cmp, int t, double i)
+{
+    int edge = (t < PWM_PERIOD_MAX) ? cmp : (2 * PWM_PERIOD_MAX - cmp);
+
+    /*both switches off for the dead time after each edge: the diode of the current polarity*/
+    if((cmp > 0) && (cmp < PWM_PERIOD_MAX) && (t >= edge) && (t - edge < PWM_DEADTIME))
+    {
+        return (i < 0.0);
+    }
+    return (t < PWM_PERIOD_MAX) ? (t < cmp) : (t >= edge);
+}
+
+
+/**
+ * @brief a bus sample at tick t of the counting down half, against the edges of the period
+ *
+ * @param[in] up: compares of the counting up half
+ * @param[in] down: compares of the counting down half
+ * @param[in] t: tick of the trigger
+ * @param[in] hi: phase on in both windows
+ * @param[in] md: phase on in window 2
+ * @return 1 on a violation
+ */
+static int sample_check(const uint16_t *up, const uint16_t *down, int t, int hi, int md)
+{
+    int bad = 0;
+    int ph;
+
+    for(ph = 0; ph < 3; ph++)
+    {
+        int e_up   = ((up[ph] > 0) && (up[ph] < PWM_PERIOD_MAX)) ? up[ph] : -1;
+        int e_down = ((down[ph] > 0) && (down[ph] < PWM_PERIOD_MAX)) ? (2 * PWM_PERIOD_MAX - down[ph]) : -1;
+        int last   = ((e_down >= 0) && (e_down <= t)) ? e_down : (((e_up >= 0) && (e_up <= t)) ? e_up : -1);
+        int on     = (t >= 2 * PWM_PERIOD_MAX - down[ph]);
+
+        bad |= ((last >= 0) && (t - last < SINGLE_SHUNT_T_RISE));
+        bad |= ((e_down >= t) && (e_down - t < SINGLE_SHUNT_T_SAMPLE));
+        bad |= (on != ((ph == hi) || (ph == md)));
+    }
+
+    return bad;
+}
+
+
+/**
+ * @brief mean of phase ph over one period centred on tick tc, from the prefix sums
+ */
+static double mean_at(double (*sum)[SIM_RING], int ph, long tc)
+{
+    return (sum[ph][(tc + PWM_PERIOD_MAX) % SIM_RING] - sum[ph][(tc - PWM_PERIOD_MAX) % SIM_RING]) / (2.0 * PWM_PERIOD_MAX);
+}
+
+
+/**
+ * @brief run one speed, accumulate the errors
+ *
+ * @param[in] rpm: speed
+ * @param[out] near: errors of the periods at a sector boundary
+ * @param[out] far: errors of the other periods
+ * @param[out] periods: periods run
+ * @return violations
+ */
+static long run(double rpm, stat_t *near, stat_t *far, long *periods)
+{
+    static double sum[3][SIM_RING];
+    double   w      = rpm * MOTOR_POLE_PAIRS * 2.0 * M_PI / 60.0;
+    double   tp     = 2.0 * PWM_PERIOD_MAX * TICK_S;
+    long     n_per  = (long)(SIM_CYCLES * 2.0 * M_PI / fmax(w, 1.0) / tp);
+    double   zr     = MOTOR_RS_OHM;
+    double   zx     = w * SIM_LS_H;
+    double   ud     = -zx * SIM_CURRENT_A;
+    double   uq     = zr * SIM_CURRENT_A + w * MOTOR_FLUX_WB;
+    double   i[3];
+    double   th0    = 0.3;
+    double   ang_plan;
+    double   ang_act = 0.0;
+    uint16_t cmp[3];
+    uint16_t cmp_up[3];
+    long     bad    = 0;
+    long     n      = 0;
+    pend_t   pend   = {0};
+    long     k;
+    int      ph;
+
+    /*steady state of id = 0, iq = I: u = (R + jwL) i + jw psi, i on the q axis*/
+    for(ph = 0; ph < 3; ph++)
+    {
+        i[ph]      = SIM_CURRENT_A * cos(th0 + M_PI / 2.0 - ph * 2.0 * M_PI / 3.0);
+        sum[ph][0] = 0.0;
+    }
+    if(n_per > 400000)
+    {
+        n_per = 400000;
+    }
+
+    motor_svpwm_init();
+    motor_single_shunt_start();
+    vector_plan(ud, uq, th0, &ang_plan);
+
+    /*a plan made in period k is latched at the next valley: the counting down half of k + 1 and the
+      counting up half of k + 2, centred on the valley between them*/
+    for(k = 0; k < n_per; k++)
+    {
+        long     t_conv[SINGLE_SHUNT_TRIGS];
+        uint32_t rank = 0;
+        uint8_t  hi;
+        uint8_t  lo;
+        int16_t  ia;
+        int16_t  ib;
+        int      t;
+
+        for(t = 0; t < 2 * PWM_PERIOD_MAX; t++, n++)
+        {
+            double tt  = n * TICK_S;
+            double v[3];
+            double vn;
+            double bus = 0.0;
+
+            /*the samples of the last period against the mean around them, one period later*/
+            if((pend.s != NULL) && (n == pend.tc[1] + PWM_PERIOD_MAX))
+            {
+                double e_max = 0.0;
+                double e_two = 0.0;
+                long   tc[3];
+
+                tc[pend.hi]               = pend.tc[0];
+                tc[pend.lo]               = pend.tc[1];
+                tc[3 - pend.hi - pend.lo] = (pend.tc[0] + pend.tc[1]) / 2;
+                for(ph = 0; ph < 3; ph++)
+                {
+                    e_max = fmax(e_max, fabs(pend.rec[ph] - mean_at(sum, ph, tc[ph])));
+                    e_two = fmax(e_two, fabs(pend.two[ph] - mean_at(sum, ph, pend.tc_two)));
+                }
+                pend.s->err_max = fmax(pend.s->err_max, e_max);
+                pend.s->err_sq += e_max * e_max;
+                pend.s->two_max = fmax(pend.s->two_max, e_two);
+                pend.s->two_sq += e_two * e_two;
+                pend.s->n++;
+                pend.s = NULL;
+            }
+
+            /*TIM1 updates: the preloaded compares go live, then the interrupt of the update*/
+            if(t == 0)
+            {
+                cmp[0]    = (uint16_t)PWM_TIM->CCDAT1;
+                cmp[1]    = (uint16_t)PWM_TIM->CCDAT2;
+                cmp[2]    = (uint16_t)PWM_TIM->CCDAT3;
+                cmp_up[0] = cmp[0];
+                cmp_up[1] = cmp[1];
+                cmp_up[2] = cmp[2];
+                motor_single_shunt_valley_isr();
+                ang_act = ang_plan;
+            }
+            else if(t == PWM_PERIOD_MAX)
+            {
+                cmp[0] = (uint16_t)PWM_TIM->CCDAT1;
+                cmp[1] = (uint16_t)PWM_TIM->CCDAT2;
+                cmp[2] = (uint16_t)PWM_TIM->CCDAT3;
+                motor_single_shunt_peak_isr();
+            }
+
+            for(ph = 0; ph < 3; ph++)
+            {
+                int h = leg_high(cmp[ph], t, i[ph]);
+
+                v[ph] = h ? vbus : 0.0;
+                bus  += h ? i[ph] : 0.0;
+            }
+            vn = (v[0] + v[1] + v[2]) / 3.0;
+
+            /*counting down: CC4 match triggers the next rank, the interrupt moves CCDAT4 on*/
+            if((t > PWM_PERIOD_MAX) && (rank < SINGLE_SHUNT_TRIGS) && ((uint32_t)(2 * PWM_PERIOD_MAX - t) == PWM_TIM->CCDAT4))
+            {
+                t_conv[rank++] = t;
+                motor_single_shunt_trig_isr();
+            }
+            if((rank > 0) && (t == t_conv[rank - 1] + ADC_SAMPLE_TICKS / 2))
+            {
+                (&ADC->JDAT1)[rank - 1] = adc_counts(adc_rank_ch(rank), bus);
+            }
+            if(t == TWO_SHUNT_TRIG + ADC_SAMPLE_TICKS / 2)
+            {
+                pend.two[0] = i[0];
+                pend.two[1] = i[1];
+                pend.two[2] = -i[0] - i[1];
+                pend.tc_two = n;
+            }
+            for(ph = 0; ph < 3; ph++)
+            {
+                double e = -w * MOTOR_FLUX_WB * sin(th0 + w * tt - ph * 2.0 * M_PI / 3.0);
+
+                sum[ph][(n + 1) % SIM_RING] = sum[ph][n % SIM_RING] + i[ph];
+                i[ph] += (v[ph] - vn - MOTOR_RS_OHM * i[ph] - e) / SIM_LS_H * TICK_S;
+            }
+        }
+        /*three conversions in order, apart, the end of conversion before the valley*/
+        if((rank != SINGLE_SHUNT_TRIGS) || (t_conv[1] - t_conv[0] < SINGLE_SHUNT_T_CONV)
+           || (t_conv[2] - t_conv[1] < SINGLE_SHUNT_T_CONV) || (2 * PWM_PERIOD_MAX - t_conv[2] < SINGLE_SHUNT_T2_MIN))
+        {
+            bad++;
+            continue;
+        }
+        bad += (abs((int)ADC->JDAT1 - (int)adc_counts(ADC_VBUS_CH, 0.0)) > 0) ? 1 : 0;
+
+        /*the adc interrupt of motor_foc_adc_isr(): the currents with the plan they were taken with, the next plan*/
+        hi = single_shunt.act.hi;
+        lo = single_shunt.act.lo;
+        if((single_shunt.act.valid != 0) && (k >= 2))
+        {
+            bad += sample_check(cmp_up, cmp, (int)t_conv[1], hi, hi) ? 1 : 0;
+            bad += sample_check(cmp_up, cmp, (int)t_conv[2], hi, 3 - hi - lo) ? 1 : 0;
+        }
+        motor_single_shunt_currents(Q15_SAT(((int32_t)ADC->JDAT2 - SIM_ADC_MID) << FOC_CURRENT_SHIFT),
+                                    Q15_SAT(((int32_t)ADC->JDAT3 - SIM_ADC_MID) << FOC_CURRENT_SHIFT), &ia, &ib);
+        if((single_shunt.act.valid != 0) && (k >= 2))
+        {
+            pend.hi = hi;
+            pend.lo = lo;
+            for(ph = 0; ph < 3; ph++)
+            {
+                pend.rec[ph] = single_shunt.i[ph] * MOTOR_I_BASE_A / 32768.0;
+            }
+            pend.tc[0] = n - 2 * PWM_PERIOD_MAX + t_conv[1] + ADC_SAMPLE_TICKS / 2;
+            pend.tc[1] = n - 2 * PWM_PERIOD_MAX + t_conv[2] + ADC_SAMPLE_TICKS / 2;
+            pend.s     = ((ang_act < SIM_BOUNDARY_DEG) || (ang_act > 60.0 - SIM_BOUNDARY_DEG)) ? near : far;
+        }
+
+        vector_plan(ud, uq, th0 + w * tp * (k + 2), &ang_plan);
+    }
+    *periods += n_per;
+    return bad;
+}
+
+
+int main(int argc, char **argv)
+{
+    static const double rpm[] = {30.0, 500.0, 1500.0, 3000.0, 4500.0, 5200.0};
+    int    fail = 0;
+    int    k;
+
+    if(argc == 2)
+    {
+        vbus = atof(argv[1]);
+    }
+    else if(argc != 1)
+    {
+        fprintf(stderr, "usage: %s [Vbus_V]\n", argv[0]);
+        return 2;
+    }
+
+    motor_single_shunt_start();
+    fail |= setup_check();
+
+    printf("single shunt, %.1f V, %.1f A: max / rms phase current error against the one period mean around the sample, A\n", vbus, SIM_CURRENT_A);
+    printf("  rpm   |v|/lin  near boundary (1sh | 2sh)            elsewhere (1sh | 2sh)              shifted  held  violations\n");
+    for(k = 0; k < (int)(sizeof(rpm) / sizeof(rpm[0])); k++)
+    {
+        stat_t near    = {0};
+        stat_t far     = {0};
+        long   periods = 0;
+        long   bad     = run(rpm[k], &near, &far, &periods);
+        double w       = rpm[k] * MOTOR_POLE_PAIRS * 2.0 * M_PI / 60.0;
+        double v       = hypot(MOTOR_RS_OHM * SIM_CURRENT_A + w * MOTOR_FLUX_WB, w * SIM_LS_H * SIM_CURRENT_A);
+        double rms_n   = sqrt(near.err_sq / fmax(near.n, 1));
+        double rms_f   = sqrt(far.err_sq / fmax(far.n, 1));
+        double holds   = (double)single_shunt.hold_cnt / periods;
+
+        printf("%5.0f   %.2f    %.3f / %.3f | %.3f / %.3f    %.3f / %.3f | %.3f / %.3f    %5.1f%%  %4.1f%%  %ld\n",
+               rpm[k], v / (vbus / sqrt(3.0)),
+               near.err_max, rms_n, near.two_max, sqrt(near.two_sq / fmax(near.n, 1)),
+               far.err_max, rms_f, far.two_max, sqrt(far.two_sq / fmax(far.n, 1)),
+               100.0 * single_shunt.shift_cnt / (periods + 1), 100.0 * holds, bad);
+        fail |= (bad != 0);
+        fail |= (fmax(near.err_max, far.err_max) > CHECK_ERR_MAX_A) || (fmax(rms_n, rms_f) > CHECK_ERR_RMS_A);
+        fail |= ((v < 0.95 * vbus / sqrt(3.0)) && (holds > CHECK_HOLD_MAX));
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
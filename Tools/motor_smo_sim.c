@@ -0,0 +1,272 @@
+/**
+ * @file motor_smo_sim.c
+ * @brief Host tool: angle error of motor_smo.c against a PMSM model over the speed range
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -o motor_smo_sim motor_smo_sim.c host/host_mcu.c ../Source/Motor/{motor_smo,motor_math}.c -lm
+ *   ./motor_smo_sim
+ *
+ * The motor is the one of motor_param.h (Rs, Ld, Lq, flux, 4 pole pairs) held
+ * at a constant speed by the load, its currents regulated by a double precision
+ * dq PI on the true angle (1kHz bandwidth, the voltage applied one period
+ * later, constant in the stator frame over the period). The observer gets what
+ * the firmware gives it: the q15 voltage of the period that just ended and the
+ * q15 currents sampled at its end with 3 LSB rms of noise.
+ *
+ * Each speed starts from a handover (the PLL preset to the true angle and
+ * speed), settles for 300ms and is measured for 200ms: the error of smo.theta
+ * against the rotor angle at the sample, mean and rms, and of smo.speed. The
+ * exit code is 1 when SMO_G * SMO_SLOPE is not under 1 (the boundary layer
+ * chatters in discrete time), the rms error is over SIM_ERR_RMS_MAX_DEG or
+ * the speed is off by more than 2%.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "motor_param.h"
+#include "motor_smo.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_VBUS_V                      (24.0)
+#define SIM_IQ_A                        (3.0)
+#define SIM_NOISE_LSB                   (3.0)
+#define SIM_CUR_BW_HZ                   (1000.0)
+#define SIM_SUBSTEPS                    (10)
+#define SIM_SETTLE_PERIODS              (6000)                  // 300ms
+#define SIM_MEASURE_PERIODS             (4000)                  // 200ms
+
+#define SIM_ERR_RMS_MAX_DEG             (1.5)
+#define SIM_SPEED_ERR_MAX               (0.02)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad*/
+    double we;                          /*electrical, rad/s*/
+    double v_alpha;                     /*applied this period, V*/
+    double v_beta;
+    double int_d;                       /*current PI integrators, V*/
+    double int_q;
+}sim_pmsm_t;
+
+static uint32_t rand_state = 1;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief angle difference folded to [-180, 180) degree
+ *
+ * @param[in] a: angle, rad
+ * @param[in] b: angle, rad
+ * @return a - b, degree
+ */
+static double sim_angle_diff(double a, double b)
+{
+    double d = fmod(a - b, 2.0 * M_PI);
+
+    d = (d < -M_PI) ? (d + 2.0 * M_PI) : ((d >= M_PI) ? (d - 2.0 * M_PI) : d);
+    return d * 180.0 / M_PI;
+}
+
+
+/**
+ * @brief PMSM over one pwm period at constant speed
+ *
+ * @param[in,out] m: motor
+ * @return None
+ */
+static void pmsm_period(sim_pmsm_t *m)
+{
+    double dt = MOTOR_TS_S / SIM_SUBSTEPS;
+    int k;
+
+    for(k = 0; k < SIM_SUBSTEPS; k++)
+    {
+        double s  = sin(m->theta);
+        double c  = cos(m->theta);
+        double vd = m->v_alpha * c + m->v_beta * s;
+        double vq = -m->v_alpha * s + m->v_beta * c;
+        double did = (vd - MOTOR_RS_OHM * m->id + m->we * MOTOR_LQ_H * m->iq) / MOTOR_LD_H;
+        double diq = (vq - MOTOR_RS_OHM * m->iq - m->we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB)) / MOTOR_LQ_H;
+
+        m->id    += did * dt;
+        m->iq    += diq * dt;
+        m->theta += m->we * dt;
+    }
+}
+
+
+/**
+ * @brief the current loop on the true angle, the voltage of the next period
+ *
+ * @param[in,out] m: motor
+ * @param[out] v_alpha: the voltage, V
+ * @param[out] v_beta: the voltage, V
+ * @return None
+ */
+static void pmsm_control(sim_pmsm_t *m, double *v_alpha, double *v_beta)
+{
+    double wc    = 2.0 * M_PI * SIM_CUR_BW_HZ;
+    double v_max = SIM_VBUS_V / sqrt(3.0);
+    double ed    = 0.0 - m->id;
+    double eq    = SIM_IQ_A - m->iq;
+    double vd, vq, mag;
+
+    m->int_d += MOTOR_RS_OHM * wc * MOTOR_TS_S * ed;
+    m->int_q += MOTOR_RS_OHM * wc * MOTOR_TS_S * eq;
+    vd  = m->int_d + MOTOR_LD_H * wc * ed - m->we * MOTOR_LQ_H * m->iq;
+    vq  = m->int_q + MOTOR_LQ_H * wc * eq + m->we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB);
+    mag = sqrt(vd * vd + vq * vq);
+    if(mag > v_max)
+    {
+        vd *= v_max / mag;
+        vq *= v_max / mag;
+    }
+    *v_alpha = vd * cos(m->theta) - vq * sin(m->theta);
+    *v_beta  = vd * sin(m->theta) + vq * cos(m->theta);
+}
+
+
+/**
+ * @brief volts or amps to q15, saturated
+ *
+ * @param[in] x: value
+ * @param[in] base: q15 full scale
+ * @return q15
+ */
+static int16_t sim_q15(double x, double base)
+{
+    double q = floor(x / base * 32768.0 + 0.5);
+
+    return (int16_t)fmin(fmax(q, -32768.0), 32767.0);
+}
+
+
+/**
+ * @brief one speed: handover, settle, measure
+ *
+ * @param[in] rpm: mechanical speed
+ * @param[out] mean: mean angle error, degree, estimate ahead positive
+ * @param[out] rms: rms angle error, degree
+ * @param[out] speed_err: relative error of the mean smo.speed
+ * @return None
+ */
+static void speed_run(double rpm, double *mean, double *rms, double *speed_err)
+{
+    sim_pmsm_t m = {0};
+    double     inc = MOTOR_RPM_TO_INC(rpm);
+    double     sum = 0.0, sum2 = 0.0, speed_sum = 0.0;
+    int16_t    v_alpha = 0, v_beta = 0;
+    uint32_t   n;
+
+    m.we    = rpm / 60.0 * 2.0 * M_PI * MOTOR_POLE_PAIRS;
+    m.theta = sim_rand() * 2.0 * M_PI;
+    m.iq    = SIM_IQ_A;
+    m.int_q = MOTOR_RS_OHM * SIM_IQ_A;
+    motor_smo_init();
+    motor_smo_reset((uint16_t)(m.theta * 65536.0 / (2.0 * M_PI)), (int16_t)lround(inc));
+
+    for(n = 0; n < SIM_SETTLE_PERIODS + SIM_MEASURE_PERIODS; n++)
+    {
+        double ia, ib, alpha, beta, va, vb;
+
+        pmsm_period(&m);
+
+        /*sample at the end of the period*/
+        alpha = m.id * cos(m.theta) - m.iq * sin(m.theta);
+        beta  = m.id * sin(m.theta) + m.iq * cos(m.theta);
+        ia    = alpha / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+        ib    = (-0.5 * alpha + sqrt(3.0) / 2.0 * beta) / MOTOR_I_BASE_A * 32768.0 + sim_noise(SIM_NOISE_LSB);
+        motor_smo_update(v_alpha, v_beta, (int16_t)lround(ia),
+                         (int16_t)lround((ia + 2.0 * ib) / sqrt(3.0)));
+
+        /*the voltage of the next period*/
+        pmsm_control(&m, &va, &vb);
+        m.v_alpha = va;
+        m.v_beta  = vb;
+        v_alpha   = sim_q15(va, MOTOR_V_BASE_V * SIM_VBUS_V / MOTOR_VBUS_NOM_V);
+        v_beta    = sim_q15(vb, MOTOR_V_BASE_V * SIM_VBUS_V / MOTOR_VBUS_NOM_V);
+
+        if(n >= SIM_SETTLE_PERIODS)
+        {
+            double e = sim_angle_diff(smo.theta * 2.0 * M_PI / 65536.0, m.theta);
+
+            sum       += e;
+            sum2      += e * e;
+            speed_sum += smo.speed;
+        }
+    }
+    *mean      = sum / SIM_MEASURE_PERIODS;
+    *rms       = sqrt(sum2 / SIM_MEASURE_PERIODS);
+    *speed_err = speed_sum / SIM_MEASURE_PERIODS / inc - 1.0;
+}
+
+
+int main(void)
+{
+    static const double rpm_run[] = {100.0, 250.0, 500.0, 1000.0, 1500.0, 2000.0, 2500.0};
+    double g_slope = (double)SMO_G * SMO_SLOPE / 32768.0;
+    int    fail    = (g_slope >= 1.0);
+    uint32_t s;
+
+    printf("SMO_G * SMO_SLOPE = %.3f\n\n", g_slope);
+    printf(" rpm    angle error degree    speed\n");
+    printf("        mean      rms         error %%\n");
+    for(s = 0; s < sizeof(rpm_run) / sizeof(rpm_run[0]); s++)
+    {
+        double mean, rms, speed_err;
+
+        speed_run(rpm_run[s], &mean, &rms, &speed_err);
+        printf("%5.0f  %+7.2f  %7.2f    %+7.2f\n", rpm_run[s], mean, rms, speed_err * 100.0);
+        fail |= (rms > SIM_ERR_RMS_MAX_DEG) || (fabs(speed_err) > SIM_SPEED_ERR_MAX);
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,410 @@
+/**
+ * @file motor_startup_sim.c
+ * @brief Host tool: time to closed loop, peak current and handover of motor_startup.c under load
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_startup_sim motor_startup_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_startup_sim
+ *
+ * The whole sequence runs as on the target: motor_startup_pwm_isr() at the
+ * underflow, motor_foc_adc_isr() on the two shunt conversions written into
+ * the injected data registers at the counter peak (1 LSB rms of noise), its
+ * duties applied from the next underflow, nothing while the main output is
+ * off. The motor is the dq model of motor_param.h with its inertia (J 1e-4),
+ * 24V, turned by its own torque against the load:
+ * - constant: opposing the rotation, holding the rotor still below it
+ * - fan: k * w^2, the constant one at the handover speed
+ *
+ * Each case starts from a random rotor angle with the default timing of
+ * motor_startup.h (4A alignment, 5A I/F, 0.4s ramp to the handover speed, 0.1s
+ * lock window) and gives the time from the start to the handover, the largest
+ * current vector at the samples, the angle error of the estimate against the
+ * rotor at the handover, the mean torque over 10ms before and after it and
+ * the lowest of the 10ms after, and the rms angle error of the last 20ms of a
+ * 100ms run after the blend. The SMO cases hand over at 20% of the rated
+ * speed, as motor_startup.h tells; on a load it cannot pull there it has to
+ * fault rather than hand over on a wrong angle. The exit code is 1 when a
+ * flux observer case does not reach RUN, an SMO case neither reaches RUN nor
+ * faults, the peak current goes more than 20% over the I/F current (a rotor
+ * swinging out of the alignment without load has the current loop chase its
+ * back emf), the torque after the handover drops by more than SIM_DIP_MAX_NM
+ * or a case that reached RUN is over 5 degree rms.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "n32g43x.h"
+#include "motor_param.h"
+#include "motor_foc.h"
+#include "motor_smo.h"
+#include "motor_flux_obs.h"
+#include "motor_startup.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_VBUS_V                      (24.0)
+#define SIM_ADC_MID                     (2048)
+#define SIM_NOISE_RAW                   (1.0)                   // adc counts rms
+#define SIM_SUBSTEPS                    (20)
+#define SIM_T_MAX_S                     (3.0)
+#define SIM_AVG_PERIODS                 (200)                   // 10ms
+#define SIM_RUN_PERIODS                 (2000)                  // 100ms after the blend
+#define SIM_ERR_PERIODS                 (400)                   // the last 20ms of it
+
+#define SIM_I_PEAK_MAX_A                (1.2 * STARTUP_IF_CURRENT * MOTOR_I_BASE_A / 32768.0)
+#define SIM_DIP_MAX_NM                  (0.01)
+#define SIM_ERR_RMS_MAX_DEG             (5.0)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef enum
+{
+    SIM_LOAD_CONST = 0,
+    SIM_LOAD_FAN,
+}sim_load_e;
+
+typedef struct
+{
+    const char     *name;
+    foc_theta_src_e src;
+    int16_t         handover_speed;
+    sim_load_e      load;
+    double          t_load;             /*Nm, the fan: at the handover speed*/
+    motor_dir_e     dir;
+}sim_case_t;
+
+typedef struct
+{
+    double id;                          /*A*/
+    double iq;
+    double theta;                       /*electrical, rad*/
+    double wm;                          /*mechanical, rad/s*/
+    double v_alpha;                     /*applied, V*/
+    double v_beta;
+    double te;                          /*electromagnetic torque, Nm*/
+    double i_peak;                      /*largest current vector at the samples, A*/
+}sim_pmsm_t;
+
+typedef struct
+{
+    startup_state_e state;
+    double closed_ms;
+    double i_peak;
+    double err_handover;                /*estimate against the rotor, degree*/
+    double te_before;                   /*Nm*/
+    double te_after;
+    double te_after_min;                /*in the direction of rotation*/
+    double err_rms;                     /*degree*/
+}sim_result_t;
+
+static uint32_t rand_state = 1;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief uniform random number in [0, 1)
+ *
+ * @param[in] None
+ * @return the number
+ */
+static double sim_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (double)((rand_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+
+/**
+ * @brief gaussian noise
+ *
+ * @param[in] rms: standard deviation
+ * @return the noise
+ */
+static double sim_noise(double rms)
+{
+    double u1 = sim_rand() + 1e-12;
+    double u2 = sim_rand();
+
+    return rms * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+
+/**
+ * @brief angle difference folded to [-180, 180) degree
+ *
+ * @param[in] a: angle, rad
+ * @param[in] b: angle, rad
+ * @return a - b, degree
+ */
+static double sim_angle_diff(double a, double b)
+{
+    double d = fmod(a - b, 2.0 * M_PI);
+
+    d = (d < -M_PI) ? (d + 2.0 * M_PI) : ((d >= M_PI) ? (d - 2.0 * M_PI) : d);
+    return d * 180.0 / M_PI;
+}
+
+
+/**
+ * @brief load torque against the rotation
+ *
+ * @param[in] c: case
+ * @param[in] wm: mechanical speed, rad/s
+ * @return the torque, Nm, positive against CW
+ */
+static double sim_load(const sim_case_t *c, double wm)
+{
+    double w_hand = c->handover_speed * (double)PWM_FREQ_HZ * 2.0 * M_PI / 65536.0 / MOTOR_POLE_PAIRS;
+
+    if(c->load == SIM_LOAD_FAN)
+    {
+        return c->t_load * wm * fabs(wm) / (w_hand * w_hand);
+    }
+    return (wm > 0.0) ? c->t_load : ((wm < 0.0) ? -c->t_load : 0.0);
+}
+
+
+/**
+ * @brief PMSM and the load over half a pwm period, the voltage is constant in the stator frame
+ *
+ * @param[in,out] m: motor
+ * @param[in] c: case, its load
+ * @param[in] on: main output enabled, else the bridge is open and no current flows
+ * @return None
+ */
+static void pmsm_half_period(sim_pmsm_t *m, const sim_case_t *c, int on)
+{
+    double dt = MOTOR_TS_S / SIM_SUBSTEPS;
+    int k;
+
+    for(k = 0; k < SIM_SUBSTEPS / 2; k++)
+    {
+        double s  = sin(m->theta);
+        double co = cos(m->theta);
+        double we = m->wm * MOTOR_POLE_PAIRS;
+        double vd = m->v_alpha * co + m->v_beta * s;
+        double vq = -m->v_alpha * s + m->v_beta * co;
+        double tl;
+
+        if(on != 0)
+        {
+            double did = (vd - MOTOR_RS_OHM * m->id + we * MOTOR_LQ_H * m->iq) / MOTOR_LD_H;
+            double diq = (vq - MOTOR_RS_OHM * m->iq - we * (MOTOR_LD_H * m->id + MOTOR_FLUX_WB)) / MOTOR_LQ_H;
+
+            m->id += did * dt;
+            m->iq += diq * dt;
+        }
+        else
+        {
+            m->id = 0.0;
+            m->iq = 0.0;
+        }
+        m->te     = 1.5 * MOTOR_POLE_PAIRS * (MOTOR_FLUX_WB * m->iq + (MOTOR_LD_H - MOTOR_LQ_H) * m->id * m->iq);
+
+        /*a constant load holds the rotor still until the torque overcomes it*/
+        tl = sim_load(c, m->wm);
+        if((m->wm == 0.0) && (c->load == SIM_LOAD_CONST) && (fabs(m->te) <= c->t_load))
+        {
+            tl = m->te;
+        }
+        m->wm    += (m->te - tl) / MOTOR_J_KGM2 * dt;
+        m->theta += m->wm * MOTOR_POLE_PAIRS * dt;
+        if((c->load == SIM_LOAD_CONST) && (((m->wm > 0.0) && (m->te - tl < 0.0) && (m->wm < fabs(tl) / MOTOR_J_KGM2 * dt))
+                                       || ((m->wm < 0.0) && (m->te - tl > 0.0) && (-m->wm < fabs(tl) / MOTOR_J_KGM2 * dt))))
+        {
+            m->wm = 0.0;                /*friction stops it instead of turning it back*/
+        }
+    }
+}
+
+
+/**
+ * @brief the stator voltage of the three duties
+ *
+ * @param[out] m: motor, applied voltage
+ * @param[in] duty: compare values
+ * @return None
+ */
+static void pmsm_apply(sim_pmsm_t *m, const uint16_t *duty)
+{
+    double v[3];
+    int i;
+
+    for(i = 0; i < 3; i++)
+    {
+        v[i] = ((double)duty[i] / PWM_PERIOD_MAX - 0.5) * SIM_VBUS_V;
+    }
+    m->v_alpha = (2.0 * v[0] - v[1] - v[2]) / 3.0;
+    m->v_beta  = (v[1] - v[2]) / sqrt(3.0);
+}
+
+
+/**
+ * @brief the two shunt conversions at the counter peak into the injected data registers
+ *
+ * @param[in] m: motor
+ * @return None
+ */
+static void adc_sample(const sim_pmsm_t *m)
+{
+    double alpha = m->id * cos(m->theta) - m->iq * sin(m->theta);
+    double beta  = m->id * sin(m->theta) + m->iq * cos(m->theta);
+    double iu    = alpha;
+    double iv    = -0.5 * alpha + sqrt(3.0) / 2.0 * beta;
+
+    /*the amplifier output falls for a positive phase current, 16 q15 per count*/
+    ADC->JDAT1 = (uint32_t)lround(SIM_ADC_MID - iu / MOTOR_I_BASE_A * 2048.0 + sim_noise(SIM_NOISE_RAW));
+    ADC->JDAT2 = (uint32_t)lround(SIM_ADC_MID - iv / MOTOR_I_BASE_A * 2048.0 + sim_noise(SIM_NOISE_RAW));
+    ADC->JDAT3 = (uint32_t)lround(SIM_VBUS_V / MOTOR_VBUS_ADC_FS_V * 4096.0);
+}
+
+
+/**
+ * @brief one start from a random rotor angle
+ *
+ * @param[in] c: case
+ * @param[out] r: result
+ * @return None
+ */
+static void case_run(const sim_case_t *c, sim_result_t *r)
+{
+    sim_pmsm_t   m = {0};
+    startup_cfg_t cfg;
+    uint16_t     duty[3] = {PWM_PERIOD_MAX / 2, PWM_PERIOD_MAX / 2, PWM_PERIOD_MAX / 2};
+    double       te_hist[SIM_AVG_PERIODS] = {0};
+    double       te_sum = 0.0, err_sum = 0.0;
+    uint32_t     n, n_max = (uint32_t)(SIM_T_MAX_S * PWM_FREQ_HZ);
+    uint32_t     n_hand = 0, n_run = 0;
+
+    m.theta = sim_rand() * 2.0 * M_PI;
+    *r = (sim_result_t){STARTUP_STATE_IDLE, -1.0, 0.0, 0.0, 0.0, 0.0, 1e9, 0.0};
+
+    motor_foc_init();
+    motor_startup_init();
+    cfg                = startup.cfg;
+    cfg.src            = c->src;
+    cfg.handover_speed = c->handover_speed;
+    cfg.accel_q16      = (int32_t)c->handover_speed * 65536 / 8000;
+    motor_startup_cfg_set(&cfg);
+    motor_startup_start(c->dir);
+
+    for(n = 0; n < n_max; n++)
+    {
+        int on = ((PWM_TIM->BKDT & TIM_BKDT_MOEN) != 0);
+        startup_state_e prev = startup.state;
+        double e;
+
+        /*underflow: the duties of the last conversion load, the sequence steps*/
+        if(on != 0)
+        {
+            pmsm_apply(&m, duty);
+        }
+        motor_startup_pwm_isr();
+        pmsm_half_period(&m, c, on);
+
+        /*counter peak: conversion, current loop on the angle of this period*/
+        e = sim_angle_diff(foc.theta * 2.0 * M_PI / 65536.0, m.theta);
+        adc_sample(&m);
+        m.i_peak = fmax(m.i_peak, sqrt(m.id * m.id + m.iq * m.iq));
+        motor_foc_adc_isr();
+        duty[0] = foc.duty[0];
+        duty[1] = foc.duty[1];
+        duty[2] = foc.duty[2];
+        pmsm_half_period(&m, c, on);
+
+        te_sum += m.te - te_hist[n % SIM_AVG_PERIODS];
+        te_hist[n % SIM_AVG_PERIODS] = m.te;
+
+        if((prev == STARTUP_STATE_IF) && (startup.state == STARTUP_STATE_BLEND))
+        {
+            n_hand          = n;
+            r->closed_ms    = startup.closed_loop_us / 1000.0;
+            r->te_before    = te_sum / SIM_AVG_PERIODS;
+            r->err_handover = sim_angle_diff(foc.theta * 2.0 * M_PI / 65536.0, m.theta);
+        }
+        if((n_hand != 0) && (n - n_hand <= SIM_AVG_PERIODS))
+        {
+            r->te_after_min = fmin(r->te_after_min, (c->dir == MOTOR_DIR_CW) ? m.te : -m.te);
+            r->te_after     = te_sum / SIM_AVG_PERIODS;
+        }
+        if((startup.state == STARTUP_STATE_RUN) && (n_run == 0))
+        {
+            n_run = n;
+        }
+        if((n_run != 0) && (n - n_run >= SIM_RUN_PERIODS - SIM_ERR_PERIODS))
+        {
+            err_sum += e * e;
+        }
+        if(((n_run != 0) && (n - n_run >= SIM_RUN_PERIODS)) || (startup.state == STARTUP_STATE_FAULT))
+        {
+            break;
+        }
+    }
+    r->state   = startup.state;
+    r->i_peak  = m.i_peak;
+    r->err_rms = sqrt(err_sum / SIM_ERR_PERIODS);
+    motor_startup_stop();
+}
+
+
+int main(void)
+{
+    static const sim_case_t case_run_list[] =
+    {
+        {"none",            FOC_THETA_FLUX, STARTUP_HANDOVER_SPEED,         SIM_LOAD_CONST, 0.0,  MOTOR_DIR_CW},
+        {"0.04 Nm",         FOC_THETA_FLUX, STARTUP_HANDOVER_SPEED,         SIM_LOAD_CONST, 0.04, MOTOR_DIR_CW},
+        {"0.08 Nm",         FOC_THETA_FLUX, STARTUP_HANDOVER_SPEED,         SIM_LOAD_CONST, 0.08, MOTOR_DIR_CW},
+        {"0.12 Nm",         FOC_THETA_FLUX, STARTUP_HANDOVER_SPEED,         SIM_LOAD_CONST, 0.12, MOTOR_DIR_CW},
+        {"fan 0.04 Nm",     FOC_THETA_FLUX, STARTUP_HANDOVER_SPEED,         SIM_LOAD_FAN,   0.04, MOTOR_DIR_CW},
+        {"0.04 Nm CCW",     FOC_THETA_FLUX, STARTUP_HANDOVER_SPEED,         SIM_LOAD_CONST, 0.04, MOTOR_DIR_CCW},
+        {"smo none",        FOC_THETA_SMO,  2 * STARTUP_HANDOVER_SPEED,     SIM_LOAD_CONST, 0.0,  MOTOR_DIR_CW},
+        {"smo 0.04 Nm",     FOC_THETA_SMO,  2 * STARTUP_HANDOVER_SPEED,     SIM_LOAD_CONST, 0.04, MOTOR_DIR_CW},
+        {"smo 0.08 Nm",     FOC_THETA_SMO,  2 * STARTUP_HANDOVER_SPEED,     SIM_LOAD_CONST, 0.08, MOTOR_DIR_CW},
+        {"smo 0.12 Nm",     FOC_THETA_SMO,  2 * STARTUP_HANDOVER_SPEED,     SIM_LOAD_CONST, 0.12, MOTOR_DIR_CW},
+    };
+    int fail = 0;
+    uint32_t k;
+
+    printf("load           closed  peak   handover   torque Nm                 after blend\n");
+    printf("               loop ms A      error deg  before  after   lowest    rms error deg\n");
+    for(k = 0; k < sizeof(case_run_list) / sizeof(case_run_list[0]); k++)
+    {
+        const sim_case_t *c = &case_run_list[k];
+        double        sign = (c->dir == MOTOR_DIR_CW) ? 1.0 : -1.0;
+        sim_result_t  r;
+
+        case_run(c, &r);
+        if(r.state != STARTUP_STATE_RUN)
+        {
+            printf("%-14s %s, peak %.2f A\n", c->name, (r.state == STARTUP_STATE_FAULT) ? "fault" : "no handover", r.i_peak);
+            fail |= (c->src == FOC_THETA_FLUX) || (r.state != STARTUP_STATE_FAULT) || (r.i_peak > SIM_I_PEAK_MAX_A);
+            continue;
+        }
+        printf("%-14s %6.1f  %5.2f  %+7.2f    %7.4f %7.4f %7.4f    %6.2f\n", c->name, r.closed_ms, r.i_peak,
+               r.err_handover, sign * r.te_before, sign * r.te_after, r.te_after_min,
+               r.err_rms);
+        fail |= (r.i_peak > SIM_I_PEAK_MAX_A) || (sign * (r.te_before - r.te_after) > SIM_DIP_MAX_NM)
+              || (r.err_rms > SIM_ERR_RMS_MAX_DEG);
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
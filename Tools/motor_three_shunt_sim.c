@@ -0,0 +1,314 @@
+/**
+ * @file motor_three_shunt_sim.c
+ * @brief Host tool: sample windows of the three shunt sensing, and motor_foc_adc_isr() on an emulated adc
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_three_shunt_sim motor_three_shunt_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_three_shunt_sim
+ *
+ * Windows: motor_svpwm_calc() (min-max zero sequence) over one electrical
+ * turn, SIM_ANGLES vectors per magnitude. A sample is valid when the duty
+ * of its phase leaves a low side window, duty <= FOC_SHUNT_DUTY_MAX. Two
+ * shunts need U and V, three shunts the two phases of the smallest duties.
+ * Given: the largest magnitude where every vector of the turn is sampled,
+ * and the share sampled at FOC_V_MAX.
+ *
+ * Interrupt: the adc is emulated on the host registers. Every period the
+ * injected sequence in JSEQ is decoded the way the library builds it (the
+ * rank position depends on the length) and each rank gets the counts of its
+ * channel: the offset of the phase minus the current, or the bus. The
+ * phase currents are a rotating set, rounded to counts each, the offsets
+ * differ per phase. The loop runs open loop with a q reference it cannot
+ * reach, so the vector sits on FOC_V_MAX and turns: every phase is left
+ * out in turn and the widest windows get narrow.
+ * Checked:
+ * - the offsets of the two rounds, W from the second one
+ * - the phase left out is the one of the largest duty of the period
+ * - foc.ia / foc.ib of a valid period against the currents, within one adc
+ *   count (the phase computed from the other two carries their rounding)
+ * - an invalid period holds the last currents and counts in
+ *   foc.shunt_hold_cnt, the share of those matches the windows above
+ * - the bus on rank 3 of every sequence
+ * The exit code is 1 on any miss.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "n32g43x.h"
+#include "bsp_pwm.h"
+#include "bsp_adc.h"
+#include "motor_param.h"
+#include "motor_six_step.h"
+#include "motor_svpwm.h"
+#include "motor_foc.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_ANGLES                      (3600)
+#define SIM_RATIO_STEP                  (0.01)
+
+#define SIM_TURNS                       (20)
+#define SIM_THETA_INC                   (64)                    // 1024 periods per turn
+#define SIM_I_AMP_COUNTS                (400.5)                 // rotating phase currents
+#define SIM_VBUS_COUNTS                 (2345)
+#define SIM_VALID_TOL                   (0.01)                  // share of valid periods, interrupt against windows
+
+/* ============================ Static Global Variables ============================ */
+
+/* adc offsets of the phase channels U, V, W */
+static const uint16_t sim_offset[3] = {2040, 2061, 2029};
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief share of one turn sampled at a magnitude
+ *
+ * @param[in] v: magnitude, q15 of 2/3 Vbus
+ * @param[in] three: 1 three shunts, 0 two
+ * @return share of the vectors with both samples valid
+ */
+static double window_share(double v, uint8_t three)
+{
+    uint16_t duty[3];
+    uint32_t k, ok = 0;
+
+    for(k = 0; k < SIM_ANGLES; k++)
+    {
+        double a = 2.0 * M_PI * k / SIM_ANGLES;
+        uint16_t hi;
+
+        motor_svpwm_calc((int16_t)lround(v * cos(a)), (int16_t)lround(v * sin(a)), duty);
+        if(three != 0)
+        {
+            hi = (duty[0] > duty[1]) ? duty[0] : duty[1];
+            hi = (duty[2] > hi) ? duty[2] : hi;
+            ok += ((duty[0] + duty[1] + duty[2] - hi - ((duty[0] < duty[1]) ? ((duty[0] < duty[2]) ? duty[0] : duty[2])
+                                                                            : ((duty[1] < duty[2]) ? duty[1] : duty[2])))
+                   <= FOC_SHUNT_DUTY_MAX) ? 1 : 0;
+        }
+        else
+        {
+            ok += ((duty[0] <= FOC_SHUNT_DUTY_MAX) && (duty[1] <= FOC_SHUNT_DUTY_MAX)) ? 1 : 0;
+        }
+    }
+    return (double)ok / SIM_ANGLES;
+}
+
+
+/**
+ * @brief largest magnitude with the whole turn sampled
+ *
+ * @param[in] three: 1 three shunts, 0 two
+ * @return of the linear circle
+ */
+static double window_limit(uint8_t three)
+{
+    double r;
+
+    for(r = SIM_RATIO_STEP; r <= 1.0; r += SIM_RATIO_STEP)
+    {
+        if(window_share(r * SVPWM_V_LINEAR, three) < 1.0)
+        {
+            break;
+        }
+    }
+    return r - SIM_RATIO_STEP;
+}
+
+
+/**
+ * @brief the injected conversions of the period: each rank gets the counts of the channel JSEQ puts there
+ *
+ * @param[in] counts: adc counts of the channels U, V, W current
+ * @return None
+ */
+static void adc_convert(const uint16_t *counts)
+{
+    uint32_t jseq = ADC->JSEQ;
+    uint32_t len  = ((jseq >> 20) & 0x3) + 1;
+    uint32_t rank;
+
+    for(rank = 1; rank <= len; rank++)
+    {
+        uint8_t  ch  = (uint8_t)((jseq >> (5 * (rank + 3 - len))) & 0x1F);
+        uint16_t val = 0;
+
+        val = (ch == ADC_IU_CH) ? counts[PHASE_U] : val;
+        val = (ch == ADC_IV_CH) ? counts[PHASE_V] : val;
+        val = (ch == ADC_IW_CH) ? counts[PHASE_W] : val;
+        val = (ch == ADC_VBUS_CH) ? SIM_VBUS_COUNTS : val;
+        (&ADC->JDAT1)[rank - 1] = val;
+    }
+}
+
+
+/**
+ * @brief the phase of the sequence loaded, by the channels on rank 1 and 2
+ *
+ * @param[in] None
+ * @return PHASE_U, PHASE_V or PHASE_W left out, 3 when the sequence is none of them
+ */
+static uint8_t adc_left_out(void)
+{
+    uint32_t jseq = ADC->JSEQ;
+    uint32_t len  = ((jseq >> 20) & 0x3) + 1;
+    uint8_t  r1   = (uint8_t)((jseq >> (5 * (4 - len))) & 0x1F);
+    uint8_t  r2   = (uint8_t)((jseq >> (5 * (5 - len))) & 0x1F);
+    uint8_t  r3   = (uint8_t)((jseq >> (5 * (6 - len))) & 0x1F);
+
+    if((len != 3) || (r3 != ADC_VBUS_CH))
+    {
+        return 3;
+    }
+    if((r1 == ADC_IV_CH) && (r2 == ADC_IW_CH))
+    {
+        return PHASE_U;
+    }
+    if((r1 == ADC_IU_CH) && (r2 == ADC_IW_CH))
+    {
+        return PHASE_V;
+    }
+    return ((r1 == ADC_IU_CH) && (r2 == ADC_IV_CH)) ? PHASE_W : 3;
+}
+
+
+/**
+ * @brief motor_foc_adc_isr() through the offset rounds and SIM_TURNS open loop turns on FOC_V_MAX
+ *
+ * @param[out] valid: share of the periods with both samples valid
+ * @return 1 on a miss
+ */
+static int isr_run(double *valid)
+{
+    uint16_t counts[3] = {sim_offset[0], sim_offset[1], sim_offset[2]};
+    uint16_t duty[3];
+    uint32_t skips[3] = {0, 0, 0};
+    uint32_t n, periods = 0, held = 0, misses = 0, wrong_skip = 0, bus = 0;
+    int32_t  err_max = 0;
+    int16_t  ia_last = 0, ib_last = 0;
+    double   phase = 0.0;
+    int      i;
+
+    motor_foc_init();
+    motor_foc_shunt_set(FOC_SHUNT_THREE);
+    motor_foc_start(MOTOR_DIR_CW);
+    motor_foc_theta_src_set(FOC_THETA_OPEN_LOOP);
+    motor_foc_theta_inc_set(SIM_THETA_INC);
+    motor_fw_enable(0);
+    motor_dtc_enable(0);
+    motor_regen_enable(0);
+    motor_cogging_enable(0);
+    motor_foc_current_ref_set(0, Q15(0.9f));
+
+    /*offset rounds, no current*/
+    for(n = 0; (n < 4 * FOC_OFFSET_SAMPLES) && (foc.state == FOC_STATE_OFFSET); n++)
+    {
+        adc_convert(counts);
+        motor_foc_adc_isr();
+    }
+    if((foc.state != FOC_STATE_RUN) || (foc.offset_a != sim_offset[0]) || (foc.offset_b != sim_offset[1])
+    || (foc.offset_c != sim_offset[2]))
+    {
+        printf("  offsets %u %u %u after %u periods, state %d\n", foc.offset_a, foc.offset_b, foc.offset_c, n, foc.state);
+        return 1;
+    }
+    printf("  offsets %u %u %u after %u periods\n", foc.offset_a, foc.offset_b, foc.offset_c, n);
+
+    for(n = 0; n < SIM_TURNS * (65536 / SIM_THETA_INC); n++)
+    {
+        double   i_a = SIM_I_AMP_COUNTS * cos(phase);
+        double   i_b = SIM_I_AMP_COUNTS * cos(phase - 2.0 * M_PI / 3.0);
+        double   i_c = -i_a - i_b;
+        uint8_t  skip = adc_left_out();
+        uint32_t hold = foc.shunt_hold_cnt;
+        uint16_t d_max;
+
+        /*the currents of the period as the amplifiers put them out, rounded to counts each*/
+        counts[PHASE_U] = (uint16_t)(sim_offset[PHASE_U] - lround(i_a));
+        counts[PHASE_V] = (uint16_t)(sim_offset[PHASE_V] - lround(i_b));
+        counts[PHASE_W] = (uint16_t)(sim_offset[PHASE_W] - lround(i_c));
+        adc_convert(counts);
+        for(i = 0; i < 3; i++)
+        {
+            duty[i] = foc.duty[i];
+        }
+        motor_foc_adc_isr();
+
+        /*the sequence converted was chosen on the duties of this period*/
+        d_max = (duty[0] > duty[1]) ? duty[0] : duty[1];
+        d_max = (duty[2] > d_max) ? duty[2] : d_max;
+        if(n > 0)
+        {
+            wrong_skip += ((skip > PHASE_W) || (duty[skip] != d_max)) ? 1 : 0;
+            skips[(skip > PHASE_W) ? PHASE_W : skip]++;
+        }
+        bus += (foc.vbus != SIM_VBUS_COUNTS) ? 1 : 0;
+
+        if(foc.shunt_hold_cnt != hold)
+        {
+            held++;
+            misses += ((foc.ia != ia_last) || (foc.ib != ib_last)) ? 1 : 0;
+        }
+        else
+        {
+            int32_t e_a = abs(foc.ia - (int32_t)lround(i_a * (1 << FOC_CURRENT_SHIFT)));
+            int32_t e_b = abs(foc.ib - (int32_t)lround(i_b * (1 << FOC_CURRENT_SHIFT)));
+
+            err_max = (e_a > err_max) ? e_a : err_max;
+            err_max = (e_b > err_max) ? e_b : err_max;
+        }
+        ia_last = foc.ia;
+        ib_last = foc.ib;
+        periods++;
+        phase += 2.0 * M_PI * 0.37 / 1024.0;
+    }
+
+    *valid = 1.0 - (double)held / periods;
+    printf("  left out U / V / W: %u / %u / %u periods, %u not the largest duty\n", skips[0], skips[1], skips[2], wrong_skip);
+    printf("  held %u of %u periods (%.1f%% sampled), %u changed while held\n", held, periods, 100.0 * *valid, misses);
+    printf("  current error max %.2f adc counts, bus misread %u times\n", (double)err_max / (1 << FOC_CURRENT_SHIFT), bus);
+    return (wrong_skip != 0) || (misses != 0) || (bus != 0) || (err_max > (1 << FOC_CURRENT_SHIFT))
+        || (skips[0] == 0) || (skips[1] == 0) || (skips[2] == 0);
+}
+
+
+int main(void)
+{
+    double two, three, share, valid;
+    int fail = 0;
+
+    motor_svpwm_init();
+    two   = window_limit(0);
+    three = window_limit(1);
+    share = window_share(FOC_V_MAX, 1);
+    printf("windows, min-max SVPWM, duty <= %d of %d:\n", FOC_SHUNT_DUTY_MAX, PWM_PERIOD_MAX);
+    printf("  whole turn sampled up to %.2f of the linear circle with U and V, %.2f with the two widest\n", two, three);
+    printf("  at FOC_V_MAX (%.2f) %.1f%% of the turn sampled with the two widest, %.1f%% with U and V\n",
+           (double)FOC_V_MAX / SVPWM_V_LINEAR, 100.0 * share, 100.0 * window_share(FOC_V_MAX, 0));
+    fail |= (three <= two);
+
+    printf("adc interrupt:\n");
+    fail |= isr_run(&valid);
+    fail |= fabs(valid - share) > SIM_VALID_TOL;
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,332 @@
+/**
+ * @file motor_traj_sim.c
+ * @brief Host tool: motor_traj.c on its own, final position, acceleration and jerk of every sample
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -o motor_traj_sim motor_traj_sim.c host/host_mcu.c ../Source/Motor/motor_traj.c -lm
+ *   ./motor_traj_sim
+ *
+ * The generator steps alone, one call per speed loop sample, with the
+ * default limits of motor_traj.h. Its output is read at full resolution:
+ * speed filter_sum / 2^jerk_shift and position pos_out / 2^jerk_shift, both
+ * q16 steps per sample. Every sample is checked against the limits:
+ * - speed within speed_max
+ * - acceleration (speed change per sample) within accel
+ * - jerk within accel / 2^(n-1), the trapezoid going straight from
+ *   accelerating to braking
+ * - the position moves by exactly the speed of the sample
+ * Cases, each trapezoidal and S-curve:
+ * - moves of 1/4, 1, 10 and 100 electrical turns and back, from standstill
+ * - a move to 10 turns re-planned mid-way to 12, then 3, then -5 turns
+ * - speed targets, reversing on the way
+ * - the jerk time changed during a move and at standstill, taken over once
+ *   settled
+ * A move has to end exactly on its target with done set. The exit code is 1
+ * on any miss.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "motor_traj.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_TURN                        (65536L)                // electrical angle steps
+#define SIM_SAMPLES_MAX                 (200000L)               // 40s
+#define SIM_HOLD_SAMPLES                (2 * TRAJ_FILTER_LEN)   // standing on the target after a move
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    int64_t  pos;                       /*q16*/
+    int64_t  speed;                     /*q16 per sample*/
+    int64_t  accel;
+    uint32_t samples;
+    int64_t  accel_max;                 /*largest |acceleration| seen*/
+    int64_t  jerk_max;
+    uint8_t  shift;                     /*jerk shift before the last sample*/
+    uint32_t misses;
+}sim_check_t;
+
+static sim_check_t chk;
+
+/* ============================ Static Function Declarations ============================ */
+
+/**
+ * @brief restart the checks at the state of the generator
+ *
+ * @param[in] None
+ * @return None
+ */
+static void sim_check_reset(void)
+{
+    chk.pos       = traj.pos_out >> traj.jerk_shift;
+    chk.speed     = traj.filter_sum >> traj.jerk_shift;
+    chk.accel     = 0;
+    chk.samples   = 0;
+    chk.accel_max = 0;
+    chk.jerk_max  = 0;
+    chk.shift     = traj.jerk_shift;
+}
+
+
+/**
+ * @brief one sample, checked against the limits
+ *
+ * @param[in] None
+ * @return None
+ */
+static void sim_step(void)
+{
+    int64_t  a_lim = traj.accel_q16;
+    int64_t  j_lim;
+    int64_t  pos, speed, accel, jerk;
+    uint8_t  before = traj.jerk_shift;
+    uint8_t  shift;
+
+    motor_traj_step();
+    pos   = traj.pos_out >> traj.jerk_shift;
+    speed = traj.filter_sum >> traj.jerk_shift;
+    accel = speed - chk.speed;
+    jerk  = accel - chk.accel;
+
+    /*across a jerk time change the shorter one holds, the moving average rounds: one q16 step per sample of slack*/
+    shift = (chk.shift < before) ? chk.shift : before;
+    j_lim = (2 * a_lim) >> shift;
+    if((llabs(speed) > traj.speed_max_q16 + 1) || (llabs(accel) > a_lim + 1)
+    || (llabs(jerk) > j_lim + 2) || (llabs(pos - chk.pos - speed) > 1))
+    {
+        if(chk.misses < 5)
+        {
+            printf("  sample %u: speed %lld accel %lld jerk %lld step %lld\n", chk.samples,
+                   (long long)speed, (long long)accel, (long long)jerk, (long long)(pos - chk.pos));
+        }
+        chk.misses++;
+    }
+    chk.accel_max = (llabs(accel) > chk.accel_max) ? llabs(accel) : chk.accel_max;
+    chk.jerk_max  = ((shift == traj.jerk_shift) && (llabs(jerk) > chk.jerk_max)) ? llabs(jerk) : chk.jerk_max;
+    chk.pos       = pos;
+    chk.speed     = speed;
+    chk.accel     = accel;
+    chk.shift     = before;
+    chk.samples++;
+}
+
+
+/**
+ * @brief step until the profile is done
+ *
+ * @param[in] None
+ * @return samples taken, 0 when it never finished
+ */
+static uint32_t sim_run_done(void)
+{
+    uint32_t n;
+
+    for(n = 1; n <= SIM_SAMPLES_MAX; n++)
+    {
+        sim_step();
+        if((traj.done != 0) && (traj.req == TRAJ_REQ_NONE))
+        {
+            return n;
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * @brief a position move from where the generator is: never past the target, ends and stays on it
+ *
+ * @param[in] target: electrical angle steps
+ * @param[in] jerk_next: jerk shift set after the first sample, -1 none
+ * @return 1 on a miss
+ */
+static int sim_move(int32_t target, int jerk_next)
+{
+    int64_t  goal = (int64_t)target << 16;
+    int64_t  dir  = (goal < chk.pos) ? -1 : 1;
+    int64_t  past = 0;
+    uint32_t n, k;
+
+    motor_traj_position_target(target);
+    sim_step();
+    if(jerk_next >= 0)
+    {
+        motor_traj_limits_set((int16_t)(traj.speed_max_q16 >> TRAJ_SPEED_SHIFT), traj.accel_q16, (uint8_t)jerk_next);
+    }
+    for(n = 2; n <= SIM_SAMPLES_MAX; n++)
+    {
+        sim_step();
+        past = ((chk.pos - goal) * dir > past) ? ((chk.pos - goal) * dir) : past;
+        if((traj.done != 0) && (traj.req == TRAJ_REQ_NONE))
+        {
+            break;
+        }
+    }
+    for(k = 0; k < SIM_HOLD_SAMPLES; k++)
+    {
+        sim_step();
+        past = (chk.pos != goal) ? (llabs(chk.pos - goal) + 1) : past;
+    }
+    if((n > SIM_SAMPLES_MAX) || (traj.pos != target) || (past != 0))
+    {
+        printf("  move to %ld: ended at %ld after %u samples, %.2f steps past it\n", (long)target, (long)traj.pos, n,
+               past / 65536.0);
+        return 1;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief moves from standstill and back
+ *
+ * @param[in] None
+ * @return 1 on a miss
+ */
+static int case_moves(void)
+{
+    static const int32_t turns_q2[] = {1, 4, 40, 400};  /*quarter turns*/
+    int fail = 0;
+    uint32_t k;
+
+    for(k = 0; k < sizeof(turns_q2) / sizeof(turns_q2[0]); k++)
+    {
+        uint32_t n = chk.samples;
+
+        fail |= sim_move(turns_q2[k] * (SIM_TURN / 4), -1);
+        n     = chk.samples - n - SIM_HOLD_SAMPLES;
+        printf("  %6.2f turns: %6.1f ms\n", turns_q2[k] / 4.0, n * 1000.0 / TRAJ_SAMPLE_HZ);
+        fail |= sim_move(0, -1);
+    }
+    return fail;
+}
+
+
+/**
+ * @brief a move re-planned mid-way, each new target once the last one is half done
+ *
+ * @param[in] None
+ * @return 1 on a miss
+ */
+static int case_replan(void)
+{
+    static const int32_t turns[] = {10, 12, 3};
+    int32_t from = traj.pos;
+    uint32_t k, n;
+
+    for(k = 0; k < sizeof(turns) / sizeof(turns[0]); k++)
+    {
+        int32_t target = turns[k] * SIM_TURN;
+
+        motor_traj_position_target(target);
+        for(n = 0; n < SIM_SAMPLES_MAX; n++)
+        {
+            sim_step();
+            if(labs(traj.pos - from) >= labs(target - from) / 2)
+            {
+                break;
+            }
+        }
+        printf("  re-planned at %.2f turns, %.0f rpm\n", (double)traj.pos / SIM_TURN,
+               traj.speed * 60.0 * PWM_FREQ_HZ / 65536.0 / MOTOR_POLE_PAIRS);
+        from = traj.pos;
+    }
+    return sim_move(-5 * SIM_TURN, -1);
+}
+
+
+/**
+ * @brief speed targets: up, reversing, down to standstill, each reached exactly
+ *
+ * @param[in] None
+ * @return 1 on a miss
+ */
+static int case_speed(void)
+{
+    static const int16_t speeds[] = {TRAJ_SPEED_MAX, TRAJ_SPEED_MAX / 3, -TRAJ_SPEED_MAX / 2, 0};
+    int fail = 0;
+    uint32_t k, n;
+
+    for(k = 0; k < sizeof(speeds) / sizeof(speeds[0]); k++)
+    {
+        motor_traj_speed_target(speeds[k]);
+        n = sim_run_done();
+        fail |= (n == 0) || (traj.speed != speeds[k]);
+        printf("  to %4d steps: %5.1f ms\n", speeds[k], n * 1000.0 / TRAJ_SAMPLE_HZ);
+    }
+    return fail;
+}
+
+
+/**
+ * @brief the jerk time changed during a move and at standstill
+ *
+ * @param[in] shift_a: jerk shift of the move
+ * @param[in] shift_b: the new one
+ * @return 1 on a miss
+ */
+static int case_jerk_change(uint8_t shift_a, uint8_t shift_b)
+{
+    int fail;
+
+    motor_traj_limits_set(TRAJ_SPEED_MAX, TRAJ_ACCEL_Q16, shift_a);
+    fail  = sim_move(traj.pos, -1);
+    fail |= sim_move(traj.pos + 3 * SIM_TURN, shift_b);
+    fail |= (traj.jerk_shift != shift_b);
+    fail |= sim_move(traj.pos + 2 * SIM_TURN, -1);
+    motor_traj_limits_set(TRAJ_SPEED_MAX, TRAJ_ACCEL_Q16, shift_a);
+    motor_traj_speed_target(TRAJ_SPEED_MAX / 2);
+    fail |= sim_run_done() == 0;
+    fail |= (traj.jerk_shift != shift_a);
+    motor_traj_speed_target(0);
+    fail |= sim_run_done() == 0;
+    printf("  jerk shift %u -> %u -> %u: %s\n", shift_a, shift_b, shift_a, fail ? "miss" : "ok");
+    return fail;
+}
+
+
+int main(void)
+{
+    static const uint8_t shifts[] = {0, TRAJ_JERK_SHIFT};
+    int fail = 0;
+    uint32_t k;
+
+    for(k = 0; k < sizeof(shifts) / sizeof(shifts[0]); k++)
+    {
+        printf("%s, jerk shift %u:\n", (shifts[k] == 0) ? "trapezoid" : "s-curve", shifts[k]);
+        motor_traj_init();
+        motor_traj_limits_set(TRAJ_SPEED_MAX, TRAJ_ACCEL_Q16, shifts[k]);
+        motor_traj_reset(0, 0);
+        sim_check_reset();
+        chk.misses = 0;
+
+        fail |= case_moves();
+        fail |= case_replan();
+        fail |= case_speed();
+        printf("  |a| max %.3f of the limit, jerk max %.3f of accel / 2^n\n", (double)chk.accel_max / traj.accel_q16,
+               (double)chk.jerk_max * (1 << shifts[k]) / traj.accel_q16);
+        fail |= case_jerk_change(shifts[k], (shifts[k] == 0) ? TRAJ_JERK_SHIFT_MAX : 2);
+        printf("  samples off the limits: %u\n", chk.misses);
+        fail |= (chk.misses != 0);
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,299 @@
+/**
+ * @file motor_tune_sim.c
+ * @brief Host tool: closed loop bandwidths of the gains of motor_tune.c
+ *
+ * @details
+ * Build and run on the PC, not part of the firmware (host/ explains the build):
+ *   gcc -O2 -no-pie -DUNIT_TEST -Ihost -I../Source/Bsp -I../Source/Motor \
+ *       -I../Libraries/SysConfig -I../Libraries/Lib/inc -I../Libraries/SysCore \
+ *       -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+ *       -o motor_tune_sim motor_tune_sim.c host/host_mcu.c ../Source/Motor/motor_*.c \
+ *       ../Source/Bsp/{bsp_pwm,bsp_adc,bsp_comp,bsp_flash}.c \
+ *       ../Libraries/Lib/src/{misc,n32g43x_adc,n32g43x_comp,n32g43x_exti,n32g43x_flash}.c \
+ *       ../Libraries/Lib/src/{n32g43x_gpio,n32g43x_rcc,n32g43x_tim}.c -lm
+ *   ./motor_tune_sim [current_bw_Hz speed_bw_Hz]
+ *
+ * For a set of motors (the one of motor_param.h and others around it)
+ * motor_tune_apply() gets a parameter block, after motor_tune_target_set()
+ * with the targets. The gains are read back from where it wrote them,
+ * foc.pid_d / foc.pid_q and loop.speed_pi, and have to equal tune. Then the
+ * closed loops are driven with a small sine reference and the -3dB frequency
+ * is found by bisection on the gain of the fundamental:
+ * - current loop: arm_pid_q15() on a copy of foc.pid_d or foc.pid_q, as
+ *   motor_foc_current_loop() runs it, on the R-L winding of the axis, solved
+ *   exactly per pwm period; the voltage of sample k is on the bridge from
+ *   half a period after it for one period
+ * - speed loop: the PI of motor_loop.c (motor_loop_test_pi() on a copy of
+ *   loop.speed_pi) every LOOP_SPEED_DIV periods on J, the torque through the
+ *   simulated q current loop, the speed measured as the angle step of the
+ *   last period
+ * The result is compared with the bandwidth the gains were made for (the
+ * target, or less when a gain was clamped); the exit code is 1 when one is
+ * off by more than CHECK_BW_TOL or a gain read back differs.
+ *
+ * @author  SamuelYang
+ * @email samuelyang615@163.com
+ * @date 2026-10-16
+ * @version 0.1.0
+ *
+ * @copyright Copyright (c) 2024 Company Name. All rights reserved.
+ */
+
+/* ============================ Include Headers ============================ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "bsp_pwm.h"
+#include "motor_param.h"
+#include "motor_foc.h"
+#include "motor_loop.h"
+#include "motor_resonant.h"
+#include "motor_tune.h"
+
+/* ============================ Module Internal Constants ============================ */
+
+#define SIM_2PI                         (6.283185307179586)
+#define SIM_INC_PER_RAD_S               (65536.0 / SIM_2PI * MOTOR_TS_S)   // angle steps per period of 1 rad/s electrical
+#define SIM_I_AMP                       (1000)              // current reference sine, q15
+#define SIM_SPEED_AMP                   (20.0)              // speed reference sine, angle steps per period
+#define SIM_CYCLES                      (20)
+#define CHECK_BW_TOL                    (0.25)
+
+/* ============================ Static Global Variables ============================ */
+
+typedef struct
+{
+    const char       *name;
+    param_id_block_t  block;
+}motor_t;
+
+typedef struct
+{
+    arm_pid_instance_q15 pid;           /*copy of the applied gains, state cleared*/
+    double a;                           /*winding solved over one period: i' = a * i + b * v*/
+    double b;
+    double i;                           /*A*/
+    double v;                           /*V on the bridge*/
+}axis_t;
+
+/* ============================ Static Function Implementations ============================ */
+
+/**
+ * @brief an axis at rest with the PI of the running current loop
+ *
+ * @param[out] x: axis
+ * @param[in] pid: foc.pid_d or foc.pid_q
+ * @param[in] r: winding resistance, Ohm
+ * @param[in] l: inductance of the axis, H
+ * @return None
+ */
+static void axis_init(axis_t *x, const arm_pid_instance_q15 *pid, double r, double l)
+{
+    x->pid          = *pid;
+    x->pid.state[0] = 0;
+    x->pid.state[1] = 0;
+    x->pid.state[2] = 0;
+    x->a            = exp(-r / l * MOTOR_TS_S);
+    x->b            = (1.0 - x->a) / r;
+    x->i            = 0.0;
+    x->v            = 0.0;
+}
+
+
+/**
+ * @brief one pwm period: the sample, arm_pid_q15() as in motor_foc_current_loop(), half a
+ *        period of the old voltage and half of the new one
+ *
+ * @param[in,out] x: axis
+ * @param[in] ref: current reference, q15
+ * @return sampled current, q15
+ */
+static int32_t axis_step(axis_t *x, int32_t ref)
+{
+    int32_t smp = (int32_t)lround(x->i / MOTOR_I_BASE_A * 32768.0);
+    int32_t e   = ref - smp;
+    int32_t y   = arm_pid_q15(&x->pid, (q15_t)((e > 32767) ? 32767 : ((e < -32768) ? -32768 : e)));
+    double  ah  = sqrt(x->a);
+    double  bh  = x->b / (1.0 + ah);
+
+    x->i = ah * x->i + bh * x->v;
+    x->v = y / 32768.0 * MOTOR_V_BASE_V;
+    x->i = ah * x->i + bh * x->v;
+
+    return smp;
+}
+
+
+/**
+ * @brief gain of the fundamental of a closed loop at f, with the gains in the loops
+ *
+ * @param[in] m: motor
+ * @param[in] loop_sel: 0 d current, 1 q current, 2 speed
+ * @param[in] f: reference frequency, Hz
+ * @return gain
+ */
+static double loop_gain(const motor_t *m, int loop_sel, double f)
+{
+    const param_id_block_t *b = &m->block;
+    long      per    = (long)(SIM_CYCLES * PWM_FREQ_HZ / f) + 1;
+    long      skip   = per / 2;
+    double    kt     = 1.5 * MOTOR_POLE_PAIRS * b->flux_wb;
+    double    amp    = (loop_sel == 2) ? SIM_SPEED_AMP : SIM_I_AMP;
+    double    si     = 0.0;
+    double    co     = 0.0;
+    double    w      = 0.0;             /*electrical rad/s*/
+    int32_t   iq_ref = 0;
+    loop_pi_t pi     = loop.speed_pi;
+    axis_t    x;
+    long      k;
+
+    pi.integ = 0;
+    axis_init(&x, (loop_sel == 0) ? &foc.pid_d : &foc.pid_q, b->rs_ohm, (loop_sel == 0) ? b->ld_h : b->lq_h);
+    for(k = 0; k < per; k++)
+    {
+        double  ph  = SIM_2PI * f * k * MOTOR_TS_S;
+        double  ref = amp * sin(ph);
+        double  out;
+
+        if(loop_sel != 2)
+        {
+            out = axis_step(&x, (int32_t)lround(ref));
+        }
+        else
+        {
+            /*the speed loop of motor_loop.c, every LOOP_SPEED_DIV periods*/
+            double inc = w * SIM_INC_PER_RAD_S;
+
+            if((k % LOOP_SPEED_DIV) == 0)
+            {
+                iq_ref = motor_loop_test_pi(&pi, (int32_t)lround(ref - inc), 0);
+            }
+            axis_step(&x, iq_ref);
+            w  += MOTOR_POLE_PAIRS * kt * x.i / b->j_kgm2 * MOTOR_TS_S;
+            out = inc;
+        }
+        if(k >= skip)
+        {
+            si += out * sin(ph);
+            co += out * cos(ph);
+        }
+    }
+
+    return 2.0 * hypot(si, co) / (per - skip) / amp;
+}
+
+
+/**
+ * @brief -3dB frequency of a closed loop, bisection between f_lo and f_hi
+ *
+ * @param[in] m: motor
+ * @param[in] loop_sel: 0 d current, 1 q current, 2 speed
+ * @param[in] f_lo: lower bound, Hz
+ * @param[in] f_hi: upper bound, Hz
+ * @return bandwidth, Hz
+ */
+static double loop_bw(const motor_t *m, int loop_sel, double f_lo, double f_hi)
+{
+    int n;
+
+    for(n = 0; n < 24; n++)
+    {
+        double f = sqrt(f_lo * f_hi);
+
+        if(loop_gain(m, loop_sel, f) > 0.70710678)
+        {
+            f_lo = f;
+        }
+        else
+        {
+            f_hi = f;
+        }
+    }
+
+    return sqrt(f_lo * f_hi);
+}
+
+
+/**
+ * @brief bandwidth off the design by more than CHECK_BW_TOL
+ *
+ * @param[in] bw: measured, Hz
+ * @param[in] design: of the gains, Hz
+ * @return 1 off, 0 within
+ */
+static int check(double bw, double design)
+{
+    return fabs(bw / design - 1.0) > CHECK_BW_TOL;
+}
+
+
+/**
+ * @brief the gains in the running loops are those of tune
+ *
+ * @param[in] None
+ * @return 1 differ, 0 equal
+ */
+static int check_applied(void)
+{
+    return (foc.pid_d.Kp != tune.kp_d) || (foc.pid_d.Ki != tune.ki_d) || (foc.pid_q.Kp != tune.kp_q)
+           || (foc.pid_q.Ki != tune.ki_q) || (loop.speed_pi.kp != tune.speed_kp) || (loop.speed_pi.ki != tune.speed_ki);
+}
+
+
+int main(int argc, char **argv)
+{
+    static const motor_t motor[] =
+    {
+        {"motor_param.h",    {MOTOR_RS_OHM, MOTOR_LD_H, MOTOR_LQ_H, MOTOR_FLUX_WB, MOTOR_J_KGM2}},
+        {"0.8R 1.2/1.6mH",   {0.80f, 0.00120f, 0.00160f, 0.0090f, 3e-4f}},
+        {"0.15R 0.2/0.28mH", {0.15f, 0.00020f, 0.00028f, 0.0035f, 4e-5f}},
+        {"1.5R 3/3mH",       {1.50f, 0.00300f, 0.00300f, 0.0150f, 1e-3f}},
+        {"light rotor",      {MOTOR_RS_OHM, MOTOR_LD_H, MOTOR_LQ_H, MOTOR_FLUX_WB, 1e-5f}},
+    };
+    int fail = 0;
+    int k;
+
+    motor_foc_init();
+    motor_loop_init();
+    motor_resonant_init();
+    motor_tune_init();
+    if(argc == 3)
+    {
+        motor_tune_target_set((float)atof(argv[1]), (float)atof(argv[2]));
+    }
+    else if(argc != 1)
+    {
+        fprintf(stderr, "usage: %s [current_bw_Hz speed_bw_Hz]\n", argv[0]);
+        return 2;
+    }
+
+    printf("targets: current %.0f Hz, speed %.1f Hz; closed loop -3dB / design bandwidth\n", tune.current_bw_hz, tune.speed_bw_hz);
+    printf("motor               kp_d  ki_d  kp_q  ki_q  speed kp / ki     d axis            q axis            speed\n");
+    for(k = 0; k < (int)(sizeof(motor) / sizeof(motor[0])); k++)
+    {
+        const motor_t *m = &motor[k];
+        double bw_d;
+        double bw_q;
+        double bw_s;
+
+        motor_tune_apply(&m->block);
+        if(check_applied() != 0)
+        {
+            printf("%-18s gains not in the loops\n", m->name);
+            fail = 1;
+            continue;
+        }
+        bw_d = loop_bw(m, 0, 1.0, 5000.0);
+        bw_q = loop_bw(m, 1, 1.0, 5000.0);
+        bw_s = loop_bw(m, 2, 0.5, 1000.0);
+        printf("%-18s %5d %5d %5d %5d  %7ld / %-6ld  %6.1f / %6.1f   %6.1f / %6.1f   %5.1f / %5.1f\n",
+               m->name, foc.pid_d.Kp, foc.pid_d.Ki, foc.pid_q.Kp, foc.pid_q.Ki, (long)loop.speed_pi.kp, (long)loop.speed_pi.ki,
+               bw_d, tune.current_bw_d_hz, bw_q, tune.current_bw_q_hz, bw_s, tune.speed_applied_bw_hz);
+        fail |= check(bw_d, tune.current_bw_d_hz) | check(bw_q, tune.current_bw_q_hz) | check(bw_s, tune.speed_applied_bw_hz);
+    }
+
+    printf("\n%s\n", fail ? "FAIL" : "pass");
+    return fail ? 1 : 0;
+}